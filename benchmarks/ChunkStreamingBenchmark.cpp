@@ -0,0 +1,110 @@
+// Walks a focus point diagonally across a large ChunkedTileMap world stored on disk, one Update per frame,
+// and reports the cost of Update on the main thread, how often the chunk under the focus was not loaded yet,
+// and the memory held by the loaded chunks against the size of the whole world.
+// The world is generated first: 30% rock, 10% sea, the rest empty, in 64 x 64 cell chunks of 16 pixel tiles.
+// Usage: ./bin/ChunkStreamingBenchmark [world size in chunks] [pixels per frame] [directory]
+//        (defaults to 64 chunks, 24 pixels per frame, ./bin/ChunkStreamingWorld)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ChunkedTileMap.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static void AddTileTypes(ChunkedTileMap &tilemap)
+{
+    tilemap.AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    tilemap.AddTileType("sea", "./assets/Map_tile_sea.bmp", true);
+}
+
+int main(int argc, char **argv)
+{
+    int worldChunks = argc > 1 ? std::max(4, std::atoi(argv[1])) : 64;
+    float speed = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 24.0f;
+    std::string directory = argc > 3 ? argv[3] : "./bin/ChunkStreamingWorld";
+    const int chunkSize = 64;
+    const int tileSize = 16;
+    const int loadRadius = 2;
+
+    std::filesystem::remove_all(directory);
+    auto start = Clock::now();
+    {
+        ChunkedTileMap writer(directory, tileSize, tileSize, chunkSize, loadRadius);
+        AddTileTypes(writer);
+        std::mt19937 rng(42);
+        std::vector<Uint16> ids(chunkSize * chunkSize);
+        for (int chunkY = 0; chunkY < worldChunks; chunkY++)
+        {
+            for (int chunkX = 0; chunkX < worldChunks; chunkX++)
+            {
+                for (Uint16 &id : ids)
+                {
+                    int roll = rng() % 10;
+                    id = roll < 3 ? 1 : roll < 4 ? 2 : 0;
+                }
+                writer.StoreChunk(chunkX, chunkY, ids.data());
+            }
+        }
+    }
+    double generateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t worldBytes = static_cast<size_t>(worldChunks) * worldChunks * chunkSize * chunkSize * sizeof(Uint16);
+    std::printf("world: %d x %d chunks, %d x %d cells, %.1f MB of cells, generated in %.0f ms\n",
+                worldChunks, worldChunks, worldChunks * chunkSize, worldChunks * chunkSize, worldBytes / (1024.0 * 1024.0), generateMs);
+
+    ChunkedTileMap tilemap(directory, tileSize, tileSize, chunkSize, loadRadius);
+    AddTileTypes(tilemap);
+    float worldPixels = worldChunks * chunkSize * tileSize;
+    float x = tileSize;
+    float y = tileSize;
+    tilemap.Update(x, y);
+    tilemap.WaitForChunks();
+
+    int frames = 0;
+    int stalls = 0;
+    int maxChunks = 0;
+    size_t maxBytes = 0;
+    std::vector<double> updateMs;
+    while (x < worldPixels - tileSize && y < worldPixels - tileSize)
+    {
+        x += speed;
+        y += speed;
+        auto frameStart = Clock::now();
+        tilemap.Update(x, y);
+        updateMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+
+        int focusChunkX = static_cast<int>(x / (tileSize * chunkSize));
+        int focusChunkY = static_cast<int>(y / (tileSize * chunkSize));
+        stalls += !tilemap.IsChunkLoaded(focusChunkX, focusChunkY);
+        // Collision queries at the focus, as a player would run every frame
+        tilemap.HasCollisionAt(x, y, tileSize * 2, tileSize * 2);
+        maxChunks = std::max(maxChunks, tilemap.GetLoadedChunkCount());
+        maxBytes = std::max(maxBytes, tilemap.GetLoadedByteSize());
+        frames++;
+        // About 60 frames per second, so the background thread has the time it would have in a game
+        SDL_Delay(16);
+    }
+
+    std::sort(updateMs.begin(), updateMs.end());
+    double total = 0.0;
+    for (double ms : updateMs)
+    {
+        total += ms;
+    }
+    std::printf("%d frames at %.0f pixels per frame, load radius %d\n", frames, speed, loadRadius);
+    std::printf("Update: mean %.3f ms, p99 %.3f ms, max %.3f ms\n", total / frames,
+                updateMs[static_cast<size_t>(frames * 0.99)], updateMs.back());
+    std::printf("frames with the focus chunk not loaded: %d\n", stalls);
+    std::printf("peak loaded: %d chunks, %.2f MB (%.2f%% of the world)\n", maxChunks,
+                maxBytes / (1024.0 * 1024.0), 100.0 * maxBytes / worldBytes);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Compares the CollisionWorld broadphases on a mix of collider sizes.
+// Most colliders are small (pickups, enemies), a few are huge (bosses, UI rects).
+// Every frame a part of the entities moves, then the world is stepped.
+// Usage: ./bin/CollisionBenchmark [frames]
+
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "CollisionWorld.hpp"
+#include "GameEntity.hpp"
+
+struct Result
+{
+    double stepMicroseconds;
+    double queryMicroseconds;
+    long contacts;
+};
+
+static std::vector<std::shared_ptr<GameEntity>> MakeEntities(int count, float worldSize, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::vector<std::shared_ptr<GameEntity>> entities;
+    for (int i = 0; i < count; i++)
+    {
+        // 1 in 50 is a giant collider, the rest are between 4 and 40 pixels wide
+        float size = (i % 50 == 0) ? 400.0f : 4.0f + (rng() % 37);
+        auto e = std::make_shared<GameEntity>();
+        e->AddTransform(position(rng), position(rng), size, size);
+        e->AddCollision2D(e->GetTransform()->GetX(), e->GetTransform()->GetY(), size, size);
+        entities.push_back(e);
+    }
+    return entities;
+}
+
+static Result Run(BroadphaseType broadphase, int count, int frames)
+{
+    const float worldSize = 8000.0f;
+    auto entities = MakeEntities(count, worldSize, 7);
+    CollisionWorld world(broadphase);
+    for (auto &e : entities)
+    {
+        world.AddEntity(e);
+    }
+
+    std::mt19937 rng(11);
+    Result result{0.0, 0.0, 0};
+    for (int frame = 0; frame < frames; frame++)
+    {
+        // A quarter of the entities move a few pixels
+        for (size_t i = frame % 4; i < entities.size(); i += 4)
+        {
+            entities[i]->MoveX(static_cast<float>(rng() % 7) - 3.0f);
+            entities[i]->MoveY(static_cast<float>(rng() % 7) - 3.0f);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        world.Step();
+        auto stepped = std::chrono::steady_clock::now();
+        for (int q = 0; q < 100; q++)
+        {
+            result.contacts += world.QueryRegion(rng() % 8000, rng() % 8000, 64.0f, 64.0f).size();
+        }
+        auto queried = std::chrono::steady_clock::now();
+
+        result.stepMicroseconds += std::chrono::duration<double, std::micro>(stepped - start).count();
+        result.queryMicroseconds += std::chrono::duration<double, std::micro>(queried - stepped).count();
+        result.contacts += world.GetContactCount();
+        world.DrainEvents();
+    }
+    result.stepMicroseconds /= frames;
+    result.queryMicroseconds /= frames;
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? std::atoi(argv[1]) : 100;
+
+    std::printf("%8s %22s %22s %24s %24s %s\n", "entities", "linear step (us)", "tree step (us)", "linear 100 queries (us)", "tree 100 queries (us)", "same result");
+    for (int count : {50, 200, 1000, 4000})
+    {
+        Result linear = Run(BroadphaseType::LinearScan, count, frames);
+        Result tree = Run(BroadphaseType::DynamicTree, count, frames);
+        std::printf("%8d %22.1f %22.1f %24.1f %24.1f %s\n", count, linear.stepMicroseconds, tree.stepMicroseconds,
+                    linear.queryMicroseconds, tree.queryMicroseconds, linear.contacts == tree.contacts ? "yes" : "NO");
+    }
+    return 0;
+}
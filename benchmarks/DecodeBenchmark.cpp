@@ -0,0 +1,124 @@
+// Compares the BMP and QOI decode paths of the ResourceManager on the same assets.
+// For each asset: the file size of both formats, the in-memory QOI decode throughput,
+// and the time to load the file into a ready surface (SDL_LoadBMP + ColorKeyToAlpha vs QoiLoadSurface).
+// Throughputs are in MB of decoded pixels per second, files are warm in the page cache.
+// Usage: ./bin/DecodeBenchmark [bmp]...   (defaults to every BMP in ./assets)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "PixelOps.hpp"
+#include "QoiCodec.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double Seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> filepaths;
+    for (int i = 1; i < argc; i++)
+    {
+        filepaths.push_back(argv[i]);
+    }
+    if (filepaths.empty())
+    {
+        for (auto &entry : std::filesystem::directory_iterator("./assets"))
+        {
+            if (entry.path().extension() == ".bmp")
+            {
+                filepaths.push_back(entry.path().string());
+            }
+        }
+        std::sort(filepaths.begin(), filepaths.end());
+    }
+
+    auto tempDirectory = std::filesystem::temp_directory_path() / "DecodeBenchmark";
+    std::filesystem::create_directories(tempDirectory);
+
+    const int repeats = 20;
+    double totalPixelMB = 0.0;
+    double totalBmpBytes = 0.0, totalQoiBytes = 0.0;
+    double totalBmpLoad = 0.0, totalQoiLoad = 0.0, totalQoiDecode = 0.0;
+
+    std::printf("%-28s %10s %10s %14s %14s %14s\n", "asset", "bmp (KB)", "qoi (KB)", "qoi dec MB/s", "bmp load MB/s", "qoi load MB/s");
+    for (auto &filepath : filepaths)
+    {
+        // Prepare the QOI version the same way QoiConverter does
+        SDL_Surface *loaded = SDL_LoadBMP(filepath.c_str());
+        if (nullptr == loaded)
+        {
+            continue;
+        }
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+        SDL_DestroySurface(loaded);
+        if (nullptr == converted)
+        {
+            continue;
+        }
+        ColorKeyToAlpha(static_cast<Uint32 *>(converted->pixels), converted->w, converted->h, converted->pitch, 0);
+        std::vector<Uint8> encoded;
+        QoiEncode(static_cast<const Uint32 *>(converted->pixels), converted->w, converted->h, converted->pitch, encoded);
+        std::string qoiPath = (tempDirectory / std::filesystem::path(filepath).filename().replace_extension(".qoi")).string();
+        QoiSaveSurface(converted, qoiPath);
+        double pixelMB = converted->w * converted->h * 4 / (1024.0 * 1024.0);
+        std::vector<Uint32> decoded(static_cast<size_t>(converted->w) * converted->h);
+
+        auto start = Clock::now();
+        for (int i = 0; i < repeats; i++)
+        {
+            QoiDecode(encoded.data(), encoded.size(), decoded.data(), converted->w * 4);
+        }
+        double qoiDecode = Seconds(start) / repeats;
+        SDL_DestroySurface(converted);
+
+        start = Clock::now();
+        for (int i = 0; i < repeats; i++)
+        {
+            SDL_Surface *bmp = SDL_LoadBMP(filepath.c_str());
+            SDL_Surface *pixels = SDL_ConvertSurfaceFormat(bmp, SDL_PIXELFORMAT_ARGB8888);
+            SDL_DestroySurface(bmp);
+            ColorKeyToAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch, 0);
+            SDL_DestroySurface(pixels);
+        }
+        double bmpLoad = Seconds(start) / repeats;
+
+        start = Clock::now();
+        for (int i = 0; i < repeats; i++)
+        {
+            SDL_DestroySurface(QoiLoadSurface(qoiPath));
+        }
+        double qoiLoad = Seconds(start) / repeats;
+
+        double bmpBytes = std::filesystem::file_size(filepath);
+        std::printf("%-28s %10.1f %10.1f %14.1f %14.1f %14.1f\n", std::filesystem::path(filepath).filename().string().c_str(),
+                    bmpBytes / 1024.0, encoded.size() / 1024.0, pixelMB / qoiDecode, pixelMB / bmpLoad, pixelMB / qoiLoad);
+
+        totalPixelMB += pixelMB;
+        totalBmpBytes += bmpBytes;
+        totalQoiBytes += encoded.size();
+        totalBmpLoad += bmpLoad;
+        totalQoiLoad += qoiLoad;
+        totalQoiDecode += qoiDecode;
+    }
+
+    if (totalPixelMB == 0.0)
+    {
+        std::printf("No asset could be loaded\n");
+        return 1;
+    }
+    std::printf("%-28s %10.1f %10.1f %14.1f %14.1f %14.1f\n", "total", totalBmpBytes / 1024.0, totalQoiBytes / 1024.0,
+                totalPixelMB / totalQoiDecode, totalPixelMB / totalBmpLoad, totalPixelMB / totalQoiLoad);
+    std::printf("Loading every asset: BMP %.2f ms, QOI %.2f ms\n", totalBmpLoad * 1000.0, totalQoiLoad * 1000.0);
+
+    std::filesystem::remove_all(tempDirectory);
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Measures undoing and redoing level editor steps with an EditHistory on a large map with a terrain and a decoration layer,
+// against building the map again from its layouts, which is what going back to an earlier state of the level cost before
+// (without reading the level or loading any texture, which building a level also does).
+// Each step is a stroke of a few cells around a cursor wandering over the map, recorded like the editor records them;
+// the whole session is undone then redone step by step. The history is then given a small memory budget,
+// and the coalesced oldest step is undone back to the start of the session.
+// Usage: ./bin/EditHistoryBenchmark [map size] [steps] [cells per step]   (defaults to 512, 2000, 8; maps are square)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "EditHistory.hpp"
+#include "SDLGraphicsProgram.hpp"
+#include "TileMap.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintTimes(const char *label, std::vector<double> &times)
+{
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double ms : times)
+    {
+        total += ms;
+    }
+    std::printf("%-34s mean %.4f ms, p99 %.4f ms, max %.4f ms\n", label, total / times.size(),
+                times[static_cast<size_t>(times.size() * 0.99)], times.back());
+}
+
+static std::shared_ptr<TileMap> MakeTileMap(std::shared_ptr<SDLGraphicsProgram> game, const std::vector<Uint16> &terrain,
+                                            const std::vector<Uint16> &decoration, int size)
+{
+    // 16 pixels per tile, the map size is not tied to the window here
+    auto tilemap = std::make_shared<TileMap>(size * 16, size * 16, size, size);
+    tilemap->AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    tilemap->AddTileType("sea", "./assets/Map_tile_sea.bmp", true);
+    tilemap->LoadLayout(game, terrain.data(), size, size);
+    int layer = tilemap->AddLayer("decoration");
+    tilemap->LoadLayout(game, decoration.data(), size, size, layer);
+    return tilemap;
+}
+
+int main(int argc, char **argv)
+{
+    int size = argc > 1 ? std::max(8, std::atoi(argv[1])) : 512;
+    int steps = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+    int stroke = argc > 3 ? std::max(1, std::atoi(argv[3])) : 8;
+
+    auto game = std::make_shared<SDLGraphicsProgram>(64, 64, "EditHistoryBenchmark");
+
+    std::mt19937 rng(size);
+    std::vector<Uint16> terrain(static_cast<size_t>(size) * size), decoration(terrain.size());
+    for (size_t i = 0; i < terrain.size(); i++)
+    {
+        int roll = rng() % 10;
+        terrain[i] = roll < 3 ? 1 : roll < 4 ? 2 : 0;
+        decoration[i] = rng() % 20 == 0 ? 2 : 0;
+    }
+    auto tilemap = MakeTileMap(game, terrain, decoration, size);
+
+    EditHistory history;
+    std::vector<double> recordMs;
+    int cursorRow = size / 2;
+    int cursorColumn = size / 2;
+    for (int step = 0; step < steps; step++)
+    {
+        cursorRow = std::clamp(cursorRow + static_cast<int>(rng() % 9) - 4, 0, size - 1);
+        cursorColumn = std::clamp(cursorColumn + static_cast<int>(rng() % 9) - 4, 0, size - 1);
+        for (int i = 0; i < stroke; i++)
+        {
+            int row = std::clamp(cursorRow + static_cast<int>(rng() % 5) - 2, 0, size - 1);
+            int column = std::clamp(cursorColumn + static_cast<int>(rng() % 5) - 2, 0, size - 1);
+            int layer = rng() % 4 == 0 ? 1 : 0;
+            Uint16 before = static_cast<Uint16>(tilemap->GetTileId(row, column, layer));
+            Uint16 after = static_cast<Uint16>(rng() % 3);
+            if (after != 0)
+            {
+                tilemap->PlaceTileAt(after == 1 ? "rock" : "sea", row, column, layer);
+            }
+            else
+            {
+                tilemap->EraseTileAt(row, column, layer);
+            }
+            auto start = Clock::now();
+            history.RecordTile(layer, row, column, before, after);
+            recordMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        auto start = Clock::now();
+        history.EndStep();
+        recordMs.back() += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    std::printf("%d x %d map, 2 layers, %d steps of %d cells: %zu bytes of history, %d steps kept\n", size, size, steps,
+                stroke, history.GetByteSize(), history.GetUndoCount());
+
+    std::vector<double> undoMs, redoMs;
+    while (history.GetUndoCount() > 0)
+    {
+        auto start = Clock::now();
+        history.Undo(tilemap);
+        undoMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    bool backToStart = true;
+    for (int row = 0; row < size && backToStart; row++)
+    {
+        for (int column = 0; column < size; column++)
+        {
+            size_t i = static_cast<size_t>(row) * size + column;
+            if (tilemap->GetTileId(row, column) != terrain[i] || tilemap->GetTileId(row, column, 1) != decoration[i])
+            {
+                backToStart = false;
+                break;
+            }
+        }
+    }
+    while (history.GetRedoCount() > 0)
+    {
+        auto start = Clock::now();
+        history.Redo(tilemap);
+        redoMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    // A budget smaller than the session, so that its oldest steps are coalesced
+    size_t budget = history.GetByteSize() / 4;
+    auto start = Clock::now();
+    history.SetMemoryBudget(budget);
+    double coalesceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("budget of %zu bytes: %zu bytes, %d steps kept, %d coalesced in %.4f ms\n", budget, history.GetByteSize(),
+                history.GetUndoCount(), history.GetCoalescedCount(), coalesceMs);
+    std::vector<double> undoCoalescedMs;
+    while (history.GetUndoCount() > 0)
+    {
+        start = Clock::now();
+        history.Undo(tilemap);
+        undoCoalescedMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::vector<double> rebuildMs;
+    for (int i = 0; i < 10; i++)
+    {
+        start = Clock::now();
+        auto rebuilt = MakeTileMap(game, terrain, decoration, size);
+        rebuildMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::printf("undone back to the start: %s\n", backToStart ? "yes" : "NO");
+    PrintTimes("record a step:", recordMs);
+    PrintTimes("undo a step:", undoMs);
+    PrintTimes("redo a step:", redoMs);
+    PrintTimes("undo, coalesced:", undoCoalescedMs);
+    PrintTimes("rebuild the tile map:", rebuildMs);
+    return 0;
+}
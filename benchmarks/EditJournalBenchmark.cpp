@@ -0,0 +1,103 @@
+// Measures what saving a level edit costs the game thread: appending records to an EditJournal, which writes and syncs
+// them on its background thread, against writing and syncing each record on the game thread.
+// Edits come in bursts of a few records per frame, like a drag in the level editor, with a commit at the end of each burst.
+// Usage: ./bin/EditJournalBenchmark [frames] [records per frame] [journal path]
+//        (defaults to 600 frames, 4 records per frame, ./bin/EditJournalBenchmark.journal)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "EditJournal.hpp"
+
+#if defined(LINUX) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintTimes(const char *label, std::vector<double> &frameMs)
+{
+    std::sort(frameMs.begin(), frameMs.end());
+    double total = 0.0;
+    for (double ms : frameMs)
+    {
+        total += ms;
+    }
+    std::printf("%-28s mean %.4f ms, p99 %.4f ms, max %.4f ms per frame\n", label, total / frameMs.size(),
+                frameMs[static_cast<size_t>(frameMs.size() * 0.99)], frameMs.back());
+}
+
+static EditRecord MakeRecord(int frame, int index)
+{
+    EditRecord record;
+    record.op = EditOp::PlaceTile;
+    record.row = frame % 20;
+    record.column = index % 20;
+    record.value = 1 + index % 2;
+    return record;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 600;
+    int perFrame = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4;
+    std::string path = argc > 3 ? argv[3] : "./bin/EditJournalBenchmark.journal";
+
+    std::filesystem::remove(path);
+    std::vector<double> journalMs;
+    {
+        EditJournal journal;
+        if (!journal.Open(path))
+        {
+            return 1;
+        }
+        for (int frame = 0; frame < frames; frame++)
+        {
+            auto start = Clock::now();
+            for (int i = 0; i < perFrame; i++)
+            {
+                journal.Append(MakeRecord(frame, i));
+            }
+            EditRecord commit;
+            commit.op = EditOp::Commit;
+            journal.Append(commit);
+            journalMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            // About 60 frames per second, so the background thread has the time it would have in a game
+            SDL_Delay(16);
+        }
+        journal.Flush();
+        std::printf("%d records in %d syncs, journal of %ju bytes\n", journal.GetWrittenCount(), journal.GetSyncCount(),
+                    static_cast<uintmax_t>(std::filesystem::file_size(path)));
+    }
+    PrintTimes("journal (background sync):", journalMs);
+
+    // The same records written and synced on the game thread, one sync per record
+    std::filesystem::remove(path);
+    std::vector<double> syncMs;
+    std::FILE *file = std::fopen(path.c_str(), "ab");
+    for (int frame = 0; frame < frames / 10; frame++)
+    {
+        auto start = Clock::now();
+        for (int i = 0; i <= perFrame; i++)
+        {
+            EditRecord record = MakeRecord(frame, i);
+            std::fwrite(&record, sizeof(record), 1, file);
+            std::fflush(file);
+#if defined(LINUX) || defined(__APPLE__)
+            fsync(fileno(file));
+#endif
+        }
+        syncMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::fclose(file);
+    PrintTimes("game thread sync:", syncMs);
+
+    std::filesystem::remove(path);
+    return 0;
+}
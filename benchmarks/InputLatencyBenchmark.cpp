@@ -0,0 +1,171 @@
+// Measures the time from a key press to the present of the first frame that sees it, and how many presses are seen,
+// with the input read the way it was before the EventQueue and with the EventQueue.
+// A thread types random letters like a fast typist, holding each key from 2 to 60 ms, so many presses are shorter than
+// a frame. The keys go to SDL as events and to a keyboard state kept here, standing in for the state SDL's keyboard
+// driver keeps (events pushed by a program do not change SDL's own keyboard state).
+// Before: the keyboard state is read at the start of each frame and the events are polled for quit at its end and
+// thrown away, as Input::isQuitClicked did. After: Input::Update pumps the events into the EventQueue at the start of
+// the frame, and flip measures their latency.
+// Usage: ./bin/InputLatencyBenchmark [seconds per run] [frame ms]   (defaults to 5, 16)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "EventQueue.hpp"
+#include "Input.hpp"
+#include "SDLGraphicsProgram.hpp"
+
+/**
+ * The keyboard as SDL's keyboard driver would see it, and when each key was last pressed.
+ */
+static std::atomic<bool> keyDown[SDL_NUM_SCANCODES];
+static std::atomic<Uint64> keyPressedNS[SDL_NUM_SCANCODES];
+
+static void PushKey(SDL_Scancode scancode, bool down)
+{
+    SDL_Event event{};
+    event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+    event.key.timestamp = SDL_GetTicksNS();
+    event.key.keysym.scancode = scancode;
+    event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+    if (down)
+    {
+        keyPressedNS[scancode] = event.key.timestamp;
+    }
+    keyDown[scancode] = down;
+    SDL_PushEvent(&event);
+}
+
+/**
+ * Type random letters until told to stop.
+ * @return The number of presses.
+ */
+static int Type(std::atomic<bool> &stop, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    int presses = 0;
+    while (!stop)
+    {
+        SDL_Scancode scancode = static_cast<SDL_Scancode>(SDL_SCANCODE_A + rng() % 26);
+        PushKey(scancode, true);
+        presses++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2 + rng() % 59));
+        PushKey(scancode, false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 + rng() % 71));
+    }
+    return presses;
+}
+
+static void PrintLatency(const char *label, int presses, std::vector<double> &latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0.0;
+    for (double ms : latencies)
+    {
+        total += ms;
+    }
+    if (latencies.empty())
+    {
+        std::printf("%-12s %5d of %5d presses seen\n", label, 0, presses);
+        return;
+    }
+    std::printf("%-12s %5zu of %5d presses seen (%5.1f%%), latency mean %.2f ms, p99 %.2f ms, max %.2f ms\n", label,
+                latencies.size(), presses, 100.0 * latencies.size() / presses, total / latencies.size(),
+                latencies[static_cast<size_t>(latencies.size() * 0.99)], latencies.back());
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    int frameMs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 16;
+
+    auto game = std::make_shared<SDLGraphicsProgram>(64, 64, "InputLatencyBenchmark");
+    std::printf("%d s per run, %d ms frames, presses held 2 to 60 ms\n", seconds, frameMs);
+
+    for (int run = 0; run < 2; run++)
+    {
+        bool queued = run == 1;
+        for (auto &down : keyDown)
+        {
+            down = false;
+        }
+        // Whatever the previous run left in SDL
+        EventQueue &events = EventQueue::Instance();
+        events.Pump();
+        events.ResetLatency();
+
+        std::atomic<bool> stop{false};
+        int presses = 0;
+        std::thread typist([&]
+                           { presses = Type(stop, 1234); });
+        std::vector<bool> wasDown(SDL_NUM_SCANCODES, false);
+        std::vector<double> latencies;
+        Uint64 end = SDL_GetTicksNS() + static_cast<Uint64>(seconds) * 1000000000;
+        while (SDL_GetTicksNS() < end)
+        {
+            // The presses seen at the start of the frame, with when they were made
+            std::vector<Uint64> pressedNS;
+            if (queued)
+            {
+                Input::Update();
+                for (int i = 0; i < events.GetFrameEventCount(); i++)
+                {
+                    const SDL_Event &event = events.GetFrameEvent(i).event;
+                    if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat)
+                    {
+                        pressedNS.push_back(event.key.timestamp);
+                    }
+                }
+            }
+            else
+            {
+                for (int i = SDL_SCANCODE_A; i <= SDL_SCANCODE_Z; i++)
+                {
+                    bool down = keyDown[i];
+                    if (down && !wasDown[i])
+                    {
+                        pressedNS.push_back(keyPressedNS[i]);
+                    }
+                    wasDown[i] = down;
+                }
+            }
+
+            // The rest of the frame
+            std::this_thread::sleep_for(std::chrono::milliseconds(frameMs));
+            game->clear(0, 0, 0, 255);
+            game->flip();
+            Uint64 presentNS = SDL_GetTicksNS();
+            for (Uint64 ns : pressedNS)
+            {
+                latencies.push_back((presentNS - ns) / 1000000.0);
+            }
+
+            if (!queued)
+            {
+                // What Input::isQuitClicked did at the end of each frame
+                SDL_Event event;
+                while (SDL_PollEvent(&event))
+                {
+                }
+            }
+        }
+        stop = true;
+        typist.join();
+
+        PrintLatency(queued ? "EventQueue:" : "before:", presses, latencies);
+        if (queued)
+        {
+            InputLatency latency = events.GetLatency();
+            std::printf("%-12s %5d presses measured by flip, latency mean %.2f ms, max %.2f ms\n", "", latency.count,
+                        latency.meanMs, latency.maxMs);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Compares the two ways of building a TileMap from a layout of tile type ids:
+// a PlaceTileAt call per cell followed by LoadToGame (what the python level builder used to do, minus the
+// interpreter), and a single LoadLayout call. The layouts are random: 30% rock, 10% sea, the rest empty.
+// The per-cell path rebuilds the collision rectangles after every tile, so it is only run on the smaller maps.
+// Usage: ./bin/LevelBuildBenchmark [max size]   (defaults to 1024, maps are square)
+
+#include <SDL3/SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SDLGraphicsProgram.hpp"
+#include "TileMap.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static const char *TILE_NAMES[] = {"", "rock", "sea"};
+
+static std::shared_ptr<TileMap> MakeTileMap(int size)
+{
+    // 16 pixels per tile, the map size is not tied to the window here
+    auto tilemap = std::make_shared<TileMap>(size * 16, size * 16, size, size);
+    tilemap->AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    tilemap->AddTileType("sea", "./assets/Map_tile_sea.bmp", true);
+    return tilemap;
+}
+
+static double BuildPerCell(std::shared_ptr<SDLGraphicsProgram> game, const std::vector<Uint16> &layout, int size)
+{
+    auto start = Clock::now();
+    auto tilemap = MakeTileMap(size);
+    for (int row = 0; row < size; row++)
+    {
+        for (int column = 0; column < size; column++)
+        {
+            Uint16 id = layout[row * size + column];
+            if (id != 0)
+            {
+                tilemap->PlaceTileAt(TILE_NAMES[id], row, column);
+            }
+        }
+    }
+    tilemap->LoadToGame(game);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double BuildFromLayout(std::shared_ptr<SDLGraphicsProgram> game, const std::vector<Uint16> &layout, int size)
+{
+    auto start = Clock::now();
+    auto tilemap = MakeTileMap(size);
+    tilemap->LoadLayout(game, layout.data(), size, size);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    int maxSize = argc > 1 ? std::atoi(argv[1]) : 1024;
+    // Past this, the per-cell path takes too long to be worth waiting for
+    const double perCellLimitMs = 10000.0;
+
+    auto game = std::make_shared<SDLGraphicsProgram>(64, 64, "LevelBuildBenchmark");
+
+    std::printf("%-12s %10s %16s %16s\n", "map", "tiles", "per cell (ms)", "LoadLayout (ms)");
+    double lastPerCell = 0.0;
+    for (int size = 64; size <= maxSize; size *= 2)
+    {
+        std::mt19937 rng(size);
+        std::vector<Uint16> layout(static_cast<size_t>(size) * size);
+        int tiles = 0;
+        for (Uint16 &id : layout)
+        {
+            int roll = rng() % 10;
+            id = roll < 3 ? 1 : roll < 4 ? 2 : 0;
+            tiles += id != 0;
+        }
+
+        std::string perCell = "skipped";
+        // The per-cell path grows faster than linearly, skip it once the last size got slow
+        if (lastPerCell < perCellLimitMs / 8)
+        {
+            lastPerCell = BuildPerCell(game, layout, size);
+            char formatted[32];
+            std::snprintf(formatted, sizeof(formatted), "%.1f", lastPerCell);
+            perCell = formatted;
+        }
+        double fromLayout = BuildFromLayout(game, layout, size);
+        std::printf("%4d x %-5d %10d %16s %16.1f\n", size, size, tiles, perCell.c_str(), fromLayout);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Compares the scalar, SSE2 and AVX2 kernels of the load time pixel passes on a large synthetic sprite sheet.
+// The sheet has an odd width so every row ends with a scalar tail, about half of it is the color key
+// and the rest has every alpha value. Each kernel's output is checked against the scalar one.
+// Throughputs are in MB of pixels per second, best of the runs.
+// Usage: ./bin/PixelOpsBenchmark [width height]   (defaults to 4099 x 4096)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "PixelOps.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+using ColorKeyKernel = void (*)(Uint32 *, int, int, int, Uint32);
+using PremultiplyKernel = void (*)(Uint32 *, int, int, int);
+
+struct Kernels
+{
+    const char *name;
+    bool supported;
+    ColorKeyKernel colorKey;
+    PremultiplyKernel premultiply;
+};
+
+int main(int argc, char **argv)
+{
+    int width = 4099, height = 4096;
+    if (argc > 2)
+    {
+        width = std::max(1, std::atoi(argv[1]));
+        height = std::max(1, std::atoi(argv[2]));
+    }
+    const Uint32 colorKey = 0x000000;
+    const int runs = 10;
+    const int pitch = width * 4;
+
+    std::vector<Uint32> sheet(static_cast<size_t>(width) * height);
+    std::mt19937 random(42);
+    for (Uint32 &pixel : sheet)
+    {
+        Uint32 value = random();
+        pixel = value & 1 ? colorKey : value;
+    }
+    double pixelMB = sheet.size() * 4 / (1024.0 * 1024.0);
+
+    Kernels kernels[] = {
+        {"scalar", true, ColorKeyToAlphaScalar, PremultiplyAlphaScalar},
+        {"sse2", SDL_HasSSE2() == SDL_TRUE, ColorKeyToAlphaSSE2, PremultiplyAlphaSSE2},
+        {"avx2", SDL_HasAVX2() == SDL_TRUE, ColorKeyToAlphaAVX2, PremultiplyAlphaAVX2},
+    };
+
+    std::vector<Uint32> expectedColorKey = sheet, expectedPremultiply = sheet;
+    ColorKeyToAlphaScalar(expectedColorKey.data(), width, height, pitch, colorKey);
+    PremultiplyAlphaScalar(expectedPremultiply.data(), width, height, pitch);
+
+    std::printf("%d x %d pixels, %.1f MB\n", width, height, pixelMB);
+    std::printf("%-8s %16s %16s\n", "kernel", "color key MB/s", "premultiply MB/s");
+    int mismatches = 0;
+    std::vector<Uint32> work(sheet.size());
+    for (auto &kernel : kernels)
+    {
+        if (!kernel.supported)
+        {
+            std::printf("%-8s %16s %16s\n", kernel.name, "-", "-");
+            continue;
+        }
+
+        double bestColorKey = 1e9, bestPremultiply = 1e9;
+        for (int i = 0; i < runs; i++)
+        {
+            work = sheet;
+            auto start = Clock::now();
+            kernel.colorKey(work.data(), width, height, pitch, colorKey);
+            bestColorKey = std::min(bestColorKey, std::chrono::duration<double>(Clock::now() - start).count());
+            mismatches += work != expectedColorKey;
+
+            work = sheet;
+            start = Clock::now();
+            kernel.premultiply(work.data(), width, height, pitch);
+            bestPremultiply = std::min(bestPremultiply, std::chrono::duration<double>(Clock::now() - start).count());
+            mismatches += work != expectedPremultiply;
+        }
+        std::printf("%-8s %16.1f %16.1f\n", kernel.name, pixelMB / bestColorKey, pixelMB / bestPremultiply);
+    }
+
+    if (mismatches > 0)
+    {
+        std::printf("%d runs differ from the scalar kernels\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Measures capturing a LevelSnapshot every frame and restoring one, on a map with a terrain and a decoration layer
+// and a crowd of animated entities, against rebuilding the map from its layouts like building a level does
+// (without reading the level or loading any texture, which building a level also does).
+// The entities move every frame and a tile changes every few frames around a cursor, like a game running with the editor open;
+// the snapshots go into a ring, as a rewind would keep them, and the oldest one is restored.
+// Usage: ./bin/SnapshotBenchmark [map size] [entities] [frames]   (defaults to 256, 200, 600; maps are square)
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "GameEntity.hpp"
+#include "LevelSnapshot.hpp"
+#include "SDLGraphicsProgram.hpp"
+#include "SingleAnimation.hpp"
+#include "TileMap.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintTimes(const char *label, std::vector<double> &times)
+{
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double ms : times)
+    {
+        total += ms;
+    }
+    std::printf("%-34s mean %.4f ms, p99 %.4f ms, max %.4f ms\n", label, total / times.size(),
+                times[static_cast<size_t>(times.size() * 0.99)], times.back());
+}
+
+static std::shared_ptr<TileMap> MakeTileMap(std::shared_ptr<SDLGraphicsProgram> game, const std::vector<Uint16> &terrain,
+                                            const std::vector<Uint16> &decoration, int size)
+{
+    // 16 pixels per tile, the map size is not tied to the window here
+    auto tilemap = std::make_shared<TileMap>(size * 16, size * 16, size, size);
+    tilemap->AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    tilemap->AddTileType("sea", "./assets/Map_tile_sea.bmp", true);
+    tilemap->LoadLayout(game, terrain.data(), size, size);
+    int layer = tilemap->AddLayer("decoration");
+    tilemap->LoadLayout(game, decoration.data(), size, size, layer);
+    return tilemap;
+}
+
+static std::shared_ptr<GameEntity> MakeEntity(float x, float y)
+{
+    auto entity = std::make_shared<GameEntity>();
+    entity->AddTransform(x, y, 48, 48);
+    entity->AddCollision2D(x + 8, y + 8, 32, 40);
+    for (const char *state : {"idle", "run", "attack"})
+    {
+        // No texture, only the playback is captured
+        auto animation = std::make_shared<SingleAnimation>();
+        animation->SetFrameConfig(0, 0, 48, 0, 48, 6, 80, true);
+        entity->AddAnimation(state, animation);
+    }
+    entity->SetState("idle");
+    return entity;
+}
+
+int main(int argc, char **argv)
+{
+    int size = argc > 1 ? std::max(1, std::atoi(argv[1])) : 256;
+    int entityCount = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+    int frames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 600;
+    // One second of rewind at 60 frames per second
+    const int ringSize = 60;
+
+    auto game = std::make_shared<SDLGraphicsProgram>(64, 64, "SnapshotBenchmark");
+
+    std::mt19937 rng(size);
+    std::vector<Uint16> terrain(static_cast<size_t>(size) * size), decoration(terrain.size());
+    for (size_t i = 0; i < terrain.size(); i++)
+    {
+        int roll = rng() % 10;
+        terrain[i] = roll < 3 ? 1 : roll < 4 ? 2 : 0;
+        decoration[i] = rng() % 20 == 0 ? 2 : 0;
+    }
+    auto tilemap = MakeTileMap(game, terrain, decoration, size);
+
+    std::vector<std::shared_ptr<GameEntity>> entities;
+    std::vector<std::vector<float>> values;
+    for (int i = 0; i < entityCount; i++)
+    {
+        entities.push_back(MakeEntity(static_cast<float>(rng() % (size * 16)), static_cast<float>(rng() % (size * 16))));
+        // Health, max health, cooldown, direction, alive, like the combatants of the game
+        values.push_back({10.0f, 10.0f, 0.0f, -1.0f, 1.0f});
+    }
+
+    std::vector<LevelSnapshot> ring(ringSize);
+    std::vector<double> captureMs, restoreMs;
+    const char *states[] = {"idle", "run", "attack"};
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int i = 0; i < entityCount; i++)
+        {
+            entities[i]->MoveX((i % 2 == 0 ? 1.0f : -1.0f) * 1.5f);
+            if ((frame + i) % 45 == 0)
+            {
+                entities[i]->SetState(states[(frame + i) % 3]);
+            }
+            entities[i]->Update(1.0f / 60.0f);
+            values[i][2] = static_cast<float>(frame % 30) / 60.0f;
+        }
+        tilemap->Update(1.0f / 60.0f);
+        if (frame % 10 == 0)
+        {
+            // An edit near the cursor, so that restoring has a layer to redraw and merge again
+            int cursorRow = (size / 2 + frame / 60) % size;
+            tilemap->PlaceTileAt(frame % 20 == 0 ? "rock" : "sea", (cursorRow + rng() % 4) % size, rng() % size);
+        }
+
+        auto start = Clock::now();
+        ring[frame % ringSize].Capture(tilemap, entities, values);
+        captureMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        // Rewind to the oldest snapshot of the ring every second, then keep going from there
+        if (frame >= ringSize && frame % ringSize == 0)
+        {
+            start = Clock::now();
+            ring[(frame + 1) % ringSize].Restore(tilemap, entities);
+            restoreMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+    }
+
+    // Restoring the snapshot of the state the map is already in, the common case of a rewind one frame back
+    std::vector<double> unchangedMs;
+    for (int i = 0; i < 100; i++)
+    {
+        ring[0].Capture(tilemap, entities, values);
+        auto start = Clock::now();
+        ring[0].Restore(tilemap, entities);
+        unchangedMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::vector<double> rebuildMs;
+    for (int i = 0; i < 10; i++)
+    {
+        auto start = Clock::now();
+        auto rebuilt = MakeTileMap(game, terrain, decoration, size);
+        rebuildMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::printf("%d x %d map, 2 layers, %d entities: %zu bytes per snapshot\n", size, size, entityCount, ring[0].GetByteSize());
+    PrintTimes("capture:", captureMs);
+    if (!restoreMs.empty())
+    {
+        PrintTimes("restore, one second back:", restoreMs);
+    }
+    PrintTimes("restore, tiles unchanged:", unchangedMs);
+    PrintTimes("rebuild the tile map:", rebuildMs);
+    return 0;
+}
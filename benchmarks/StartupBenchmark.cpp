@@ -0,0 +1,145 @@
+// Compares loading every asset from the loose BMP files against loading them from a packed archive.
+// Loose: SDL_LoadBMP, color key pass, SDL_CreateTextureFromSurface, file by file.
+// Packed: map the archive once, SDL_CreateTexture + SDL_UpdateTexture from the mapped pixels.
+// Cold runs first evict the files from the page cache (posix_fadvise, no root needed), warm runs do not.
+// Usage: ./bin/StartupBenchmark [archive] [runs]
+// The archive is made with: ./bin/AssetPacker ./assets/assets.pak ./assets/*.bmp
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "AssetArchive.hpp"
+#include "PixelOps.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static void EvictFromPageCache(const std::string &filepath)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return;
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static double LoadLoose(SDL_Renderer *renderer, const std::vector<std::string> &filepaths)
+{
+    auto start = Clock::now();
+    std::vector<SDL_Texture *> textures;
+    for (auto &filepath : filepaths)
+    {
+        // Same path as ResourceManager::DecodeSurface
+        SDL_Surface *loaded = SDL_LoadBMP(filepath.c_str());
+        if (nullptr == loaded)
+        {
+            continue;
+        }
+        SDL_Surface *pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+        SDL_DestroySurface(loaded);
+        ColorKeyToAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch, 0);
+        textures.push_back(SDL_CreateTextureFromSurface(renderer, pixels));
+        SDL_DestroySurface(pixels);
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    for (SDL_Texture *texture : textures)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    return ms;
+}
+
+static double LoadPacked(SDL_Renderer *renderer, const std::string &archivePath)
+{
+    auto start = Clock::now();
+    AssetArchive archive;
+    std::vector<SDL_Texture *> textures;
+    if (archive.Open(archivePath))
+    {
+        for (int i = 0; i < archive.GetEntryCount(); i++)
+        {
+            textures.push_back(archive.CreateTexture(renderer, archive.GetEntry(i)));
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    for (SDL_Texture *texture : textures)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    return ms;
+}
+
+static double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char **argv)
+{
+    std::string archivePath = argc > 1 ? argv[1] : "./assets/assets.pak";
+    int runs = argc > 2 ? std::atoi(argv[2]) : 9;
+
+    // Load the same assets both ways: the ones the archive holds
+    std::vector<std::string> filepaths;
+    {
+        AssetArchive archive;
+        if (!archive.Open(archivePath))
+        {
+            std::printf("Could not open %s, build it first with AssetPacker\n", archivePath.c_str());
+            return 1;
+        }
+        for (int i = 0; i < archive.GetEntryCount(); i++)
+        {
+            filepaths.emplace_back(archive.GetPath(archive.GetEntry(i)));
+        }
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::printf("SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Window *window = SDL_CreateWindow("StartupBenchmark", 64, 64, SDL_WINDOW_HIDDEN);
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, NULL, SDL_RENDERER_ACCELERATED);
+    if (nullptr == renderer)
+    {
+        std::printf("SDL_CreateRenderer failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    std::vector<double> looseCold, looseWarm, packedCold, packedWarm;
+    for (int run = 0; run < runs; run++)
+    {
+        for (auto &filepath : filepaths)
+        {
+            EvictFromPageCache(filepath);
+        }
+        looseCold.push_back(LoadLoose(renderer, filepaths));
+        looseWarm.push_back(LoadLoose(renderer, filepaths));
+
+        EvictFromPageCache(archivePath);
+        packedCold.push_back(LoadPacked(renderer, archivePath));
+        packedWarm.push_back(LoadPacked(renderer, archivePath));
+    }
+
+    std::printf("%zu assets, median of %d runs\n", filepaths.size(), runs);
+    std::printf("%-8s %12s %12s\n", "", "cold (ms)", "warm (ms)");
+    std::printf("%-8s %12.2f %12.2f\n", "loose", Median(looseCold), Median(looseWarm));
+    std::printf("%-8s %12.2f %12.2f\n", "packed", Median(packedCold), Median(packedWarm));
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Measures texture cache hits under contention, with 8 to 32 loader threads.
+// All but one thread look up textures that are already cached, while the last one keeps
+// requesting new assets, like a level loading in the background.
+// Compares ResourceManager::LoadTextureAsync against the previous design, where one global
+// mutex guarded contains() then operator[] and was held while SDL_LoadBMP decoded a miss.
+// Also checks that concurrent requests for one new asset start a single decode.
+// Run from the repository root so that ./assets is found.
+// Usage: ./bin/TextureCacheBenchmark [lookups per thread]
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ResourceManager.hpp"
+
+namespace fs = std::filesystem;
+
+// The cache as it was: every lookup serializes on one mutex, misses decode while holding it
+struct GlobalMutexCache
+{
+    std::shared_ptr<TextureHandle> Load(const std::string &filepath)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mResources.contains(filepath))
+        {
+            SDL_Surface *pixels = SDL_LoadBMP(filepath.c_str());
+            if (nullptr != pixels)
+            {
+                SDL_DestroySurface(pixels);
+            }
+            mResources.insert({filepath, std::make_shared<TextureHandle>(filepath)});
+        }
+        return mResources[filepath];
+    }
+
+    std::mutex mMutex;
+    std::unordered_map<std::string, std::shared_ptr<TextureHandle>> mResources;
+};
+
+struct Result
+{
+    double hitsPerSecond;
+    double worstHitMicroseconds;
+};
+
+template <typename F>
+static Result Run(int threads, int lookups, const std::vector<std::string> &hits, const std::vector<std::string> &misses, F load)
+{
+    std::atomic<bool> go{false};
+    std::atomic<bool> done{false};
+    std::vector<double> worst(threads, 0.0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < threads - 1; t++)
+    {
+        readers.emplace_back([&, t]()
+                             {
+            while (!go)
+            {
+            }
+            size_t k = t;
+            for (int i = 0; i < lookups; i++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                load(hits[k]);
+                double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                worst[t] = std::max(worst[t], us);
+                k = (k + 7) % hits.size();
+            } });
+    }
+    std::thread loader([&]()
+                       {
+        while (!go)
+        {
+        }
+        for (size_t i = 0; i < misses.size() && !done; i++)
+        {
+            load(misses[i]);
+        } });
+
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &r : readers)
+    {
+        r.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done = true;
+    loader.join();
+    return {(threads - 1) * static_cast<double>(lookups) / seconds, *std::max_element(worst.begin(), worst.end())};
+}
+
+int main(int argc, char **argv)
+{
+    int lookups = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::vector<std::string> hits;
+    for (auto &entry : fs::directory_iterator("./assets"))
+    {
+        if (entry.path().extension() == ".bmp")
+        {
+            hits.push_back(entry.path().string());
+        }
+    }
+    if (hits.empty())
+    {
+        std::printf("No assets found, run from the repository root\n");
+        return 1;
+    }
+
+    // Copies of the assets under new names, so that every request of the loader thread is a real miss
+    fs::path scratch = fs::temp_directory_path() / "TextureCacheBenchmark";
+    fs::create_directories(scratch);
+    auto makeMisses = [&](const std::string &prefix)
+    {
+        std::vector<std::string> misses;
+        for (int i = 0; i < 128; i++)
+        {
+            fs::path copy = scratch / (prefix + "_" + std::to_string(i) + ".bmp");
+            fs::copy_file(hits[i % hits.size()], copy, fs::copy_options::overwrite_existing);
+            misses.push_back(copy.string());
+        }
+        return misses;
+    };
+
+    ResourceManager &manager = ResourceManager::Instance();
+    std::printf("%8s %24s %24s %24s %24s\n", "threads", "global mutex (hits/s)", "sharded (hits/s)", "global mutex worst (us)", "sharded worst (us)");
+    for (int threads : {8, 16, 32})
+    {
+        // Fresh caches and fresh miss names for every round
+        GlobalMutexCache baseline;
+        std::vector<std::string> baselineMisses = makeMisses(std::to_string(threads) + "_before");
+        std::vector<std::string> managerMisses = makeMisses(std::to_string(threads) + "_after");
+        for (auto &h : hits)
+        {
+            baseline.Load(h);
+            manager.LoadTextureAsync(h)->WaitUntilDecoded();
+        }
+
+        Result before = Run(threads, lookups, hits, baselineMisses, [&](const std::string &k)
+                            { return baseline.Load(k); });
+        Result after = Run(threads, lookups, hits, managerMisses, [&](const std::string &k)
+                           { return manager.LoadTextureAsync(k); });
+        std::printf("%8d %24.0f %24.0f %24.1f %24.1f\n", threads, before.hitsPerSecond, after.hitsPerSecond,
+                    before.worstHitMicroseconds, after.worstHitMicroseconds);
+    }
+
+    // Every thread asks for the same asset at once, only one decode should start
+    std::string fresh = makeMisses("coalesce")[0];
+    int decodesBefore = manager.GetDecodeCount();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 32; t++)
+    {
+        workers.emplace_back([&]()
+                             { manager.LoadTextureAsync(fresh)->WaitUntilDecoded(); });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    std::printf("32 concurrent requests for one new asset started %d decode(s)\n", manager.GetDecodeCount() - decodesBefore);
+
+    fs::remove_all(scratch);
+    return 0;
+}
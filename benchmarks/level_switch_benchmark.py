@@ -0,0 +1,118 @@
+# Compares the time to get a level in hand when switching levels: parsing config.json as the game used to on every
+# switch, mapping the binary level file, and what the game does on a switch: mapping the file and turning it into the
+# dict the level editor works on, with the layouts as flat TileLayouts TileMap.load_layout reads in place.
+# The last column is the old way of the game, the layouts turned into nested python lists.
+# Runs on the levels of config.json, then on generated square levels with 30% rock, 10% sea and 50 enemies,
+# and prints the size of each level as JSON and as a level file.
+# The level file is opened with mygameengine.LevelFile when the engine module is built, with python's mmap otherwise.
+# Usage (from the repository root): python3 benchmarks/level_switch_benchmark.py [runs]   (defaults to 20)
+
+
+import json
+import mmap
+import os
+import random
+import statistics
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "lib"))
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "helpers"))
+from level_format import HEADER, LAYER, write_level_file, read_level_file, level_config_from_level_file
+
+try:
+    import mygameengine
+except ImportError:
+    mygameengine = None
+
+
+def map_level_file(path):
+    if(mygameengine is not None):
+        level_file = mygameengine.LevelFile()
+        level_file.open(path)
+        return level_file.get_layer_cells(0)
+    # Same work as the engine: map, check the header, point at the ids
+    with open(path, "rb") as file:
+        data = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+    header = HEADER.unpack_from(data, 0)
+    rows, columns, layers_offset = header[2], header[3], header[10]
+    cells_offset = LAYER.unpack_from(data, layers_offset)[4]
+    return memoryview(data)[cells_offset:cells_offset + rows * columns * 2].cast("H", (rows, columns))
+
+
+def read_game_level(path):
+    # What build_level does with a level file before building
+    if(mygameengine is not None):
+        level_file = mygameengine.LevelFile()
+        level_file.open(path)
+        return level_config_from_level_file(level_file)
+    return read_level_file(path)[1]
+
+
+def read_nested_level(path):
+    level_config = read_game_level(path)
+    level_config["map_layout"] = level_config["map_layout"].tolist()
+    for layer in level_config.get("layers", []):
+        layer["map_layout"] = layer["map_layout"].tolist()
+    return level_config
+
+
+def read_json_level(path, level_name):
+    with open(path, "r") as file:
+        return json.load(file)["levels"][level_name]
+
+
+def median_ms(function, runs):
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        function()
+        times.append((time.perf_counter() - start) * 1000)
+    return statistics.median(times)
+
+
+def generated_level(size, rng):
+    def position(x, y, w, h):
+        return {"initial_x": x, "initial_y": y, "width": w, "height": h}
+    return {
+        "destination_position": {"transform": {"x": 824.0, "y": 885.0, "width": 140, "height": 110},
+                                 "collider": {"x": 859.0, "y": 912.5, "width": 70, "height": 55}},
+        "player_position": {"transform": position(62.0, 129.0, 42, 64), "collider": position(68.0, 136.5, 30, 49)},
+        "enemies": [{"no.": i + 1, "type": "hyena", "transform": position(rng.randrange(size * 32) + 0.5, rng.randrange(size * 32) + 0.5, 45, 29),
+                     "collider": position(rng.randrange(size * 32) + 0.5, rng.randrange(size * 32) + 0.5, 45, 29)} for i in range(50)],
+        "map_layout": [[1 if roll < 3 else 2 if roll < 4 else 0 for roll in (rng.randrange(10) for _ in range(size))] for _ in range(size)],
+    }
+
+
+def run(label, config, level_name, directory, runs):
+    config_path = os.path.join(directory, "config.json")
+    with open(config_path, "w") as file:
+        json.dump(config, file, indent=4)
+    level_path = os.path.join(directory, "level.lvl")
+    level_size = write_level_file(level_path, level_name, config["levels"][level_name])
+    json_size = len(json.dumps(config["levels"][level_name], indent=4))
+
+    json_ms = median_ms(lambda: read_json_level(config_path, level_name), runs)
+    mapped_ms = median_ms(lambda: map_level_file(level_path), runs)
+    game_ms = median_ms(lambda: read_game_level(level_path), runs)
+    nested_ms = median_ms(lambda: read_nested_level(level_path), runs)
+    print("{:<18} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>12} {:>12}".format(label, json_ms, mapped_ms, game_ms, nested_ms,
+                                                                        json_size, level_size))
+
+
+runs = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+with open("./config.json", "r") as file:
+    game_config = json.load(file)
+
+print("level file opened with {}, median of {} runs".format("mygameengine.LevelFile" if mygameengine else "python mmap", runs))
+print("{:<18} {:>10} {:>10} {:>10} {:>10} {:>12} {:>12}".format("level", "json ms", "mapped ms", "game ms", "lists ms",
+                                                                "json bytes", "file bytes"))
+with tempfile.TemporaryDirectory() as directory:
+    for level_name in game_config["levels"]:
+        run(level_name, game_config, level_name, directory, runs)
+
+    rng = random.Random(42)
+    for size in (64, 256, 1024):
+        config = {"global_config": game_config["global_config"], "levels": {"level 1": generated_level(size, rng)}}
+        run("{} x {}".format(size, size), config, "level 1", directory, max(1, runs // (size // 64)))
@@ -0,0 +1,56 @@
+# Replays a recorded run of the game several times, headless and as fast as possible, to compare builds on the same
+# workload: prints the frame times of each replay and checks that every replay went through the same states,
+# frame by frame, as the recording and as each other.
+# Record a run first with: python3 main.py --record run.sdir
+# Each replay runs on its own copy of the levels, so the recorded editor edits never reach ./levels.
+# Usage (from the repository root): python3 benchmarks/replay_benchmark.py run.sdir [runs]   (defaults to 5)
+
+
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+MAIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "main.py")
+SUMMARY = re.compile(r"Replayed (\d+) of (\d+) frames in ([\d.]+) s: ([\d.]+) frames/s, frame mean ([\d.]+) ms, p99 ([\d.]+) ms")
+
+
+def replay(recording, hashes_path):
+    output = subprocess.run([sys.executable, MAIN, "--replay", recording, "--headless", "--hashes", hashes_path],
+                            capture_output=True, text=True).stdout
+    summary = SUMMARY.search(output)
+    if(summary is None):
+        print(output)
+        sys.exit("The replay did not finish")
+    with open(hashes_path, "r") as file:
+        hashes = file.read()
+    return summary, "Every frame matched" in output, hashes
+
+
+def main():
+    if(len(sys.argv) < 2):
+        sys.exit("Usage: python3 benchmarks/replay_benchmark.py run.sdir [runs]")
+    recording = sys.argv[1]
+    runs = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+    frame_means = []
+    first_hashes = None
+    same_states = True
+    with tempfile.TemporaryDirectory() as directory:
+        for run in range(runs):
+            summary, matched, hashes = replay(recording, os.path.join(directory, "hashes_{}.txt".format(run)))
+            frames, total, seconds, fps, mean_ms, p99_ms = summary.groups()
+            print("run {}: {} frames in {} s, {} frames/s, frame mean {} ms, p99 {} ms, {}".format(
+                run + 1, frames, seconds, fps, mean_ms, p99_ms, "same states as recorded" if matched else "STATES DIFFER"))
+            frame_means.append(float(mean_ms))
+            first_hashes = hashes if first_hashes is None else first_hashes
+            same_states = same_states and matched and hashes == first_hashes
+
+    print("median frame mean {:.3f} ms over {} runs, states {}".format(
+        statistics.median(frame_means), runs, "identical in every run" if same_states else "NOT identical"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,38 @@
+# Builds every .cpp file of a directory as its own executable in ./bin.
+# Each executable is linked against the engine sources, minus the
+# python bindings, so it runs without python.
+# Used by benchmarks/buildbenchmarks.py and tools/buildtools.py.
+# Usage (from the repository root): python3 buildexecutables.py directory...
+
+
+import glob
+import os
+import sys
+
+COMPILER="g++"
+
+# Same flags as the engine, optimized and without -shared
+ARGUMENTS="-D LINUX -std=c++20 -O2"
+
+INCLUDE_DIR="-I ./include/"
+
+LIBRARIES="-lSDL3 -ldl -lpthread"
+
+# Everything but the bindings, which need python
+ENGINE_SOURCE=" ".join(s for s in sorted(glob.glob("./src/*.cpp")) if not s.endswith("bindings.cpp"))
+
+OUTPUT_DIR="./bin"
+
+
+def build_executables(directory):
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+    for source in sorted(glob.glob(os.path.join(directory, "*.cpp"))):
+        name = os.path.splitext(os.path.basename(source))[0]
+        compileString=COMPILER+" "+ARGUMENTS+" -o "+os.path.join(OUTPUT_DIR, name)+" "+INCLUDE_DIR+" "+source+" "+ENGINE_SOURCE+" "+LIBRARIES
+        print(compileString)
+        os.system(compileString)
+
+
+if __name__ == "__main__":
+    for directory in sys.argv[1:]:
+        build_executables(directory)
@@ -1,48 +1,62 @@
-import json
-FILE_PATH = "./config.json"
-
-def get_level_config(level_name, json_data):
-    for level in json_data:
-        if level["levelName"] == level_name:
-            return level
-    return None
-
-
-def read_config(*keys):
-    try:
-        with open(FILE_PATH, 'r') as file:
-            data = json.load(file)
-            for key in keys:
-                data = data[key]
-            return data
-
-    except FileNotFoundError:
-        print(f"File '{FILE_PATH}' not found.")
-        return None
-    except json.JSONDecodeError:
-        print(f"Error decoding JSON in '{FILE_PATH}'.")
-        return None
-    except KeyError:
-        print(f"Key not found in JSON structure.")
-        return None
-
-def write_config(data, *keys):
-    try:
-        with open(FILE_PATH, 'r') as file:
-            json_data = json.load(file)
-        
-        # Traverse to the nested level
-        temp = json_data
-        for key in keys[:-1]:
-            temp = temp[key]
-        
-        # Update the value
-        temp[keys[-1]] = data
-        
-        with open(FILE_PATH, 'w') as file:
-            json.dump(json_data, file, indent=4)
-        print(f"Data written to '{FILE_PATH}' successfully.")
-    except json.JSONDecodeError:
-        print(f"Error decoding JSON in '{FILE_PATH}'.")
-    except Exception as e:
+import json
+import os
+FILE_PATH = "./config.json"
+
+# The parsed file, kept until the file changes so that every read does not parse the whole file again.
+# read_config hands out the cached data itself: callers must not change it, and copy what they need to change,
+# e.g. editable_level_config in level_format.py for the level editor
+_cache = None
+_cache_mtime = None
+
+def get_level_config(level_name, json_data):
+    for level in json_data:
+        if level["levelName"] == level_name:
+            return level
+    return None
+
+
+def read_config(*keys):
+    global _cache, _cache_mtime
+    try:
+        mtime = os.stat(FILE_PATH).st_mtime_ns
+        if(_cache is None or mtime != _cache_mtime):
+            with open(FILE_PATH, 'r') as file:
+                _cache = json.load(file)
+            _cache_mtime = mtime
+        data = _cache
+        for key in keys:
+            data = data[key]
+        return data
+
+    except FileNotFoundError:
+        print(f"File '{FILE_PATH}' not found.")
+        return None
+    except json.JSONDecodeError:
+        print(f"Error decoding JSON in '{FILE_PATH}'.")
+        return None
+    except KeyError:
+        print(f"Key not found in JSON structure.")
+        return None
+
+def write_config(data, *keys):
+    global _cache
+    try:
+        with open(FILE_PATH, 'r') as file:
+            json_data = json.load(file)
+        
+        # Traverse to the nested level
+        temp = json_data
+        for key in keys[:-1]:
+            temp = temp[key]
+        
+        # Update the value
+        temp[keys[-1]] = data
+        
+        with open(FILE_PATH, 'w') as file:
+            json.dump(json_data, file, indent=4)
+        _cache = None
+        print(f"Data written to '{FILE_PATH}' successfully.")
+    except json.JSONDecodeError:
+        print(f"Error decoding JSON in '{FILE_PATH}'.")
+    except Exception as e:
         print(f"Error writing data to '{FILE_PATH}': {e}")
\ No newline at end of file
@@ -0,0 +1,75 @@
+import mygameengine
+from object_builders import build_enemy
+from objects import find_obj
+from level_journal import EditOp, apply_edit
+
+# Undo and redo of the level editor. The engine keeps each step as the cells and entities it changed, patches the
+# tile map and moves the player and destination back and forth itself; the records it returns for the state it went to
+# update the level config and go into the journal like any other edit.
+# The enemies taken out of the level by an edit, an undo or a redo are kept by number, to be put back as they were.
+
+
+def entity_record(level_config_dict, op, enemy_num=0):
+    # The record of the player, the destination or an enemy as it is in the level config
+    if(op == EditOp.MOVE_PLAYER):
+        position = level_config_dict["player_position"]
+        keys = ("initial_x", "initial_y", "width", "height")
+    elif(op == EditOp.MOVE_DESTINATION):
+        position = level_config_dict["destination_position"]
+        keys = ("x", "y", "width", "height")
+    else:
+        position = next((enemy for enemy in level_config_dict["enemies"] if enemy["no."] == enemy_num), None)
+        if(op == EditOp.REMOVE_ENEMY or position is None):
+            return mygameengine.EditRecord(EditOp.REMOVE_ENEMY, value=enemy_num)
+        return mygameengine.EditRecord(EditOp.ADD_ENEMY, value=enemy_num, type=position["type"],
+                                       transform=[position["transform"][k] for k in ("initial_x", "initial_y", "width", "height")],
+                                       collider=[position["collider"][k] for k in ("initial_x", "initial_y", "width", "height")])
+    return mygameengine.EditRecord(op, transform=[position["transform"][k] for k in keys],
+                                   collider=[position["collider"][k] for k in keys])
+
+
+class LevelEditHistory:
+    def __init__(self):
+        self.history = mygameengine.EditHistory()
+        self.removed_enemies = {}
+
+    def record_tile(self, row, column, before, after, layer=0):
+        self.history.record_tile(layer, row, column, before, after)
+
+    def record_entity(self, obj, before, after):
+        if(after.op == EditOp.REMOVE_ENEMY):
+            self.removed_enemies[after.value] = obj
+        self.history.record_entity(obj.game_entity, before, after)
+
+    def end_step(self):
+        self.history.end_step()
+
+    def clear(self):
+        self.history.clear()
+        self.removed_enemies = {}
+
+    def undo(self, game, tilemap, objects, global_config_dict, level_config_dict, journal=None):
+        # Returns False if there was nothing to undo
+        return self._apply(self.history.undo(tilemap), game, objects, global_config_dict, level_config_dict, journal)
+
+    def redo(self, game, tilemap, objects, global_config_dict, level_config_dict, journal=None):
+        # Returns False if there was nothing to redo
+        return self._apply(self.history.redo(tilemap), game, objects, global_config_dict, level_config_dict, journal)
+
+    def _apply(self, records, game, objects, global_config_dict, level_config_dict, journal):
+        for record in records:
+            apply_edit(level_config_dict, record)
+            if(journal is not None):
+                journal.append(record)
+            if(record.op == EditOp.ADD_ENEMY):
+                enemy = self.removed_enemies.pop(record.value, None)
+                if(enemy is None):
+                    position = next(e for e in level_config_dict["enemies"] if e["no."] == record.value)
+                    enemy = build_enemy(game, global_config_dict["enemies_config"][record.type], position)
+                objects.append(enemy)
+            elif(record.op == EditOp.REMOVE_ENEMY):
+                enemy = find_obj(str(record.value), objects)
+                if(enemy is not None):
+                    objects.remove(enemy)
+                    self.removed_enemies[record.value] = enemy
+        return len(records) > 0
@@ -0,0 +1,111 @@
+import os
+import shutil
+import tempfile
+import time
+import mygameengine
+
+# Recording and replaying the input of a run of the game, to run it again exactly. The engine keeps the keyboard,
+# the mouse and the frame clock of every frame in an InputRecording; the game adds a hash of the state of the level
+# after each frame. A replay feeds the recorded input and frame times back through Input and the frame clock,
+# as fast as the frames can be computed, and checks each state against the recorded one.
+# Both modes run on a temporary copy of the level directory, so that a replay starts from the levels the recording
+# started from: edits made in the level editor are journaled in the copy and thrown away with it. Textures are loaded
+# completely when a level starts, in both modes, so that colliders fitted to the sprites do not depend on how fast
+# the textures load.
+
+FNV_PRIME = 1099511628211
+HASH_MASK = 0xFFFFFFFFFFFFFFFF
+
+
+def state_hash(snapshot, tilemap, objects, *values):
+    # The hash of the level from a LevelSnapshot, mixed with a few values the game keeps outside the level
+    snapshot.capture(tilemap, [o.game_entity for o in objects], [o.get_snapshot_values() for o in objects])
+    h = snapshot.get_hash()
+    for value in values:
+        h = ((h ^ int(value)) * FNV_PRIME) & HASH_MASK
+    return h
+
+
+class InputSession:
+    def __init__(self, record_path=None, replay_path=None, hashes_path=None):
+        self.record_path = record_path
+        self.replay_path = replay_path
+        self.hashes_path = hashes_path
+        self.hashes = None
+        self.recording = None
+        self.snapshot = mygameengine.LevelSnapshot()
+        self.frame = 0
+        self.mismatch = None
+        self.frame_times = []
+        self.frame_start = None
+        self.level_copy = None
+
+    def is_deterministic(self):
+        return self.record_path is not None or self.replay_path is not None
+
+    def level_directory(self, level_directory):
+        # The directory the levels are read from and edited in during the session
+        if(not self.is_deterministic()):
+            return level_directory
+        self.level_copy = tempfile.TemporaryDirectory(prefix="levels_", ignore_cleanup_errors=True)
+        if(os.path.isdir(level_directory)):
+            shutil.copytree(level_directory, self.level_copy.name, dirs_exist_ok=True)
+        return self.level_copy.name
+
+    def start(self):
+        # Returns False if the replay could not be read
+        self.recording = mygameengine.InputRecording()
+        if(self.replay_path is not None):
+            if(not self.recording.load(self.replay_path)):
+                return False
+            mygameengine.Input.start_replay(self.recording)
+        elif(self.record_path is not None):
+            mygameengine.Input.start_recording(self.recording)
+        if(self.hashes_path is not None):
+            self.hashes = open(self.hashes_path, "w")
+        self.frame_start = time.perf_counter()
+        return True
+
+    def end_frame(self, tilemap, objects, *values):
+        # Called once at the end of every frame, after everything the frame changes
+        now = time.perf_counter()
+        self.frame_times.append(now - self.frame_start)
+        if(self.is_deterministic() or self.hashes is not None):
+            h = state_hash(self.snapshot, tilemap, objects, *values)
+            if(self.record_path is not None and self.replay_path is None):
+                self.recording.set_state_hash(h)
+            elif(self.replay_path is not None and self.mismatch is None and h != self.recording.get_state_hash(self.frame)):
+                self.mismatch = self.frame
+            if(self.hashes is not None):
+                self.hashes.write("{} {:016x}\n".format(self.frame, h))
+        self.frame += 1
+        # The hashing is not part of the frame time
+        self.frame_start = time.perf_counter()
+
+    def is_finished(self):
+        return self.replay_path is not None and not mygameengine.Input.is_replaying()
+
+    def close(self):
+        if(self.hashes is not None):
+            self.hashes.close()
+        if(self.level_copy is not None):
+            self.level_copy.cleanup()
+        if(self.recording is None):
+            return
+        if(self.record_path is not None and self.replay_path is None):
+            mygameengine.Input.stop_recording()
+            self.recording.save(self.record_path)
+            print("Recorded {} frames to {} ({} bytes)".format(self.recording.get_frame_count(), self.record_path,
+                                                              self.recording.get_byte_size()))
+        if(self.replay_path is not None):
+            mygameengine.Input.stop_replay()
+            times = sorted(self.frame_times)
+            total = sum(times)
+            if(len(times) > 0):
+                print("Replayed {} of {} frames in {:.3f} s: {:.1f} frames/s, frame mean {:.3f} ms, p99 {:.3f} ms".format(
+                    self.frame, self.recording.get_frame_count(), total, len(times) / total if total > 0 else 0.0,
+                    total / len(times) * 1000, times[min(len(times) - 1, int(len(times) * 0.99))] * 1000))
+            if(self.mismatch is None):
+                print("Every frame matched the recorded state")
+            else:
+                print("The state first differed from the recording after frame {}".format(self.mismatch))
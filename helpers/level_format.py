@@ -0,0 +1,239 @@
+import array
+import mmap
+import os
+import struct
+import sys
+
+# Binary level files, read by the engine's LevelFile (include/LevelFile.hpp) straight from a memory mapping.
+# Layout: header, layer records, spawn records, the uint16 tile type ids of each layer, string table.
+# Everything is little-endian; the structs below must match LevelFileHeader, LevelFileLayer and LevelFileSpawn.
+
+LEVEL_MAGIC = b"SDEL"
+LEVEL_VERSION = 1
+LAYER_COLLIDABLE = 1
+LAYER_FOREGROUND = 2
+
+# magic, version, rows, columns, layerCount, spawnCount, layerSize, spawnSize, nameOffset, journalSequence,
+# layersOffset, spawnsOffset, stringsOffset, stringsSize
+HEADER = struct.Struct("<4s9I4Q")
+# nameOffset, flags, parallaxX, parallaxY, cellsOffset
+LAYER = struct.Struct("<2I2fQ")
+# kindOffset, typeOffset, number, transform x y w h, collider x y w h, reserved
+SPAWN = struct.Struct("<2Ii4f4fI")
+
+
+def level_file_path(global_config_dict, level):
+    return os.path.join(global_config_dict["level_directory"], "level_{}.lvl".format(level))
+
+
+def _align(offset, alignment=8):
+    return (offset + alignment - 1) // alignment * alignment
+
+
+def _number(value):
+    # Floats that hold whole numbers go back to ints, as the JSON levels wrote them
+    return int(value) if value.is_integer() else value
+
+
+class TileLayout:
+    # The tile type ids of one layer, row-major in one flat uint16 array that TileMap.load_layout reads in place.
+    # Indexed layout[row][column] like the nested lists of the JSON levels, so the level editor changes it the same way.
+    def __init__(self, cells, columns):
+        self.cells = cells
+        self.columns = columns
+        view = memoryview(cells)
+        self.rows = [view[start:start + columns] for start in range(0, len(cells), columns)] if columns > 0 else []
+
+    @classmethod
+    def from_bytes(cls, data, columns):
+        # data holds little-endian ids, as level files store them
+        cells = array.array("H")
+        cells.frombytes(data)
+        if(sys.byteorder == "big"):
+            cells.byteswap()
+        return cls(cells, columns)
+
+    @classmethod
+    def from_rows(cls, rows):
+        return cls(array.array("H", [id for row in rows for id in row]), len(rows[0]) if len(rows) > 0 else 0)
+
+    def to_bytes(self):
+        if(sys.byteorder == "big"):
+            cells = array.array("H", self.cells)
+            cells.byteswap()
+            return cells.tobytes()
+        return self.cells.tobytes()
+
+    def tolist(self):
+        return [row.tolist() for row in self.rows]
+
+    def __len__(self):
+        return len(self.rows)
+
+    def __getitem__(self, row):
+        return self.rows[row]
+
+    def __iter__(self):
+        return iter(self.rows)
+
+    def __deepcopy__(self, memo):
+        return TileLayout(array.array("H", self.cells), self.columns)
+
+
+def layout_buffer(layout):
+    # What to hand TileMap.load_layout: the flat array of a TileLayout, nested lists as they are
+    return layout.cells if isinstance(layout, TileLayout) else layout
+
+
+def layout_tile_ids(layout):
+    # The distinct tile type ids of a layout, a TileLayout is read as one flat array
+    return set(layout.cells) if isinstance(layout, TileLayout) else {id for row in layout for id in row}
+
+
+class _StringTable:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, string):
+        if(string not in self.offsets):
+            self.offsets[string] = len(self.data)
+            self.data += string.encode("utf-8") + b"\0"
+        return self.offsets[string]
+
+
+def write_level_file(filepath, level_name, level_config_dict, journal_sequence=0):
+    # journal_sequence is the last edit journal record folded into the level, see level_journal.py
+    strings = _StringTable()
+    rows = len(level_config_dict["map_layout"])
+    columns = len(level_config_dict["map_layout"][0]) if rows > 0 else 0
+
+    # The terrain is layer 0, always collidable, then the optional extra layers in order
+    layers = [(strings.add("terrain"), LAYER_COLLIDABLE, 1.0, 1.0, level_config_dict["map_layout"])]
+    for layer_config in level_config_dict.get("layers", []):
+        parallax = layer_config.get("parallax", [1.0, 1.0])
+        flags = (LAYER_COLLIDABLE if layer_config.get("collidable", False) else 0) | \
+                (LAYER_FOREGROUND if layer_config.get("foreground", False) else 0)
+        layers.append((strings.add(layer_config["name"]), flags, parallax[0], parallax[1], layer_config["map_layout"]))
+
+    spawns = []
+    player = level_config_dict["player_position"]
+    spawns.append((strings.add("player"), strings.add(""), 0,
+                   [player["transform"][k] for k in ("initial_x", "initial_y", "width", "height")],
+                   [player["collider"][k] for k in ("initial_x", "initial_y", "width", "height")]))
+    for enemy in level_config_dict["enemies"]:
+        spawns.append((strings.add("enemy"), strings.add(enemy["type"]), int(enemy["no."]),
+                       [enemy["transform"][k] for k in ("initial_x", "initial_y", "width", "height")],
+                       [enemy["collider"][k] for k in ("initial_x", "initial_y", "width", "height")]))
+    destination = level_config_dict["destination_position"]
+    spawns.append((strings.add("destination"), strings.add(""), 0,
+                   [destination["transform"][k] for k in ("x", "y", "width", "height")],
+                   [destination["collider"][k] for k in ("x", "y", "width", "height")]))
+    name_offset = strings.add(level_name)
+
+    layers_offset = HEADER.size
+    spawns_offset = layers_offset + LAYER.size * len(layers)
+    cells_offset = _align(spawns_offset + SPAWN.size * len(spawns))
+    cell_bytes = rows * columns * 2
+    strings_offset = cells_offset + _align(cell_bytes) * len(layers)
+
+    out = bytearray(strings_offset + len(strings.data))
+    HEADER.pack_into(out, 0, LEVEL_MAGIC, LEVEL_VERSION, rows, columns, len(layers), len(spawns), LAYER.size, SPAWN.size,
+                     name_offset, journal_sequence, layers_offset, spawns_offset, strings_offset, len(strings.data))
+    for i, (layer_name, flags, parallax_x, parallax_y, layout) in enumerate(layers):
+        if(len(layout) != rows or any(len(row) != columns for row in layout)):
+            raise ValueError("every layer of a level must be {} x {} tiles".format(rows, columns))
+        offset = cells_offset + _align(cell_bytes) * i
+        LAYER.pack_into(out, layers_offset + LAYER.size * i, layer_name, flags, parallax_x, parallax_y, offset)
+        if(not isinstance(layout, TileLayout)):
+            layout = TileLayout.from_rows(layout)
+        out[offset:offset + cell_bytes] = layout.to_bytes()
+    for i, (kind, type, number, transform, collider) in enumerate(spawns):
+        SPAWN.pack_into(out, spawns_offset + SPAWN.size * i, kind, type, number, *transform, *collider, 0)
+    out[strings_offset:] = strings.data
+
+    # Written next to the old file then renamed over it, a crash never leaves half a level behind
+    temp_path = filepath + ".tmp"
+    with open(temp_path, "wb") as file:
+        file.write(out)
+        file.flush()
+        os.fsync(file.fileno())
+    os.replace(temp_path, filepath)
+    return len(out)
+
+
+def level_config_from_records(layers, spawns):
+    # layers: (name, parallax_x, parallax_y, collidable, foreground, map_layout) with the terrain first
+    # spawns: (kind, type, number, (x, y, w, h), (collider x, y, w, h)), as LevelFile.get_spawns returns them
+    level_config = {"map_layout": layers[0][5], "enemies": []}
+    for kind, type, number, transform, collider in spawns:
+        transform = [_number(v) for v in transform]
+        collider = [_number(v) for v in collider]
+        if(kind == "player"):
+            level_config["player_position"] = {
+                "transform": dict(zip(("initial_x", "initial_y", "width", "height"), transform)),
+                "collider": dict(zip(("initial_x", "initial_y", "width", "height"), collider))}
+        elif(kind == "enemy"):
+            level_config["enemies"].append({
+                "no.": number, "type": type,
+                "transform": dict(zip(("initial_x", "initial_y", "width", "height"), transform)),
+                "collider": dict(zip(("initial_x", "initial_y", "width", "height"), collider))})
+        elif(kind == "destination"):
+            level_config["destination_position"] = {
+                "transform": dict(zip(("x", "y", "width", "height"), transform)),
+                "collider": dict(zip(("x", "y", "width", "height"), collider))}
+    if(len(layers) > 1):
+        level_config["layers"] = [{"name": name, "parallax": [parallax_x, parallax_y], "collidable": collidable,
+                                   "foreground": foreground, "map_layout": layout}
+                                  for name, parallax_x, parallax_y, collidable, foreground, layout in layers[1:]]
+    return level_config
+
+
+def level_config_from_level_file(level_file):
+    # Same dict as a JSON level, from an open mygameengine.LevelFile; the layouts are copied into TileLayouts
+    # the editor can change, one flat copy per layer rather than a python int per cell
+    columns = level_file.get_column_count()
+    layers = [level_file.get_layer(i) + (TileLayout.from_bytes(level_file.get_layer_cells(i).cast("B"), columns),)
+              for i in range(level_file.get_layer_count())]
+    return level_config_from_records(layers, level_file.get_spawns())
+
+
+def editable_level_config(level_config_dict):
+    # A copy of a JSON level the level editor can change without touching the cached config.json:
+    # the layouts become TileLayouts and the positions and enemies are copied, the rest is shared
+    def position(position_dict):
+        return {part: dict(values) for part, values in position_dict.items()}
+    level_config = dict(level_config_dict)
+    level_config["map_layout"] = TileLayout.from_rows(level_config_dict["map_layout"])
+    level_config["player_position"] = position(level_config_dict["player_position"])
+    level_config["destination_position"] = position(level_config_dict["destination_position"])
+    level_config["enemies"] = [{**enemy, "transform": dict(enemy["transform"]), "collider": dict(enemy["collider"])}
+                               for enemy in level_config_dict["enemies"]]
+    if("layers" in level_config_dict):
+        level_config["layers"] = [{**layer, "map_layout": TileLayout.from_rows(layer["map_layout"])} for layer in level_config_dict["layers"]]
+    return level_config
+
+
+def read_level_file(filepath):
+    # Pure python reader, for the tools that run without the engine: (level name, level config dict)
+    with open(filepath, "rb") as file, mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ) as data:
+        (magic, version, rows, columns, layer_count, spawn_count, layer_size, spawn_size, name_offset, _,
+         layers_offset, spawns_offset, strings_offset, strings_size) = HEADER.unpack_from(data, 0)
+        if(magic != LEVEL_MAGIC or version != LEVEL_VERSION):
+            raise ValueError("{} is not a version {} level file".format(filepath, LEVEL_VERSION))
+
+        def string(offset):
+            start = strings_offset + offset
+            return data[start:data.find(b"\0", start, strings_offset + strings_size)].decode("utf-8")
+
+        layers = []
+        for i in range(layer_count):
+            layer_name, flags, parallax_x, parallax_y, cells_offset = LAYER.unpack_from(data, layers_offset + layer_size * i)
+            layout = TileLayout.from_bytes(data[cells_offset:cells_offset + rows * columns * 2], columns)
+            layers.append((string(layer_name), parallax_x, parallax_y, bool(flags & LAYER_COLLIDABLE),
+                           bool(flags & LAYER_FOREGROUND), layout))
+        spawns = []
+        for i in range(spawn_count):
+            fields = SPAWN.unpack_from(data, spawns_offset + spawn_size * i)
+            spawns.append((string(fields[0]), string(fields[1]), fields[2], fields[3:7], fields[7:11]))
+        return string(name_offset), level_config_from_records(layers, spawns)
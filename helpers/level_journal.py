@@ -0,0 +1,117 @@
+import os
+import mygameengine
+from level_format import level_file_path, write_level_file
+
+# Edits made in the level editor are appended to a journal next to the level file instead of rewriting the level.
+# Saving appends a COMMIT record, leaving the editor without saving a DISCARD record.
+# The committed edits are folded into the level file once the journal holds COMPACT_RECORD_COUNT records,
+# and when a level is built, which also recovers the edits saved before a crash.
+
+COMPACT_RECORD_COUNT = 256
+
+EditOp = mygameengine.EditOp
+
+
+def journal_path(global_config_dict, level):
+    return os.path.join(global_config_dict["level_directory"], "level_{}.journal".format(level))
+
+
+def open_level_journal(global_config_dict, level, level_file=None):
+    # New records are numbered after the ones already folded into the level file, even if the journal was deleted
+    journal = mygameengine.EditJournal()
+    folded = level_file.get_journal_sequence() if level_file is not None else 0
+    if(not journal.open(journal_path(global_config_dict, level), folded)):
+        return None
+    return journal
+
+
+def record_edit(journal, op, **fields):
+    if(journal is not None):
+        journal.append(mygameengine.EditRecord(op, **fields))
+
+
+def _layout(level_config_dict, layer):
+    return level_config_dict["map_layout"] if layer == 0 else level_config_dict["layers"][layer - 1]["map_layout"]
+
+
+def apply_edit(level_config_dict, record):
+    if(record.op == EditOp.PLACE_TILE):
+        _layout(level_config_dict, record.layer)[record.row][record.column] = record.value
+    elif(record.op == EditOp.ERASE_TILE):
+        _layout(level_config_dict, record.layer)[record.row][record.column] = 0
+    elif(record.op == EditOp.MOVE_PLAYER):
+        keys = ("initial_x", "initial_y", "width", "height")
+        level_config_dict["player_position"]["transform"].update(zip(keys, record.transform))
+        level_config_dict["player_position"]["collider"].update(zip(keys, record.collider))
+    elif(record.op == EditOp.MOVE_DESTINATION):
+        keys = ("x", "y", "width", "height")
+        level_config_dict["destination_position"]["transform"].update(zip(keys, record.transform))
+        level_config_dict["destination_position"]["collider"].update(zip(keys, record.collider))
+    elif(record.op == EditOp.ADD_ENEMY):
+        keys = ("initial_x", "initial_y", "width", "height")
+        level_config_dict["enemies"].append({"no.": record.value, "type": record.type,
+                                             "transform": dict(zip(keys, record.transform)),
+                                             "collider": dict(zip(keys, record.collider))})
+    elif(record.op == EditOp.REMOVE_ENEMY):
+        level_config_dict["enemies"] = [enemy for enemy in level_config_dict["enemies"] if enemy["no."] != record.value]
+
+
+def replay_journal(level_config_dict, records, after_sequence):
+    # Only the edits followed by a COMMIT count; the ones before a DISCARD, or at the end of a crashed session, do not.
+    # Returns the sequence number of the last COMMIT applied.
+    committed = after_sequence
+    pending = []
+    for record in records:
+        if(record.sequence <= after_sequence):
+            continue
+        if(record.op == EditOp.COMMIT):
+            for edit in pending:
+                apply_edit(level_config_dict, edit)
+            pending = []
+            committed = record.sequence
+        elif(record.op == EditOp.DISCARD):
+            pending = []
+        else:
+            pending.append(record)
+    return committed
+
+
+def compact_level(global_config_dict, level, level_config_dict, journal, sequence):
+    # The level file is replaced first, then the journal forgets the folded records;
+    # a crash in between replays nothing twice, the level file knows which records it holds
+    write_level_file(level_file_path(global_config_dict, level), "level {}".format(level), level_config_dict, sequence)
+    journal.drop_through(sequence)
+
+
+def save_level_edits(global_config_dict, level, level_config_dict, journal):
+    if(journal is None):
+        return
+    sequence = journal.append(mygameengine.EditRecord(EditOp.COMMIT))
+    if(journal.get_record_count() >= COMPACT_RECORD_COUNT):
+        compact_level(global_config_dict, level, level_config_dict, journal, sequence)
+
+
+def discard_level_edits(journal):
+    if(journal is None):
+        return
+    journal.append(mygameengine.EditRecord(EditOp.DISCARD))
+
+
+def recover_level_edits(global_config_dict, level, level_file, level_config_dict):
+    # Folds the saved edits still in the journal into the level, e.g. after a crash; returns True if there were any
+    if(not os.path.exists(journal_path(global_config_dict, level))):
+        return False
+    journal = open_level_journal(global_config_dict, level, level_file)
+    if(journal is None):
+        return False
+    if(journal.get_record_count() == 0):
+        journal.close()
+        return False
+    folded = level_file.get_journal_sequence() if level_file is not None else 0
+    committed = replay_journal(level_config_dict, journal.get_records(), folded)
+    if(committed > folded):
+        write_level_file(level_file_path(global_config_dict, level), "level {}".format(level), level_config_dict, committed)
+    # What is left is folded now, or edits that were never saved
+    journal.drop_through(journal.get_last_sequence())
+    journal.close()
+    return committed > folded
@@ -0,0 +1,31 @@
+import copy
+import mygameengine
+
+# The state of a running level at one moment, restored without reading the level or loading anything again.
+# The engine keeps the tile cells and the state of the entities in one buffer, reused by every capture;
+# the list of objects is kept as it is, so the objects removed since come back as they were.
+
+
+class LevelSnapshot:
+    def __init__(self):
+        self.snapshot = mygameengine.LevelSnapshot()
+        self.objects = []
+        self.level_config = None
+
+    def capture(self, tilemap, objects, level_config_dict=None):
+        # The level config is only kept when given, copying it is too slow to do every frame
+        self.objects = list(objects)
+        self.level_config = copy.deepcopy(level_config_dict) if level_config_dict is not None else None
+        self.snapshot.capture(tilemap, [o.game_entity for o in self.objects], [o.get_snapshot_values() for o in self.objects])
+
+    def restore(self, tilemap, objects, level_config_dict=None):
+        # objects and level_config_dict are changed in place; returns False if the snapshot does not fit the level
+        if(self.snapshot.is_empty() or not self.snapshot.restore(tilemap, [o.game_entity for o in self.objects])):
+            return False
+        for i, obj in enumerate(self.objects):
+            obj.set_snapshot_values(self.snapshot.get_values(i))
+        objects[:] = self.objects
+        if(level_config_dict is not None and self.level_config is not None):
+            level_config_dict.clear()
+            level_config_dict.update(copy.deepcopy(self.level_config))
+        return True
@@ -1,162 +1,275 @@
-import mygameengine
-from config_manager import read_config
-from objects import Object, Player, Enemy
-
-def build_level_tilemap(game, global_config_dict, level_config_dict):
-    tilemap = mygameengine.TileMap(global_config_dict["window_width"], global_config_dict["window_height"],
-                                global_config_dict["num_tile_row"], global_config_dict["num_tile_column"])
-
-    for i in range(1, len(global_config_dict["tile_types"])):
-        tilemap.add_tile_type(global_config_dict["tile_types"][i]["tile_name"], 
-                            global_config_dict["tile_types"][i]["filepath"], 
-                            global_config_dict["tile_types"][i]["collidable"])
-    
-    layout = level_config_dict["map_layout"]
-    for i in range(global_config_dict["num_tile_row"]):
-        for j in range(global_config_dict["num_tile_column"]):
-            tile_type_index = layout[i][j]
-            if(tile_type_index != 0):
-                tile_name = global_config_dict["tile_types"][tile_type_index]["tile_name"]
-                tilemap.place_tile_at(tile_name, i, j)
-    
-    tilemap.load_to_game(game)
-    return tilemap
-
-
-def load_animations(game, combatant, animations_dict):
-    for key, value in animations_dict.items():
-        animation = mygameengine.Animation()
-        animation.create_animation(game, value["filepath"])
-        animation.set_frame_config(x=value["first_x"], y=value["first_y"], 
-                                   w=value["frame_width"], h=value["frame_height"],
-                                   w_offset=value["frame_offset_x"],
-                                   maxFrame=value["max_frame"], 
-                                   millisecond_duration=value["millisecond_duration"],
-                                   repeat=value["repeat"])
-        combatant.game_entity.add_animation(key, animation)
-
-
-def build_player(game, player_config_dict, level_config_dict):
-    player = Player(level_config_dict["player_position"]["transform"]["initial_x"], 
-                    level_config_dict["player_position"]["transform"]["initial_y"],
-                    level_config_dict["player_position"]["transform"]["width"],
-                    level_config_dict["player_position"]["transform"]["height"],
-                    player_config_dict["max_health"])
-
-    player.add_collision2D(level_config_dict["player_position"]["collider"]["initial_x"],
-                            level_config_dict["player_position"]["collider"]["initial_y"],
-                            level_config_dict["player_position"]["collider"]["width"],
-                            level_config_dict["player_position"]["collider"]["height"])
-    
-    load_animations(game, player, player_config_dict["animations"])
-    return player
-
-
-def build_enemy(game, enemy_config_dict, enemy_position_config_dict):
-    enemy = Enemy(enemy_position_config_dict["transform"]["initial_x"], 
-                    enemy_position_config_dict["transform"]["initial_y"],
-                    enemy_position_config_dict["transform"]["width"],
-                    enemy_position_config_dict["transform"]["height"],
-                    enemy_config_dict["max_health"])
-    enemy.add_collision2D(enemy_position_config_dict["collider"]["initial_x"],
-                            enemy_position_config_dict["collider"]["initial_y"],
-                            enemy_position_config_dict["collider"]["width"],
-                            enemy_position_config_dict["collider"]["height"])
-    
-    enemy.set_enemy_no(str(enemy_position_config_dict["no."]))
-    load_animations(game, enemy, enemy_config_dict["animations"])
-    
-    return enemy
-
-
-def build_enemies(game, enemies_config_dict, level_config_dict):
-    enemies = []
-    for enemy_position_config_dict in level_config_dict["enemies"]:
-        type = enemy_position_config_dict["type"]
-        enemy_config_dict = enemies_config_dict[type]
-        e = build_enemy(game, enemy_config_dict, enemy_position_config_dict)
-        enemies.append(e)
-    return enemies
-
-
-def build_destination(game, destination_config_dict, level_config_dict):
-    destination = Object(level_config_dict["destination_position"]["transform"]["x"], 
-                                level_config_dict["destination_position"]["transform"]["y"],
-                                level_config_dict["destination_position"]["transform"]["width"],
-                                level_config_dict["destination_position"]["transform"]["height"])
-
-    destination.add_collision2D(level_config_dict["destination_position"]["collider"]["x"],
-                                    level_config_dict["destination_position"]["collider"]["y"],
-                                    level_config_dict["destination_position"]["collider"]["width"],
-                                    level_config_dict["destination_position"]["collider"]["height"])
-
-    destination.game_entity.set_name("destination")
-    destination.game_entity.add_texture(game, destination_config_dict["filepath"])
-
-    return destination
-
-
-def build_level_objects(game, global_config_dict, level_config_dict):
-    objects = []
-
-    player = build_player(game, global_config_dict["player_config"], level_config_dict)
-    enemies = build_enemies(game, global_config_dict["enemies_config"], level_config_dict)
-    destination = build_destination(game, global_config_dict["destination_config"], level_config_dict)
-
-    objects.append(destination)
-    objects.extend(enemies)
-    objects.append(player)
-
-    return objects
-
-
-def build_level(game, global_config_dict, curr_level):
-    level_config = read_config("levels", "level {}".format(curr_level))
-    tilemap = build_level_tilemap(game, global_config_dict, level_config)
-    objects = build_level_objects(game, global_config_dict, level_config)
-
-    return level_config, tilemap, objects
-    
-
-def build_prompt(game, global_config_dict, type):
-    prompt = Object(global_config_dict["prompts"][type]["transform"]["x"],
-                    global_config_dict["prompts"][type]["transform"]["y"],
-                    global_config_dict["prompts"][type]["transform"]["width"],
-                    global_config_dict["prompts"][type]["transform"]["height"])
-    prompt.game_entity.add_texture(game, global_config_dict["prompts"][type]["filepath"])
-
-    return prompt
-
-
-def build_editor_mouse_image(game, tilemap, global_config_dict, level_config_dict, mouse_x, mouse_y, type=1):
-    if(type==2):
-        width = tilemap.get_tile_width()
-        height = tilemap.get_tile_height()
-        filepath = global_config_dict["tile_types"][2]["filepath"]
-    elif(type==3):
-        width = level_config_dict["player_position"]["transform"]["width"]
-        height = level_config_dict["player_position"]["transform"]["height"]
-        filepath = global_config_dict["player_config"]["filepath"]
-    elif(type==4):
-        width = level_config_dict["enemies"][0]["transform"]["width"] if len(level_config_dict["enemies"]) > 0 else global_config_dict["enemies_config"]["hyena"]["default_width"]
-        height = level_config_dict["enemies"][0]["transform"]["height"] if len(level_config_dict["enemies"]) > 0 else global_config_dict["enemies_config"]["hyena"]["default_height"]
-        filepath = global_config_dict["enemies_config"]["hyena"]["filepath"]
-    elif(type==5):
-        width = level_config_dict["destination_position"]["transform"]["width"]
-        height = level_config_dict["destination_position"]["transform"]["height"]
-        filepath = global_config_dict["destination_config"]["filepath"]
-    elif(type=="e"):
-        width = global_config_dict["editor_eraser"]["transform"]["width"]
-        height = global_config_dict["editor_eraser"]["transform"]["height"]
-        filepath = global_config_dict["editor_eraser"]["filepath"]
-    else:
-        # Default to tile type 1
-        width = tilemap.get_tile_width()
-        height = tilemap.get_tile_height()
-        filepath = global_config_dict["tile_types"][1]["filepath"]
-
-    editor_mouse_image = Object(mouse_x - width/2, mouse_y - height/2, width, height)
-    editor_mouse_image.game_entity.add_texture(game, filepath)
-
-    return editor_mouse_image
-
+import os
+import mygameengine
+from config_manager import read_config
+from level_format import level_file_path, level_config_from_level_file, editable_level_config, layout_buffer, layout_tile_ids
+from level_journal import recover_level_edits
+from objects import Object, Player, Enemy
+
+def open_level_file(global_config_dict, level):
+    # The converted level is mapped, not parsed; without it the level is read from config.json
+    path = level_file_path(global_config_dict, level)
+    if(not os.path.exists(path)):
+        return None
+    level_file = mygameengine.LevelFile()
+    if(not level_file.open(path)):
+        return None
+    return level_file
+
+
+def read_level_config(global_config_dict, level, level_file=None):
+    if(level_file is None):
+        level_file = open_level_file(global_config_dict, level)
+    if(level_file is None):
+        return editable_level_config(read_config("levels", "level {}".format(level)))
+    return level_config_from_level_file(level_file)
+
+
+def build_level_tilemap(game, global_config_dict, level_config_dict, level_file=None):
+    tilemap = mygameengine.TileMap(global_config_dict["window_width"], global_config_dict["window_height"],
+                                global_config_dict["num_tile_row"], global_config_dict["num_tile_column"])
+
+    for i in range(1, len(global_config_dict["tile_types"])):
+        # An optional [x, y, w, h] "src_rect" picks the tile out of a tileset image
+        src_rect = global_config_dict["tile_types"][i].get("src_rect", [0, 0, 0, 0])
+        # Animated tiles list their [x, y, w, h] "frames" and a "frame_duration" in milliseconds
+        frames = [tuple(frame) for frame in global_config_dict["tile_types"][i].get("frames", [])]
+        tilemap.add_tile_type(global_config_dict["tile_types"][i]["tile_name"], 
+                            global_config_dict["tile_types"][i]["filepath"], 
+                            global_config_dict["tile_types"][i]["collidable"],
+                            *src_rect, frames, global_config_dict["tile_types"][i].get("frame_duration", 0))
+    
+    # The tile types were added in config order, so the ids of the layout are the tile type ids
+    if(level_file is not None):
+        # Every layer straight from the mapped file
+        tilemap.load_level_file(game, level_file)
+        return tilemap
+    tilemap.load_layout(game, layout_buffer(level_config_dict["map_layout"]))
+
+    # Optional extra layers over the terrain, e.g. decoration behind the entities or overlays in front of them
+    for layer_config in level_config_dict.get("layers", []):
+        parallax = layer_config.get("parallax", [1.0, 1.0])
+        layer = tilemap.add_layer(layer_config["name"], parallax[0], parallax[1],
+                                  layer_config.get("collidable", False), layer_config.get("foreground", False))
+        tilemap.load_layout(game, layout_buffer(layer_config["map_layout"]), layer)
+    return tilemap
+
+
+def load_animations(game, combatant, animations_dict):
+    for key, value in animations_dict.items():
+        animation = mygameengine.Animation()
+        animation.create_animation(game, value["filepath"])
+        animation.set_frame_config(x=value["first_x"], y=value["first_y"], 
+                                   w=value["frame_width"], h=value["frame_height"],
+                                   w_offset=value["frame_offset_x"],
+                                   maxFrame=value["max_frame"], 
+                                   millisecond_duration=value["millisecond_duration"],
+                                   repeat=value["repeat"])
+        combatant.game_entity.add_animation(key, animation)
+
+
+def build_player(game, player_config_dict, level_config_dict):
+    player = Player(level_config_dict["player_position"]["transform"]["initial_x"], 
+                    level_config_dict["player_position"]["transform"]["initial_y"],
+                    level_config_dict["player_position"]["transform"]["width"],
+                    level_config_dict["player_position"]["transform"]["height"],
+                    player_config_dict["max_health"])
+
+    player.add_collision2D(level_config_dict["player_position"]["collider"]["initial_x"],
+                            level_config_dict["player_position"]["collider"]["initial_y"],
+                            level_config_dict["player_position"]["collider"]["width"],
+                            level_config_dict["player_position"]["collider"]["height"])
+    
+    load_animations(game, player, player_config_dict["animations"])
+    if("fit_collider_to_animation" in player_config_dict):
+        player.fit_collider_to_animation(player_config_dict["fit_collider_to_animation"])
+    return player
+
+
+def build_enemy(game, enemy_config_dict, enemy_position_config_dict):
+    enemy = Enemy(enemy_position_config_dict["transform"]["initial_x"], 
+                    enemy_position_config_dict["transform"]["initial_y"],
+                    enemy_position_config_dict["transform"]["width"],
+                    enemy_position_config_dict["transform"]["height"],
+                    enemy_config_dict["max_health"])
+    enemy.add_collision2D(enemy_position_config_dict["collider"]["initial_x"],
+                            enemy_position_config_dict["collider"]["initial_y"],
+                            enemy_position_config_dict["collider"]["width"],
+                            enemy_position_config_dict["collider"]["height"])
+    
+    enemy.set_enemy_no(str(enemy_position_config_dict["no."]))
+    load_animations(game, enemy, enemy_config_dict["animations"])
+    if("fit_collider_to_animation" in enemy_config_dict):
+        enemy.fit_collider_to_animation(enemy_config_dict["fit_collider_to_animation"])
+    
+    return enemy
+
+
+def build_enemies(game, enemies_config_dict, level_config_dict):
+    enemies = []
+    for enemy_position_config_dict in level_config_dict["enemies"]:
+        type = enemy_position_config_dict["type"]
+        enemy_config_dict = enemies_config_dict[type]
+        e = build_enemy(game, enemy_config_dict, enemy_position_config_dict)
+        enemies.append(e)
+    return enemies
+
+
+def build_destination(game, destination_config_dict, level_config_dict):
+    destination = Object(level_config_dict["destination_position"]["transform"]["x"], 
+                                level_config_dict["destination_position"]["transform"]["y"],
+                                level_config_dict["destination_position"]["transform"]["width"],
+                                level_config_dict["destination_position"]["transform"]["height"])
+
+    destination.add_collision2D(level_config_dict["destination_position"]["collider"]["x"],
+                                    level_config_dict["destination_position"]["collider"]["y"],
+                                    level_config_dict["destination_position"]["collider"]["width"],
+                                    level_config_dict["destination_position"]["collider"]["height"])
+
+    destination.game_entity.set_name("destination")
+    # The destination is walked into, never against
+    destination.game_entity.get_collision2D().set_trigger(True)
+    destination.game_entity.add_texture(game, destination_config_dict["filepath"])
+
+    return destination
+
+
+def build_level_objects(game, global_config_dict, level_config_dict):
+    objects = []
+
+    player = build_player(game, global_config_dict["player_config"], level_config_dict)
+    enemies = build_enemies(game, global_config_dict["enemies_config"], level_config_dict)
+    destination = build_destination(game, global_config_dict["destination_config"], level_config_dict)
+
+    objects.append(destination)
+    objects.extend(enemies)
+    objects.append(player)
+
+    return objects
+
+
+def build_collision_world(objects, tilemap=None):
+    world = mygameengine.CollisionWorld()
+    world.set_tilemap(tilemap)
+    # Enemies stop a pixel away from the player, and still touch it
+    world.set_contact_margin(0.5)
+    for obj in objects:
+        world.add_entity(obj.game_entity)
+        # The new world reports the contacts again from its first step
+        if(isinstance(obj, Enemy)):
+            obj.touching_player = False
+    return world
+
+
+def build_level_steps(game, global_config_dict, curr_level, prefetch=False):
+    # Builds a level one part at a time, yielding None between the parts and the level at the end.
+    # With prefetch the textures are decoded at low priority first, so the level can be built while another one plays.
+    resources = mygameengine.ResourceManager.instance()
+    level_file = open_level_file(global_config_dict, curr_level)
+    level_config = read_level_config(global_config_dict, curr_level, level_file)
+    if(recover_level_edits(global_config_dict, curr_level, level_file, level_config)):
+        # The saved edits were folded into a new level file
+        level_file = open_level_file(global_config_dict, curr_level)
+    if(prefetch):
+        yield None
+        resources.prefetch_level(curr_level, level_asset_paths(global_config_dict, level_config))
+    yield None
+
+    # Every texture requested while building is pinned to the level until it is released
+    resources.begin_level_scope(curr_level)
+    tilemap = build_level_tilemap(game, global_config_dict, level_config, level_file)
+    resources.end_level_scope()
+    yield None
+
+    resources.begin_level_scope(curr_level)
+    objects = build_level_objects(game, global_config_dict, level_config)
+    resources.end_level_scope()
+    yield level_config, tilemap, objects
+
+
+def build_level(game, global_config_dict, curr_level):
+    for level in build_level_steps(game, global_config_dict, curr_level):
+        pass
+    return level
+
+
+def level_asset_paths(global_config_dict, level_config_dict):
+    paths = set()
+    for tile_type_index in layout_tile_ids(level_config_dict["map_layout"]):
+        if(tile_type_index != 0):
+            paths.add(global_config_dict["tile_types"][tile_type_index]["filepath"])
+
+    for animation in global_config_dict["player_config"]["animations"].values():
+        paths.add(animation["filepath"])
+    for enemy_position_config_dict in level_config_dict["enemies"]:
+        for animation in global_config_dict["enemies_config"][enemy_position_config_dict["type"]]["animations"].values():
+            paths.add(animation["filepath"])
+    paths.add(global_config_dict["destination_config"]["filepath"])
+
+    return sorted(paths)
+
+
+class LevelPrefetch:
+    # Builds the next level while the current one plays, one part per frame so that no frame pays for the whole build
+    def __init__(self, game, global_config_dict, level):
+        self.level = level
+        self.steps = build_level_steps(game, global_config_dict, level, prefetch=True)
+        self.built = None
+
+    def step(self):
+        # Called once per frame, returns True once the level is built
+        if(self.built is None):
+            self.built = next(self.steps)
+        return self.built is not None
+
+    def finish(self):
+        # The level is entered: builds what is left, and its textures still waiting to decode go before other work
+        while(not self.step()):
+            pass
+        resources = mygameengine.ResourceManager.instance()
+        if(not resources.is_level_resident(self.level)):
+            resources.promote_level(self.level)
+        return self.built
+
+
+def build_prompt(game, global_config_dict, type):
+    prompt = Object(global_config_dict["prompts"][type]["transform"]["x"],
+                    global_config_dict["prompts"][type]["transform"]["y"],
+                    global_config_dict["prompts"][type]["transform"]["width"],
+                    global_config_dict["prompts"][type]["transform"]["height"])
+    prompt.game_entity.add_texture(game, global_config_dict["prompts"][type]["filepath"])
+
+    return prompt
+
+
+def build_editor_mouse_image(game, tilemap, global_config_dict, level_config_dict, mouse_x, mouse_y, type=1):
+    if(type==2):
+        width = tilemap.get_tile_width()
+        height = tilemap.get_tile_height()
+        filepath = global_config_dict["tile_types"][2]["filepath"]
+    elif(type==3):
+        width = level_config_dict["player_position"]["transform"]["width"]
+        height = level_config_dict["player_position"]["transform"]["height"]
+        filepath = global_config_dict["player_config"]["filepath"]
+    elif(type==4):
+        width = level_config_dict["enemies"][0]["transform"]["width"] if len(level_config_dict["enemies"]) > 0 else global_config_dict["enemies_config"]["hyena"]["default_width"]
+        height = level_config_dict["enemies"][0]["transform"]["height"] if len(level_config_dict["enemies"]) > 0 else global_config_dict["enemies_config"]["hyena"]["default_height"]
+        filepath = global_config_dict["enemies_config"]["hyena"]["filepath"]
+    elif(type==5):
+        width = level_config_dict["destination_position"]["transform"]["width"]
+        height = level_config_dict["destination_position"]["transform"]["height"]
+        filepath = global_config_dict["destination_config"]["filepath"]
+    elif(type=="e"):
+        width = global_config_dict["editor_eraser"]["transform"]["width"]
+        height = global_config_dict["editor_eraser"]["transform"]["height"]
+        filepath = global_config_dict["editor_eraser"]["filepath"]
+    else:
+        # Default to tile type 1
+        width = tilemap.get_tile_width()
+        height = tilemap.get_tile_height()
+        filepath = global_config_dict["tile_types"][1]["filepath"]
+
+    editor_mouse_image = Object(mouse_x - width/2, mouse_y - height/2, width, height)
+    editor_mouse_image.game_entity.add_texture(game, filepath)
+
+    return editor_mouse_image
+
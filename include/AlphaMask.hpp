@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+
+/**
+ * A struct that records which pixels of an image are not fully transparent, one bit per pixel.
+ * Built once when a texture is decoded, so the opaque bounds of any part of the image can be found
+ * later without reading the texture back from the renderer.
+ * @see TextureHandle::GetAlphaMask
+ */
+struct AlphaMask
+{
+    /**
+     * Constructor for AlphaMask.
+     * The mask is empty until built.
+     * @see Build
+     */
+    AlphaMask();
+
+    /**
+     * Build the mask from ARGB8888 pixels. A pixel counts as opaque as soon as its alpha is not 0.
+     * @param pixels The first pixel of the image.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @param pitch The length of a row in bytes.
+     */
+    void Build(const Uint32 *pixels, int width, int height, int pitch);
+
+    /**
+     * Get the smallest rectangle holding every opaque pixel of a cell of the image.
+     * The cell is clipped to the image first.
+     * @param cell The cell to look into, in pixels of the image.
+     * @return The opaque bounds in pixels of the image, with a width and height of 0 if the cell is fully transparent.
+     */
+    SDL_Rect GetOpaqueBounds(const SDL_Rect &cell) const;
+
+    /**
+     * Get the width of the image.
+     * @return The width in pixels.
+     */
+    int GetWidth() const;
+
+    /**
+     * Get the height of the image.
+     * @return The height in pixels.
+     */
+    int GetHeight() const;
+
+    /**
+     * Get the memory used by the mask.
+     * @return The size of the mask in bytes.
+     */
+    size_t GetByteSize() const;
+
+private:
+    /**
+     * Find the first and last opaque pixel of a row between two columns.
+     * @param y The row.
+     * @param x0 The first column, included.
+     * @param x1 The last column, excluded.
+     * @param first Set to the first opaque column.
+     * @param last Set to the last opaque column.
+     * @return True if the row has an opaque pixel between the columns, false otherwise.
+     */
+    bool FindRowSpan(int y, int x0, int x1, int *first, int *last) const;
+
+    /**
+     * The width of the image in pixels.
+     */
+    int mWidth{0};
+    /**
+     * The height of the image in pixels.
+     */
+    int mHeight{0};
+    /**
+     * The number of words in a row of the mask.
+     */
+    int mWordsPerRow{0};
+    /**
+     * The bits of the mask, row by row, bit x % 64 of word x / 64 for column x.
+     */
+    std::vector<Uint64> mBits;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The header at the start of an asset archive.
+ * An archive is laid out as: header, pixel data of every asset, index entries, path strings.
+ * Every field is stored in the byte order of the machine that packed it.
+ * @see AssetArchive
+ */
+struct AssetArchiveHeader
+{
+    /**
+     * Always ARCHIVE_MAGIC.
+     */
+    char magic[4];
+    /**
+     * The version of the format, ARCHIVE_VERSION.
+     */
+    Uint32 version;
+    /**
+     * The number of assets in the archive.
+     */
+    Uint32 entryCount;
+    /**
+     * The SDL pixel format of every asset.
+     */
+    Uint32 pixelFormat;
+    /**
+     * Where the index entries start, in bytes from the start of the file.
+     */
+    Uint64 indexOffset;
+    /**
+     * Where the path strings start, in bytes from the start of the file.
+     */
+    Uint64 stringsOffset;
+};
+
+/**
+ * An index entry of an asset archive, one per asset.
+ * @see AssetArchive
+ */
+struct AssetArchiveEntry
+{
+    /**
+     * Where the path of the asset starts, in bytes from the start of the path strings.
+     */
+    Uint32 pathOffset;
+    /**
+     * The length of the path, without terminator.
+     */
+    Uint32 pathLength;
+    /**
+     * The width of the asset in pixels.
+     */
+    Uint32 width;
+    /**
+     * The height of the asset in pixels.
+     */
+    Uint32 height;
+    /**
+     * The length of a row in bytes.
+     */
+    Uint32 pitch;
+    /**
+     * Unused, keeps dataOffset aligned.
+     */
+    Uint32 reserved;
+    /**
+     * Where the pixels start, in bytes from the start of the file. Aligned to ARCHIVE_ALIGNMENT.
+     */
+    Uint64 dataOffset;
+};
+
+/**
+ * A struct that represents a read-only asset archive made by the AssetPacker tool.
+ * The archive holds every asset already converted to the texture format and with the color key turned into alpha,
+ * the other pixels keeping the alpha of the source image.
+ * The file is memory mapped, so textures are created straight from the mapped pixels without decoding or copying.
+ * @see ResourceManager::MountArchive
+ */
+struct AssetArchive
+{
+    /**
+     * The magic bytes every archive starts with.
+     */
+    static constexpr char ARCHIVE_MAGIC[4] = {'S', 'D', 'E', 'A'};
+    /**
+     * The version of the format written by the packer.
+     * Version 1 archives made every pixel but the color key opaque, losing the alpha of the sprites, and are rejected.
+     */
+    static constexpr Uint32 ARCHIVE_VERSION = 2;
+    /**
+     * The alignment of the pixel data of each asset, so that rows can be read with wide loads.
+     */
+    static constexpr Uint64 ARCHIVE_ALIGNMENT = 64;
+
+    /**
+     * Constructor for AssetArchive.
+     */
+    AssetArchive();
+
+    /**
+     * Destructor for AssetArchive.
+     * The file is unmapped, pixels obtained from the archive become invalid.
+     */
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive &) = delete;
+    AssetArchive &operator=(const AssetArchive &) = delete;
+
+    /**
+     * Open an archive and read its index.
+     * @param filepath The path to the archive.
+     * @return True if the archive is valid, false otherwise.
+     */
+    bool Open(const std::string &filepath);
+
+    /**
+     * Close the archive.
+     */
+    void Close();
+
+    /**
+     * Check if an archive is open.
+     * @return True if an archive is open, false otherwise.
+     */
+    bool IsOpen() const;
+
+    /**
+     * Find an asset by path. The path is compared in its normal form, so "./assets/a.bmp" finds "assets/a.bmp".
+     * @param assetPath The path the asset was packed with.
+     * @return The entry of the asset, or nullptr if it is not in the archive.
+     */
+    const AssetArchiveEntry *Find(const std::string &assetPath) const;
+
+    /**
+     * Get an entry by index.
+     * @param index The index of the entry, between 0 and GetEntryCount.
+     * @return The entry.
+     */
+    const AssetArchiveEntry &GetEntry(int index) const;
+
+    /**
+     * Get the path an asset was packed with.
+     * @param entry The entry of the asset.
+     * @return The path, pointing into the mapped file.
+     */
+    std::string_view GetPath(const AssetArchiveEntry &entry) const;
+
+    /**
+     * Get the pixels of an asset.
+     * @param entry The entry of the asset.
+     * @return The first pixel, pointing into the mapped file.
+     */
+    const void *GetPixels(const AssetArchiveEntry &entry) const;
+
+    /**
+     * Create a texture from the pixels of an asset.
+     * Must be called from the thread owning the renderer.
+     * @param renderer The renderer to create the texture with.
+     * @param entry The entry of the asset.
+     * @param premultiply True to upload the pixels multiplied by their alpha, from a copy since the mapping is read-only.
+     * @return The texture, or nullptr on failure.
+     * @see PremultiplyAlpha
+     */
+    SDL_Texture *CreateTexture(SDL_Renderer *renderer, const AssetArchiveEntry &entry, bool premultiply = false) const;
+
+    /**
+     * Get the number of assets in the archive.
+     * @return The number of assets.
+     */
+    int GetEntryCount() const;
+
+    /**
+     * Get the SDL pixel format of the assets.
+     * @return The pixel format.
+     */
+    Uint32 GetPixelFormat() const;
+
+    /**
+     * Get the normal form of an asset path, the form used as key in the archive.
+     * @param assetPath The path.
+     * @return The path without "." components and with forward slashes.
+     */
+    static std::string NormalizePath(const std::string &assetPath);
+
+private:
+    /**
+     * Check the header and every entry against the size of the file.
+     * @return True if the archive is well formed, false otherwise.
+     */
+    bool Validate() const;
+
+    /**
+     * The mapped file, nullptr when closed.
+     */
+    const Uint8 *mData{nullptr};
+    /**
+     * The size of the mapped file in bytes.
+     */
+    size_t mSize{0};
+    /**
+     * The file contents when memory mapping is not available.
+     */
+    std::vector<Uint8> mBuffer;
+    /**
+     * The header, pointing into the mapped file.
+     */
+    const AssetArchiveHeader *mHeader{nullptr};
+    /**
+     * The index entries, pointing into the mapped file.
+     */
+    const AssetArchiveEntry *mEntries{nullptr};
+    /**
+     * The entries by path, the keys point into the mapped file.
+     */
+    std::unordered_map<std::string_view, const AssetArchiveEntry *> mIndex;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A struct that watches asset files for changes on a thread of its own, with inotify on Linux.
+ * The directories of the watched files are watched, so files replaced by a rename are seen too.
+ * Bursts of writes to the same file are coalesced: the callback only runs once the file has been quiet for the debounce delay.
+ * Nothing runs, and nothing is watched, until Start is called. Not supported on other platforms, where Start fails.
+ * @see ResourceManager::EnableHotReload
+ */
+struct AssetWatcher
+{
+    /**
+     * Called on the watcher thread with the path of a changed asset, as it was given to Watch.
+     */
+    using Callback = std::function<void(const std::string &filepath)>;
+
+    /**
+     * Constructor for AssetWatcher.
+     * The watcher does not run until started.
+     * @see Start
+     */
+    AssetWatcher();
+
+    /**
+     * Destructor for AssetWatcher.
+     * Stops the watcher thread.
+     */
+    ~AssetWatcher();
+
+    /**
+     * Start watching, on a new thread.
+     * @param onChanged Called once per changed asset after each burst of writes.
+     * @param debounceNS How long a file must go without writes before it counts as changed, in nanoseconds.
+     * @return True if the watcher is running, false if it is not supported or could not start.
+     */
+    bool Start(Callback onChanged, Uint64 debounceNS);
+
+    /**
+     * Stop watching and join the watcher thread. Forgets every watched file.
+     * Safe to call more than once.
+     */
+    void Stop();
+
+    /**
+     * Check if the watcher is running.
+     * @return True if running, false otherwise.
+     */
+    bool IsRunning() const;
+
+    /**
+     * Watch an asset file. Safe to call from any thread, and more than once for the same file.
+     * Does nothing while the watcher is not running.
+     * @param filepath The path of the asset.
+     */
+    void Watch(const std::string &filepath);
+
+private:
+    /**
+     * The loop of the watcher thread: reads the events and runs the callback for the files that went quiet.
+     */
+    void Run();
+
+    /**
+     * The inotify instance, -1 when not running.
+     */
+    int mInotify{-1};
+    /**
+     * The watcher thread.
+     */
+    std::thread mThread;
+    /**
+     * Set to stop the watcher thread, checked a few times per second.
+     */
+    std::atomic<bool> mStop{false};
+    /**
+     * Called for every changed asset.
+     */
+    Callback mOnChanged;
+    /**
+     * How long a file must go without writes before it counts as changed, in nanoseconds.
+     */
+    Uint64 mDebounceNS{0};
+    /**
+     * Guards the maps below, written by Watch and read by the watcher thread.
+     */
+    std::mutex mMutex;
+    /**
+     * The watched directories, by inotify watch descriptor.
+     */
+    std::unordered_map<int, std::string> mDirectories;
+    /**
+     * The paths given to Watch, by normalized path. Different spellings of the same path are kept apart.
+     */
+    std::unordered_map<std::string, std::vector<std::string>> mFiles;
+};
@@ -0,0 +1,473 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "GameEntity.hpp"
+#include "RaycastHit.hpp"
+#include "SDLGraphicsProgram.hpp"
+#include "ThreadPool.hpp"
+#include "TileMap.hpp"
+#include "TileRecord.hpp"
+
+/**
+ * A struct that represents a tile map split in square chunks streamed from disk, for worlds much larger than the screen.
+ * Each loaded chunk is a TileMap of its own, so the layers, the merged collision rectangles, the raycasts and the
+ * layer caches are the ones of TileMap; this struct only places the chunks in the world and streams them.
+ * Only the chunks within a radius of a focus point (usually the player) are kept in memory, so memory stays bounded
+ * whatever the size of the world. Chunks are read and written on a background thread, one file per chunk in a directory;
+ * a chunk without a file is empty. Edited chunks are written back when they are unloaded.
+ * Cells are addressed with world row and column numbers, which may be negative. Chunks that are not loaded count as empty.
+ * @see TileMap
+ */
+struct ChunkedTileMap
+{
+    /**
+     * Constructor for ChunkedTileMap.
+     * Nothing is loaded until the first Update.
+     * @param directory The directory holding the chunk files, created when the first chunk is written.
+     * @param tileWidth The width of a tile in pixels.
+     * @param tileHeight The height of a tile in pixels.
+     * @param chunkSize The number of rows and columns of a chunk.
+     * @param loadRadius The number of chunks kept loaded around the chunk of the focus point, in every direction.
+     */
+    ChunkedTileMap(std::string directory, int tileWidth, int tileHeight, int chunkSize = 64, int loadRadius = 2);
+
+    /**
+     * Destructor for ChunkedTileMap.
+     * Writes the edited chunks back and waits for every pending write.
+     */
+    ~ChunkedTileMap();
+
+    /**
+     * Add a tile type to every chunk, loaded or not.
+     * Tile types get ids in the order they are added, starting at 1; 0 stands for an empty cell.
+     * The chunk files store these ids, so the types must be added in the same order every time.
+     * @param tileName The name of the tile.
+     * @param filepath The path to the texture of the tile.
+     * @param collidable Whether the tile is collidable.
+     * @param srcRect The part of the texture to draw, the whole texture if its width is 0.
+     * @param frames The parts of the texture to cycle through for an animated tile, empty for a static one.
+     * @param frameDuration How long each frame is shown in milliseconds, the tile is static if 0.
+     * @see TileMap::AddTileType
+     */
+    void AddTileType(std::string tileName, std::string filepath, bool collidable, SDL_FRect srcRect = SDL_FRect{0.0f, 0.0f, 0.0f, 0.0f},
+                     std::vector<SDL_FRect> frames = {}, Uint32 frameDuration = 0);
+
+    /**
+     * Add a layer over the layers added before it, in every chunk. The terrain, layer 0, is collidable and exists from the start.
+     * Layers scroll with the terrain: a parallax background does not repeat across chunks and belongs in a TileMap of its own.
+     * The chunk files store every layer, so the layers must be added in the same order every time.
+     * @param name The name of the layer.
+     * @param collidable Whether the collidable tiles of the layer block entities.
+     * @param foreground Whether the layer is drawn over the entities.
+     * @return The index of the layer.
+     * @see TileMap::AddLayer
+     */
+    int AddLayer(std::string name, bool collidable = false, bool foreground = false);
+
+    /**
+     * Get the number of layers, terrain included.
+     * @return The number of layers.
+     */
+    int GetLayerCount() const;
+
+    /**
+     * Move the focus point, request the chunks around it and unload the ones that got too far.
+     * Chunks finished loading since the last call are added to the map. Call it once per frame.
+     * Chunks are only unloaded one chunk past the load radius, so walking along a chunk border does not reload them.
+     * @param focusX The x position of the focus point in pixels.
+     * @param focusY The y position of the focus point in pixels.
+     * @param deltaTime The time since the last frame in seconds, to advance the tile clock of the animated tiles.
+     */
+    void Update(float focusX, float focusY, float deltaTime = 0.0f);
+
+    /**
+     * Block until every requested chunk is loaded, then add them to the map. For loading screens.
+     */
+    void WaitForChunks();
+
+    /**
+     * Write every edited chunk still in memory to its file, on the calling thread.
+     * @return True if every chunk was written, false otherwise.
+     */
+    bool SaveAll();
+
+    /**
+     * Replace the content of a chunk on disk, and in memory if it is loaded. For level tools and generators.
+     * The file is written on the calling thread.
+     * @param chunkX The column of the chunk, in chunks.
+     * @param chunkY The row of the chunk, in chunks.
+     * @param ids The tile type id of each cell of every layer, row-major, one layer after the other:
+     *            GetLayerCount() * chunkSize * chunkSize of them.
+     * @return True if the chunk was written, false if an id is unknown or the file could not be written.
+     */
+    bool StoreChunk(int chunkX, int chunkY, const Uint16 *ids);
+
+    /**
+     * Place a tile in a loaded chunk. The chunk is written back to disk once unloaded.
+     * @param tileName The name of the tile to place.
+     * @param rowNum The world row number of the cell.
+     * @param columnNum The world column number of the cell.
+     * @param layer The index of the layer, the terrain by default.
+     * @return True if the tile was placed, false if the tile type or the layer is unknown or the chunk is not loaded.
+     */
+    bool PlaceTileAt(std::string tileName, int rowNum, int columnNum, int layer = 0);
+
+    /**
+     * Erase a tile in a loaded chunk.
+     * @param rowNum The world row number of the cell.
+     * @param columnNum The world column number of the cell.
+     * @param layer The index of the layer, the terrain by default.
+     * @return True if the cell was erased, false if the layer is unknown or the chunk is not loaded.
+     */
+    bool EraseTileAt(int rowNum, int columnNum, int layer = 0);
+
+    /**
+     * Get the tile type id of a cell.
+     * @param rowNum The world row number of the cell.
+     * @param columnNum The world column number of the cell.
+     * @param layer The index of the layer, the terrain by default.
+     * @return The tile type id, 0 for an empty cell, an unknown layer or a cell of a chunk that is not loaded.
+     */
+    Uint16 GetTileId(int rowNum, int columnNum, int layer = 0) const;
+
+    /**
+     * Check if a target entity collides with any collidable tile.
+     * @param target The target entity to check collision with.
+     * @return Whether the target collides with a tile.
+     */
+    bool HasCollisionWith(std::shared_ptr<GameEntity> target) const;
+
+    /**
+     * Check if any collidable tile overlaps a rectangle, asking each loaded chunk the rectangle covers.
+     * @param x The x position of the rectangle.
+     * @param y The y position of the rectangle.
+     * @param w The width of the rectangle.
+     * @param h The height of the rectangle.
+     * @return Whether a collidable tile overlaps the rectangle.
+     * @see TileMap::HasCollisionAt
+     */
+    bool HasCollisionAt(float x, float y, float w, float h) const;
+
+    /**
+     * Cast a ray over the cells and find the first collidable tile it enters.
+     * The ray is cast in each chunk it crosses with TileMap::Raycast, from where it left the previous one,
+     * and stops at the first chunk that is not loaded.
+     * @param x The x position of the ray origin.
+     * @param y The y position of the ray origin.
+     * @param dirX The x component of the ray direction, does not need to be normalized.
+     * @param dirY The y component of the ray direction, does not need to be normalized.
+     * @param maxDistance The maximum distance to travel.
+     * @return The first hit, if any, with world row and column numbers.
+     * @see RaycastHit
+     */
+    RaycastHit Raycast(float x, float y, float dirX, float dirY, float maxDistance) const;
+
+    /**
+     * Check if no collidable tile lies on the segment between two points.
+     * @param x0 The x position of the first point.
+     * @param y0 The y position of the first point.
+     * @param x1 The x position of the second point.
+     * @param y1 The y position of the second point.
+     * @return True if the second point can be seen from the first one, false otherwise.
+     */
+    bool HasLineOfSight(float x0, float y0, float x1, float y1) const;
+
+    /**
+     * Check if a chunk is loaded.
+     * @param chunkX The column of the chunk, in chunks.
+     * @param chunkY The row of the chunk, in chunks.
+     * @return True if the chunk is in memory, false otherwise.
+     */
+    bool IsChunkLoaded(int chunkX, int chunkY) const;
+
+    /**
+     * Get the number of chunks in memory.
+     * @return The number of loaded chunks.
+     */
+    int GetLoadedChunkCount() const;
+
+    /**
+     * Get the number of chunks requested but not loaded yet.
+     * @return The number of pending chunks.
+     */
+    int GetPendingChunkCount() const;
+
+    /**
+     * Get the memory held by the cells and the merged collision rectangles of the loaded chunks.
+     * @return The size in bytes.
+     */
+    size_t GetLoadedByteSize() const;
+
+    /**
+     * Get the number of rows and columns of a chunk.
+     * @return The chunk size.
+     */
+    int GetChunkSize() const;
+
+    /**
+     * Get the width of a tile.
+     * @return The width of a tile.
+     */
+    float GetTileWidth() const;
+
+    /**
+     * Get the height of a tile.
+     * @return The height of a tile.
+     */
+    float GetTileHeight() const;
+
+    /**
+     * Move the camera. Collision is not affected, it stays in world coordinates.
+     * @param x The x position of the top left corner of the view in pixels.
+     * @param y The y position of the top left corner of the view in pixels.
+     */
+    void SetCamera(float x, float y);
+
+    /**
+     * Render every visible layer of the loaded chunks within the render output.
+     * Each chunk renders itself as a TileMap, through the caches of its layers, with the camera moved to its origin.
+     * The textures of the tile types a chunk uses are loaded the first time it is on screen.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see TileMap::Render
+     */
+    void Render(std::shared_ptr<SDLGraphicsProgram> game);
+
+    /**
+     * Render the layers of the loaded chunks drawn under the entities. Call it before rendering the entities.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see Render
+     */
+    void RenderBackground(std::shared_ptr<SDLGraphicsProgram> game);
+
+    /**
+     * Render the foreground layers of the loaded chunks. Call it after rendering the entities.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see Render
+     */
+    void RenderForeground(std::shared_ptr<SDLGraphicsProgram> game);
+
+private:
+    /**
+     * A loaded chunk.
+     */
+    struct Chunk
+    {
+        /**
+         * The cells of the chunk, in cell and pixel coordinates relative to the top left corner of the chunk.
+         */
+        std::shared_ptr<TileMap> map;
+        /**
+         * Whether the chunk was edited since it was read.
+         */
+        bool dirty{false};
+        /**
+         * Whether the textures of the tile types the chunk uses were requested since it was last edited.
+         */
+        bool texturesLoaded{false};
+    };
+
+    /**
+     * A chunk read by the background thread, waiting to be added to the map.
+     */
+    struct LoadedChunk
+    {
+        /**
+         * The key of the chunk.
+         * @see ChunkKey
+         */
+        Sint64 key;
+        /**
+         * The tile type ids read from the file, every layer one after the other, all 0 if there was none.
+         */
+        std::vector<Uint16> cells;
+    };
+
+    /**
+     * A layer every chunk has.
+     */
+    struct ChunkLayer
+    {
+        /**
+         * The name of the layer.
+         */
+        std::string name;
+        /**
+         * Whether the collidable tiles of the layer block entities.
+         */
+        bool collidable;
+        /**
+         * Whether the layer is drawn over the entities.
+         */
+        bool foreground;
+    };
+
+    /**
+     * Pack the coordinates of a chunk in a single key.
+     * @param chunkX The column of the chunk, in chunks.
+     * @param chunkY The row of the chunk, in chunks.
+     * @return The key.
+     */
+    static Sint64 ChunkKey(int chunkX, int chunkY);
+
+    /**
+     * Get the path of the file of a chunk.
+     * @param key The key of the chunk.
+     * @return The path.
+     */
+    std::string GetChunkPath(Sint64 key) const;
+
+    /**
+     * Read a chunk file. Runs on the background thread.
+     * @param path The path of the file.
+     * @param layerCount The number of layers to read; layers the file does not have are left empty.
+     * @param cells Filled with the ids of every layer, all 0 if the file is missing or invalid.
+     */
+    void ReadChunk(const std::string &path, int layerCount, std::vector<Uint16> &cells) const;
+
+    /**
+     * Write a chunk file.
+     * @param path The path of the file.
+     * @param cells The ids of every layer of the chunk, one layer after the other.
+     * @return True if the file was written, false otherwise.
+     */
+    bool WriteChunk(const std::string &path, const std::vector<Uint16> &cells) const;
+
+    /**
+     * Queue a job on the background thread, counted so the destructor can wait for it.
+     * @param job The job to run.
+     */
+    void SubmitJob(std::function<void()> job);
+
+    /**
+     * Add the chunks read by the background thread to the map, unless they are no longer wanted.
+     */
+    void AddLoadedChunks();
+
+    /**
+     * Make the TileMap of a chunk, with the tile types and the layers of the map.
+     * @param cells The ids of every layer, one layer after the other.
+     * @return The TileMap.
+     */
+    std::shared_ptr<TileMap> MakeChunkMap(const std::vector<Uint16> &cells) const;
+
+    /**
+     * Get the ids of every layer of a loaded chunk, one layer after the other, as they are written to its file.
+     * @param chunk The chunk.
+     * @return The ids.
+     */
+    std::vector<Uint16> GetChunkCells(const Chunk &chunk) const;
+
+    /**
+     * Find a loaded chunk.
+     * @param chunkX The column of the chunk, in chunks.
+     * @param chunkY The row of the chunk, in chunks.
+     * @return The chunk, or nullptr if it is not loaded.
+     */
+    const Chunk *FindChunk(int chunkX, int chunkY) const;
+
+    /**
+     * Find the loaded chunk of a cell.
+     * @param rowNum The world row number of the cell.
+     * @param columnNum The world column number of the cell.
+     * @param row Set to the row number of the cell in the chunk.
+     * @param column Set to the column number of the cell in the chunk.
+     * @return The chunk, or nullptr if it is not loaded.
+     */
+    Chunk *FindCellChunk(int rowNum, int columnNum, int *row, int *column);
+
+    /**
+     * Render the loaded chunks within the render output.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @param render Renders one chunk, its camera already set.
+     */
+    void RenderChunks(std::shared_ptr<SDLGraphicsProgram> game, const std::function<void(TileMap &)> &render);
+
+    /**
+     * The directory holding the chunk files.
+     */
+    std::string mDirectory;
+    /**
+     * The width of a tile.
+     */
+    int mTileWidth{0};
+    /**
+     * The height of a tile.
+     */
+    int mTileHeight{0};
+    /**
+     * The number of rows and columns of a chunk.
+     */
+    int mChunkSize{64};
+    /**
+     * The number of chunks kept loaded around the focus chunk, in every direction.
+     */
+    int mLoadRadius{2};
+    /**
+     * The tile types in the order they were added, with their names, to add them to each new chunk.
+     * @see TileRecord
+     */
+    std::vector<std::pair<std::string, TileRecord>> mTileTypes;
+    /**
+     * The layers of every chunk in drawing order, the terrain first.
+     */
+    std::vector<ChunkLayer> mLayers;
+    /**
+     * The tile clock in seconds, given to each chunk before it renders.
+     */
+    double mTileClock{0.0};
+    /**
+     * The x position of the camera.
+     */
+    float mCameraX{0};
+    /**
+     * The y position of the camera.
+     */
+    float mCameraY{0};
+    /**
+     * The loaded chunks by key.
+     */
+    std::unordered_map<Sint64, Chunk> mChunks;
+    /**
+     * The keys of the chunks requested and not added yet.
+     */
+    std::unordered_set<Sint64> mPendingChunks;
+    /**
+     * The chunk column of the focus point at the last Update.
+     */
+    int mFocusChunkX{0};
+    /**
+     * The chunk row of the focus point at the last Update.
+     */
+    int mFocusChunkY{0};
+    /**
+     * The chunks read by the background thread, protected by mLoadMutex.
+     */
+    std::vector<LoadedChunk> mLoadedChunks;
+    /**
+     * Mutex protecting mLoadedChunks and mRunningJobs.
+     */
+    std::mutex mLoadMutex;
+    /**
+     * Signalled when a background job finishes.
+     */
+    std::condition_variable mLoadCondition;
+    /**
+     * The number of background jobs queued or running.
+     */
+    int mRunningJobs{0};
+    /**
+     * The background thread reading and writing chunks. A single worker runs the jobs in order,
+     * so a chunk unloaded then requested again is read only after it was written.
+     * Declared last so it is destroyed first.
+     */
+    ThreadPool mIOPool{1};
+};
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "GameEntity.hpp"
+#include "TileMap.hpp"
+#include "DynamicAABBTree.hpp"
+
+/**
+ * An enum class that represents the type of a collision event.
+ * @see CollisionEvent
+ */
+enum class CollisionEventType : short
+{
+    Enter,
+    Stay,
+    Exit,
+};
+
+/**
+ * An enum class that represents the broadphase used by a CollisionWorld to find candidate pairs.
+ * LinearScan tests every pair, which is fine for a handful of entities.
+ * DynamicTree keeps a DynamicAABBTree, which scales with many entities of very different sizes.
+ * @see CollisionWorld
+ * @see DynamicAABBTree
+ */
+enum class BroadphaseType : short
+{
+    LinearScan,
+    DynamicTree,
+};
+
+/**
+ * A struct that represents a collision event between two entities.
+ * Events are produced by CollisionWorld::Step and drained in one call.
+ * @see CollisionWorld
+ */
+struct CollisionEvent
+{
+    /**
+     * Whether the contact started, continued or ended this frame.
+     */
+    CollisionEventType type;
+    /**
+     * The first entity of the contact (the one added to the world first).
+     */
+    std::shared_ptr<GameEntity> a;
+    /**
+     * The second entity of the contact.
+     */
+    std::shared_ptr<GameEntity> b;
+};
+
+/**
+ * A struct that represents a CollisionWorld.
+ * The world holds the collidable entities of a level, computes their contacts once per frame
+ * and turns the difference with the previous frame into enter/stay/exit events.
+ * Trigger colliders take part in contacts like any other collider.
+ * @see CollisionEvent
+ * @see Collision2DComponent
+ */
+struct CollisionWorld
+{
+    /**
+     * Constructor for CollisionWorld.
+     * @param broadphase The broadphase used to find candidate pairs.
+     */
+    CollisionWorld(BroadphaseType broadphase = BroadphaseType::LinearScan);
+
+    /**
+     * Destructor for CollisionWorld.
+     */
+    ~CollisionWorld();
+
+    /**
+     * Add an entity to the world.
+     * Entities without a collision component are ignored. Adding the same entity twice has no effect.
+     * @param e The entity to add.
+     */
+    void AddEntity(std::shared_ptr<GameEntity> e);
+
+    /**
+     * Remove an entity from the world.
+     * Exit events are emitted right away for every contact the entity had.
+     * @param e The entity to remove.
+     */
+    void RemoveEntity(std::shared_ptr<GameEntity> e);
+
+    /**
+     * Remove all entities from the world without emitting any event.
+     * The static geometry of the tile map is kept.
+     */
+    void Clear();
+
+    /**
+     * Compute the contacts of this frame and emit the events.
+     * Should be called once per frame after the entities have moved.
+     */
+    void Step();
+
+    /**
+     * Get all the events emitted since the last call and empty the buffer.
+     * @return The events in the order they were emitted.
+     */
+    std::vector<CollisionEvent> DrainEvents();
+
+    /**
+     * Check if two entities were in contact during the last Step.
+     * @param a The first entity.
+     * @param b The second entity.
+     * @return True if the entities are in contact, false otherwise.
+     */
+    bool HasContact(std::shared_ptr<GameEntity> a, std::shared_ptr<GameEntity> b) const;
+
+    /**
+     * Get the number of contacts found during the last Step.
+     * @return The number of contacts.
+     */
+    int GetContactCount() const;
+
+    /**
+     * Set how much each collision box is grown on every side when looking for contacts.
+     * Entities that stop right next to each other, e.g. an enemy blocked by the player, then still touch.
+     * IsBlockedAt and the queries use the boxes as they are.
+     * @param margin The margin, 0 by default.
+     */
+    void SetContactMargin(float margin);
+
+    /**
+     * Get how much each collision box is grown on every side when looking for contacts.
+     * @return The margin.
+     */
+    float GetContactMargin() const;
+
+    /**
+     * Set the tile map holding the static geometry of the world.
+     * Its merged static collision rectangles are copied into a tree of their own, used by IsBlockedAt whatever the
+     * broadphase of the entities, so it should be set again after the collidable tiles change.
+     * They never take part in contacts.
+     * @param tilemap The tile map, or nullptr for none.
+     * @see TileMap::GetStaticCollisionRects
+     */
+    void SetTileMap(std::shared_ptr<TileMap> tilemap);
+
+    /**
+     * Check if an entity would be blocked if its collision box was moved to a position.
+     * The static geometry is tested first, through its tree, then every other non-trigger entity of the world.
+     * @param e The entity whose collision box size is used.
+     * @param x The x position to test.
+     * @param y The y position to test.
+     * @return True if the entity would be blocked, false otherwise.
+     */
+    bool IsBlockedAt(std::shared_ptr<GameEntity> e, float x, float y) const;
+
+    /**
+     * Get every entity whose collision box overlaps a region, triggers included.
+     * @param x The x position of the region.
+     * @param y The y position of the region.
+     * @param w The width of the region.
+     * @param h The height of the region.
+     * @return The entities found.
+     */
+    std::vector<std::shared_ptr<GameEntity>> QueryRegion(float x, float y, float w, float h) const;
+
+    /**
+     * Get every entity whose collision box contains a point, triggers included.
+     * @param x The x position of the point.
+     * @param y The y position of the point.
+     * @return The entities found.
+     */
+    std::vector<std::shared_ptr<GameEntity>> QueryPoint(float x, float y) const;
+
+    /**
+     * Get the broadphase used by the world.
+     * @return The broadphase.
+     */
+    BroadphaseType GetBroadphase() const;
+
+    /**
+     * Get the number of entities in the world.
+     * @return The number of entities.
+     */
+    int GetEntityCount() const;
+
+private:
+    /**
+     * A struct that represents an entity registered in the world.
+     * The id is stable for the lifetime of the body so that contacts can be keyed by id pairs.
+     */
+    struct Body
+    {
+        uint32_t id;
+        std::shared_ptr<GameEntity> entity;
+        /**
+         * The proxy of the body in the tree, -1 with the linear scan.
+         */
+        int proxyId{-1};
+    };
+
+    /**
+     * Find a body by id.
+     * @param id The id of the body.
+     * @return The body, or nullptr if no body has that id.
+     */
+    const Body *FindBody(uint32_t id) const;
+
+    /**
+     * Find the id of the body holding an entity.
+     * @param e The entity.
+     * @return The id of the body, or 0 if the entity is not in the world.
+     */
+    uint32_t FindId(const std::shared_ptr<GameEntity> &e) const;
+
+    /**
+     * Find the contacts of this frame through the broadphase and add their keys to mCurrContacts.
+     * @param rects The collision box of each body, in the order of mBodies.
+     */
+    void FindContacts(const std::vector<SDL_FRect> &rects);
+
+    /**
+     * Build the key of a contact from two body ids, the smaller id first.
+     */
+    static uint64_t MakePairKey(uint32_t a, uint32_t b);
+
+    /**
+     * The broadphase used to find candidate pairs.
+     */
+    BroadphaseType mBroadphase;
+    /**
+     * The tree holding a proxy per body when the broadphase is DynamicTree.
+     */
+    DynamicAABBTree mTree;
+    /**
+     * The bodies in the world, sorted by id since ids only grow.
+     */
+    std::vector<Body> mBodies;
+    /**
+     * The next id to give to a body. 0 is never used.
+     */
+    uint32_t mNextId{1};
+    /**
+     * How much each collision box is grown on every side when looking for contacts.
+     */
+    float mContactMargin{0.0f};
+    /**
+     * The sorted contact keys of the previous frame.
+     */
+    std::vector<uint64_t> mPrevContacts;
+    /**
+     * The sorted contact keys of the current frame.
+     */
+    std::vector<uint64_t> mCurrContacts;
+    /**
+     * The events waiting to be drained.
+     */
+    std::vector<CollisionEvent> mEvents;
+    /**
+     * The merged static collision rectangles of the tile map, in world coordinates.
+     */
+    std::vector<SDL_FRect> mStaticRects;
+    /**
+     * The tree holding a proxy per static rectangle, with the index of the rectangle as user data.
+     * Never fattened, the rectangles do not move.
+     */
+    DynamicAABBTree mStaticTree{0.0f};
+};
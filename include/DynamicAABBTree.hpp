@@ -0,0 +1,180 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * A struct that represents a dynamic bounding volume tree of axis aligned boxes.
+ * Each leaf (proxy) stores a box fattened by a margin so that small moves do not touch the tree.
+ * Insertions pick the sibling that grows the tree perimeter the least, and rotations keep it balanced.
+ * Used as a broadphase when collider sizes vary a lot, where a uniform grid would struggle.
+ * @see CollisionWorld
+ */
+struct DynamicAABBTree
+{
+    /**
+     * Constructor for DynamicAABBTree.
+     * @param margin How much each proxy box is grown on every side.
+     */
+    DynamicAABBTree(float margin = 4.0f);
+
+    /**
+     * Destructor for DynamicAABBTree.
+     */
+    ~DynamicAABBTree();
+
+    /**
+     * Create a proxy for a box.
+     * @param rect The tight box.
+     * @param userData A value given back by the queries, e.g. an index.
+     * @return The id of the proxy.
+     */
+    int CreateProxy(SDL_FRect rect, int userData);
+
+    /**
+     * Destroy a proxy.
+     * @param proxyId The id of the proxy.
+     */
+    void DestroyProxy(int proxyId);
+
+    /**
+     * Move a proxy to a new tight box.
+     * Nothing happens while the new box still fits in the fattened one.
+     * @param proxyId The id of the proxy.
+     * @param rect The new tight box.
+     * @return True if the proxy was re-inserted, false otherwise.
+     */
+    bool MoveProxy(int proxyId, SDL_FRect rect);
+
+    /**
+     * Remove every proxy.
+     */
+    void Clear();
+
+    /**
+     * Get the user data of a proxy.
+     * @param proxyId The id of the proxy.
+     * @return The user data given to CreateProxy.
+     */
+    int GetUserData(int proxyId) const;
+
+    /**
+     * Get the fattened box of a proxy.
+     * @param proxyId The id of the proxy.
+     * @return The fattened box.
+     */
+    SDL_FRect GetFatRect(int proxyId) const;
+
+    /**
+     * Visit every proxy whose fattened box overlaps a region.
+     * @param rect The region.
+     * @param callback Called with the proxy id, return false to stop the query.
+     */
+    void Query(SDL_FRect rect, const std::function<bool(int)> &callback) const;
+
+    /**
+     * Get the user data of every proxy whose fattened box overlaps a region.
+     * @param rect The region.
+     * @return The user data of the proxies found.
+     */
+    std::vector<int> QueryRegion(SDL_FRect rect) const;
+
+    /**
+     * Get the user data of every proxy whose fattened box contains a point.
+     * @param x The x position of the point.
+     * @param y The y position of the point.
+     * @return The user data of the proxies found.
+     */
+    std::vector<int> QueryPoint(float x, float y) const;
+
+    /**
+     * Get every pair of proxies whose fattened boxes overlap.
+     * Each pair is reported once, the smaller proxy id first.
+     * @return The overlapping proxy id pairs.
+     */
+    std::vector<std::pair<int, int>> QueryPairs() const;
+
+    /**
+     * Get the height of the tree, 0 for a single leaf.
+     * @return The height of the tree.
+     */
+    int GetHeight() const;
+
+    /**
+     * Get the number of proxies in the tree.
+     * @return The number of proxies.
+     */
+    int GetProxyCount() const;
+
+private:
+    /**
+     * A box stored as min and max corners, cheaper to merge and test than SDL_FRect.
+     */
+    struct AABB
+    {
+        float minX, minY, maxX, maxY;
+    };
+
+    /**
+     * A node of the tree. Leaves hold proxies, internal nodes hold the union of their children.
+     * Free nodes reuse parent as the next free node.
+     */
+    struct Node
+    {
+        AABB box;
+        int parent{-1};
+        int child1{-1};
+        int child2{-1};
+        /**
+         * Leaf = 0, free node = -1.
+         */
+        int height{-1};
+        int userData{-1};
+
+        bool IsLeaf() const
+        {
+            return child1 == -1;
+        }
+    };
+
+    int AllocateNode();
+    void FreeNode(int nodeId);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+
+    /**
+     * Rotate the subtree at a node if its children heights differ by more than one.
+     * @param iA The node to balance.
+     * @return The node now at the root of the subtree.
+     */
+    int Balance(int iA);
+
+    static AABB Union(const AABB &a, const AABB &b);
+    static float Perimeter(const AABB &a);
+    static bool Overlaps(const AABB &a, const AABB &b);
+    static bool Contains(const AABB &outer, const AABB &inner);
+    static AABB ToAABB(SDL_FRect rect);
+
+    /**
+     * How much each proxy box is grown on every side.
+     */
+    float mMargin;
+    /**
+     * The node pool. Ids are indices into it and stay valid until the node is freed.
+     */
+    std::vector<Node> mNodes;
+    /**
+     * The root node, -1 when the tree is empty.
+     */
+    int mRoot{-1};
+    /**
+     * The head of the free node list.
+     */
+    int mFreeList{-1};
+    /**
+     * The number of proxies in the tree.
+     */
+    int mProxyCount{0};
+};
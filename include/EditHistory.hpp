@@ -0,0 +1,228 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "EditJournal.hpp"
+#include "GameEntity.hpp"
+#include "TileMap.hpp"
+
+/**
+ * A struct that represents the change of one cell in an EditHistory.
+ * It keeps the tile type before and after the change, so it can be undone and redone.
+ * @see EditHistory
+ */
+struct TileDelta
+{
+    /**
+     * The row of the cell.
+     */
+    Sint32 row{0};
+    /**
+     * The column of the cell.
+     */
+    Sint32 column{0};
+    /**
+     * The index of the tile layer.
+     */
+    Uint16 layer{0};
+    /**
+     * The tile type id before the change, 0 for an empty cell.
+     */
+    Uint16 before{0};
+    /**
+     * The tile type id after the change, 0 for an empty cell.
+     */
+    Uint16 after{0};
+};
+
+/**
+ * A struct that represents the change of one entity in an EditHistory, as the records of the entity before and after it.
+ * A move is a pair of move records; an enemy being added goes from a RemoveEnemy record to an AddEnemy one.
+ * @see EditHistory
+ */
+struct EntityDelta
+{
+    /**
+     * The entity, moved back and forth by undo and redo. May be nullptr when there is nothing to move.
+     */
+    std::shared_ptr<GameEntity> entity;
+    /**
+     * The entity before the change.
+     */
+    EditRecord before;
+    /**
+     * The entity after the change.
+     */
+    EditRecord after;
+};
+
+/**
+ * A struct that represents one step of an EditHistory: everything undone or redone together.
+ * @see EditHistory
+ */
+struct EditStep
+{
+    /**
+     * The cells changed by the step, in order.
+     */
+    std::vector<TileDelta> tiles;
+    /**
+     * The entities changed by the step, in order.
+     */
+    std::vector<EntityDelta> entities;
+};
+
+/**
+ * A struct that represents the undo and redo history of the level editor.
+ * Each step is kept as the small reversible deltas of what it changed, not as a copy of the level,
+ * and undoing or redoing one patches only those cells and entities.
+ * There is no limit on the number of steps. Once the history uses more memory than its budget, its oldest steps are
+ * coalesced into one, which keeps only the first and last state of each cell or entity they touched: the level can
+ * still be undone back to where the history started, in bigger steps.
+ * Undo and Redo also return the records of the state they went to, for updating the level config and the EditJournal.
+ * @see TileDelta
+ * @see EntityDelta
+ */
+struct EditHistory
+{
+    /**
+     * Constructor for EditHistory.
+     */
+    EditHistory();
+
+    /**
+     * Destructor for EditHistory.
+     */
+    ~EditHistory();
+
+    /**
+     * Record the change of a cell in the step being recorded.
+     * @param layer The index of the tile layer.
+     * @param row The row of the cell.
+     * @param column The column of the cell.
+     * @param before The tile type id before the change.
+     * @param after The tile type id after the change.
+     */
+    void RecordTile(int layer, int row, int column, Uint16 before, Uint16 after);
+
+    /**
+     * Record the change of an entity in the step being recorded.
+     * @param entity The entity, moved by undo and redo when the records are moves; may be nullptr.
+     * @param before The record of the entity before the change.
+     * @param after The record of the entity after the change.
+     */
+    void RecordEntity(std::shared_ptr<GameEntity> entity, const EditRecord &before, const EditRecord &after);
+
+    /**
+     * End the step being recorded, which can then be undone, and forget the steps that could be redone.
+     * A step that changed nothing is not kept. Coalesces the oldest steps if the history is over its memory budget.
+     */
+    void EndStep();
+
+    /**
+     * Undo the last step, ending the one being recorded first.
+     * @param tilemap The tile map to patch, may be nullptr.
+     * @return The records of the state the changed cells and entities went back to, empty if there was nothing to undo.
+     */
+    std::vector<EditRecord> Undo(std::shared_ptr<TileMap> tilemap);
+
+    /**
+     * Redo the last step undone.
+     * @param tilemap The tile map to patch, may be nullptr.
+     * @return The records of the state the changed cells and entities went to, empty if there was nothing to redo.
+     */
+    std::vector<EditRecord> Redo(std::shared_ptr<TileMap> tilemap);
+
+    /**
+     * Forget every step, e.g. after the level went back to a snapshot.
+     */
+    void Clear();
+
+    /**
+     * Get the number of steps that can be undone.
+     * @return The number of steps.
+     */
+    int GetUndoCount() const;
+
+    /**
+     * Get the number of steps that can be redone.
+     * @return The number of steps.
+     */
+    int GetRedoCount() const;
+
+    /**
+     * Get the number of steps merged into older ones to stay within the memory budget, for statistics.
+     * @return The number of steps coalesced.
+     */
+    int GetCoalescedCount() const;
+
+    /**
+     * Set how much memory the history may use before its oldest steps are coalesced.
+     * @param bytes The budget in bytes.
+     */
+    void SetMemoryBudget(size_t bytes);
+
+    /**
+     * Get how much memory the history uses.
+     * @return The size of the steps in bytes.
+     */
+    size_t GetByteSize() const;
+
+private:
+    /**
+     * Merge consecutive steps into one holding the first and last state of each cell and entity they changed.
+     * Changes that end where they started are dropped.
+     * @param first The first step to merge.
+     * @param last Past the last step to merge.
+     * @return The merged step.
+     */
+    static EditStep Compose(std::vector<EditStep>::const_iterator first, std::vector<EditStep>::const_iterator last);
+
+    /**
+     * Get the memory used by a step.
+     * @param step The step.
+     * @return The size in bytes.
+     */
+    static size_t StepBytes(const EditStep &step);
+
+    /**
+     * Patch the tile map and entities to the state before or after a step.
+     * @param tilemap The tile map to patch, may be nullptr.
+     * @param step The step.
+     * @param redo True to go to the state after the step, false for the state before it.
+     * @return The records of the state reached.
+     */
+    static std::vector<EditRecord> Apply(std::shared_ptr<TileMap> tilemap, const EditStep &step, bool redo);
+
+    /**
+     * Coalesce the oldest steps until the history fits in its memory budget, or only one step is left.
+     */
+    void Coalesce();
+
+    /**
+     * The step being recorded.
+     */
+    EditStep mRecording;
+    /**
+     * The steps that can be undone, the oldest first.
+     */
+    std::vector<EditStep> mUndo;
+    /**
+     * The steps that can be redone, the last undone last.
+     */
+    std::vector<EditStep> mRedo;
+    /**
+     * The memory used by mUndo and mRedo.
+     */
+    size_t mByteSize{0};
+    /**
+     * How much memory the history may use, 4 MB unless set.
+     */
+    size_t mMemoryBudget{4 * 1024 * 1024};
+    /**
+     * The number of steps coalesced since the history was created or cleared.
+     */
+    int mCoalescedCount{0};
+};
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+/**
+ * An enum class that represents the operation of an EditRecord.
+ * Edits only count once a Commit follows them; a Discard drops the edits since the last Commit.
+ * @see EditRecord
+ */
+enum class EditOp : short
+{
+    PlaceTile = 1,
+    EraseTile,
+    MovePlayer,
+    MoveDestination,
+    AddEnemy,
+    RemoveEnemy,
+    Commit,
+    Discard,
+};
+
+/**
+ * A struct that represents one edit of a level, as stored in an EditJournal.
+ * The fields used depend on the operation: tiles use row, column, value (the tile type id) and layer,
+ * moves use transform and collider, enemies use value (their number), type, transform and collider.
+ * Every edit sets absolute values, so the level after replaying the journal does not depend on the level before the edit.
+ * @see EditJournal
+ */
+struct EditRecord
+{
+    /**
+     * The position of the record in the journal, set by EditJournal::Append, starting at 1.
+     */
+    Uint32 sequence{0};
+    /**
+     * The operation.
+     */
+    EditOp op{EditOp::Commit};
+    /**
+     * The index of the tile layer of a tile edit.
+     */
+    Uint16 layer{0};
+    /**
+     * The row of a tile edit.
+     */
+    Sint32 row{0};
+    /**
+     * The column of a tile edit.
+     */
+    Sint32 column{0};
+    /**
+     * The tile type id of a tile edit, or the number of an enemy.
+     */
+    Sint32 value{0};
+    /**
+     * The transform of an entity as x, y, width, height.
+     */
+    float transform[4]{};
+    /**
+     * The collider of an entity as x, y, width, height.
+     */
+    float collider[4]{};
+    /**
+     * The type of an added enemy, 0 terminated.
+     */
+    char type[16]{};
+    /**
+     * Checksum of the bytes before it, set by EditJournal::Append; a record torn by a crash does not match it.
+     */
+    Uint32 checksum{0};
+};
+
+/**
+ * The header at the start of an edit journal file, followed by the records.
+ * @see EditJournal
+ */
+struct EditJournalHeader
+{
+    /**
+     * Always JOURNAL_MAGIC.
+     */
+    char magic[4];
+    /**
+     * The version of the format, JOURNAL_VERSION.
+     */
+    Uint32 version;
+    /**
+     * The size of a record in bytes, sizeof(EditRecord).
+     */
+    Uint32 recordSize;
+    /**
+     * The sequence number of the last record dropped by a compaction, the records of the file come after it.
+     */
+    Uint32 baseSequence;
+};
+
+/**
+ * A struct that represents an append-only journal of level edits, so that saving an edit does not rewrite the level.
+ * Appended records are written and synced to disk on a background thread, in the order they were appended;
+ * records appended while a write is running are written together by the next one.
+ * Once the edits are folded into the level file, DropThrough removes them from the journal.
+ * When a journal is opened, the records that made it to disk are read back for replaying,
+ * and a record torn by a crash is cut off the end of the file.
+ * @see EditRecord
+ * @see LevelFile::GetJournalSequence
+ */
+struct EditJournal
+{
+    /**
+     * The magic bytes every journal starts with.
+     */
+    static constexpr char JOURNAL_MAGIC[4] = {'E', 'J', 'N', 'L'};
+    /**
+     * The version of the format read by this EditJournal.
+     */
+    static constexpr Uint32 JOURNAL_VERSION = 1;
+
+    /**
+     * Constructor for EditJournal.
+     */
+    EditJournal();
+
+    /**
+     * Destructor for EditJournal.
+     * Waits for every appended record to be on disk.
+     */
+    ~EditJournal();
+
+    EditJournal(const EditJournal &) = delete;
+    EditJournal &operator=(const EditJournal &) = delete;
+
+    /**
+     * Open a journal, creating it if the file does not exist, and read its records.
+     * A journal that is not valid is not changed, and not opened.
+     * @param filepath The path to the journal file.
+     * @param minSequence The sequence number the new records must come after, usually the one of the level file.
+     * If the journal ends before it, e.g. because it was deleted, its records are dropped and numbering resumes from there.
+     * @return True if the journal is open, false otherwise.
+     */
+    bool Open(const std::string &filepath, Uint32 minSequence = 0);
+
+    /**
+     * Close the journal, after every appended record is on disk.
+     */
+    void Close();
+
+    /**
+     * Check if a journal is open.
+     * @return True if a journal is open, false otherwise.
+     */
+    bool IsOpen() const;
+
+    /**
+     * Get the records read when the journal was opened, in order.
+     * @return The records.
+     */
+    const std::vector<EditRecord> &GetRecords() const;
+
+    /**
+     * Append a record. It is written and synced on the background thread, this call does not wait for the disk.
+     * @param record The record, its sequence and checksum are set here.
+     * @return The sequence number given to the record, 0 if the journal is not open.
+     */
+    Uint32 Append(EditRecord record);
+
+    /**
+     * Block until every appended record is on disk.
+     */
+    void Flush();
+
+    /**
+     * Remove the records up to a sequence number, once they are folded into the level file.
+     * The journal is rewritten on the background thread after the records appended before this call.
+     * @param sequence The sequence number of the last record to remove.
+     */
+    void DropThrough(Uint32 sequence);
+
+    /**
+     * Get the sequence number of the last record appended, or read when opening.
+     * @return The sequence number, the base sequence if the journal has no record.
+     */
+    Uint32 GetLastSequence() const;
+
+    /**
+     * Get the number of records in the journal file, including those not written yet.
+     * @return The number of records.
+     */
+    int GetRecordCount() const;
+
+    /**
+     * Get the number of records written to disk since the journal was opened, for statistics.
+     * @return The number of records written.
+     */
+    int GetWrittenCount();
+
+    /**
+     * Get the number of write and sync calls since the journal was opened, several records may share one.
+     * @return The number of syncs.
+     */
+    int GetSyncCount();
+
+private:
+    /**
+     * Compute the checksum of a record.
+     * @param record The record.
+     * @return The checksum of the bytes before its checksum field.
+     */
+    static Uint32 Checksum(const EditRecord &record);
+
+    /**
+     * Write the records appended since the last write at the end of the file, then sync it.
+     * Runs on the background thread.
+     */
+    void WritePending();
+
+    /**
+     * Rewrite the file without the records up to a sequence number. Runs on the background thread.
+     * @param sequence The sequence number of the last record to remove.
+     */
+    void Rewrite(Uint32 sequence);
+
+    /**
+     * Queue a job on the background thread, counted in mRunningJobs.
+     * @param job The job to run.
+     */
+    void SubmitJob(std::function<void()> job);
+
+    /**
+     * The path to the journal file.
+     */
+    std::string mFilepath;
+    /**
+     * The records read by Open.
+     */
+    std::vector<EditRecord> mRecords;
+    /**
+     * The sequence number of the last record appended.
+     */
+    Uint32 mLastSequence{0};
+    /**
+     * The sequence number of the last record dropped, the records of the file come after it.
+     */
+    Uint32 mDroppedSequence{0};
+    /**
+     * The file, open for appending. Only used by the background thread once the journal is open.
+     */
+    std::FILE *mFile{nullptr};
+    /**
+     * The records in the file, kept for rewriting it. Only used by the background thread once the journal is open.
+     */
+    std::vector<EditRecord> mWritten;
+    /**
+     * The records appended but not written yet, protected by mMutex.
+     */
+    std::vector<EditRecord> mPending;
+    /**
+     * Whether a write of mPending is queued and not started yet, protected by mMutex.
+     */
+    bool mWriteQueued{false};
+    /**
+     * The number of records written since the journal was opened, protected by mMutex.
+     */
+    int mWrittenCount{0};
+    /**
+     * The number of syncs since the journal was opened, protected by mMutex.
+     */
+    int mSyncCount{0};
+    /**
+     * Mutex protecting mPending, mWriteQueued, the counters and mRunningJobs.
+     */
+    std::mutex mMutex;
+    /**
+     * Signalled when a background job finishes.
+     */
+    std::condition_variable mJobCondition;
+    /**
+     * The number of background jobs queued or running.
+     */
+    int mRunningJobs{0};
+    /**
+     * The background thread writing the journal. A single worker keeps the writes in order.
+     * Declared last so it is destroyed first.
+     */
+    ThreadPool mIOPool{1};
+};
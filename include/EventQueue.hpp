@@ -0,0 +1,215 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <vector>
+
+/**
+ * A struct that represents one SDL event kept by the EventQueue.
+ * The text of text input, text editing and drop events is copied into the event, since SDL frees it on the next poll;
+ * the text pointer of the SDL event itself is set to nullptr.
+ */
+struct QueuedEvent
+{
+    /**
+     * The SDL event. Its timestamp is in nanoseconds, on the SDL_GetTicksNS clock.
+     */
+    SDL_Event event;
+    /**
+     * The number of the event, counted from the first event the queue took.
+     */
+    Uint64 sequence{0};
+    /**
+     * The text of the event, empty for events without text. Longer text is cut.
+     */
+    char text[64]{};
+};
+
+/**
+ * A struct that represents the time between input events and the present of the frame that first saw them.
+ * Only key presses (not key repeats) and mouse button presses are measured.
+ */
+struct InputLatency
+{
+    /**
+     * The number of events measured.
+     */
+    int count{0};
+    /**
+     * The mean latency in milliseconds.
+     */
+    double meanMs{0.0};
+    /**
+     * The largest latency in milliseconds.
+     */
+    double maxMs{0.0};
+    /**
+     * The latency of the last event measured, in milliseconds.
+     */
+    double lastMs{0.0};
+};
+
+/**
+ * A singleton class that owns the SDL event pump.
+ * Pump is called once per frame, by Input::Update, and keeps every event SDL had in a preallocated ring buffer,
+ * so that the engine and Python read the events of the frame from here instead of calling SDL_PollEvent themselves.
+ * The events of the current frame are never overwritten: the ring grows when one frame has more events than it holds.
+ * Events of earlier frames stay readable by sequence number until the ring wraps over them.
+ * Not thread safe, the events are pumped and read on the main thread.
+ * @see Input::Update
+ */
+struct EventQueue
+{
+    /**
+     * Used to get the singleton instance of the EventQueue.
+     * If the instance does not exist, it will be created.
+     */
+    static EventQueue &Instance()
+    {
+        if (nullptr == mInstance)
+        {
+            mInstance = new EventQueue();
+        }
+        return *mInstance;
+    }
+
+    /**
+     * Destroy the singleton instance, if any.
+     */
+    static void Destroy()
+    {
+        delete mInstance;
+        mInstance = nullptr;
+    }
+
+    /**
+     * Destructor for EventQueue.
+     */
+    ~EventQueue();
+
+    /**
+     * Start a new frame and take every event waiting in SDL.
+     * @return The number of events of the frame.
+     */
+    int Pump();
+
+    /**
+     * Get the number of events taken by the last Pump.
+     * @return The number of events.
+     */
+    int GetFrameEventCount() const;
+
+    /**
+     * Get an event taken by the last Pump.
+     * @param index The index of the event in the frame, from 0 to GetFrameEventCount() - 1.
+     * @return The event.
+     */
+    const QueuedEvent &GetFrameEvent(int index) const;
+
+    /**
+     * Get a copy of the events taken by the last Pump, oldest first.
+     * @return The events.
+     */
+    std::vector<QueuedEvent> GetFrameEvents() const;
+
+    /**
+     * Get a copy of the events from a sequence number on, oldest first, for readers that do not read every frame.
+     * Events the ring has wrapped over are skipped; the sequence of the first event returned tells where it starts.
+     * @param sequence The sequence number of the first event wanted, e.g. the GetSequence of the last read.
+     * @return The events still in the ring.
+     */
+    std::vector<QueuedEvent> GetEventsSince(Uint64 sequence) const;
+
+    /**
+     * Get the sequence number the next event will have.
+     * @return The sequence number.
+     */
+    Uint64 GetSequence() const;
+
+    /**
+     * Get the number of events the ring holds before it wraps.
+     * @return The capacity of the ring.
+     */
+    size_t GetCapacity() const;
+
+    /**
+     * Check if a quit event was pumped. Stays true once it was.
+     * @return True if SDL asked to quit, false otherwise.
+     */
+    bool IsQuitRequested() const;
+
+    /**
+     * Measure the latency of the key and mouse button presses pumped since the last present.
+     * Called by SDLGraphicsProgram::flip once the frame is presented.
+     * @param presentNS The time of the present, on the SDL_GetTicksNS clock.
+     */
+    void MarkPresented(Uint64 presentNS);
+
+    /**
+     * Get the input to present latency measured so far.
+     * @return The latency.
+     */
+    InputLatency GetLatency() const;
+
+    /**
+     * Forget the latency measured so far.
+     */
+    void ResetLatency();
+
+private:
+    /**
+     * Private Constructor for EventQueue.
+     * This is a singleton class so the constructor is private.
+     * @param capacity The number of events the ring holds, rounded up to a power of two.
+     */
+    EventQueue(size_t capacity = 1024);
+
+    /**
+     * Double the ring, keeping the events it holds.
+     */
+    void Grow();
+
+    /**
+     * The ring of events, indexed by sequence number. Its size is a power of two.
+     */
+    std::vector<QueuedEvent> mEvents;
+
+    /**
+     * The sequence number the next event will have.
+     */
+    Uint64 mNext{0};
+
+    /**
+     * The sequence number of the oldest event the ring holds.
+     */
+    Uint64 mOldest{0};
+
+    /**
+     * The sequence number of the first event of the current frame.
+     */
+    Uint64 mFrameStart{0};
+
+    /**
+     * The sequence number of the first event not yet presented.
+     */
+    Uint64 mPresented{0};
+
+    /**
+     * Whether a quit event was pumped.
+     */
+    bool mQuitRequested{false};
+
+    /**
+     * The latency measured so far.
+     */
+    InputLatency mLatency;
+
+    /**
+     * The sum of the latencies measured so far, in milliseconds.
+     */
+    double mLatencyTotalMs{0.0};
+
+    /**
+     * The singleton instance of the EventQueue.
+     */
+    inline static EventQueue *mInstance{nullptr};
+};
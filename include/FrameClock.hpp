@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+/**
+ * A struct that represents the clock of the game, which moves once per frame.
+ * Tick is called at the start of every frame, by SDLGraphicsProgram::getDeltaTime, and the whole frame sees the
+ * time of that tick: the delta time given to the game and the ticks the animations are timed with.
+ * While Input replays a recording, the clock takes the times of the recording instead of SDL_GetTicks,
+ * so that the replayed frames run with the same times as the recorded ones, however fast they run.
+ * This is a static class, not meant to be instantiated.
+ * @see Input::StartReplay
+ */
+struct FrameClock
+{
+    /**
+     * Constructor for FrameClock.
+     * Do not use this constructor.
+     * All functions in this class are static.
+     */
+    FrameClock();
+
+    /**
+     * Destructor for FrameClock.
+     */
+    ~FrameClock();
+
+    /**
+     * Start a new frame.
+     * @return The time since the last frame in seconds, 1/60 for the first frame.
+     */
+    static float Tick();
+
+    /**
+     * Get the time between the last two ticks.
+     * @return The time in seconds.
+     */
+    static float GetDeltaTime();
+
+    /**
+     * Get the time of the last tick.
+     * @return The time in milliseconds, SDL_GetTicks until the first tick.
+     */
+    static Uint64 GetTicks();
+};
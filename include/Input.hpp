@@ -1,122 +1,220 @@
-#pragma once
-
-#include <SDL3/SDL.h>
-#include <vector>
-
-/**
- * A struct that represents the input of the game.
- * Used to get the input from the user.
- * Note that it's not a component.
- * This is a static class, not meant to be instantiated.
- * It serves as a utility class to get input from the user.
- */
-struct Input
-{
-    /**
-     * Constructor for Input.
-     * Do not use this constructor.
-     * All functions in this class are static.
-     */
-    Input();
-
-    /**
-     * Destructor for Input.
-     */
-    ~Input();
-
-    /**
-     * Check if the up key is pressed.
-     * @return True if the up key is pressed, false otherwise.
-     */
-    static bool isUpKeyDown();
-
-    /**
-     * Check if the down key is pressed.
-     * @return True if the down key is pressed, false otherwise.
-     */
-    static bool isDownKeyDown();
-
-    /**
-     * Check if the left key is pressed.
-     * @return True if the left key is pressed, false otherwise.
-     */
-    static bool isLeftKeyDown();
-
-    /**
-     * Check if the right key is pressed.
-     * @return True if the right key is pressed, false otherwise.
-     */
-    static bool isRightKeyDown();
-
-    /**
-     * Check if the ESC key is pressed.
-     * @return True if the ESC key is pressed, false otherwise.
-     */
-    static bool isESCKeyDown();
-
-    /**
-     * Check if the x key is pressed.
-     * @return True if the x key is pressed, false otherwise.
-     */
-    static bool isXKeyDown();
-
-    /**
-     * Check if the e key is pressed.
-     * @return True if the e key is pressed, false otherwise.
-     */
-    static bool isEKeyDown();
-
-    /**
-     * Check if the s key is pressed.
-     * @return True if the s key is pressed, false otherwise.
-     */
-    static bool isSKeyDown();
-
-    /**
-     * Check if the 1 key is pressed.
-     * @return True if the 1 key is pressed, false otherwise.
-     */
-    static bool is1KeyDown();
-
-    /**
-     * Check if the 2 key is pressed.
-     * @return True if the 2 key is pressed, false otherwise.
-     */
-    static bool is2KeyDown();
-
-    /**
-     * Check if the 3 key is pressed.
-     * @return True if the 3 key is pressed, false otherwise.
-     */
-    static bool is3KeyDown();
-
-    /**
-     * Check if the 4 key is pressed.
-     * @return True if the 4 key is pressed, false otherwise.
-     */
-    static bool is4KeyDown();
-
-    /**
-     * Check if the 5 key is pressed.
-     * @return True if the 5 key is pressed, false otherwise.
-     */
-    static bool is5KeyDown();
-
-    /**
-     * Get the mouse click position.
-     * @return A vector of floats representing the x and y position of the mouse click.
-     */
-    static std::vector<float> GetMouseClickPosition();
-
-    /**
-     * Get the mouse position.
-     * @return A vector of floats representing the x and y position of the mouse.
-     */
-    static std::vector<float> GetMousePosition();
-
-    /**
-     * Check if the quit button is clicked.
-     * @return True if the quit button is clicked, false otherwise.
-     */
-    static bool isQuitClicked();
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "InputSnapshot.hpp"
+
+struct InputRecording;
+
+/**
+ * A struct that represents the input of the game.
+ * Used to get the input from the user.
+ * Note that it's not a component.
+ * This is a static class, not meant to be instantiated.
+ * It serves as a utility class to get input from the user.
+ * The keyboard and mouse are read once per frame by Update, and every check reads that snapshot,
+ * so that the whole frame sees the same input and a key can be checked for being just pressed or released.
+ * Update also pumps the SDL events into the EventQueue, nothing else polls them.
+ * The snapshots can be added to an InputRecording as they are taken, or taken from one to replay a run.
+ * @see InputSnapshot
+ * @see InputRecording
+ * @see EventQueue
+ */
+struct Input
+{
+    /**
+     * Constructor for Input.
+     * Do not use this constructor.
+     * All functions in this class are static.
+     */
+    Input();
+
+    /**
+     * Destructor for Input.
+     */
+    ~Input();
+
+    /**
+     * Take the snapshot of the keyboard and mouse for this frame, keeping the previous one for the pressed and released checks.
+     * Pumps the events of the frame into the EventQueue first; a key or button pressed since the last frame is down
+     * in the snapshot even if it was already released.
+     * Call once at the start of every frame.
+     * @return The snapshot.
+     */
+    static const InputSnapshot &Update();
+
+    /**
+     * Start adding the snapshot of every frame to a recording, with the delta time and ticks of the FrameClock.
+     * Tick the FrameClock before Update, so that each frame is recorded with its own time.
+     * @param recording The recording, emptied first.
+     */
+    static void StartRecording(std::shared_ptr<InputRecording> recording);
+
+    /**
+     * Stop adding frames to the recording.
+     */
+    static void StopRecording();
+
+    /**
+     * Start taking the snapshot of every frame from a recording instead of the keyboard and mouse, from its first frame.
+     * The FrameClock takes the time of the frames from the recording too. Once every frame is played,
+     * the replay stops and the keyboard and mouse are read again.
+     * @param recording The recording.
+     */
+    static void StartReplay(std::shared_ptr<InputRecording> recording);
+
+    /**
+     * Stop the replay, the keyboard and mouse are read again.
+     */
+    static void StopReplay();
+
+    /**
+     * Get the recording being replayed.
+     * @return The recording, nullptr if no replay is running.
+     */
+    static std::shared_ptr<InputRecording> GetReplay();
+
+    /**
+     * Check if a replay has frames left to play.
+     * @return True if a replay is running and not finished, false otherwise.
+     */
+    static bool IsReplaying();
+
+    /**
+     * Get the snapshot taken by the last Update.
+     * @return The snapshot.
+     */
+    static const InputSnapshot &GetSnapshot();
+
+    /**
+     * Check if a key is down.
+     * @param scancode The scancode of the key.
+     * @return True if the key is down, false otherwise.
+     */
+    static bool IsKeyDown(SDL_Scancode scancode);
+
+    /**
+     * Check if a key was pressed this frame.
+     * @param scancode The scancode of the key.
+     * @return True if the key went down since the last frame, false otherwise.
+     */
+    static bool IsKeyPressed(SDL_Scancode scancode);
+
+    /**
+     * Check if a key was released this frame.
+     * @param scancode The scancode of the key.
+     * @return True if the key went up since the last frame, false otherwise.
+     */
+    static bool IsKeyReleased(SDL_Scancode scancode);
+
+    /**
+     * Check if the up key is pressed.
+     * @return True if the up key is pressed, false otherwise.
+     */
+    static bool isUpKeyDown();
+
+    /**
+     * Check if the down key is pressed.
+     * @return True if the down key is pressed, false otherwise.
+     */
+    static bool isDownKeyDown();
+
+    /**
+     * Check if the left key is pressed.
+     * @return True if the left key is pressed, false otherwise.
+     */
+    static bool isLeftKeyDown();
+
+    /**
+     * Check if the right key is pressed.
+     * @return True if the right key is pressed, false otherwise.
+     */
+    static bool isRightKeyDown();
+
+    /**
+     * Check if the ESC key is pressed.
+     * @return True if the ESC key is pressed, false otherwise.
+     */
+    static bool isESCKeyDown();
+
+    /**
+     * Check if the x key is pressed.
+     * @return True if the x key is pressed, false otherwise.
+     */
+    static bool isXKeyDown();
+
+    /**
+     * Check if the e key is pressed.
+     * @return True if the e key is pressed, false otherwise.
+     */
+    static bool isEKeyDown();
+
+    /**
+     * Check if the s key is pressed.
+     * @return True if the s key is pressed, false otherwise.
+     */
+    static bool isSKeyDown();
+
+    /**
+     * Check if the z key is pressed.
+     * @return True if the z key is pressed, false otherwise.
+     */
+    static bool isZKeyDown();
+
+    /**
+     * Check if the y key is pressed.
+     * @return True if the y key is pressed, false otherwise.
+     */
+    static bool isYKeyDown();
+
+    /**
+     * Check if the 1 key is pressed.
+     * @return True if the 1 key is pressed, false otherwise.
+     */
+    static bool is1KeyDown();
+
+    /**
+     * Check if the 2 key is pressed.
+     * @return True if the 2 key is pressed, false otherwise.
+     */
+    static bool is2KeyDown();
+
+    /**
+     * Check if the 3 key is pressed.
+     * @return True if the 3 key is pressed, false otherwise.
+     */
+    static bool is3KeyDown();
+
+    /**
+     * Check if the 4 key is pressed.
+     * @return True if the 4 key is pressed, false otherwise.
+     */
+    static bool is4KeyDown();
+
+    /**
+     * Check if the 5 key is pressed.
+     * @return True if the 5 key is pressed, false otherwise.
+     */
+    static bool is5KeyDown();
+
+    /**
+     * Get the mouse click position.
+     * @return A vector of floats representing the x and y position of the mouse click.
+     */
+    static std::vector<float> GetMouseClickPosition();
+
+    /**
+     * Get the mouse position.
+     * @return A vector of floats representing the x and y position of the mouse.
+     */
+    static std::vector<float> GetMousePosition();
+
+    /**
+     * Check if the quit button is clicked.
+     * Reads the events pumped by Update, and stays true once the quit button was clicked.
+     * @return True if the quit button is clicked, false otherwise.
+     */
+    static bool isQuitClicked();
 };
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <bitset>
+#include <string>
+#include <vector>
+
+#include "InputSnapshot.hpp"
+
+/**
+ * The header at the start of an input recording file, followed by the frames.
+ * @see InputRecording
+ */
+struct InputRecordingHeader
+{
+    /**
+     * Always RECORDING_MAGIC.
+     */
+    char magic[4];
+    /**
+     * The version of the format, RECORDING_VERSION.
+     */
+    Uint32 version;
+    /**
+     * The number of frames.
+     */
+    Uint32 frameCount;
+    /**
+     * The number of key changes of all the frames together.
+     */
+    Uint32 keyChangeCount;
+    /**
+     * The ticks of the first frame in milliseconds.
+     */
+    Uint64 startTicks;
+};
+
+/**
+ * One frame of an input recording file, followed by the scancodes of its key changes as Uint16.
+ * @see InputRecording
+ */
+struct InputRecordingFrame
+{
+    /**
+     * The hash of the state of the game after the frame, 0 if none was set.
+     */
+    Uint64 stateHash;
+    /**
+     * The delta time of the frame in seconds.
+     */
+    float deltaTime;
+    /**
+     * The milliseconds since the ticks of the frame before, 0 for the first frame.
+     */
+    Uint32 elapsedMs;
+    /**
+     * The x position of the mouse.
+     */
+    float mouseX;
+    /**
+     * The y position of the mouse.
+     */
+    float mouseY;
+    /**
+     * The mouse buttons down, as SDL_BUTTON flags.
+     */
+    Uint32 mouseButtons;
+    /**
+     * The number of keys that went down or up since the frame before.
+     */
+    Uint32 keyChangeCount;
+};
+
+/**
+ * A struct that represents the input of a run of the game, frame by frame, to run it again exactly.
+ * Each frame keeps the input snapshot and the time of the frame clock: the keys as the ones that changed since the
+ * frame before, the mouse, the delta time and the ticks; about 32 bytes per frame.
+ * A hash of the state of the game can be kept with each frame, to check that a replay ends up in the same states.
+ * Recorded by Input::Update while recording, and played back by Input::Update and FrameClock::Tick while replaying.
+ * @see Input::StartRecording
+ * @see Input::StartReplay
+ * @see FrameClock
+ */
+struct InputRecording
+{
+    /**
+     * The magic bytes every recording starts with.
+     */
+    static constexpr char RECORDING_MAGIC[4] = {'S', 'D', 'I', 'R'};
+    /**
+     * The version of the format read by this InputRecording.
+     */
+    static constexpr Uint32 RECORDING_VERSION = 1;
+
+    /**
+     * Constructor for InputRecording. The recording is empty.
+     */
+    InputRecording();
+
+    /**
+     * Destructor for InputRecording.
+     */
+    ~InputRecording();
+
+    /**
+     * Add a frame.
+     * @param snapshot The input snapshot of the frame.
+     * @param deltaTime The delta time of the frame in seconds.
+     * @param ticks The ticks of the frame clock in milliseconds.
+     */
+    void Record(const InputSnapshot &snapshot, float deltaTime, Uint64 ticks);
+
+    /**
+     * Set the hash of the state of the game after the last frame added.
+     * @param hash The hash.
+     */
+    void SetStateHash(Uint64 hash);
+
+    /**
+     * Get the hash of the state of the game after a frame.
+     * @param frame The index of the frame.
+     * @return The hash, 0 if none was set or for a frame out of range.
+     */
+    Uint64 GetStateHash(int frame) const;
+
+    /**
+     * Get the delta time of a frame.
+     * @param frame The index of the frame.
+     * @return The delta time in seconds, 0 for a frame out of range.
+     */
+    float GetDeltaTime(int frame) const;
+
+    /**
+     * Get the number of frames.
+     * @return The number of frames.
+     */
+    int GetFrameCount() const;
+
+    /**
+     * Get the size the recording takes in a file.
+     * @return The size in bytes.
+     */
+    size_t GetByteSize() const;
+
+    /**
+     * Remove every frame.
+     */
+    void Clear();
+
+    /**
+     * Write the recording to a file, replacing it.
+     * @param filepath The path to the file.
+     * @return True if the file was written, false otherwise.
+     */
+    bool Save(const std::string &filepath) const;
+
+    /**
+     * Read a recording from a file, replacing this one, and rewind it.
+     * A file that is not a valid recording leaves this one as it was.
+     * @param filepath The path to the file.
+     * @return True if the file was read, false otherwise.
+     */
+    bool Load(const std::string &filepath);
+
+    /**
+     * Go back to the first frame for playing.
+     */
+    void Rewind();
+
+    /**
+     * Get the index of the frame Play plays next.
+     * @return The index of the frame.
+     */
+    int GetPosition() const;
+
+    /**
+     * Check if every frame was played.
+     * @return True if there is no frame left to play, false otherwise.
+     */
+    bool IsFinished() const;
+
+    /**
+     * Get the time of the frame Play plays next, without moving on.
+     * @param deltaTime Set to the delta time of the frame in seconds.
+     * @param ticks Set to the ticks of the frame in milliseconds.
+     * @return True if there is a frame left to play, false otherwise, and nothing is set.
+     */
+    bool PeekClock(float &deltaTime, Uint64 &ticks) const;
+
+    /**
+     * Play the next frame into an input snapshot, keeping the state it had as the previous frame, and move on.
+     * The snapshot must hold the frame played before, or no key for the first frame.
+     * @param snapshot The snapshot.
+     * @return True if a frame was played, false if there is no frame left.
+     */
+    bool Play(InputSnapshot &snapshot);
+
+private:
+    /**
+     * The frames.
+     */
+    std::vector<InputRecordingFrame> mFrames;
+    /**
+     * The scancodes of the key changes of all the frames, in order.
+     */
+    std::vector<Uint16> mKeyChanges;
+    /**
+     * The ticks of the first frame.
+     */
+    Uint64 mStartTicks{0};
+    /**
+     * The keys down in the last frame added.
+     */
+    std::bitset<SDL_NUM_SCANCODES> mRecordedKeys;
+    /**
+     * The ticks of the last frame added.
+     */
+    Uint64 mRecordedTicks{0};
+    /**
+     * The index of the frame Play plays next.
+     */
+    int mPosition{0};
+    /**
+     * The index in mKeyChanges of the first key change of the frame Play plays next.
+     */
+    size_t mKeyChangePosition{0};
+    /**
+     * The ticks of the frame played last, the start ticks before the first frame.
+     */
+    Uint64 mPlayedTicks{0};
+};
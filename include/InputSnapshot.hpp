@@ -0,0 +1,97 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <bitset>
+#include <vector>
+
+/**
+ * A struct that represents the state of the keyboard and mouse for one frame, with the state of the frame before,
+ * so that a key can be checked for being held, just pressed or just released.
+ * Taken once per frame by Input::Update; every check made during the frame sees the same state.
+ * @see Input
+ */
+struct InputSnapshot
+{
+    /**
+     * The keys down this frame, one bit per scancode.
+     */
+    std::bitset<SDL_NUM_SCANCODES> keys;
+    /**
+     * The keys down the frame before.
+     */
+    std::bitset<SDL_NUM_SCANCODES> previousKeys;
+    /**
+     * The mouse buttons down this frame, as SDL_BUTTON flags.
+     */
+    Uint32 mouseButtons{0};
+    /**
+     * The mouse buttons down the frame before.
+     */
+    Uint32 previousMouseButtons{0};
+    /**
+     * The x position of the mouse.
+     */
+    float mouseX{0.0f};
+    /**
+     * The y position of the mouse.
+     */
+    float mouseY{0.0f};
+    /**
+     * The number of the frame, counted by Input::Update.
+     */
+    Uint64 frame{0};
+
+    /**
+     * Check if a key is down.
+     * @param scancode The scancode of the key.
+     * @return True if the key is down this frame, false otherwise or for an unknown scancode.
+     */
+    bool IsKeyDown(SDL_Scancode scancode) const;
+
+    /**
+     * Check if a key was pressed this frame.
+     * @param scancode The scancode of the key.
+     * @return True if the key is down this frame and was not the frame before, false otherwise.
+     */
+    bool IsKeyPressed(SDL_Scancode scancode) const;
+
+    /**
+     * Check if a key was released this frame.
+     * @param scancode The scancode of the key.
+     * @return True if the key was down the frame before and is not this frame, false otherwise.
+     */
+    bool IsKeyReleased(SDL_Scancode scancode) const;
+
+    /**
+     * Check if a mouse button is down.
+     * @param button The button, e.g. SDL_BUTTON_LEFT.
+     * @return True if the button is down this frame, false otherwise.
+     */
+    bool IsMouseButtonDown(int button) const;
+
+    /**
+     * Check if a mouse button was pressed this frame.
+     * @param button The button, e.g. SDL_BUTTON_LEFT.
+     * @return True if the button is down this frame and was not the frame before, false otherwise.
+     */
+    bool IsMouseButtonPressed(int button) const;
+
+    /**
+     * Check if a mouse button was released this frame.
+     * @param button The button, e.g. SDL_BUTTON_LEFT.
+     * @return True if the button was down the frame before and is not this frame, false otherwise.
+     */
+    bool IsMouseButtonReleased(int button) const;
+
+    /**
+     * Get every key down this frame.
+     * @return The scancodes of the keys, in increasing order.
+     */
+    std::vector<int> GetKeysDown() const;
+
+    /**
+     * Get every key pressed this frame.
+     * @return The scancodes of the keys, in increasing order.
+     */
+    std::vector<int> GetKeysPressed() const;
+};
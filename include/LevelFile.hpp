@@ -0,0 +1,295 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The header at the start of a level file.
+ * A level file is laid out as: header, layer records, spawn records, tile type ids of each layer, string table.
+ * Every field is little-endian. Strings are referenced by their offset in the string table and end with a 0 byte.
+ * Records may grow at the end in later versions of the format: readers step through them with the record sizes
+ * of the header and only read the fields they know, the version only changes when old readers cannot cope.
+ * @see LevelFile
+ */
+struct LevelFileHeader
+{
+    /**
+     * Always LEVEL_MAGIC.
+     */
+    char magic[4];
+    /**
+     * The version of the format, LEVEL_VERSION.
+     */
+    Uint32 version;
+    /**
+     * The number of rows of every layer.
+     */
+    Uint32 rows;
+    /**
+     * The number of columns of every layer.
+     */
+    Uint32 columns;
+    /**
+     * The number of layers, the terrain first.
+     */
+    Uint32 layerCount;
+    /**
+     * The number of spawn records.
+     */
+    Uint32 spawnCount;
+    /**
+     * The size of a layer record in bytes, at least sizeof(LevelFileLayer).
+     */
+    Uint32 layerSize;
+    /**
+     * The size of a spawn record in bytes, at least sizeof(LevelFileSpawn).
+     */
+    Uint32 spawnSize;
+    /**
+     * The name of the level, in the string table.
+     */
+    Uint32 nameOffset;
+    /**
+     * The sequence number of the last edit journal record folded into this file, 0 if none.
+     * @see EditJournal
+     */
+    Uint32 journalSequence;
+    /**
+     * Where the layer records start, in bytes from the start of the file.
+     */
+    Uint64 layersOffset;
+    /**
+     * Where the spawn records start, in bytes from the start of the file.
+     */
+    Uint64 spawnsOffset;
+    /**
+     * Where the string table starts, in bytes from the start of the file.
+     */
+    Uint64 stringsOffset;
+    /**
+     * The size of the string table in bytes.
+     */
+    Uint64 stringsSize;
+};
+
+/**
+ * A layer record of a level file, one per tile layer.
+ * @see TileLayer
+ */
+struct LevelFileLayer
+{
+    /**
+     * The name of the layer, in the string table.
+     */
+    Uint32 nameOffset;
+    /**
+     * LAYER_COLLIDABLE and LAYER_FOREGROUND bits.
+     */
+    Uint32 flags;
+    /**
+     * The horizontal parallax factor of the layer.
+     */
+    float parallaxX;
+    /**
+     * The vertical parallax factor of the layer.
+     */
+    float parallaxY;
+    /**
+     * Where the tile type ids of the layer start, rows * columns of them row-major, in bytes from the start of the file.
+     */
+    Uint64 cellsOffset;
+};
+
+/**
+ * A spawn record of a level file: where an entity of the level starts.
+ */
+struct LevelFileSpawn
+{
+    /**
+     * What is spawned, "player", "enemy" or "destination", in the string table.
+     */
+    Uint32 kindOffset;
+    /**
+     * The type of the entity, like "hyena" for an enemy, in the string table. Empty if the kind has no types.
+     */
+    Uint32 typeOffset;
+    /**
+     * The number of the entity among those of its kind, 0 if unused.
+     */
+    Sint32 number;
+    /**
+     * The transform of the entity as x, y, width, height.
+     */
+    float transform[4];
+    /**
+     * The collider of the entity as x, y, width, height.
+     */
+    float collider[4];
+    /**
+     * Unused, keeps the records aligned.
+     */
+    Uint32 reserved;
+};
+
+/**
+ * A struct that represents a read-only level file, converted from the JSON levels by tools/convert_levels.py.
+ * The file is memory mapped and checked once when opened; tile layouts, spawns and strings are then read
+ * straight from the mapping without any parsing or copying.
+ * @see TileMap::LoadLevelFile
+ */
+struct LevelFile
+{
+    /**
+     * The magic bytes every level file starts with.
+     */
+    static constexpr char LEVEL_MAGIC[4] = {'S', 'D', 'E', 'L'};
+    /**
+     * The version of the format read by this LevelFile.
+     */
+    static constexpr Uint32 LEVEL_VERSION = 1;
+    /**
+     * The layer is collidable.
+     */
+    static constexpr Uint32 LAYER_COLLIDABLE = 1;
+    /**
+     * The layer is drawn over the entities.
+     */
+    static constexpr Uint32 LAYER_FOREGROUND = 2;
+
+    /**
+     * Constructor for LevelFile.
+     */
+    LevelFile();
+
+    /**
+     * Destructor for LevelFile.
+     * The file is unmapped, layouts and strings obtained from it become invalid.
+     */
+    ~LevelFile();
+
+    LevelFile(const LevelFile &) = delete;
+    LevelFile &operator=(const LevelFile &) = delete;
+
+    /**
+     * Open a level file and check it.
+     * @param filepath The path to the level file.
+     * @return True if the level file is valid, false otherwise.
+     */
+    bool Open(const std::string &filepath);
+
+    /**
+     * Close the level file.
+     * The file is unmapped unless a mapping shared by GetMapping is still held.
+     */
+    void Close();
+
+    /**
+     * Check if a level file is open.
+     * @return True if a level file is open, false otherwise.
+     */
+    bool IsOpen() const;
+
+    /**
+     * Share the mapped file, for views of it that may outlive this LevelFile or its Close, e.g. from Python.
+     * @return The start of the mapped file, nullptr when closed. The file stays mapped while it is held.
+     */
+    std::shared_ptr<const Uint8> GetMapping() const;
+
+    /**
+     * Get the name of the level.
+     * @return The name, pointing into the mapped file.
+     */
+    std::string_view GetName() const;
+
+    /**
+     * Get the number of rows of the layers.
+     * @return The number of rows.
+     */
+    int GetRowCount() const;
+
+    /**
+     * Get the number of columns of the layers.
+     * @return The number of columns.
+     */
+    int GetColumnCount() const;
+
+    /**
+     * Get the number of layers, the terrain included.
+     * @return The number of layers.
+     */
+    int GetLayerCount() const;
+
+    /**
+     * Get a layer record.
+     * @param index The index of the layer, between 0 and GetLayerCount, 0 for the terrain.
+     * @return The layer record.
+     */
+    const LevelFileLayer &GetLayer(int index) const;
+
+    /**
+     * Get the tile type ids of a layer.
+     * @param index The index of the layer.
+     * @return The ids, row-major, pointing into the mapped file.
+     */
+    const Uint16 *GetLayerCells(int index) const;
+
+    /**
+     * Get the number of spawn records.
+     * @return The number of spawns.
+     */
+    int GetSpawnCount() const;
+
+    /**
+     * Get a spawn record.
+     * @param index The index of the spawn, between 0 and GetSpawnCount.
+     * @return The spawn record.
+     */
+    const LevelFileSpawn &GetSpawn(int index) const;
+
+    /**
+     * Get a string of the string table.
+     * @param offset The offset of the string, as found in a record.
+     * @return The string, pointing into the mapped file.
+     */
+    std::string_view GetString(Uint32 offset) const;
+
+    /**
+     * Get the sequence number of the last edit journal record folded into the file.
+     * Journal records up to this number are already part of the level and must not be replayed.
+     * @return The sequence number, 0 if no edit was folded in.
+     */
+    Uint32 GetJournalSequence() const;
+
+    /**
+     * Get the size of the file.
+     * @return The size in bytes.
+     */
+    size_t GetByteSize() const;
+
+private:
+    /**
+     * Check the header and every record against the size of the file.
+     * @return True if the level file is well formed, false otherwise.
+     */
+    bool Validate() const;
+
+    /**
+     * The mapped file, nullptr when closed.
+     */
+    const Uint8 *mData{nullptr};
+    /**
+     * Owns the mapping, or the file contents when memory mapping is not available.
+     */
+    std::shared_ptr<const Uint8> mMapping;
+    /**
+     * The size of the mapped file in bytes.
+     */
+    size_t mSize{0};
+    /**
+     * The header, pointing into the mapped file.
+     */
+    const LevelFileHeader *mHeader{nullptr};
+};
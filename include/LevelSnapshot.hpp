@@ -0,0 +1,268 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GameEntity.hpp"
+#include "TileMap.hpp"
+
+/**
+ * The header at the start of a snapshot buffer.
+ * A snapshot is laid out as: header, tile type ids of each layer (padded to 4 bytes), entity records,
+ * values of the entities, string table. Strings are referenced by their offset in the string table and end with a 0 byte.
+ * @see LevelSnapshot
+ */
+struct LevelSnapshotHeader
+{
+    /**
+     * Always SNAPSHOT_MAGIC.
+     */
+    char magic[4];
+    /**
+     * The version of the format, SNAPSHOT_VERSION.
+     */
+    Uint32 version;
+    /**
+     * The number of rows of the tile map, 0 if the snapshot has no tile map.
+     */
+    Uint32 rows;
+    /**
+     * The number of columns of the tile map.
+     */
+    Uint32 columns;
+    /**
+     * The number of tile layers.
+     */
+    Uint32 layerCount;
+    /**
+     * The number of entity records.
+     */
+    Uint32 entityCount;
+    /**
+     * The number of values of all the entities together.
+     */
+    Uint32 valueCount;
+    /**
+     * The size of the string table in bytes.
+     */
+    Uint32 stringsSize;
+    /**
+     * The tile clock of the tile map.
+     */
+    double tileClock;
+};
+
+/**
+ * The state of one entity in a snapshot buffer.
+ * @see LevelSnapshot
+ */
+struct LevelSnapshotEntity
+{
+    /**
+     * The rectangle of the transform as x, y, width, height.
+     */
+    float transform[4];
+    /**
+     * The rectangle of the collider as x, y, width, height.
+     */
+    float collider[4];
+    /**
+     * The state of the entity, in the string table.
+     */
+    Uint32 stateOffset;
+    /**
+     * The state of the animation being played, in the string table.
+     */
+    Uint32 animationOffset;
+    /**
+     * The frame of the animation being played.
+     * @see SingleAnimation::GetFrame
+     */
+    Sint32 frame;
+    /**
+     * How long the frame has been shown for in milliseconds.
+     * @see SingleAnimation::GetFrameTime
+     */
+    float frameTime;
+    /**
+     * The index of the first value of the entity.
+     */
+    Uint32 valueOffset;
+    /**
+     * The number of values of the entity.
+     */
+    Uint16 valueCount;
+    /**
+     * A combination of the ENTITY_ flags of LevelSnapshot.
+     */
+    Uint16 flags;
+};
+
+/**
+ * A struct that represents the state of a running level at one moment, kept in one compact buffer:
+ * the cells of every tile layer and the tile clock, then for each entity its transform, collider, state, flip
+ * and animation playback, plus a few values the game keeps outside the engine (health, cooldowns, ...).
+ * Restoring writes the state back into the same tile map and entities, without loading or creating anything,
+ * and only the tile layers that changed are redrawn. The buffer is reused from one capture to the next,
+ * so a snapshot can be captured every frame, e.g. for rewinding or debugging.
+ * What entities are in the level is up to the caller: restore into the entities that were captured, in the same order.
+ * @see TileMap
+ * @see GameEntity
+ */
+struct LevelSnapshot
+{
+    /**
+     * The magic bytes every snapshot starts with.
+     */
+    static constexpr char SNAPSHOT_MAGIC[4] = {'S', 'D', 'E', 'S'};
+    /**
+     * The version of the format read by this LevelSnapshot.
+     */
+    static constexpr Uint32 SNAPSHOT_VERSION = 1;
+    /**
+     * Flag of an entity with a transform.
+     */
+    static constexpr Uint16 ENTITY_TRANSFORM = 1;
+    /**
+     * Flag of an entity with a collider.
+     */
+    static constexpr Uint16 ENTITY_COLLIDER = 2;
+    /**
+     * Flag of an entity whose collider is a trigger.
+     */
+    static constexpr Uint16 ENTITY_TRIGGER = 4;
+    /**
+     * Flag of a flipped entity.
+     */
+    static constexpr Uint16 ENTITY_FLIP = 8;
+    /**
+     * Flag of an entity with animations.
+     */
+    static constexpr Uint16 ENTITY_ANIMATION = 16;
+
+    /**
+     * Constructor for LevelSnapshot. The snapshot is empty until captured.
+     */
+    LevelSnapshot();
+
+    /**
+     * Destructor for LevelSnapshot.
+     */
+    ~LevelSnapshot();
+
+    /**
+     * Capture the state of a level, replacing the previous one.
+     * @param tilemap The tile map of the level, may be nullptr.
+     * @param entities The entities of the level.
+     * @param values Values to keep with each entity, in the same order as the entities; may be shorter than them.
+     * At most 65535 values per entity.
+     */
+    void Capture(std::shared_ptr<TileMap> tilemap, const std::vector<std::shared_ptr<GameEntity>> &entities,
+                 const std::vector<std::vector<float>> &values = {});
+
+    /**
+     * Restore the captured state into a tile map and entities.
+     * Nothing changes if the tile map does not have the size and layers it had, or the number of entities differs.
+     * The tile types must still be the ones the cells were captured with.
+     * @param tilemap The tile map that was captured, may be nullptr to restore the entities only.
+     * @param entities The entities that were captured, in the same order.
+     * @return True if the state was restored, false otherwise.
+     */
+    bool Restore(std::shared_ptr<TileMap> tilemap, const std::vector<std::shared_ptr<GameEntity>> &entities) const;
+
+    /**
+     * Check if the snapshot is empty.
+     * @return True if nothing was captured or set yet, false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Get the number of entities captured.
+     * @return The number of entities.
+     */
+    int GetEntityCount() const;
+
+    /**
+     * Get the values kept with an entity.
+     * @param entity The index of the entity.
+     * @return The values, empty for an index out of range.
+     */
+    std::vector<float> GetValues(int entity) const;
+
+    /**
+     * Get the buffer holding the snapshot, e.g. to keep it for later or write it to a file.
+     * @return The buffer, empty if nothing was captured.
+     */
+    const std::vector<Uint8> &GetBuffer() const;
+
+    /**
+     * Replace the snapshot with a buffer from GetBuffer.
+     * A buffer that is not valid leaves the snapshot as it was.
+     * @param buffer The buffer.
+     * @return True if the buffer is a valid snapshot, false otherwise.
+     */
+    bool SetBuffer(std::vector<Uint8> buffer);
+
+    /**
+     * Get the size of the snapshot.
+     * @return The size in bytes.
+     */
+    size_t GetByteSize() const;
+
+    /**
+     * Get a hash of the snapshot, e.g. to check that two runs of the game went through the same states.
+     * @return The hash, the same for two snapshots of the same state.
+     */
+    Uint64 GetHash() const;
+
+private:
+    /**
+     * Check that a buffer holds a whole snapshot whose references stay inside it.
+     * @param buffer The buffer.
+     * @return True if the buffer is valid, false otherwise.
+     */
+    static bool Validate(const std::vector<Uint8> &buffer);
+
+    /**
+     * Add a string to the string table being captured, once.
+     * @param text The string.
+     * @return The offset of the string in the table.
+     */
+    Uint32 AddString(const std::string &text);
+
+    /**
+     * Get the header of the buffer, which must not be empty.
+     * @return The header.
+     */
+    const LevelSnapshotHeader &GetHeader() const;
+
+    /**
+     * Get the entity records of the buffer, which must not be empty.
+     * @return The first entity record.
+     */
+    const LevelSnapshotEntity *GetEntities() const;
+
+    /**
+     * Get a string of the string table.
+     * @param offset The offset of the string.
+     * @return The string.
+     */
+    const char *GetString(Uint32 offset) const;
+
+    /**
+     * The snapshot, empty until captured.
+     */
+    std::vector<Uint8> mBuffer;
+    /**
+     * Where the string table starts in mBuffer.
+     */
+    size_t mStringsOffset{0};
+    /**
+     * The strings added to the string table by the capture running, with their offset.
+     * Kept between captures so that its storage is reused.
+     */
+    std::vector<std::pair<std::string, Uint32>> mStrings;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+/**
+ * Pixel passes run on images at load or pack time. Every image is ARGB8888.
+ * Each pass has a scalar, an SSE2 and an AVX2 kernel; the plain function picks the widest one the CPU supports.
+ * On other architectures the SSE2 and AVX2 kernels fall back to the scalar one.
+ */
+
+/**
+ * Turn the color key of an image into alpha, in place.
+ * Pixels matching the key become fully transparent black, every other pixel keeps its color and its own alpha,
+ * so sprites with an alpha channel stay as they were drawn. Partly transparent pixels still need PremultiplyAlpha.
+ * @param pixels The first pixel of the image.
+ * @param width The width of the image in pixels.
+ * @param height The height of the image in pixels.
+ * @param pitch The length of a row in bytes.
+ * @param colorKey The color key as 0xRRGGBB.
+ */
+void ColorKeyToAlpha(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey);
+
+/**
+ * Multiply the color channels of an image by its alpha, in place, rounding to nearest.
+ * Premultiplied textures must be drawn with GetPremultipliedBlendMode.
+ * @param pixels The first pixel of the image.
+ * @param width The width of the image in pixels.
+ * @param height The height of the image in pixels.
+ * @param pitch The length of a row in bytes.
+ */
+void PremultiplyAlpha(Uint32 *pixels, int width, int height, int pitch);
+
+/**
+ * Get the blend mode drawing premultiplied textures: dst = src + dst * (1 - srcA).
+ * @return The blend mode.
+ */
+SDL_BlendMode GetPremultipliedBlendMode();
+
+/**
+ * The kernels behind ColorKeyToAlpha, exposed for the benchmarks. The caller checks the CPU support.
+ */
+void ColorKeyToAlphaScalar(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey);
+void ColorKeyToAlphaSSE2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey);
+void ColorKeyToAlphaAVX2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey);
+
+/**
+ * The kernels behind PremultiplyAlpha, exposed for the benchmarks. The caller checks the CPU support.
+ */
+void PremultiplyAlphaScalar(Uint32 *pixels, int width, int height, int pitch);
+void PremultiplyAlphaSSE2(Uint32 *pixels, int width, int height, int pitch);
+void PremultiplyAlphaAVX2(Uint32 *pixels, int width, int height, int pitch);
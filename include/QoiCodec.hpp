@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * A lossless image codec following the QOI format (https://qoiformat.org), without any dependency.
+ * Pixels go in and out as ARGB8888, the layout of the engine textures.
+ * Runs of identical pixels, like the transparent background of a sprite, are stored as a single byte,
+ * so sprites take a fraction of their BMP size on disk and in the page cache.
+ */
+
+/**
+ * Encode an image.
+ * @param pixels The first pixel of the image, ARGB8888.
+ * @param width The width of the image in pixels.
+ * @param height The height of the image in pixels.
+ * @param pitch The length of a row in bytes.
+ * @param out Receives the encoded file.
+ * @return True on success, false if the size is not supported.
+ */
+bool QoiEncode(const Uint32 *pixels, int width, int height, int pitch, std::vector<Uint8> &out);
+
+/**
+ * Read the size of an encoded image.
+ * @param data The encoded file.
+ * @param size The size of the encoded file in bytes.
+ * @param width Receives the width of the image in pixels.
+ * @param height Receives the height of the image in pixels.
+ * @return True if the header is valid, false otherwise.
+ */
+bool QoiReadHeader(const Uint8 *data, size_t size, int *width, int *height);
+
+/**
+ * Decode an image into a buffer sized from QoiReadHeader.
+ * @param data The encoded file.
+ * @param size The size of the encoded file in bytes.
+ * @param pixels The first pixel of the destination, ARGB8888.
+ * @param pitch The length of a destination row in bytes.
+ * @return True on success, false if the file is invalid or truncated.
+ */
+bool QoiDecode(const Uint8 *data, size_t size, Uint32 *pixels, int pitch);
+
+/**
+ * Load a QOI file into a new ARGB8888 surface.
+ * @param filepath The path to the file.
+ * @return The surface, or nullptr on failure. The caller destroys it.
+ */
+SDL_Surface *QoiLoadSurface(const std::string &filepath);
+
+/**
+ * Write an ARGB8888 surface to a QOI file.
+ * @param surface The surface to write.
+ * @param filepath The path to the file.
+ * @return True on success, false otherwise.
+ */
+bool QoiSaveSurface(SDL_Surface *surface, const std::string &filepath);
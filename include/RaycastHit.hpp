@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * A struct that represents the result of a raycast on a TileMap.
+ * When nothing is hit, row and column are -1 and the distance is the distance travelled.
+ * @see TileMap::Raycast
+ */
+struct RaycastHit
+{
+    bool hit{false};
+    int row{-1};
+    int column{-1};
+    float distance{0.0f};
+    float x{0.0f};
+    float y{0.0f};
+};
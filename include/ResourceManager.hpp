@@ -1,125 +1,509 @@
-#pragma once
-
-#include <SDL3/SDL.h>
-#include <unordered_map>
-#include <string>
-#include <memory>
-#include <thread>
-#include <mutex>
-
-/**
- * Functor to be used as a custom deleter when creating the shared pointer.
- * This functor will be used to destroy the SDL_Texture when the shared pointer goes out of scope.
- */
-struct TextureFunctorDeleter
-{
-    /**
-     * Overloaded function call operator to destroy the SDL_Texture.
-     * @param pTexture The SDL_Texture to destroy.
-     */
-    void operator()(SDL_Texture *pTexture) const
-    {
-        SDL_DestroyTexture(pTexture);
-    }
-};
-
-// Function declaration to create a shared pointer to a texture
-std::shared_ptr<SDL_Texture> make_shared_texture(SDL_Renderer *renderer, SDL_Surface *pixels);
-
-/**
- * A singleton class that manages the resources of the game.
- * This class is responsible for loading and storing textures.
- */
-struct ResourceManager
-{
-    /**
-     * Used to get the singleton instance of the ResourceManager.
-     * If the instance does not exist, it will be created.
-     */
-    static ResourceManager &Instance() // Just like *, here the & is used to return a reference of ReserouceManager type to the object
-    {
-        if (nullptr == mInstance)
-        {
-            mInstance = new ResourceManager();
-        }
-        return *mInstance; // De-referencing the pointer to get the object since we're returning a reference
-    }
-
-    /**
-     * Load a texture from a file.
-     * If the texture has already been loaded, it will be reused.
-     * @param renderer The renderer to use to create the texture.
-     * @param filepath The path to the texture file.
-     * @return A shared pointer to the texture.
-     */
-    std::shared_ptr<SDL_Texture> LoadTexture(SDL_Renderer *renderer, std::string filepath)
-    // Changed from const char* to std::string for better key uniqueness than const char* which eveually is a pointer of address
-    {
-        std::lock_guard<std::mutex> lock(mMutex); //!< Lock the mutex to prevent from multiple threads accessing the resource at the same time
-
-        /** C++ 20 just uses contains method
-         * If don't have C++ 20, use find method:
-         * - if(mTextureResources.find(filepath) != mTextureResources.end()）{...}
-         */
-        if (!mTextureResources.contains(filepath))
-        {
-            SDL_Surface *pixels = SDL_LoadBMP(filepath.c_str()); //!< Changed from std::string to const char* for SDL_LoadBMP
-
-            /**
-             *  Get rid of the background
-             */
-            SDL_SetSurfaceColorKey(pixels, SDL_TRUE, SDL_MapRGB(pixels->format, COLOR_KEY_R, COLOR_KEY_G, COLOR_KEY_B));
-
-            std::shared_ptr<SDL_Texture> texture = make_shared_texture(renderer, pixels);
-            mTextureResources.insert({filepath, texture});
-
-            SDL_DestroySurface(pixels);
-            SDL_Log("Created new resource %s", filepath.c_str());
-        }
-        // else
-        // {
-        //     SDL_Log("Reused resource %s", filepath.c_str());
-        // }
-
-        return mTextureResources[filepath];
-    }
-
-private:
-    /**
-     * Mutex to prevent multiple threads from accessing the resources at the same time.
-     */
-    std::mutex mMutex;
-    /**
-     * The color key - r to use when loading textures.
-     */
-    int COLOR_KEY_R = 0;
-    /**
-     * The color key - g to use when loading textures.
-     */
-    int COLOR_KEY_G = 0;
-    /**
-     * The color key - b to use when loading textures.
-     */
-    int COLOR_KEY_B = 0;
-
-    /**
-     * Private Constructor for ResourceManager.
-     * This is a singleton class so the constructor is private.
-     */
-    ResourceManager()
-    {
-    }
-
-    // inline is sort of easier to deal with, though it's exposing some info
-    /**
-     * The singleton instance of the ResourceManager.
-     */
-    inline static ResourceManager *mInstance{nullptr};
-
-    /**
-     * A map of the texture resources.
-     * The key is the filepath of the texture.
-     * The value is a shared pointer to the texture.
-     */
-    std::unordered_map<std::string, std::shared_ptr<SDL_Texture>> mTextureResources;
-};
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <deque>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+
+#include "TextureHandle.hpp"
+#include "ThreadPool.hpp"
+#include "AssetArchive.hpp"
+#include "AssetWatcher.hpp"
+
+/**
+ * Functor to be used as a custom deleter when creating the shared pointer.
+ * This functor will be used to destroy the SDL_Texture when the shared pointer goes out of scope.
+ */
+struct TextureFunctorDeleter
+{
+    /**
+     * Overloaded function call operator to destroy the SDL_Texture.
+     * @param pTexture The SDL_Texture to destroy.
+     */
+    void operator()(SDL_Texture *pTexture) const
+    {
+        SDL_DestroyTexture(pTexture);
+    }
+};
+
+// Function declaration to create a shared pointer to a texture
+std::shared_ptr<SDL_Texture> make_shared_texture(SDL_Renderer *renderer, SDL_Surface *pixels);
+
+/**
+ * A singleton class that manages the resources of the game.
+ * This class is responsible for loading and storing textures.
+ * Resident textures are accounted in bytes against a memory budget. Once over budget, the least recently
+ * used textures that nobody holds a handle to are evicted. Textures pinned by a level are never evicted.
+ */
+struct ResourceManager
+{
+    /**
+     * Used to get the singleton instance of the ResourceManager.
+     * If the instance does not exist, it will be created.
+     */
+    static ResourceManager &Instance() // Just like *, here the & is used to return a reference of ReserouceManager type to the object
+    {
+        if (nullptr == mInstance)
+        {
+            mInstance = new ResourceManager();
+        }
+        return *mInstance; // De-referencing the pointer to get the object since we're returning a reference
+    }
+
+    /**
+     * Destroy the singleton instance, if any.
+     * Stops the decoders and releases every texture, so it must be called before SDL_Quit.
+     * Handles still held elsewhere stay valid but are no longer ready.
+     */
+    static void Destroy()
+    {
+        delete mInstance;
+        mInstance = nullptr;
+    }
+
+    /**
+     * Destructor for ResourceManager.
+     */
+    ~ResourceManager();
+
+    /**
+     * Load a texture from a file without blocking.
+     * If the texture has already been requested, the same handle is reused; this path never takes a lock
+     * unless a level scope is open or the texture was evicted, in which case it is loaded again.
+     * Otherwise the file is decoded into an SDL_Surface on a worker thread, the color key is applied there too,
+     * and the surface waits in the upload queue until ProcessUploads turns it into a texture on the main thread.
+     * @param filepath The path to the texture file.
+     * @param priority The priority of the decode, if one is needed. A decode already queued keeps its priority.
+     * @return A handle to the texture, not ready until uploaded, and failed if the asset cannot be decoded or uploaded.
+     * @see TextureHandle
+     * @see ProcessUploads
+     */
+    std::shared_ptr<TextureHandle> LoadTextureAsync(std::string filepath, JobPriority priority = JobPriority::High);
+
+    /**
+     * Mount a packed asset archive.
+     * Textures found in a mounted archive are created straight from its mapped pixels, without any decode.
+     * Archives mounted last are searched first. Can be called while textures load, but only the textures requested
+     * after it returns are found in the archive.
+     * @param filepath The path to the archive.
+     * @return True if the archive was mounted, false otherwise.
+     * @see AssetArchive
+     */
+    bool MountArchive(std::string filepath);
+
+    /**
+     * Create textures from the decoded surfaces waiting in the upload queue.
+     * Must be called from the thread owning the renderer, once per frame.
+     * Stops as soon as the time budget is used up, at least one upload is done if any is waiting.
+     * Textures are then evicted if the memory budget is exceeded.
+     * @param renderer The renderer to create the textures with.
+     * @param budgetNS The time budget in nanoseconds.
+     * @return The number of textures uploaded.
+     */
+    int ProcessUploads(SDL_Renderer *renderer, Uint64 budgetNS);
+
+    /**
+     * Get the number of decoded surfaces waiting to be uploaded.
+     * @return The number of pending uploads.
+     */
+    int GetPendingUploadCount();
+
+    /**
+     * Wait for every decode submitted so far and upload every texture, whatever the time it takes.
+     * Used to start a level with all its textures ready, so that a run does not depend on how fast they load,
+     * e.g. when recording or replaying input. Must be called from the thread owning the renderer.
+     * @param renderer The renderer to create the textures with.
+     * @return The number of textures uploaded.
+     */
+    int FinishLoads(SDL_Renderer *renderer);
+
+    /**
+     * Get the number of decode jobs started so far.
+     * Concurrent requests for the same asset share a single decode, reloads after an eviction count again.
+     * @return The number of decodes.
+     */
+    int GetDecodeCount() const;
+
+    /**
+     * Load an evicted texture again, keeping its handle.
+     * Does nothing unless the handle is evicted, so it is cheap to call every frame while a handle is not ready.
+     * @param handle The handle to restore.
+     */
+    void Restore(const std::shared_ptr<TextureHandle> &handle);
+
+    /**
+     * Watch the files of the loaded textures, and load a texture again when its file changes on disk.
+     * The new pixels are decoded on the workers and swapped into the existing handle by ProcessUploads,
+     * so nothing holding the handle has to be rebuilt. Bursts of writes to a file cause a single reload.
+     * Edited files are read from disk even if a mounted archive holds an older copy.
+     * Only supported on Linux. Until enabled, nothing is watched and the frame does no extra work.
+     * @param debounceMS How long a file must go without writes before it is reloaded, in milliseconds.
+     * @return True if hot reload is enabled, false otherwise.
+     * @see AssetWatcher
+     */
+    bool EnableHotReload(Uint32 debounceMS = 100);
+
+    /**
+     * Stop watching the files of the loaded textures.
+     */
+    void DisableHotReload();
+
+    /**
+     * Check if hot reload is enabled.
+     * @return True if enabled, false otherwise.
+     */
+    bool IsHotReloadEnabled() const;
+
+    /**
+     * Get the number of textures reloaded because their file changed.
+     * Counted by ProcessUploads once the new texture is swapped in, so that caches drawn with the textures,
+     * like the layers of a TileMap, can tell when to draw again.
+     * @return The number of reloads.
+     */
+    int GetReloadCount() const;
+
+    /**
+     * Choose whether textures are loaded with premultiplied alpha and drawn with the matching blend mode.
+     * Premultiplied textures keep their edges clean when scaled. Must be set before any texture is requested.
+     * @param premultiplied True for premultiplied alpha, false for straight alpha.
+     * @see GetPremultipliedBlendMode
+     */
+    void SetPremultipliedAlpha(bool premultiplied);
+
+    /**
+     * Check whether textures are loaded with premultiplied alpha.
+     * @return True for premultiplied alpha, false for straight alpha.
+     */
+    bool IsPremultipliedAlpha() const;
+
+    /**
+     * Set the memory budget of the resident textures.
+     * The budget is enforced at the end of every ProcessUploads.
+     * @param bytes The budget in bytes, 0 for no budget.
+     */
+    void SetMemoryBudget(size_t bytes);
+
+    /**
+     * Get the memory budget of the resident textures.
+     * @return The budget in bytes, 0 for no budget.
+     */
+    size_t GetMemoryBudget() const;
+
+    /**
+     * Get the memory used by the resident textures.
+     * @return The memory usage in bytes.
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * Get the number of resident textures.
+     * @return The number of textures currently uploaded.
+     */
+    int GetResidentCount() const;
+
+    /**
+     * Get the number of evictions so far.
+     * @return The number of evicted textures.
+     */
+    int GetEvictionCount() const;
+
+    /**
+     * Evict every resident texture that nobody holds a handle to, whatever the budget.
+     * Only to be called from the main thread.
+     * @return The number of textures evicted.
+     */
+    int EvictUnused();
+
+    /**
+     * Open a level scope: every texture requested until EndLevelScope is pinned to the level.
+     * Only one scope is open at a time, opening another one closes the previous one.
+     * @param levelId The id of the level.
+     */
+    void BeginLevelScope(int levelId);
+
+    /**
+     * Close the open level scope. The textures stay pinned until ReleaseLevel.
+     */
+    void EndLevelScope();
+
+    /**
+     * Warm the cache with the textures of a level in the background.
+     * The decodes run at low priority, so they never delay the textures of the level being played.
+     * The textures are pinned to the level until ReleaseLevel.
+     * @param levelId The id of the level.
+     * @param filepaths The paths of the textures the level uses.
+     */
+    void PrefetchLevel(int levelId, const std::vector<std::string> &filepaths);
+
+    /**
+     * Check if every texture pinned to a level has been uploaded, or failed to load.
+     * @param levelId The id of the level.
+     * @return True if the level has pinned textures and none of them is still loading or evicted, false otherwise.
+     */
+    bool IsLevelResident(int levelId);
+
+    /**
+     * Move the decodes of a level still waiting at low priority ahead of the other low priority work.
+     * Called when the level a PrefetchLevel warmed is entered before its textures are resident.
+     * @param levelId The id of the level.
+     * @return The number of decodes promoted.
+     */
+    int PromoteLevel(int levelId);
+
+    /**
+     * Unpin the textures of a level. They can be evicted once nobody else holds their handle.
+     * @param levelId The id of the level.
+     */
+    void ReleaseLevel(int levelId);
+
+private:
+    /**
+     * A decoded surface waiting to be turned into a texture on the main thread.
+     */
+    struct PendingUpload
+    {
+        std::shared_ptr<TextureHandle> handle;
+        /**
+         * The decoded surface, nullptr when the pixels come from an archive.
+         */
+        SDL_Surface *surface;
+        /**
+         * The archive holding the pixels, nullptr when they come from a surface.
+         */
+        const AssetArchive *archive;
+        /**
+         * The entry of the asset in the archive.
+         */
+        const AssetArchiveEntry *entry;
+        /**
+         * Which pixels of the surface are opaque, built by the worker. nullptr for archives.
+         */
+        std::shared_ptr<const AlphaMask> alphaMask;
+        /**
+         * Whether the pixels were decoded again because the file changed.
+         */
+        bool reload;
+    };
+
+    /**
+     * Decode a file into an ARGB8888 surface with the color key turned into alpha.
+     * BMP files go through SDL_LoadBMP, QOI files through the built-in codec and already have alpha.
+     * Safe to call from any thread, it does not touch the renderer.
+     * @param filepath The path to the texture file.
+     * @return The decoded surface, or nullptr on failure.
+     */
+    SDL_Surface *DecodeSurface(const std::string &filepath);
+
+    /**
+     * Queue the decode of a handle's asset on the workers, or its upload right away if a mounted archive holds it.
+     * @param handle The handle to decode the asset of.
+     * @param promise Completed once the decode is over, or nullptr.
+     * @param priority The priority of the decode.
+     */
+    void SubmitDecode(std::shared_ptr<TextureHandle> handle, std::shared_ptr<std::promise<bool>> promise, JobPriority priority);
+
+    /**
+     * Queue the decode of a handle's asset on the workers, skipping the mounted archives.
+     * @param handle The handle to decode the asset of.
+     * @param promise Completed once the decode is over, with false if the workers stopped before it started, or nullptr.
+     * @param priority The priority of the decode.
+     * @param reload Whether the file changed, counted as a reload once the new texture is swapped in.
+     */
+    void SubmitFileDecode(std::shared_ptr<TextureHandle> handle, std::shared_ptr<std::promise<bool>> promise, JobPriority priority, bool reload = false);
+
+    /**
+     * Load the texture of a changed file again. Called on the watcher thread.
+     * Evicted textures are left alone, they are read from the new file when restored.
+     * @param filepath The path of the changed file, as the texture was requested with.
+     */
+    void OnAssetChanged(const std::string &filepath);
+
+    /**
+     * Pin a handle to the open level scope, if any.
+     * @param handle The handle to pin.
+     */
+    void PinToLevelScope(const std::shared_ptr<TextureHandle> &handle);
+
+    /**
+     * Evict the least recently used textures nobody holds a handle to.
+     * Only to be called from the main thread.
+     * @param targetBytes Eviction stops once the memory usage is at or under this value.
+     * @return The number of textures evicted.
+     */
+    int EvictUntil(size_t targetBytes);
+
+    /**
+     * An immutable map of filepath to handle, replaced as a whole on every insert.
+     * The handles are owned by mHandles, so that a handle nobody else holds has a use count of 1
+     * no matter how many snapshots are still alive.
+     */
+    using HandleMap = std::unordered_map<std::string, TextureHandle *>;
+
+    /**
+     * A slice of the texture cache, picked by the hash of the filepath.
+     * Readers look up their thread's copy of the snapshot without taking any lock.
+     * Writers copy the snapshot, insert, and publish the copy, serialized by the shard mutex.
+     * Textures are few and inserted once, so copying a shard on insert is cheap.
+     */
+    struct CacheShard
+    {
+        std::mutex writeMutex;
+        std::atomic<std::shared_ptr<const HandleMap>> snapshot{std::make_shared<const HandleMap>()};
+        /**
+         * Bumped after every publish, so that readers only reload the snapshot when it changed.
+         */
+        std::atomic<uint64_t> version{0};
+    };
+
+    /**
+     * A reader's copy of a shard snapshot, kept per thread.
+     * Loading the shared snapshot touches its reference count, which every reader would fight over,
+     * while comparing versions is a plain atomic read.
+     */
+    struct LocalSnapshot
+    {
+        uint64_t version{UINT64_MAX};
+        std::shared_ptr<const HandleMap> map;
+    };
+
+    /**
+     * Get the index of the shard a filepath belongs to.
+     * @param filepath The path to the texture file.
+     * @return The shard index.
+     */
+    static size_t GetShardIndex(const std::string &filepath);
+
+    /**
+     * The number of cache shards. Writers to different shards never wait for each other.
+     */
+    static constexpr size_t NUM_SHARDS = 16;
+    /**
+     * The texture cache.
+     * The key is the filepath of the texture.
+     * The value is a shared pointer to the texture handle, which may still be loading.
+     */
+    std::array<CacheShard, NUM_SHARDS> mShards;
+    /**
+     * The generation of this manager, different for every manager created.
+     * The per-thread snapshots are keyed on it: the versions of a new manager start over,
+     * so a snapshot left by a destroyed manager could otherwise pass for a current one.
+     */
+    const uint64_t mGeneration{++mGenerations};
+    /**
+     * The number of decode jobs started so far.
+     */
+    std::atomic<int> mDecodeCount{0};
+    /**
+     * The number of decode jobs submitted and not finished yet.
+     */
+    std::atomic<int> mDecodesRunning{0};
+    /**
+     * Mutex protecting the handle list and the level pins.
+     */
+    std::mutex mResidencyMutex;
+    /**
+     * Every handle ever created, owning them.
+     */
+    std::vector<std::shared_ptr<TextureHandle>> mHandles;
+    /**
+     * The handles pinned by each level. Holding the handles keeps them from being evicted.
+     */
+    std::unordered_map<int, std::unordered_set<std::shared_ptr<TextureHandle>>> mLevelPins;
+    /**
+     * The level whose scope is open, -1 for none.
+     */
+    std::atomic<int> mActiveLevel{-1};
+    /**
+     * The memory budget in bytes, 0 for no budget.
+     */
+    size_t mMemoryBudget{0};
+    /**
+     * The memory used by the resident textures in bytes.
+     */
+    std::atomic<size_t> mMemoryUsage{0};
+    /**
+     * The number of textures currently uploaded.
+     */
+    std::atomic<int> mResidentCount{0};
+    /**
+     * The number of evictions so far.
+     */
+    std::atomic<int> mEvictionCount{0};
+    /**
+     * The mounted archives, searched last to first. Never unmounted, so the pending uploads can point into them.
+     */
+    std::vector<std::unique_ptr<AssetArchive>> mArchives;
+    /**
+     * Mutex protecting the list of archives, mounted on one thread while others look textures up in it.
+     */
+    std::shared_mutex mArchivesMutex;
+    /**
+     * Mutex protecting the upload queue.
+     */
+    std::mutex mUploadMutex;
+    /**
+     * The decoded surfaces waiting to be uploaded, oldest first.
+     */
+    std::deque<PendingUpload> mUploads;
+    /**
+     * The workers decoding the assets.
+     * Leaves a core to the main thread, and more than 4 decoders only fight over the disk.
+     */
+    ThreadPool mDecodePool{static_cast<int>(std::clamp(std::thread::hardware_concurrency(), 2u, 5u)) - 1};
+    /**
+     * Watches the files of the loaded textures while hot reload is enabled.
+     */
+    AssetWatcher mWatcher;
+    /**
+     * Whether hot reload is enabled, read when a new texture is requested.
+     */
+    std::atomic<bool> mHotReload{false};
+    /**
+     * The number of reloaded textures swapped in so far.
+     */
+    std::atomic<int> mReloadCount{0};
+    /**
+     * Whether textures are loaded with premultiplied alpha, read by the decode workers.
+     */
+    std::atomic<bool> mPremultipliedAlpha{false};
+    /**
+     * The color key - r to use when loading textures.
+     */
+    int COLOR_KEY_R = 0;
+    /**
+     * The color key - g to use when loading textures.
+     */
+    int COLOR_KEY_G = 0;
+    /**
+     * The color key - b to use when loading textures.
+     */
+    int COLOR_KEY_B = 0;
+
+    /**
+     * Private Constructor for ResourceManager.
+     * This is a singleton class so the constructor is private.
+     */
+    ResourceManager()
+    {
+    }
+
+    // inline is sort of easier to deal with, though it's exposing some info
+    /**
+     * The singleton instance of the ResourceManager.
+     */
+    inline static ResourceManager *mInstance{nullptr};
+
+    /**
+     * The number of managers created so far.
+     */
+    inline static std::atomic<uint64_t> mGenerations{0};
+};
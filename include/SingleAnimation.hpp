@@ -1,137 +1,182 @@
-#pragma once
-
-#include <SDL3/SDL.h>
-#include <memory>
-#include <string>
-
-#include "SDLGraphicsProgram.hpp"
-#include "GameEntity.hpp"
-
-// Animation is not a component as one object could have multiple animations
-/**
- * A struct that represents a single animation.
- * Note that this is not a component.
- * Used to create and render a single animation to be held by an AnimationComponent.
- * @see AnimationComponent
- */
-struct SingleAnimation
-{
-    /**
-     * Constructor for SingleAnimation.
-     * Note that the texture is not loaded here. It is loaded in CreateAnimation.
-     * @see CreateAnimation
-     */
-    SingleAnimation();
-
-    /**
-     * Create an animation from a file.
-     * To speed up the loading process, the texture is loaded in a separate thread.
-     * Note that the configuration of the frame must be set after the texture is loaded.
-     * @param game The game to render to as an SDLGraphicsProgram.
-     * @param filepath The path to the file to load.
-     * @see SetFrameConfig
-     */
-    void CreateAnimation(std::shared_ptr<SDLGraphicsProgram> game, std::string filepath);
-
-    /**
-     * Destructor for SingleAnimation.
-     */
-    ~SingleAnimation();
-
-    /**
-     * Set the configuration of the frame.
-     * @param x The x position of the frame.
-     * @param y The y position of the frame.
-     * @param w The width of the frame.
-     * @param w_offset The offset of the width of the frame.
-     * @param h The height of the frame.
-     * @param maxFrame The maximum number of frames.
-     * @param millisecond_duration The duration of the frame in milliseconds.
-     * @param repeat Whether the animation should repeat.
-     */
-    void SetFrameConfig(int x, int y, int w, int w_offset, int h, int maxFrame, int millisecond_duration, bool repeat);
-
-    /**
-     * Get the width of the frame.
-     * @return The width of the frame.
-     */
-    int GetW() const;
-
-    /**
-     * Get the height of the frame.
-     * @return The height of the frame.
-     */
-    int GetH() const;
-
-    /**
-     * Get the duration of the frame.
-     * @return The duration of the frame.
-     */
-    int GetDuration();
-
-    /**
-     * Reset the frame to the initial frame.
-     */
-    void ResetFrame();
-
-    /**
-     * Update the frame.
-     * Only updates the frame if the duration of the frame has passed.
-     * When the last frame is reached, the frame is reset if the animation is set to repeat.
-     * @see GetDuration
-     */
-    void UpdateFrame();
-
-    /**
-     * Render the frame.
-     * Frame will be flipped if the associated game entity's mFlip is set to true.
-     * If no texture is set, only the source rectangle will be rendered.
-     * @param game The game to render to as an SDLGraphicsProgram.
-     * @param ge The GameEntity to render the frame to.
-     */
-    void RenderFrame(std::shared_ptr<SDLGraphicsProgram> game, std::shared_ptr<GameEntity> ge);
-
-private:
-    /**
-     * The future for the texture.
-     * Used to load the texture in a separate thread.
-     */
-    std::future<std::shared_ptr<SDL_Texture>> futureTexture;
-    /**
-     * The texture of the animation.
-     */
-    std::shared_ptr<SDL_Texture> mTexture;
-    /**
-     * The source rectangle of the frame.
-     */
-    SDL_FRect mRect_src{0.0f, 0.0f, 0.0f, 0.0f};
-    /**
-     * The x position of the initial frame.
-     */
-    int initialX;
-    /**
-     * The offset of the width of the frame.
-     */
-    int offsetW;
-    /**
-     * The maximum number of frames.
-     */
-    int mMaxFrame;
-    /**
-     * The duration of each frame in milliseconds.
-     */
-    int mFrameDuration;
-    /**
-     * The current frame.
-     */
-    int currFrame = -1;
-    /**
-     * The start time of the frame.
-     * Used to calculate the duration of the frame.
-     */
-    float frameStartTime{0.0f};
-    /**
-     * Whether the animation should repeat.
-     */
-    bool mRepeat;
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SDLGraphicsProgram.hpp"
+#include "GameEntity.hpp"
+#include "TextureHandle.hpp"
+
+// Animation is not a component as one object could have multiple animations
+/**
+ * A struct that represents a single animation.
+ * Note that this is not a component.
+ * Used to create and render a single animation to be held by an AnimationComponent.
+ * @see AnimationComponent
+ */
+struct SingleAnimation
+{
+    /**
+     * Constructor for SingleAnimation.
+     * Note that the texture is not loaded here. It is loaded in CreateAnimation.
+     * @see CreateAnimation
+     */
+    SingleAnimation();
+
+    /**
+     * Create an animation from a file.
+     * To speed up the loading process, the texture is decoded on a worker thread and uploaded later by the main thread.
+     * Note that the configuration of the frame must be set after the texture is loaded.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @param filepath The path to the file to load.
+     * @see SetFrameConfig
+     */
+    void CreateAnimation(std::shared_ptr<SDLGraphicsProgram> game, std::string filepath);
+
+    /**
+     * Destructor for SingleAnimation.
+     */
+    ~SingleAnimation();
+
+    /**
+     * Set the configuration of the frame.
+     * @param x The x position of the frame.
+     * @param y The y position of the frame.
+     * @param w The width of the frame.
+     * @param w_offset The offset of the width of the frame.
+     * @param h The height of the frame.
+     * @param maxFrame The maximum number of frames.
+     * @param millisecond_duration The duration of the frame in milliseconds.
+     * @param repeat Whether the animation should repeat.
+     */
+    void SetFrameConfig(int x, int y, int w, int w_offset, int h, int maxFrame, int millisecond_duration, bool repeat);
+
+    /**
+     * Get the width of the frame.
+     * @return The width of the frame.
+     */
+    int GetW() const;
+
+    /**
+     * Get the height of the frame.
+     * @return The height of the frame.
+     */
+    int GetH() const;
+
+    /**
+     * Get the smallest rectangle holding the opaque pixels of every frame, relative to the frame.
+     * Known once the texture has been uploaded.
+     * @param bounds Set to the bounds, in pixels of the frame.
+     * @return True if the bounds are known and not empty, false otherwise.
+     */
+    bool GetOpaqueBounds(SDL_FRect *bounds);
+
+    /**
+     * Get the duration of the frame.
+     * @return The duration of the frame.
+     */
+    int GetDuration();
+
+    /**
+     * Reset the frame to the initial frame.
+     */
+    void ResetFrame();
+
+    /**
+     * Update the frame.
+     * Only updates the frame if the duration of the frame has passed.
+     * When the last frame is reached, the frame is reset if the animation is set to repeat.
+     * @see GetDuration
+     */
+    void UpdateFrame();
+
+    /**
+     * Get the frame being shown.
+     * @return The index of the frame, -1 if the animation was reset and not updated since.
+     */
+    int GetFrame() const;
+
+    /**
+     * Get how long the current frame has been shown for.
+     * @return The time in milliseconds, -1 if the animation was never updated.
+     */
+    float GetFrameTime() const;
+
+    /**
+     * Jump to a frame, e.g. to restore a snapshot of the playback.
+     * @param frame The index of the frame, -1 to show the initial frame until the next update.
+     * @param frameTime How long the frame has been shown for in milliseconds, -1 if the animation was never updated.
+     * @see GetFrame
+     * @see GetFrameTime
+     */
+    void SetFrame(int frame, float frameTime);
+
+    /**
+     * Render the frame.
+     * Frame will be flipped if the associated game entity's mFlip is set to true.
+     * Only the opaque part of the frame is drawn, at the place it has in the destination rectangle,
+     * so the transparent margins of the sprite sheet cost no fill rate.
+     * Until the texture is ready, only the outline of the destination rectangle is rendered as a placeholder.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @param ge The GameEntity to render the frame to.
+     */
+    void RenderFrame(std::shared_ptr<SDLGraphicsProgram> game, std::shared_ptr<GameEntity> ge);
+
+private:
+    /**
+     * Find the opaque bounds of every frame from the alpha mask of the texture.
+     * Does nothing once done for the current mask, or while the texture has no mask yet.
+     * @return True if the trims are known, false otherwise.
+     */
+    bool TrimFrames();
+
+    /**
+     * The handle to the texture, which is loaded in the background.
+     * @see TextureHandle
+     */
+    std::shared_ptr<TextureHandle> mTexture;
+    /**
+     * The source rectangle of the frame.
+     */
+    SDL_FRect mRect_src{0.0f, 0.0f, 0.0f, 0.0f};
+    /**
+     * The x position of the initial frame.
+     */
+    int initialX;
+    /**
+     * The offset of the width of the frame.
+     */
+    int offsetW;
+    /**
+     * The maximum number of frames.
+     */
+    int mMaxFrame;
+    /**
+     * The duration of each frame in milliseconds.
+     */
+    int mFrameDuration;
+    /**
+     * The current frame.
+     */
+    int currFrame = -1;
+    /**
+     * The start time of the frame, on the FrameClock.
+     * Used to calculate the duration of the frame.
+     */
+    float frameStartTime{0.0f};
+    /**
+     * Whether the animation should repeat.
+     */
+    bool mRepeat;
+    /**
+     * The opaque bounds of each frame, relative to the frame. Empty until the texture has been uploaded.
+     * @see TrimFrames
+     */
+    std::vector<SDL_FRect> mFrameTrims;
+    /**
+     * The alpha mask the trims were found from, to notice when the texture is reloaded.
+     */
+    std::shared_ptr<const AlphaMask> mTrimmedMask;
 };
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "AlphaMask.hpp"
+
+/**
+ * An enum class that represents where a texture handle is in its lifetime.
+ * @see TextureHandle
+ */
+enum class TextureState : short
+{
+    Loading,
+    Ready,
+    Evicted,
+    // The asset could not be decoded or uploaded, nothing is resident. Only a hot reload of its file loads it again.
+    Failed,
+};
+
+/**
+ * A struct that represents a texture that may still be loading.
+ * Handles are handed out by the ResourceManager right away, the texture is set later on the
+ * main thread once the asset has been decoded and uploaded.
+ * Users render a placeholder until IsReady returns true, or for good if the load failed.
+ * The texture may later be evicted to stay under the memory budget, the handle itself lives on
+ * and the texture is loaded again the next time the handle is requested or restored.
+ * @see ResourceManager::LoadTextureAsync
+ */
+struct TextureHandle : std::enable_shared_from_this<TextureHandle>
+{
+    /**
+     * Constructor for TextureHandle.
+     * @param filepath The path of the asset the handle stands for.
+     */
+    TextureHandle(std::string filepath) : mFilepath(filepath)
+    {
+    }
+
+    /**
+     * Check if the texture has been uploaded.
+     * @return True if the texture is ready to be rendered, false otherwise.
+     */
+    bool IsReady() const
+    {
+        return mTexture != nullptr;
+    }
+
+    /**
+     * Check if the asset could not be decoded or uploaded.
+     * @return True if the handle will not become ready, false otherwise.
+     */
+    bool IsFailed() const
+    {
+        return mState == TextureState::Failed;
+    }
+
+    /**
+     * Get the state of the handle.
+     * @return The state.
+     */
+    TextureState GetState() const
+    {
+        return mState;
+    }
+
+    /**
+     * Move the handle from one state to another, only if it is still in the expected state.
+     * @param expected The state the handle should be in.
+     * @param desired The new state.
+     * @return True if the state changed, false otherwise.
+     */
+    bool ChangeState(TextureState expected, TextureState desired)
+    {
+        return mState.compare_exchange_strong(expected, desired);
+    }
+
+    /**
+     * Get the texture and mark it as used.
+     * Only to be called from the main thread.
+     * @return The texture, or nullptr while it is still loading or evicted.
+     */
+    SDL_Texture *GetTexture() const
+    {
+        Touch();
+        return mTexture.get();
+    }
+
+    /**
+     * Set the texture once it has been uploaded, or release it.
+     * Only to be called from the main thread.
+     * @param texture The uploaded texture, or nullptr to release it.
+     * @param byteSize The memory used by the texture.
+     */
+    void SetTexture(std::shared_ptr<SDL_Texture> texture, size_t byteSize)
+    {
+        mTexture = texture;
+        mByteSize = texture != nullptr ? byteSize : 0;
+        mState = texture != nullptr ? TextureState::Ready : TextureState::Evicted;
+    }
+
+    /**
+     * Get which pixels of the texture are opaque.
+     * Kept after the texture is evicted. Replaced when the texture is reloaded from a changed file.
+     * Only to be called from the main thread.
+     * @return The mask, or nullptr until the texture has been uploaded once.
+     */
+    const std::shared_ptr<const AlphaMask> &GetAlphaMask() const
+    {
+        return mAlphaMask;
+    }
+
+    /**
+     * Set which pixels of the texture are opaque.
+     * Only to be called from the main thread.
+     * @param alphaMask The mask built from the decoded pixels.
+     */
+    void SetAlphaMask(std::shared_ptr<const AlphaMask> alphaMask)
+    {
+        mAlphaMask = alphaMask;
+    }
+
+    /**
+     * Get the memory used by the texture.
+     * @return The size of the texture in bytes, 0 when not resident.
+     */
+    size_t GetByteSize() const
+    {
+        return mByteSize;
+    }
+
+    /**
+     * Mark the texture as used now, for the least recently used eviction.
+     */
+    void Touch() const
+    {
+        mLastUsedNS.store(SDL_GetTicksNS(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Get when the texture was last used.
+     * @return The time of the last use in nanoseconds since SDL was initialized.
+     */
+    Uint64 GetLastUsed() const
+    {
+        return mLastUsedNS.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Check if the asset has been decoded (successfully or not) without blocking.
+     * Only the first decode is tracked, reloads after an eviction are not.
+     * @return True once the decode is over, false otherwise.
+     */
+    bool IsDecoded() const
+    {
+        return mDecoded.valid() && mDecoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /**
+     * Block until the asset has been decoded.
+     * Every thread asking for the same asset waits on the same decode.
+     * @return True if the decode succeeded, false otherwise.
+     */
+    bool WaitUntilDecoded() const
+    {
+        return mDecoded.valid() && mDecoded.get();
+    }
+
+    /**
+     * Set the future completed by the decode job.
+     * Must be called before the handle is shared with other threads.
+     * @param decoded The future, true when the decode succeeded.
+     */
+    void SetDecodeFuture(std::shared_future<bool> decoded)
+    {
+        mDecoded = decoded;
+    }
+
+    /**
+     * Get the path of the asset the handle stands for.
+     * @return The filepath.
+     */
+    const std::string &GetFilepath() const
+    {
+        return mFilepath;
+    }
+
+private:
+    /**
+     * The path of the asset, also the cache key.
+     */
+    std::string mFilepath;
+    /**
+     * Completed by the decode job, shared by everyone waiting on this asset.
+     */
+    std::shared_future<bool> mDecoded;
+    /**
+     * The uploaded texture, nullptr until ready and once evicted.
+     */
+    std::shared_ptr<SDL_Texture> mTexture;
+    /**
+     * Which pixels of the texture are opaque, nullptr until the first upload.
+     */
+    std::shared_ptr<const AlphaMask> mAlphaMask;
+    /**
+     * The memory used by the texture in bytes.
+     */
+    size_t mByteSize{0};
+    /**
+     * Where the handle is in its lifetime, changed from any thread.
+     */
+    std::atomic<TextureState> mState{TextureState::Loading};
+    /**
+     * When the texture was last requested or rendered, in nanoseconds.
+     */
+    mutable std::atomic<Uint64> mLastUsedNS{0};
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * An enum class that represents the priority of a job in a ThreadPool.
+ * Low priority jobs only run when no high priority job is waiting.
+ * @see ThreadPool
+ */
+enum class JobPriority : short
+{
+    High,
+    Low,
+};
+
+/**
+ * A struct that represents a fixed-size pool of worker threads.
+ * Jobs of the same priority are run in the order they were submitted.
+ * Used to decode assets off the main thread without spawning a thread per asset.
+ * @see ResourceManager
+ */
+struct ThreadPool
+{
+    /**
+     * Constructor for ThreadPool.
+     * The workers are started right away.
+     * @param numThreads The number of worker threads, at least 1.
+     */
+    ThreadPool(int numThreads);
+
+    /**
+     * Destructor for ThreadPool.
+     * Jobs not started yet are cancelled, running jobs are waited for.
+     */
+    ~ThreadPool();
+
+    /**
+     * Stop the workers.
+     * Running jobs are waited for, then the cancel function of each job not started yet is run on the calling thread,
+     * in the order the jobs were queued. Calling it again has no effect.
+     */
+    void Stop();
+
+    /**
+     * Queue a job to be run by one of the workers.
+     * @param job The job to run.
+     * @param priority The priority of the job.
+     * @param key Identifies a low priority job for Promote, e.g. the asset it decodes. Can be nullptr.
+     * @param cancel Run instead of the job if the pool stops before the job starts, or right away if it is stopped
+     * already, e.g. to fail a promise someone waits on. Can be empty.
+     */
+    void Submit(std::function<void()> job, JobPriority priority = JobPriority::High, const void *key = nullptr,
+                std::function<void()> cancel = nullptr);
+
+    /**
+     * Move the low priority jobs still waiting that were submitted with one of the keys behind the high priority jobs.
+     * They keep their order.
+     * @param keys The keys of the jobs.
+     * @return The number of jobs promoted.
+     */
+    int Promote(const std::unordered_set<const void *> &keys);
+
+    /**
+     * Get the number of jobs waiting for a worker, whatever their priority.
+     * @return The number of queued jobs.
+     */
+    int GetQueuedCount();
+
+    /**
+     * Get the number of worker threads.
+     * @return The number of workers.
+     */
+    int GetThreadCount() const;
+
+private:
+    /**
+     * The loop run by each worker: wait for a job, run it, repeat until stopped.
+     */
+    void WorkerLoop();
+
+    /**
+     * The worker threads.
+     */
+    std::vector<std::thread> mWorkers;
+    /**
+     * A job waiting for a worker, with what to run if it never starts and the key it can be promoted by.
+     */
+    struct QueuedJob
+    {
+        std::function<void()> job;
+        std::function<void()> cancel;
+        const void *key;
+    };
+    /**
+     * The high priority jobs waiting for a worker.
+     */
+    std::deque<QueuedJob> mJobs;
+    /**
+     * The low priority jobs waiting for a worker.
+     */
+    std::deque<QueuedJob> mLowPriorityJobs;
+    /**
+     * Mutex protecting the job queue and the stop flag.
+     */
+    std::mutex mMutex;
+    /**
+     * Signalled when a job is queued or the pool stops.
+     */
+    std::condition_variable mCondition;
+    /**
+     * Set when the pool is being destroyed.
+     */
+    bool mStop{false};
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+/**
+ * A struct that represents the new tile type of one cell of a TileMap, for setting many cells in one call.
+ * @see TileMap::SetTileIds
+ */
+struct TileChange
+{
+    int row{0};
+    int column{0};
+    Uint16 id{0};
+    Uint16 layer{0};
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * A struct that represents a TileLayer.
+ * A TileLayer is one grid of tile type ids of a TileMap, drawn over the layers added before it.
+ * The tile types are shared by every layer of the map.
+ * @see TileMap::AddLayer
+ */
+struct TileLayer
+{
+    /**
+     * The name of the layer.
+     */
+    std::string name;
+    /**
+     * The tile type id of each cell, row-major, 0 for an empty cell.
+     */
+    std::vector<Uint16> cells;
+    /**
+     * How much the layer moves with the camera horizontally: 1 for the terrain, less for a far background.
+     */
+    float parallaxX{1.0f};
+    /**
+     * How much the layer moves with the camera vertically.
+     */
+    float parallaxY{1.0f};
+    /**
+     * Whether the layer is drawn.
+     */
+    bool visible{true};
+    /**
+     * Whether the collidable tiles of the layer block entities, raycasts and lines of sight.
+     */
+    bool collidable{false};
+    /**
+     * Whether the layer is drawn over the entities, by TileMap::RenderForeground, rather than under them.
+     */
+    bool foreground{false};
+    /**
+     * The whole layer drawn once into a target texture, redrawn only after an edit. Owned by the TileMap.
+     * nullptr until the layer is first drawn, or if the renderer could not create it.
+     */
+    SDL_Texture *cache{nullptr};
+    /**
+     * Whether the cache holds the current content of the layer.
+     */
+    bool cacheValid{false};
+    /**
+     * The indices of the cells edited since the cache was drawn, redrawn into it one by one
+     * instead of redrawing the whole layer. Only used while the cache is valid.
+     */
+    std::vector<int> dirtyCells;
+    /**
+     * Set when the cache texture could not be created, the layer is then drawn cell by cell.
+     */
+    bool cacheFailed{false};
+    /**
+     * The indices of the cells holding an animated tile, which the cache leaves out. Rebuilt with the cache.
+     */
+    std::vector<int> animatedCells;
+    /**
+     * The number of texture reloads when the cache was drawn, a reloaded tile texture invalidates it.
+     * @see ResourceManager::GetReloadCount
+     */
+    int cacheReloadCount{0};
+};
@@ -1,141 +1,543 @@
-#pragma once
-
-#include <SDL3/SDL.h>
-#include <string>
-#include <unordered_map>
-#include <vector>
-#include <memory>
-
-#include "GameEntity.hpp"
-#include "TileRecord.hpp"
-
-/**
- * A struct that represents a TileMap.
- * A TileMap is a map of tiles that can be placed in the game.
- */
-struct TileMap
-{
-    /**
-     * Constructor for TileMap.
-     * @param mapWidth The width of the map.
-     * @param mapHeight The height of the map.
-     * @param numOfTileRow The number of rows of tiles.
-     * @param numOfTileColumn The number of columns of tiles.
-     */
-    TileMap(int mapWidth, int mapHeight, int numOfTileRow, int numOfTileColumn);
-
-    /**
-     * Destructor for TileMap.
-     */
-    ~TileMap();
-
-    /**
-     * Add a tile type to the map to be used to fill the map.
-     * @param tileName The name of the tile.
-     * @param filepath The path to the file to load.
-     * @param collidable Whether the tile is collidable.
-     */
-    void AddTileType(std::string tileName, std::string filepath, bool collidable);
-
-    /**
-     * Place a tile that's previously added at a specific position in the map.
-     * A tile of class GameEntity is created and placed in the map.
-     * @param tileName The name of the tile to place.
-     * @param rowNum The row number to place the tile.
-     * @param columnNum The column number to place the tile.
-     * @see GameEntity
-     */
-    void PlaceTileAt(std::string tileName, int rowNum, int columnNum);
-
-    /**
-     * Erase a tile at a specific position in the map.
-     * @param rowNum The row number to erase the tile.
-     * @param columnNum The column number to erase the tile.
-     */
-    void EraseTileAt(int rowNum, int columnNum);
-
-    /**
-     * Create texture components for all tiles in the map onto the game.
-     * This function is separated from PlaceTileAt to speed up the loading process.
-     * @param game The game to load to as an SDLGraphicsProgram.
-     * @see SDLGraphicsProgram
-     */
-    void LoadToGame(std::shared_ptr<SDLGraphicsProgram> game);
-
-    /**
-     * Check if a specific tile is colliding with a target entity.
-     * @param target The target entity to check collision with.
-     * @return Whether the tile is colliding with the target entity.
-     */
-    bool HasCollisionWith(std::shared_ptr<GameEntity> target);
-
-    /**
-     * Get the width of the map.
-     * @return The width of the map.
-     */
-    int GetMapWidth() const;
-
-    /**
-     * Get the height of the map.
-     * @return The height of the map.
-     */
-    int GetMapHeight() const;
-
-    /**
-     * Get the width of a tile.
-     * @return The width of a tile.
-     */
-    float GetTileWidth() const;
-
-    /**
-     * Get the height of a tile.
-     * @return The height of a tile.
-     */
-    float GetTileHeight() const;
-
-    /**
-     * Render the map (each tile it contains) to the screen.
-     * @param game The game to render to as an SDLGraphicsProgram.
-     * @see SDLGraphicsProgram
-     */
-    void Render(std::shared_ptr<SDLGraphicsProgram> game);
-
-private:
-    /**
-     * The width of the map.
-     */
-    int mMapWidth{0};
-    /**
-     * The height of the map.
-     */
-    int mMapHeight{0};
-    /**
-     * The maximum row number of the map.
-     */
-    int maxRow{0};
-    /**
-     * The maximum column number of the map.
-     */
-    int maxColumn{0};
-    /**
-     * The width of a tile.
-     */
-    float mTileWidth{0};
-    /**
-     * The height of a tile.
-     */
-    float mTileHeight{0};
-    /**
-     * A map of tile names to TileRecords.
-     * Key: tile name
-     * Value: TileRecord which contains the texture filepath and collidable information of the tile.
-     * @see TileRecord
-     */
-    std::unordered_map<std::string, TileRecord> mTiles;
-    /**
-     * A 2D vector of shared pointers to GameEntities.
-     * Represents the layout of the map.
-     * @see GameEntity
-     */
-    std::vector<std::vector<std::shared_ptr<GameEntity>>> mMapLayout;
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+
+#include "GameEntity.hpp"
+#include "LevelFile.hpp"
+#include "TileLayer.hpp"
+#include "TileRecord.hpp"
+#include "RaycastHit.hpp"
+#include "TileChange.hpp"
+
+/**
+ * A struct that represents a TileMap.
+ * A TileMap is a map of tiles that can be placed in the game.
+ * Each cell only stores the id of its tile type, everything else lives once per type in the type table.
+ * Rendering and collision read the cells directly, GameEntities are only created for the cells that ask for one.
+ * The map has one or more layers sharing the tile types. Layer 0, the terrain, is created with the map and is the only
+ * collidable one unless told otherwise; the layers added after it are drawn over it.
+ * @see TileRecord
+ * @see GetTileEntity
+ */
+struct TileMap
+{
+    /**
+     * Constructor for TileMap.
+     * @param mapWidth The width of the map.
+     * @param mapHeight The height of the map.
+     * @param numOfTileRow The number of rows of tiles.
+     * @param numOfTileColumn The number of columns of tiles.
+     */
+    TileMap(int mapWidth, int mapHeight, int numOfTileRow, int numOfTileColumn);
+
+    /**
+     * Destructor for TileMap.
+     * Destroys the layer caches.
+     */
+    ~TileMap();
+
+    /**
+     * Add a layer over the layers added before it.
+     * @param name The name of the layer.
+     * @param parallaxX How much the layer moves with the camera horizontally, 1 for the terrain.
+     * @param parallaxY How much the layer moves with the camera vertically.
+     * @param collidable Whether the collidable tiles of the layer block entities.
+     * @param foreground Whether the layer is drawn over the entities.
+     * @return The index of the layer.
+     * @see TileLayer
+     */
+    int AddLayer(std::string name, float parallaxX = 1.0f, float parallaxY = 1.0f, bool collidable = false, bool foreground = false);
+
+    /**
+     * Get the number of layers, terrain included.
+     * @return The number of layers.
+     */
+    int GetLayerCount() const;
+
+    /**
+     * Find a layer by name.
+     * @param name The name of the layer.
+     * @return The index of the first layer of that name, -1 if there is none.
+     */
+    int GetLayerIndex(std::string name) const;
+
+    /**
+     * Show or hide a layer. Hidden layers still collide.
+     * @param layer The index of the layer.
+     * @param visible Whether the layer is drawn.
+     */
+    void SetLayerVisible(int layer, bool visible);
+
+    /**
+     * Set how much a layer moves with the camera.
+     * @param layer The index of the layer.
+     * @param parallaxX The horizontal factor, 1 to move with the terrain, 0 to stay on screen.
+     * @param parallaxY The vertical factor.
+     */
+    void SetLayerParallax(int layer, float parallaxX, float parallaxY);
+
+    /**
+     * Choose whether the collidable tiles of a layer block entities, raycasts and lines of sight.
+     * @param layer The index of the layer.
+     * @param collidable Whether the layer collides.
+     */
+    void SetLayerCollidable(int layer, bool collidable);
+
+    /**
+     * Move the camera. Each layer is drawn shifted by the camera position times its parallax factors.
+     * Collision is not affected, it stays in map coordinates.
+     * @param x The x position of the top left corner of the view.
+     * @param y The y position of the top left corner of the view.
+     */
+    void SetCamera(float x, float y);
+
+    /**
+     * Add a tile type to the map to be used to fill the map.
+     * Tile types get ids in the order they are added, starting at 1; 0 stands for an empty cell.
+     * Adding a name again gives it a new id, but PlaceTileAt keeps using the first type of that name.
+     * @param tileName The name of the tile.
+     * @param filepath The path to the file to load.
+     * @param collidable Whether the tile is collidable.
+     * @param srcRect The part of the texture to draw, the whole texture if its width is 0.
+     * @param frames The parts of the texture to cycle through for an animated tile, empty for a static one.
+     * @param frameDuration How long each frame is shown in milliseconds, the tile is static if 0.
+     * @see LoadLayout
+     * @see Update
+     */
+    void AddTileType(std::string tileName, std::string filepath, bool collidable, SDL_FRect srcRect = SDL_FRect{0.0f, 0.0f, 0.0f, 0.0f},
+                     std::vector<SDL_FRect> frames = {}, Uint32 frameDuration = 0);
+
+    /**
+     * Advance the tile clock shared by every animated tile type.
+     * Every tile of an animated type shows the same frame, picked from the clock when rendering,
+     * so animated tiles cost nothing per tile to update.
+     * @param deltaTime The time since the last frame in seconds.
+     */
+    void Update(float deltaTime);
+
+    /**
+     * Get the tile clock, the time animated tiles have been running for.
+     * @return The clock in seconds.
+     */
+    double GetTileClock() const;
+
+    /**
+     * Set the tile clock, e.g. to restore a snapshot.
+     * @param clock The clock in seconds.
+     */
+    void SetTileClock(double clock);
+
+    /**
+     * Place a tile that's previously added at a specific position in the map.
+     * The entity of the cell, if any, is dropped.
+     * @param tileName The name of the tile to place.
+     * @param rowNum The row number to place the tile.
+     * @param columnNum The column number to place the tile.
+     * @param layer The index of the layer, the terrain by default.
+     */
+    void PlaceTileAt(std::string tileName, int rowNum, int columnNum, int layer = 0);
+
+    /**
+     * Set the tile type of many cells in one call, e.g. to undo or redo an edit.
+     * Unlike PlaceTileAt, the collision rectangles are merged again once for all the cells instead of once per cell.
+     * The tile types must already be loaded by LoadToGame. Changes outside the map, on an unknown layer
+     * or to an unknown id are skipped.
+     * @param changes The cells and their new tile type id, applied in order.
+     * @return The number of changes applied.
+     * @see TileChange
+     */
+    int SetTileIds(const std::vector<TileChange> &changes);
+
+    /**
+     * Get the tile type id of a cell.
+     * @param rowNum The row number of the cell.
+     * @param columnNum The column number of the cell.
+     * @param layer The index of the layer, the terrain by default.
+     * @return The tile type id, 0 for an empty cell, a position outside the map or an unknown layer.
+     */
+    Uint16 GetTileId(int rowNum, int columnNum, int layer = 0) const;
+
+    /**
+     * Get the entity of a terrain tile, for the few tiles that need behavior of their own (scripts, triggers, ...).
+     * The entity is created on the first call, with a transform, the filepath as name, and a collision box if the tile is collidable.
+     * It is not rendered by the map, and is dropped once the tile is replaced or erased.
+     * @param rowNum The row number of the tile.
+     * @param columnNum The column number of the tile.
+     * @return The entity, or nullptr for an empty cell or a position outside the map.
+     * @see GameEntity
+     */
+    std::shared_ptr<GameEntity> GetTileEntity(int rowNum, int columnNum);
+
+    /**
+     * Fill the whole map from a layout of tile type ids in one pass, textures included.
+     * Replaces every cell, and rebuilds the merged collision rectangles once at the end
+     * instead of after every tile like PlaceTileAt does.
+     * Nothing changes if the layout does not match the size of the map or holds an unknown id.
+     * @param game The game to load the textures to as an SDLGraphicsProgram.
+     * @param ids The tile type id of each cell, row-major, 0 for an empty cell.
+     * @param rows The number of rows of the layout.
+     * @param columns The number of columns of the layout.
+     * @param layer The index of the layer to fill, the terrain by default.
+     * @return True if the layout was loaded, false otherwise.
+     * @see AddTileType
+     */
+    bool LoadLayout(std::shared_ptr<SDLGraphicsProgram> game, const Uint16 *ids, int rows, int columns, int layer = 0);
+
+    /**
+     * Fill the map from the layers of an open level file, the ids read straight from its mapping.
+     * The first layer of the file fills the terrain, the others are added over it with AddLayer,
+     * so the map should not have layers of its own yet. The tile types must be added first, in the order the ids refer to.
+     * @param game The game to load the textures to as an SDLGraphicsProgram.
+     * @param levelFile The level file, of the same size as the map.
+     * @return True if every layer was loaded, false otherwise.
+     * @see LevelFile
+     */
+    bool LoadLevelFile(std::shared_ptr<SDLGraphicsProgram> game, const LevelFile &levelFile);
+
+    /**
+     * Get the tile type ids of every cell of a layer.
+     * @param layer The index of the layer.
+     * @return The ids, row-major, GetRowCount() * GetColumnCount() of them; nullptr if the layer does not exist.
+     */
+    const Uint16 *GetLayerCells(int layer) const;
+
+    /**
+     * Replace every cell of a layer, without loading any texture.
+     * Used by LoadLayout, and to restore a snapshot of tile types that are already loaded.
+     * A layer whose cells do not change is left alone, so its cached texture and collision rectangles are kept.
+     * Nothing changes if the layer does not exist or an id is unknown.
+     * @param ids The tile type id of each cell, row-major, GetRowCount() * GetColumnCount() of them.
+     * @param layer The index of the layer.
+     * @return True if the cells were set, false otherwise.
+     * @see LevelSnapshot
+     */
+    bool SetLayerCells(const Uint16 *ids, int layer);
+
+    /**
+     * Get the number of rows of the map.
+     * @return The number of rows.
+     */
+    int GetRowCount() const;
+
+    /**
+     * Get the number of columns of the map.
+     * @return The number of columns.
+     */
+    int GetColumnCount() const;
+
+    /**
+     * Erase a tile at a specific position in the map.
+     * @param rowNum The row number to erase the tile.
+     * @param columnNum The column number to erase the tile.
+     * @param layer The index of the layer, the terrain by default.
+     */
+    void EraseTileAt(int rowNum, int columnNum, int layer = 0);
+
+    /**
+     * Load the textures of the tile types used in any layer onto the game, once per type.
+     * This function is separated from PlaceTileAt to speed up the loading process.
+     * @param game The game to load to as an SDLGraphicsProgram.
+     * @see SDLGraphicsProgram
+     */
+    void LoadToGame(std::shared_ptr<SDLGraphicsProgram> game);
+
+    /**
+     * Check if a specific tile is colliding with a target entity.
+     * @param target The target entity to check collision with.
+     * @return Whether the tile is colliding with the target entity.
+     */
+    bool HasCollisionWith(std::shared_ptr<GameEntity> target);
+
+    /**
+     * Check if any collidable tile of a collidable layer overlaps a rectangle.
+     * Tested against the merged static collision rectangles rather than tile by tile.
+     * @param x The x position of the rectangle.
+     * @param y The y position of the rectangle.
+     * @param w The width of the rectangle.
+     * @param h The height of the rectangle.
+     * @return Whether a collidable tile overlaps the rectangle.
+     */
+    bool HasCollisionAt(float x, float y, float w, float h) const;
+
+    /**
+     * Get the merged static collision rectangles of the map in world coordinates.
+     * Adjacent collidable tiles are greedily merged, first along rows then down columns.
+     * @return The merged rectangles.
+     */
+    std::vector<SDL_FRect> GetStaticCollisionRects() const;
+
+    /**
+     * Get the number of merged static collision rectangles.
+     * @return The number of merged rectangles.
+     */
+    int GetStaticCollisionRectCount() const;
+
+    /**
+     * Cast a ray over the cell grid and find the first collidable tile it enters.
+     * Walks the grid cell by cell (DDA), so the cost only depends on the number of cells crossed.
+     * A ray starting inside a collidable tile hits it at distance 0.
+     * @param x The x position of the ray origin.
+     * @param y The y position of the ray origin.
+     * @param dirX The x component of the ray direction, does not need to be normalized.
+     * @param dirY The y component of the ray direction, does not need to be normalized.
+     * @param maxDistance The maximum distance to travel.
+     * @return The first hit, if any.
+     * @see RaycastHit
+     */
+    RaycastHit Raycast(float x, float y, float dirX, float dirY, float maxDistance) const;
+
+    /**
+     * Check if no collidable tile lies on the segment between two points.
+     * @param x0 The x position of the first point.
+     * @param y0 The y position of the first point.
+     * @param x1 The x position of the second point.
+     * @param y1 The y position of the second point.
+     * @return True if the second point can be seen from the first one, false otherwise.
+     */
+    bool HasLineOfSight(float x0, float y0, float x1, float y1) const;
+
+    /**
+     * Cast many rays in one call.
+     * @param rays The rays packed as (x, y, dirX, dirY, maxDistance), 5 floats per ray.
+     * @return One hit per ray, in the same order.
+     * @see Raycast
+     */
+    std::vector<RaycastHit> RaycastBatch(const std::vector<float> &rays) const;
+
+    /**
+     * Check many lines of sight in one call.
+     * @param segments The segments packed as (x0, y0, x1, y1), 4 floats per segment.
+     * @return One flag per segment, in the same order.
+     * @see HasLineOfSight
+     */
+    std::vector<bool> LineOfSightBatch(const std::vector<float> &segments) const;
+
+    /**
+     * Get the width of the map.
+     * @return The width of the map.
+     */
+    int GetMapWidth() const;
+
+    /**
+     * Get the height of the map.
+     * @return The height of the map.
+     */
+    int GetMapHeight() const;
+
+    /**
+     * Get the width of a tile.
+     * @return The width of a tile.
+     */
+    float GetTileWidth() const;
+
+    /**
+     * Get the height of a tile.
+     * @return The height of a tile.
+     */
+    float GetTileHeight() const;
+
+    /**
+     * Render every visible layer of the map to the screen, in order.
+     * Each layer is drawn once into a cached texture and only redrawn after an edit or a texture reload;
+     * layers too large for a texture are drawn cell by cell, visiting only the cells within the render output.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see SDLGraphicsProgram
+     */
+    void Render(std::shared_ptr<SDLGraphicsProgram> game);
+
+    /**
+     * Render the visible layers drawn under the entities, in order. Call it before rendering the entities.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see Render
+     */
+    void RenderBackground(std::shared_ptr<SDLGraphicsProgram> game);
+
+    /**
+     * Render the visible foreground layers, in order. Call it after rendering the entities.
+     * @param game The game to render to as an SDLGraphicsProgram.
+     * @see Render
+     */
+    void RenderForeground(std::shared_ptr<SDLGraphicsProgram> game);
+
+private:
+    /**
+     * Check if a cell holds a collidable tile in any collidable layer.
+     * @param rowNum The row number of the cell.
+     * @param columnNum The column number of the cell.
+     * @return Whether the cell is collidable.
+     */
+    bool IsCellSolid(int rowNum, int columnNum) const;
+
+    /**
+     * Check if a layer index is valid, logging it if not.
+     * @param layer The index of the layer.
+     * @return True if the layer exists, false otherwise.
+     */
+    bool IsValidLayer(int layer) const;
+
+    /**
+     * Set the tile type of a cell, redraw it in the cache of its layer, drop its entity
+     * and update the merged rectangles around it.
+     * @param rowNum The row number of the cell.
+     * @param columnNum The column number of the cell.
+     * @param id The tile type id, 0 to empty the cell.
+     * @param layer The index of the layer.
+     */
+    void SetCell(int rowNum, int columnNum, Uint16 id, int layer);
+
+    /**
+     * Set the tile type of a cell, mark it for redrawing in the cache of its layer and drop its entity,
+     * leaving the merged rectangles to the caller.
+     * @param rowNum The row number of the cell.
+     * @param columnNum The column number of the cell.
+     * @param id The tile type id, 0 to empty the cell.
+     * @param layer The index of the layer.
+     * @return True if the cell became solid or stopped being solid, so the merged rectangles must be updated.
+     */
+    bool WriteCell(int rowNum, int columnNum, Uint16 id, int layer);
+
+    /**
+     * Redraw the cells edited since the cache of a layer was drawn into it, one by one.
+     * @param renderer The renderer to draw with.
+     * @param layer The layer, its cache valid.
+     */
+    void PatchCache(SDL_Renderer *renderer, TileLayer &layer);
+
+    /**
+     * Look up the texture and the current frame of every tile type, once per render call.
+     */
+    void ResolveTileTypes();
+
+    /**
+     * Render a layer, through its cache when it can.
+     * Animated tiles are left out of the cache and drawn over it.
+     * @param renderer The renderer to draw with.
+     * @param layer The layer.
+     */
+    void RenderLayer(SDL_Renderer *renderer, TileLayer &layer);
+
+    /**
+     * Draw the cells of a layer within a rectangle of the render target.
+     * @param renderer The renderer to draw with.
+     * @param layer The layer.
+     * @param offsetX Where the left of the map is drawn.
+     * @param offsetY Where the top of the map is drawn.
+     * @param outputWidth The width of the area to fill.
+     * @param outputHeight The height of the area to fill.
+     * @param animated Whether the animated tiles are drawn too.
+     * @return True if every tile was drawn with its texture, false if placeholders were drawn instead.
+     */
+    bool DrawLayerCells(SDL_Renderer *renderer, const TileLayer &layer, float offsetX, float offsetY, int outputWidth, int outputHeight, bool animated);
+
+    /**
+     * Draw one cell with the texture and frame resolved for its type.
+     * @param renderer The renderer to draw with.
+     * @param id The tile type id of the cell, not 0.
+     * @param rect Where to draw the cell.
+     * @return True if the tile was drawn as it will stay (its texture, or the placeholder of a texture that failed), false otherwise.
+     */
+    bool DrawCell(SDL_Renderer *renderer, Uint16 id, const SDL_FRect &rect);
+
+    /**
+     * Rebuild the merged rectangles of the cells affected by edits in a region of the map.
+     * Every merged rectangle overlapping the edited region is dropped, then the cells they covered
+     * and the edited cells are merged again around the rectangles kept.
+     * @param edited The edited cells, as the column, row, number of columns and number of rows of the region.
+     */
+    void RebuildStaticRects(SDL_Rect edited);
+
+    /**
+     * Merge the solid cells of a region of the map that no rectangle covers yet.
+     * @param region The region, as the column, row, number of columns and number of rows.
+     */
+    void MergeStaticRects(SDL_Rect region);
+
+    /**
+     * The width of the map.
+     */
+    int mMapWidth{0};
+    /**
+     * The height of the map.
+     */
+    int mMapHeight{0};
+    /**
+     * The maximum row number of the map.
+     */
+    int maxRow{0};
+    /**
+     * The maximum column number of the map.
+     */
+    int maxColumn{0};
+    /**
+     * The width of a tile.
+     */
+    float mTileWidth{0};
+    /**
+     * The height of a tile.
+     */
+    float mTileHeight{0};
+    /**
+     * A map of tile names to tile type ids.
+     * Key: tile name
+     * Value: the id of the tile type, an index in mTileTypes plus 1.
+     */
+    std::unordered_map<std::string, Uint16> mTiles;
+    /**
+     * The tile types in the order they were added, the type of id i is at index i - 1.
+     * Each TileRecord contains the texture filepath and collidable information of the tile.
+     * @see TileRecord
+     */
+    std::vector<TileRecord> mTileTypes;
+    /**
+     * Whether each tile type is collidable, indexed by id so that 0 (empty) is not.
+     */
+    std::vector<uint8_t> mSolidTypes{0};
+    /**
+     * Whether each tile type is animated, indexed by id.
+     */
+    std::vector<uint8_t> mAnimatedTypes{0};
+    /**
+     * The tile clock in seconds, shared by every animated tile type.
+     */
+    double mTileClock{0.0};
+    /**
+     * The texture of each tile type for the current render call, indexed by id, nullptr if not ready.
+     */
+    std::vector<SDL_Texture *> mTypeTextures;
+    /**
+     * Whether each tile type is drawn as a placeholder in the current render call: 1 while its texture is loading,
+     * 2 if it failed to load, in which case the placeholder is final and can be cached.
+     */
+    std::vector<uint8_t> mTypePlaceholders;
+    /**
+     * The part of the texture drawn for each tile type in the current render call, nullptr for the whole texture.
+     */
+    std::vector<const SDL_FRect *> mTypeSrcRects;
+    /**
+     * The layers of the map in drawing order, the terrain first.
+     * @see TileLayer
+     */
+    std::vector<TileLayer> mLayers;
+    /**
+     * The x position of the camera.
+     */
+    float mCameraX{0};
+    /**
+     * The y position of the camera.
+     */
+    float mCameraY{0};
+    /**
+     * The entities of the terrain tiles that asked for one, by cell index.
+     * @see GetTileEntity
+     */
+    std::unordered_map<int, std::shared_ptr<GameEntity>> mTileEntities;
+    /**
+     * The merged static collision rectangles, in cell units (x: column, y: row).
+     * Together they cover every collidable cell exactly once.
+     */
+    std::vector<SDL_Rect> mStaticRects;
 };
\ No newline at end of file
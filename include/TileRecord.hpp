@@ -1,15 +1,42 @@
-#pragma once
-
-#include <SDL3/SDL.h>
-#include <string>
-
-/**
- * A struct that represents a TileRecord.
- * A TileRecord is a record of a tile in the game.
- * It contains the filepath of the tile and whether it is collidable.
- */
-struct TileRecord
-{
-    std::string filepath;
-    bool collidable;
-};
\ No newline at end of file
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TextureHandle.hpp"
+
+/**
+ * A struct that represents a TileRecord.
+ * A TileRecord is a record of a tile type in the game, shared by every cell holding that type.
+ * It contains the filepath of the tile, whether it is collidable and how it is drawn.
+ */
+struct TileRecord
+{
+    /**
+     * The path to the texture of the tile.
+     */
+    std::string filepath;
+    /**
+     * Whether the tile is collidable.
+     */
+    bool collidable;
+    /**
+     * The part of the texture drawn in each cell, the whole texture if its width is 0.
+     * Lets several tile types share one tile sheet.
+     */
+    SDL_FRect srcRect{0.0f, 0.0f, 0.0f, 0.0f};
+    /**
+     * The parts of the texture an animated tile cycles through, in order. Empty for a static tile.
+     */
+    std::vector<SDL_FRect> frames;
+    /**
+     * How long each frame of an animated tile is shown in milliseconds.
+     */
+    Uint32 frameDuration{0};
+    /**
+     * The texture of the tile, nullptr until the map is loaded to the game.
+     */
+    std::shared_ptr<TextureHandle> texture;
+};
@@ -1,107 +1,168 @@
-import sys
-import os
-
-# Add the "lib" directory to the Python module search path
-lib_dir = os.path.join(os.path.dirname(__file__), 'lib')
-sys.path.insert(0, lib_dir)
-
-helper_dir = os.path.join(os.path.dirname(__file__), "helpers")
-sys.path.append(helper_dir)
-
-import mygameengine
-from config_manager import read_config, write_config
-from object_builders import build_level_tilemap, build_prompt, build_level_objects, build_editor_mouse_image, build_level
-from helper import check_level_completion, get_edit_type, edit_level
-from objects import find_obj
-
-GLOBAL_CONFIG = read_config("global_config")
-
-def main():
-    # Initialize SDL
-    game = mygameengine.SDLGraphicsProgram(GLOBAL_CONFIG["window_width"], GLOBAL_CONFIG["window_height"], "My Game")
-
-    curr_level = 1
-    level_config, tilemap, objects = build_level(game, GLOBAL_CONFIG, curr_level)
-
-    prompt_game = build_prompt(game, GLOBAL_CONFIG, "game_prompt")
-    prompt_editor = build_prompt(game, GLOBAL_CONFIG, "editor_prompt")
-    prompt_win = build_prompt(game, GLOBAL_CONFIG, "win_prompt")
-
-    press_cd = 0
-    editor_mode = False
-    edit_type = 1
-    editor_mouse_image = build_editor_mouse_image(game, tilemap, GLOBAL_CONFIG, level_config, 0, 0, edit_type)
-
-    run = True
-    win = False
-    while run:
-        deltaTime = game.get_delta_time()
-        curr_health = find_obj("player", objects).get_curr_health()
-
-        if(press_cd > 0):
-            press_cd -= deltaTime
-        else:
-            press_cd = 0
-
-        game.clear(r=0, g=0, b=0, a=1)
-
-        if(not win):
-            if(not editor_mode):
-                prompt_game.render(game)
-            else:
-                prompt_editor.render(game)
-                mouse_position = mygameengine.Input.get_mouse_position()
-                curr_edit_type = get_edit_type()
-                if(curr_edit_type != None and curr_edit_type != edit_type):
-                    edit_type = curr_edit_type
-
-                editor_mouse_image = build_editor_mouse_image(game, tilemap, GLOBAL_CONFIG, level_config, mouse_position[0], mouse_position[1], edit_type)
-                editor_mouse_image.render(game)
-
-                mouse_clicked_position = mygameengine.Input.get_mouse_click_position()
-                if(len(mouse_clicked_position) > 0 and press_cd <= 0):
-                    press_cd = 0.5
-                    edit_level(game, tilemap, objects, GLOBAL_CONFIG, level_config, mouse_clicked_position[0], mouse_clicked_position[1], edit_type)
-                
-                if(mygameengine.Input.is_s_key_down() and press_cd <= 0):
-                    press_cd = 0.5
-                    editor_mode = False
-                    write_config(level_config, "levels", "level {}".format(curr_level))
-
-                if(mygameengine.Input.is_esc_key_down() and press_cd <= 0):
-                    press_cd = 0.5
-                    editor_mode = False
-                    level_config, tilemap, objects = build_level(game, GLOBAL_CONFIG, curr_level)
-
-            tilemap.render(game)
-
-            for obj in objects:
-                if(obj.get_name() != "destination"):
-                    obj.update(deltaTime, game, objects, tilemap)
-                obj.render(game)
-        
-        else:
-            prompt_win.render(game)
-            
-        game.flip()
-
-        if(check_level_completion(objects)):
-            curr_level += 1
-
-            if(curr_level <= GLOBAL_CONFIG["num_levels"]):
-                level_config = read_config("levels", "level {}".format(curr_level))
-                tilemap = build_level_tilemap(game, GLOBAL_CONFIG, level_config)
-                objects = build_level_objects(game, GLOBAL_CONFIG, level_config)
-                find_obj("player", objects).set_curr_health(curr_health)
-            else:
-                win = True
-
-        if(mygameengine.Input.is_esc_key_down() and press_cd <= 0):
-            press_cd = 0.5
-            editor_mode = True
-
-        if(mygameengine.Input.is_quit_clicked()):
-            run = False
-
-if __name__ == "__main__":
+import argparse
+import sys
+import os
+
+# Add the "lib" directory to the Python module search path
+lib_dir = os.path.join(os.path.dirname(__file__), 'lib')
+sys.path.insert(0, lib_dir)
+
+helper_dir = os.path.join(os.path.dirname(__file__), "helpers")
+sys.path.append(helper_dir)
+
+import mygameengine
+from config_manager import read_config
+from object_builders import build_prompt, build_editor_mouse_image, build_level, build_collision_world, LevelPrefetch, open_level_file
+from helper import handle_collision_events, get_edit_type, edit_level
+from objects import find_obj
+from level_journal import open_level_journal, save_level_edits, discard_level_edits
+from level_snapshot import LevelSnapshot
+from edit_history import LevelEditHistory
+from input_replay import InputSession
+
+# A copy, the level directory changes for recorded and replayed runs
+GLOBAL_CONFIG = dict(read_config("global_config"))
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--record", metavar="FILE", help="record the input of the run to FILE")
+    parser.add_argument("--replay", metavar="FILE", help="run the input recorded in FILE again, as fast as possible")
+    parser.add_argument("--hashes", metavar="FILE", help="write the hash of the state after each frame to FILE")
+    parser.add_argument("--headless", action="store_true", help="run without showing a window")
+    args = parser.parse_args()
+    session = InputSession(args.record, args.replay, args.hashes)
+    GLOBAL_CONFIG["level_directory"] = session.level_directory(GLOBAL_CONFIG["level_directory"])
+
+    # Initialize SDL
+    game = mygameengine.SDLGraphicsProgram(GLOBAL_CONFIG["window_width"], GLOBAL_CONFIG["window_height"], "My Game", args.headless)
+    resources = mygameengine.ResourceManager.instance()
+    resources.set_premultiplied_alpha(GLOBAL_CONFIG["premultiplied_alpha"])
+    resources.set_memory_budget(GLOBAL_CONFIG["texture_budget_mb"] * 1024 * 1024)
+    # The archive is optional, the loose BMP files are loaded without it
+    if(os.path.exists(GLOBAL_CONFIG["asset_archive"])):
+        resources.mount_archive(GLOBAL_CONFIG["asset_archive"])
+    # Reload the art when it changes on disk, for iterating without restarting
+    if(GLOBAL_CONFIG["hot_reload"] and not session.is_deterministic()):
+        resources.enable_hot_reload()
+
+    curr_level = 1
+    level_config, tilemap, objects = build_level(game, GLOBAL_CONFIG, curr_level)
+    if(session.is_deterministic()):
+        resources.finish_loads(game)
+    world = build_collision_world(objects, tilemap)
+    # The next level is built a part per frame from the frame after a level starts, so the costs never add up in one frame
+    next_level = LevelPrefetch(game, GLOBAL_CONFIG, curr_level + 1) if curr_level < GLOBAL_CONFIG["num_levels"] else None
+
+    prompt_game = build_prompt(game, GLOBAL_CONFIG, "game_prompt")
+    prompt_editor = build_prompt(game, GLOBAL_CONFIG, "editor_prompt")
+    prompt_win = build_prompt(game, GLOBAL_CONFIG, "win_prompt")
+
+    editor_mode = False
+    edit_type = 1
+    # The edit journal of the current level, opened the first time the editor is
+    journal = None
+    # The level as it was when entering the editor, restored when leaving it without saving
+    editor_snapshot = LevelSnapshot()
+    # The edits of the current level that can be undone, kept until the level changes or its edits are discarded
+    history = LevelEditHistory()
+    editor_mouse_image = build_editor_mouse_image(game, tilemap, GLOBAL_CONFIG, level_config, 0, 0, edit_type)
+
+    run = session.start()
+    win = False
+    while run:
+        deltaTime = game.get_delta_time()
+        # One snapshot of the keyboard and mouse for the whole frame; keys act once when pressed, not while held
+        keys = mygameengine.Input.update()
+        was_editing = editor_mode
+        curr_health = find_obj("player", objects).get_curr_health()
+
+        game.clear(r=0, g=0, b=0, a=1)
+
+        if(not win):
+            if(not editor_mode):
+                prompt_game.render(game)
+            else:
+                prompt_editor.render(game)
+                curr_edit_type = get_edit_type(keys)
+                if(curr_edit_type != None and curr_edit_type != edit_type):
+                    edit_type = curr_edit_type
+
+                editor_mouse_image = build_editor_mouse_image(game, tilemap, GLOBAL_CONFIG, level_config, keys.mouse_x, keys.mouse_y, edit_type)
+                editor_mouse_image.render(game)
+
+                if(keys.is_mouse_button_pressed()):
+                    edit_level(game, tilemap, objects, GLOBAL_CONFIG, level_config, keys.mouse_x, keys.mouse_y, edit_type, journal, history)
+                    world = build_collision_world(objects, tilemap)
+
+                if(keys.is_key_pressed(mygameengine.Scancode.Z)):
+                    if(history.undo(game, tilemap, objects, GLOBAL_CONFIG, level_config, journal)):
+                        world = build_collision_world(objects, tilemap)
+
+                if(keys.is_key_pressed(mygameengine.Scancode.Y)):
+                    if(history.redo(game, tilemap, objects, GLOBAL_CONFIG, level_config, journal)):
+                        world = build_collision_world(objects, tilemap)
+                
+                if(keys.is_key_pressed(mygameengine.Scancode.S)):
+                    editor_mode = False
+                    # The edits are already in the journal, saving only marks them as kept
+                    save_level_edits(GLOBAL_CONFIG, curr_level, level_config, journal)
+
+                elif(keys.is_key_pressed(mygameengine.Scancode.ESCAPE)):
+                    editor_mode = False
+                    discard_level_edits(journal)
+                    editor_snapshot.restore(tilemap, objects, level_config)
+                    history.clear()
+                    world = build_collision_world(objects, tilemap)
+
+            tilemap.update(deltaTime)
+            tilemap.render_background(game)
+
+            for obj in objects:
+                if(obj.get_name() != "destination"):
+                    obj.update(deltaTime, game, objects, tilemap, world)
+                obj.render(game)
+
+            tilemap.render_foreground(game)
+        
+        else:
+            prompt_win.render(game)
+            
+        game.flip()
+
+        world.step()
+        if(handle_collision_events(world.drain_events(), objects)):
+            curr_level += 1
+
+            if(curr_level <= GLOBAL_CONFIG["num_levels"]):
+                level_config, tilemap, objects = next_level.finish() if next_level != None else build_level(game, GLOBAL_CONFIG, curr_level)
+                if(session.is_deterministic()):
+                    resources.finish_loads(game)
+                if(journal != None):
+                    journal.close()
+                    journal = None
+                history.clear()
+                next_level = LevelPrefetch(game, GLOBAL_CONFIG, curr_level + 1) if curr_level < GLOBAL_CONFIG["num_levels"] else None
+                world = build_collision_world(objects, tilemap)
+                resources.release_level(curr_level - 1)
+                find_obj("player", objects).set_curr_health(curr_health)
+            else:
+                win = True
+
+        elif(next_level != None):
+            next_level.step()
+
+        if(not was_editing and keys.is_key_pressed(mygameengine.Scancode.ESCAPE)):
+            editor_mode = True
+            editor_snapshot.capture(tilemap, objects, level_config)
+            if(journal == None):
+                journal = open_level_journal(GLOBAL_CONFIG, curr_level, open_level_file(GLOBAL_CONFIG, curr_level))
+
+        session.end_frame(tilemap, objects, curr_level, win, editor_mode)
+        if(mygameengine.Input.is_quit_clicked() or session.is_finished()):
+            run = False
+
+    if(journal != None):
+        journal.close()
+    session.close()
+
+if __name__ == "__main__":
     main()
\ No newline at end of file
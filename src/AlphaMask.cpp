@@ -0,0 +1,112 @@
+#include "AlphaMask.hpp"
+#include <algorithm>
+#include <bit>
+
+AlphaMask::AlphaMask()
+{
+}
+
+void AlphaMask::Build(const Uint32 *pixels, int width, int height, int pitch)
+{
+    mWidth = width;
+    mHeight = height;
+    mWordsPerRow = (width + 63) / 64;
+    mBits.assign(static_cast<size_t>(mWordsPerRow) * height, 0);
+    for (int y = 0; y < height; y++)
+    {
+        const Uint32 *row = reinterpret_cast<const Uint32 *>(reinterpret_cast<const Uint8 *>(pixels) + static_cast<size_t>(y) * pitch);
+        Uint64 *bits = mBits.data() + static_cast<size_t>(y) * mWordsPerRow;
+        for (int x = 0; x < width; x++)
+        {
+            bits[x >> 6] |= static_cast<Uint64>(row[x] > 0x00FFFFFF) << (x & 63);
+        }
+    }
+}
+
+bool AlphaMask::FindRowSpan(int y, int x0, int x1, int *first, int *last) const
+{
+    const Uint64 *bits = mBits.data() + static_cast<size_t>(y) * mWordsPerRow;
+    int firstWord = x0 >> 6;
+    int lastWord = (x1 - 1) >> 6;
+
+    // Only keep the columns between x0 and x1 of the words at both ends
+    auto word = [&](int i)
+    {
+        Uint64 w = bits[i];
+        if (i == firstWord)
+        {
+            w &= ~0ULL << (x0 & 63);
+        }
+        if (i == lastWord && (x1 & 63) != 0)
+        {
+            w &= ~0ULL >> (64 - (x1 & 63));
+        }
+        return w;
+    };
+
+    int i = firstWord;
+    while (i <= lastWord && word(i) == 0)
+    {
+        i++;
+    }
+    if (i > lastWord)
+    {
+        return false;
+    }
+    *first = i * 64 + std::countr_zero(word(i));
+
+    int j = lastWord;
+    while (word(j) == 0)
+    {
+        j--;
+    }
+    *last = j * 64 + 63 - std::countl_zero(word(j));
+    return true;
+}
+
+SDL_Rect AlphaMask::GetOpaqueBounds(const SDL_Rect &cell) const
+{
+    int x0 = std::max(cell.x, 0);
+    int y0 = std::max(cell.y, 0);
+    int x1 = std::min(cell.x + cell.w, mWidth);
+    int y1 = std::min(cell.y + cell.h, mHeight);
+
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return SDL_Rect{x0, y0, 0, 0};
+    }
+
+    int left = x1, right = -1, top = -1, bottom = -1;
+    for (int y = y0; y < y1; y++)
+    {
+        int first, last;
+        if (FindRowSpan(y, x0, x1, &first, &last))
+        {
+            left = std::min(left, first);
+            right = std::max(right, last);
+            top = top < 0 ? y : top;
+            bottom = y;
+        }
+    }
+
+    if (top < 0)
+    {
+        return SDL_Rect{x0, y0, 0, 0};
+    }
+    return SDL_Rect{left, top, right - left + 1, bottom - top + 1};
+}
+
+int AlphaMask::GetWidth() const
+{
+    return mWidth;
+}
+
+int AlphaMask::GetHeight() const
+{
+    return mHeight;
+}
+
+size_t AlphaMask::GetByteSize() const
+{
+    return mBits.size() * sizeof(Uint64);
+}
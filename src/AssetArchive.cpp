@@ -0,0 +1,204 @@
+#include "AssetArchive.hpp"
+#include "PixelOps.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(LINUX) || defined(__APPLE__)
+#define ASSET_ARCHIVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetArchive::AssetArchive()
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const std::string &filepath)
+{
+    Close();
+
+#ifdef ASSET_ARCHIVE_MMAP
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        SDL_Log("Error opening archive %s", filepath.c_str());
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0)
+    {
+        SDL_Log("Error reading archive %s", filepath.c_str());
+        close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive, the descriptor is not needed anymore
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        SDL_Log("Error mapping archive %s", filepath.c_str());
+        return false;
+    }
+    mData = static_cast<const Uint8 *>(mapped);
+    mSize = info.st_size;
+#else
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        SDL_Log("Error opening archive %s", filepath.c_str());
+        return false;
+    }
+    mBuffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(mBuffer.data()), mBuffer.size());
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+#endif
+
+    mHeader = reinterpret_cast<const AssetArchiveHeader *>(mData);
+    if (mSize >= sizeof(AssetArchiveHeader) && std::memcmp(mHeader->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0 && mHeader->version != ARCHIVE_VERSION)
+    {
+        SDL_Log("Error reading archive %s: version %u, pack the assets again with the AssetPacker", filepath.c_str(), mHeader->version);
+        Close();
+        return false;
+    }
+    if (!Validate())
+    {
+        SDL_Log("Error reading archive %s: not a valid archive", filepath.c_str());
+        Close();
+        return false;
+    }
+
+    mEntries = reinterpret_cast<const AssetArchiveEntry *>(mData + mHeader->indexOffset);
+    mIndex.reserve(mHeader->entryCount);
+    for (Uint32 i = 0; i < mHeader->entryCount; i++)
+    {
+        mIndex[GetPath(mEntries[i])] = &mEntries[i];
+    }
+    return true;
+}
+
+void AssetArchive::Close()
+{
+#ifdef ASSET_ARCHIVE_MMAP
+    if (mData != nullptr)
+    {
+        munmap(const_cast<Uint8 *>(mData), mSize);
+    }
+#endif
+    mBuffer.clear();
+    mBuffer.shrink_to_fit();
+    mData = nullptr;
+    mSize = 0;
+    mHeader = nullptr;
+    mEntries = nullptr;
+    mIndex.clear();
+}
+
+bool AssetArchive::IsOpen() const
+{
+    return mData != nullptr;
+}
+
+const AssetArchiveEntry *AssetArchive::Find(const std::string &assetPath) const
+{
+    auto found = mIndex.find(NormalizePath(assetPath));
+    if (found == mIndex.end())
+    {
+        return nullptr;
+    }
+    return found->second;
+}
+
+const AssetArchiveEntry &AssetArchive::GetEntry(int index) const
+{
+    return mEntries[index];
+}
+
+std::string_view AssetArchive::GetPath(const AssetArchiveEntry &entry) const
+{
+    return {reinterpret_cast<const char *>(mData + mHeader->stringsOffset + entry.pathOffset), entry.pathLength};
+}
+
+const void *AssetArchive::GetPixels(const AssetArchiveEntry &entry) const
+{
+    return mData + entry.dataOffset;
+}
+
+SDL_Texture *AssetArchive::CreateTexture(SDL_Renderer *renderer, const AssetArchiveEntry &entry, bool premultiply) const
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, mHeader->pixelFormat, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+    if (nullptr == texture)
+    {
+        SDL_Log("Error creating texture: %s", SDL_GetError());
+        return nullptr;
+    }
+    // The renderer copies straight from the mapping, unless the pixels have to be premultiplied first
+    const void *pixels = GetPixels(entry);
+    std::vector<Uint32> premultiplied;
+    if (premultiply)
+    {
+        const Uint32 *first = static_cast<const Uint32 *>(pixels);
+        premultiplied.assign(first, first + static_cast<size_t>(entry.pitch / 4) * entry.height);
+        PremultiplyAlpha(premultiplied.data(), entry.width, entry.height, entry.pitch);
+        pixels = premultiplied.data();
+    }
+    if (SDL_UpdateTexture(texture, nullptr, pixels, entry.pitch) != 0)
+    {
+        SDL_Log("Error updating texture: %s", SDL_GetError());
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+int AssetArchive::GetEntryCount() const
+{
+    return mHeader != nullptr ? mHeader->entryCount : 0;
+}
+
+Uint32 AssetArchive::GetPixelFormat() const
+{
+    return mHeader != nullptr ? mHeader->pixelFormat : 0;
+}
+
+std::string AssetArchive::NormalizePath(const std::string &assetPath)
+{
+    return std::filesystem::path(assetPath).lexically_normal().generic_string();
+}
+
+bool AssetArchive::Validate() const
+{
+    if (mSize < sizeof(AssetArchiveHeader) || std::memcmp(mHeader->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || mHeader->version != ARCHIVE_VERSION)
+    {
+        return false;
+    }
+    if (mHeader->indexOffset % alignof(AssetArchiveEntry) != 0 || mHeader->indexOffset > mSize ||
+        (mSize - mHeader->indexOffset) / sizeof(AssetArchiveEntry) < mHeader->entryCount || mHeader->stringsOffset > mSize)
+    {
+        return false;
+    }
+
+    int bytesPerPixel = SDL_BYTESPERPIXEL(mHeader->pixelFormat);
+    const AssetArchiveEntry *entries = reinterpret_cast<const AssetArchiveEntry *>(mData + mHeader->indexOffset);
+    for (Uint32 i = 0; i < mHeader->entryCount; i++)
+    {
+        const AssetArchiveEntry &entry = entries[i];
+        Uint64 dataSize = static_cast<Uint64>(entry.pitch) * entry.height;
+        if (entry.pitch < static_cast<Uint64>(entry.width) * bytesPerPixel || entry.dataOffset > mSize || dataSize > mSize - entry.dataOffset ||
+            static_cast<Uint64>(entry.pathOffset) + entry.pathLength > mSize - mHeader->stringsOffset)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,182 @@
+#include "AssetWatcher.hpp"
+#include <algorithm>
+#include <filesystem>
+
+#if defined(LINUX)
+#define ASSET_WATCHER_INOTIFY
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * The key of a file in the maps of the watcher, the same for "./assets/a.bmp" and "assets/a.bmp".
+     */
+    std::string NormalizePath(const std::filesystem::path &filepath)
+    {
+        return filepath.lexically_normal().generic_string();
+    }
+
+    /**
+     * How long the watcher thread waits for events at most, so that it notices Stop.
+     */
+    constexpr int POLL_TIMEOUT_MS = 100;
+}
+
+AssetWatcher::AssetWatcher()
+{
+}
+
+AssetWatcher::~AssetWatcher()
+{
+    Stop();
+}
+
+bool AssetWatcher::Start(Callback onChanged, Uint64 debounceNS)
+{
+    if (IsRunning())
+    {
+        return true;
+    }
+
+#ifdef ASSET_WATCHER_INOTIFY
+    mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mInotify == -1)
+    {
+        SDL_Log("Error starting the asset watcher: inotify_init1 failed");
+        return false;
+    }
+    mOnChanged = onChanged;
+    mDebounceNS = debounceNS;
+    mStop = false;
+    mThread = std::thread(&AssetWatcher::Run, this);
+    return true;
+#else
+    SDL_Log("The asset watcher is only supported on Linux");
+    return false;
+#endif
+}
+
+void AssetWatcher::Stop()
+{
+    mStop = true;
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+
+#ifdef ASSET_WATCHER_INOTIFY
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mInotify != -1)
+    {
+        // Closing the instance removes every watch
+        close(mInotify);
+        mInotify = -1;
+    }
+    mDirectories.clear();
+    mFiles.clear();
+#endif
+}
+
+bool AssetWatcher::IsRunning() const
+{
+    return mInotify != -1;
+}
+
+void AssetWatcher::Watch(const std::string &filepath)
+{
+#ifdef ASSET_WATCHER_INOTIFY
+    std::filesystem::path normalized = std::filesystem::path(filepath).lexically_normal();
+    std::string directory = normalized.parent_path().empty() ? "." : normalized.parent_path().generic_string();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mInotify == -1)
+    {
+        return;
+    }
+    auto &spellings = mFiles[normalized.generic_string()];
+    if (std::find(spellings.begin(), spellings.end(), filepath) != spellings.end())
+    {
+        return;
+    }
+    spellings.push_back(filepath);
+
+    // Adding the same directory again returns the same descriptor
+    int wd = inotify_add_watch(mInotify, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd == -1)
+    {
+        SDL_Log("Error watching %s", directory.c_str());
+        return;
+    }
+    mDirectories[wd] = directory;
+#endif
+}
+
+void AssetWatcher::Run()
+{
+#ifdef ASSET_WATCHER_INOTIFY
+    // When each changed file was last written, by normalized path
+    std::unordered_map<std::string, Uint64> pending;
+    alignas(inotify_event) char buffer[4096];
+
+    while (!mStop)
+    {
+        // Sleep until the next event, or until the first pending file goes quiet
+        int timeout = POLL_TIMEOUT_MS;
+        Uint64 now = SDL_GetTicksNS();
+        for (auto &[file, lastWrite] : pending)
+        {
+            Uint64 due = lastWrite + mDebounceNS;
+            timeout = std::min(timeout, due > now ? static_cast<int>((due - now) / 1000000) + 1 : 0);
+        }
+        pollfd fd{mInotify, POLLIN, 0};
+        poll(&fd, 1, timeout);
+
+        ssize_t length;
+        while ((length = read(mInotify, buffer, sizeof(buffer))) > 0)
+        {
+            now = SDL_GetTicksNS();
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (char *p = buffer; p < buffer + length;)
+            {
+                auto *event = reinterpret_cast<inotify_event *>(p);
+                p += sizeof(inotify_event) + event->len;
+                auto directory = mDirectories.find(event->wd);
+                if (event->len == 0 || directory == mDirectories.end())
+                {
+                    continue;
+                }
+                std::string file = NormalizePath(std::filesystem::path(directory->second) / event->name);
+                if (mFiles.count(file) != 0)
+                {
+                    pending[file] = now;
+                }
+            }
+        }
+
+        // Report the files that have not been written for the debounce delay
+        now = SDL_GetTicksNS();
+        std::vector<std::string> changed;
+        for (auto it = pending.begin(); it != pending.end();)
+        {
+            if (now - it->second >= mDebounceNS)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto &spellings = mFiles[it->first];
+                changed.insert(changed.end(), spellings.begin(), spellings.end());
+                it = pending.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+        for (auto &filepath : changed)
+        {
+            mOnChanged(filepath);
+        }
+    }
+#endif
+}
@@ -0,0 +1,627 @@
+#include "ChunkedTileMap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    /**
+     * The first bytes of a chunk file, followed by the version, the chunk size and the number of layers
+     * as 16-bit integers, then the ids of each layer.
+     */
+    const char CHUNK_MAGIC[4] = {'T', 'C', 'H', 'K'};
+    const Uint16 CHUNK_VERSION = 1;
+
+    int FloorDiv(int a, int b)
+    {
+        return a / b - (a % b != 0 && (a < 0) != (b < 0));
+    }
+}
+
+ChunkedTileMap::ChunkedTileMap(std::string directory, int tileWidth, int tileHeight, int chunkSize, int loadRadius)
+{
+    mDirectory = directory;
+    mTileWidth = std::max(1, tileWidth);
+    mTileHeight = std::max(1, tileHeight);
+    mChunkSize = std::max(1, chunkSize);
+    mLoadRadius = std::max(0, loadRadius);
+    mLayers.push_back({"terrain", true, false});
+}
+
+ChunkedTileMap::~ChunkedTileMap()
+{
+    SaveAll();
+    // The writes queued by Update may still be running
+    std::unique_lock<std::mutex> lock(mLoadMutex);
+    mLoadCondition.wait(lock, [this]
+                        { return mRunningJobs == 0; });
+}
+
+void ChunkedTileMap::AddTileType(std::string tileName, std::string filepath, bool collidable, SDL_FRect srcRect,
+                                 std::vector<SDL_FRect> frames, Uint32 frameDuration)
+{
+    TileRecord tr;
+    tr.filepath = filepath;
+    tr.collidable = collidable;
+    tr.srcRect = srcRect;
+    tr.frames = frames;
+    tr.frameDuration = frameDuration;
+    mTileTypes.emplace_back(tileName, tr);
+    for (auto &[key, chunk] : mChunks)
+    {
+        chunk.map->AddTileType(tileName, filepath, collidable, srcRect, frames, frameDuration);
+    }
+}
+
+int ChunkedTileMap::AddLayer(std::string name, bool collidable, bool foreground)
+{
+    mLayers.push_back({name, collidable, foreground});
+    for (auto &[key, chunk] : mChunks)
+    {
+        chunk.map->AddLayer(name, 1.0f, 1.0f, collidable, foreground);
+    }
+    return mLayers.size() - 1;
+}
+
+int ChunkedTileMap::GetLayerCount() const
+{
+    return mLayers.size();
+}
+
+void ChunkedTileMap::Update(float focusX, float focusY, float deltaTime)
+{
+    mTileClock += deltaTime;
+    AddLoadedChunks();
+
+    mFocusChunkX = static_cast<int>(std::floor(focusX / (mTileWidth * mChunkSize)));
+    mFocusChunkY = static_cast<int>(std::floor(focusY / (mTileHeight * mChunkSize)));
+
+    // Unload the chunks past the radius, writing back the edited ones
+    for (auto it = mChunks.begin(); it != mChunks.end();)
+    {
+        int chunkX = static_cast<Sint32>(it->first >> 32);
+        int chunkY = static_cast<Sint32>(static_cast<Uint32>(it->first));
+        if (std::max(std::abs(chunkX - mFocusChunkX), std::abs(chunkY - mFocusChunkY)) <= mLoadRadius + 1)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second.dirty)
+        {
+            SubmitJob([this, path = GetChunkPath(it->first), cells = GetChunkCells(it->second)]
+                      { WriteChunk(path, cells); });
+        }
+        it = mChunks.erase(it);
+    }
+
+    // Request the missing chunks, nearest first
+    std::vector<std::pair<int, Sint64>> requests;
+    for (int chunkY = mFocusChunkY - mLoadRadius; chunkY <= mFocusChunkY + mLoadRadius; chunkY++)
+    {
+        for (int chunkX = mFocusChunkX - mLoadRadius; chunkX <= mFocusChunkX + mLoadRadius; chunkX++)
+        {
+            Sint64 key = ChunkKey(chunkX, chunkY);
+            if (mChunks.find(key) != mChunks.end() || mPendingChunks.find(key) != mPendingChunks.end())
+            {
+                continue;
+            }
+            int dx = chunkX - mFocusChunkX;
+            int dy = chunkY - mFocusChunkY;
+            requests.emplace_back(dx * dx + dy * dy, key);
+        }
+    }
+    std::sort(requests.begin(), requests.end());
+    for (auto &request : requests)
+    {
+        Sint64 key = request.second;
+        mPendingChunks.insert(key);
+        SubmitJob([this, key, path = GetChunkPath(key), layerCount = GetLayerCount()]
+                  {
+                      LoadedChunk loaded{key, {}};
+                      ReadChunk(path, layerCount, loaded.cells);
+                      std::lock_guard<std::mutex> lock(mLoadMutex);
+                      mLoadedChunks.push_back(std::move(loaded)); });
+    }
+}
+
+void ChunkedTileMap::WaitForChunks()
+{
+    {
+        std::unique_lock<std::mutex> lock(mLoadMutex);
+        mLoadCondition.wait(lock, [this]
+                            { return mRunningJobs == 0; });
+    }
+    AddLoadedChunks();
+}
+
+bool ChunkedTileMap::SaveAll()
+{
+    bool saved = true;
+    for (auto &[key, chunk] : mChunks)
+    {
+        if (chunk.dirty)
+        {
+            chunk.dirty = !WriteChunk(GetChunkPath(key), GetChunkCells(chunk));
+            saved = saved && !chunk.dirty;
+        }
+    }
+    return saved;
+}
+
+bool ChunkedTileMap::StoreChunk(int chunkX, int chunkY, const Uint16 *ids)
+{
+    size_t cellCount = static_cast<size_t>(GetLayerCount()) * mChunkSize * mChunkSize;
+    if (std::any_of(ids, ids + cellCount, [&](Uint16 id)
+                    { return id > mTileTypes.size(); }))
+    {
+        std::cout << "Tile type not found" << std::endl;
+        return false;
+    }
+
+    // Let queued reads and writes of this chunk finish first, so they cannot overwrite it afterwards
+    WaitForChunks();
+
+    std::vector<Uint16> cells(ids, ids + cellCount);
+    if (!WriteChunk(GetChunkPath(ChunkKey(chunkX, chunkY)), cells))
+    {
+        return false;
+    }
+    auto it = mChunks.find(ChunkKey(chunkX, chunkY));
+    if (it != mChunks.end())
+    {
+        size_t layerSize = static_cast<size_t>(mChunkSize) * mChunkSize;
+        for (int layer = 0; layer < GetLayerCount(); layer++)
+        {
+            it->second.map->SetLayerCells(cells.data() + layer * layerSize, layer);
+        }
+        it->second.dirty = false;
+        it->second.texturesLoaded = false;
+    }
+    return true;
+}
+
+bool ChunkedTileMap::PlaceTileAt(std::string tileName, int rowNum, int columnNum, int layer)
+{
+    auto type = std::find_if(mTileTypes.begin(), mTileTypes.end(), [&](const auto &t)
+                             { return t.first == tileName; });
+    if (type == mTileTypes.end())
+    {
+        std::cout << "Tile type not found" << std::endl;
+        return false;
+    }
+    int row = 0;
+    int column = 0;
+    Chunk *chunk = FindCellChunk(rowNum, columnNum, &row, &column);
+    if (nullptr == chunk || layer < 0 || layer >= GetLayerCount())
+    {
+        std::cout << "Chunk or layer not loaded" << std::endl;
+        return false;
+    }
+    chunk->map->PlaceTileAt(tileName, row, column, layer);
+    chunk->dirty = true;
+    chunk->texturesLoaded = false;
+    return true;
+}
+
+bool ChunkedTileMap::EraseTileAt(int rowNum, int columnNum, int layer)
+{
+    int row = 0;
+    int column = 0;
+    Chunk *chunk = FindCellChunk(rowNum, columnNum, &row, &column);
+    if (nullptr == chunk || layer < 0 || layer >= GetLayerCount())
+    {
+        std::cout << "Chunk or layer not loaded" << std::endl;
+        return false;
+    }
+    chunk->map->EraseTileAt(row, column, layer);
+    chunk->dirty = true;
+    return true;
+}
+
+Uint16 ChunkedTileMap::GetTileId(int rowNum, int columnNum, int layer) const
+{
+    int chunkX = FloorDiv(columnNum, mChunkSize);
+    int chunkY = FloorDiv(rowNum, mChunkSize);
+    const Chunk *chunk = FindChunk(chunkX, chunkY);
+    if (nullptr == chunk)
+    {
+        return 0;
+    }
+    return chunk->map->GetTileId(rowNum - chunkY * mChunkSize, columnNum - chunkX * mChunkSize, layer);
+}
+
+bool ChunkedTileMap::HasCollisionWith(std::shared_ptr<GameEntity> target) const
+{
+    if (!target->isCollidable())
+    {
+        return false;
+    }
+    auto rect = target->GetCollision2D()->GetRect();
+    return HasCollisionAt(rect.x, rect.y, rect.w, rect.h);
+}
+
+bool ChunkedTileMap::HasCollisionAt(float x, float y, float w, float h) const
+{
+    float chunkWidth = static_cast<float>(mTileWidth * mChunkSize);
+    float chunkHeight = static_cast<float>(mTileHeight * mChunkSize);
+    int firstChunkX = static_cast<int>(std::floor(x / chunkWidth));
+    int lastChunkX = static_cast<int>(std::floor((x + w) / chunkWidth));
+    int firstChunkY = static_cast<int>(std::floor(y / chunkHeight));
+    int lastChunkY = static_cast<int>(std::floor((y + h) / chunkHeight));
+
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++)
+    {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++)
+        {
+            const Chunk *chunk = FindChunk(chunkX, chunkY);
+            // Each chunk tests the rectangle against its own merged rectangles, in its own coordinates
+            if (nullptr != chunk && chunk->map->HasCollisionAt(x - chunkX * chunkWidth, y - chunkY * chunkHeight, w, h))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+RaycastHit ChunkedTileMap::Raycast(float x, float y, float dirX, float dirY, float maxDistance) const
+{
+    RaycastHit result;
+    float length = std::sqrt(dirX * dirX + dirY * dirY);
+    if (length == 0.0f)
+    {
+        return result;
+    }
+    dirX /= length;
+    dirY /= length;
+
+    float chunkWidth = static_cast<float>(mTileWidth * mChunkSize);
+    float chunkHeight = static_cast<float>(mTileHeight * mChunkSize);
+    int chunkX = static_cast<int>(std::floor(x / chunkWidth));
+    int chunkY = static_cast<int>(std::floor(y / chunkHeight));
+    float pointX = x;
+    float pointY = y;
+    float distance = 0.0f;
+    while (true)
+    {
+        const Chunk *chunk = FindChunk(chunkX, chunkY);
+        if (nullptr == chunk)
+        {
+            break;
+        }
+
+        // Where the ray enters the chunk, kept inside it: a ray leaving a chunk to the left enters
+        // the next one on its right edge, which TileMap counts as outside
+        float originX = chunkX * chunkWidth;
+        float originY = chunkY * chunkHeight;
+        float localX = std::clamp(pointX - originX, 0.0f, std::nextafter(chunkWidth, 0.0f));
+        float localY = std::clamp(pointY - originY, 0.0f, std::nextafter(chunkHeight, 0.0f));
+        float remaining = maxDistance - distance;
+        RaycastHit part = chunk->map->Raycast(localX, localY, dirX, dirY, remaining);
+        if (part.hit)
+        {
+            distance += part.distance;
+            result.hit = true;
+            result.row = part.row + chunkY * mChunkSize;
+            result.column = part.column + chunkX * mChunkSize;
+            break;
+        }
+        // Compared with what this chunk was given rather than summed, so rounding cannot leave a sliver of ray
+        if (part.distance >= remaining)
+        {
+            distance = maxDistance;
+            break;
+        }
+        distance += part.distance;
+
+        // The ray left the chunk before its end, go on in the chunk past the border it reached first.
+        // At a corner the row changes first, as in the grid walk of TileMap
+        float borderX = dirX != 0.0f ? ((dirX > 0.0f ? chunkWidth : 0.0f) - localX) / dirX : INFINITY;
+        float borderY = dirY != 0.0f ? ((dirY > 0.0f ? chunkHeight : 0.0f) - localY) / dirY : INFINITY;
+        if (borderX < borderY)
+        {
+            chunkX += dirX > 0.0f ? 1 : -1;
+        }
+        else
+        {
+            chunkY += dirY > 0.0f ? 1 : -1;
+        }
+        pointX = originX + part.x;
+        pointY = originY + part.y;
+    }
+
+    result.distance = distance;
+    result.x = x + dirX * distance;
+    result.y = y + dirY * distance;
+    return result;
+}
+
+bool ChunkedTileMap::HasLineOfSight(float x0, float y0, float x1, float y1) const
+{
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0.0f)
+    {
+        return !Raycast(x0, y0, 1.0f, 0.0f, 0.0f).hit;
+    }
+    return !Raycast(x0, y0, dx, dy, length).hit;
+}
+
+bool ChunkedTileMap::IsChunkLoaded(int chunkX, int chunkY) const
+{
+    return nullptr != FindChunk(chunkX, chunkY);
+}
+
+int ChunkedTileMap::GetLoadedChunkCount() const
+{
+    return mChunks.size();
+}
+
+int ChunkedTileMap::GetPendingChunkCount() const
+{
+    return mPendingChunks.size();
+}
+
+size_t ChunkedTileMap::GetLoadedByteSize() const
+{
+    size_t cellBytes = static_cast<size_t>(GetLayerCount()) * mChunkSize * mChunkSize * sizeof(Uint16);
+    size_t size = 0;
+    for (auto &[key, chunk] : mChunks)
+    {
+        size += cellBytes + chunk.map->GetStaticCollisionRectCount() * sizeof(SDL_Rect);
+    }
+    return size;
+}
+
+int ChunkedTileMap::GetChunkSize() const
+{
+    return mChunkSize;
+}
+
+float ChunkedTileMap::GetTileWidth() const
+{
+    return mTileWidth;
+}
+
+float ChunkedTileMap::GetTileHeight() const
+{
+    return mTileHeight;
+}
+
+void ChunkedTileMap::SetCamera(float x, float y)
+{
+    mCameraX = x;
+    mCameraY = y;
+}
+
+void ChunkedTileMap::Render(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    RenderChunks(game, [&](TileMap &map)
+                 { map.Render(game); });
+}
+
+void ChunkedTileMap::RenderBackground(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    RenderChunks(game, [&](TileMap &map)
+                 { map.RenderBackground(game); });
+}
+
+void ChunkedTileMap::RenderForeground(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    RenderChunks(game, [&](TileMap &map)
+                 { map.RenderForeground(game); });
+}
+
+Sint64 ChunkedTileMap::ChunkKey(int chunkX, int chunkY)
+{
+    return static_cast<Sint64>(static_cast<Uint64>(static_cast<Uint32>(chunkX)) << 32 | static_cast<Uint32>(chunkY));
+}
+
+std::string ChunkedTileMap::GetChunkPath(Sint64 key) const
+{
+    int chunkX = static_cast<Sint32>(key >> 32);
+    int chunkY = static_cast<Sint32>(static_cast<Uint32>(key));
+    return mDirectory + "/chunk_" + std::to_string(chunkX) + "_" + std::to_string(chunkY) + ".bin";
+}
+
+void ChunkedTileMap::ReadChunk(const std::string &path, int layerCount, std::vector<Uint16> &cells) const
+{
+    size_t layerSize = static_cast<size_t>(mChunkSize) * mChunkSize;
+    cells.assign(layerCount * layerSize, 0);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        // Nothing was ever written there
+        return;
+    }
+    char magic[4];
+    Uint16 version = 0;
+    Uint16 chunkSize = 0;
+    Uint16 fileLayerCount = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&chunkSize), sizeof(chunkSize));
+    file.read(reinterpret_cast<char *>(&fileLayerCount), sizeof(fileLayerCount));
+    if (!file || std::memcmp(magic, CHUNK_MAGIC, sizeof(magic)) != 0 || version != CHUNK_VERSION || chunkSize != mChunkSize)
+    {
+        SDL_Log("Invalid chunk file %s", path.c_str());
+        return;
+    }
+    // Layers added since the chunk was written stay empty, layers the map no longer has are dropped
+    size_t readCount = std::min<size_t>(layerCount, fileLayerCount) * layerSize;
+    if (!file.read(reinterpret_cast<char *>(cells.data()), readCount * sizeof(Uint16)))
+    {
+        SDL_Log("Truncated chunk file %s", path.c_str());
+        std::fill(cells.begin(), cells.end(), 0);
+    }
+}
+
+bool ChunkedTileMap::WriteChunk(const std::string &path, const std::vector<Uint16> &cells) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory, error);
+
+    // Written next to the chunk then renamed over it, so a crash never leaves half a chunk
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        Uint16 version = CHUNK_VERSION;
+        Uint16 chunkSize = mChunkSize;
+        Uint16 layerCount = cells.size() / (static_cast<size_t>(mChunkSize) * mChunkSize);
+        file.write(CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        file.write(reinterpret_cast<const char *>(&chunkSize), sizeof(chunkSize));
+        file.write(reinterpret_cast<const char *>(&layerCount), sizeof(layerCount));
+        file.write(reinterpret_cast<const char *>(cells.data()), cells.size() * sizeof(Uint16));
+        if (!file)
+        {
+            SDL_Log("Could not write chunk file %s", path.c_str());
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        SDL_Log("Could not write chunk file %s: %s", path.c_str(), error.message().c_str());
+        return false;
+    }
+    return true;
+}
+
+void ChunkedTileMap::SubmitJob(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLoadMutex);
+        mRunningJobs++;
+    }
+    auto finish = [this]
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLoadMutex);
+            mRunningJobs--;
+        }
+        mLoadCondition.notify_all();
+    };
+    // A job the pool drops without running must not be waited for
+    mIOPool.Submit([job = std::move(job), finish]
+                   {
+                       job();
+                       finish(); },
+                   JobPriority::High, nullptr, finish);
+}
+
+void ChunkedTileMap::AddLoadedChunks()
+{
+    std::vector<LoadedChunk> loaded;
+    {
+        std::lock_guard<std::mutex> lock(mLoadMutex);
+        loaded.swap(mLoadedChunks);
+    }
+
+    for (auto &chunk : loaded)
+    {
+        mPendingChunks.erase(chunk.key);
+        int chunkX = static_cast<Sint32>(chunk.key >> 32);
+        int chunkY = static_cast<Sint32>(static_cast<Uint32>(chunk.key));
+        // The focus may have moved away while the chunk was read
+        if (std::max(std::abs(chunkX - mFocusChunkX), std::abs(chunkY - mFocusChunkY)) > mLoadRadius + 1)
+        {
+            continue;
+        }
+        // A layer added while the chunk was read was not read, it is empty
+        chunk.cells.resize(static_cast<size_t>(GetLayerCount()) * mChunkSize * mChunkSize, 0);
+        mChunks[chunk.key].map = MakeChunkMap(chunk.cells);
+    }
+}
+
+std::shared_ptr<TileMap> ChunkedTileMap::MakeChunkMap(const std::vector<Uint16> &cells) const
+{
+    auto map = std::make_shared<TileMap>(mTileWidth * mChunkSize, mTileHeight * mChunkSize, mChunkSize, mChunkSize);
+    for (auto &[name, tr] : mTileTypes)
+    {
+        map->AddTileType(name, tr.filepath, tr.collidable, tr.srcRect, tr.frames, tr.frameDuration);
+    }
+    for (size_t layer = 1; layer < mLayers.size(); layer++)
+    {
+        map->AddLayer(mLayers[layer].name, 1.0f, 1.0f, mLayers[layer].collidable, mLayers[layer].foreground);
+    }
+    size_t layerSize = static_cast<size_t>(mChunkSize) * mChunkSize;
+    for (int layer = 0; layer < GetLayerCount(); layer++)
+    {
+        // A layer holding an unknown id, from a file written with other tile types, is left empty
+        map->SetLayerCells(cells.data() + layer * layerSize, layer);
+    }
+    return map;
+}
+
+std::vector<Uint16> ChunkedTileMap::GetChunkCells(const Chunk &chunk) const
+{
+    size_t layerSize = static_cast<size_t>(mChunkSize) * mChunkSize;
+    std::vector<Uint16> cells;
+    cells.reserve(GetLayerCount() * layerSize);
+    for (int layer = 0; layer < GetLayerCount(); layer++)
+    {
+        const Uint16 *ids = chunk.map->GetLayerCells(layer);
+        cells.insert(cells.end(), ids, ids + layerSize);
+    }
+    return cells;
+}
+
+const ChunkedTileMap::Chunk *ChunkedTileMap::FindChunk(int chunkX, int chunkY) const
+{
+    auto it = mChunks.find(ChunkKey(chunkX, chunkY));
+    return it != mChunks.end() ? &it->second : nullptr;
+}
+
+ChunkedTileMap::Chunk *ChunkedTileMap::FindCellChunk(int rowNum, int columnNum, int *row, int *column)
+{
+    int chunkX = FloorDiv(columnNum, mChunkSize);
+    int chunkY = FloorDiv(rowNum, mChunkSize);
+    auto it = mChunks.find(ChunkKey(chunkX, chunkY));
+    if (it == mChunks.end())
+    {
+        return nullptr;
+    }
+    *row = rowNum - chunkY * mChunkSize;
+    *column = columnNum - chunkX * mChunkSize;
+    return &it->second;
+}
+
+void ChunkedTileMap::RenderChunks(std::shared_ptr<SDLGraphicsProgram> game, const std::function<void(TileMap &)> &render)
+{
+    int chunkWidth = mTileWidth * mChunkSize;
+    int chunkHeight = mTileHeight * mChunkSize;
+    int outputWidth = 0;
+    int outputHeight = 0;
+    SDL_GetCurrentRenderOutputSize(game->getSDLRenderer(), &outputWidth, &outputHeight);
+    int firstChunkX = static_cast<int>(std::floor(mCameraX / chunkWidth));
+    int lastChunkX = static_cast<int>(std::floor((mCameraX + outputWidth - 1) / chunkWidth));
+    int firstChunkY = static_cast<int>(std::floor(mCameraY / chunkHeight));
+    int lastChunkY = static_cast<int>(std::floor((mCameraY + outputHeight - 1) / chunkHeight));
+
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++)
+    {
+        for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++)
+        {
+            auto it = mChunks.find(ChunkKey(chunkX, chunkY));
+            if (it == mChunks.end())
+            {
+                continue;
+            }
+            Chunk &chunk = it->second;
+            if (!chunk.texturesLoaded)
+            {
+                chunk.map->LoadToGame(game);
+                chunk.texturesLoaded = true;
+            }
+            chunk.map->SetTileClock(mTileClock);
+            chunk.map->SetCamera(mCameraX - chunkX * chunkWidth, mCameraY - chunkY * chunkHeight);
+            render(*chunk.map);
+        }
+    }
+}
@@ -0,0 +1,316 @@
+#include "CollisionWorld.hpp"
+#include <algorithm>
+
+CollisionWorld::CollisionWorld(BroadphaseType broadphase) : mBroadphase(broadphase)
+{
+}
+
+CollisionWorld::~CollisionWorld()
+{
+}
+
+void CollisionWorld::AddEntity(std::shared_ptr<GameEntity> e)
+{
+    if (e == nullptr || !e->isCollidable() || FindId(e) != 0)
+    {
+        return;
+    }
+    Body body{mNextId++, e};
+    if (mBroadphase == BroadphaseType::DynamicTree)
+    {
+        body.proxyId = mTree.CreateProxy(e->GetCollision2D()->GetRect(), body.id);
+    }
+    mBodies.push_back(body);
+}
+
+void CollisionWorld::RemoveEntity(std::shared_ptr<GameEntity> e)
+{
+    uint32_t id = FindId(e);
+    if (id == 0)
+    {
+        return;
+    }
+
+    // Contacts of the removed body end now, they would otherwise never get an exit event
+    auto ended = std::remove_if(mCurrContacts.begin(), mCurrContacts.end(), [&](uint64_t key)
+                                {
+        uint32_t first = static_cast<uint32_t>(key >> 32);
+        uint32_t second = static_cast<uint32_t>(key);
+        if (first != id && second != id)
+        {
+            return false;
+        }
+        mEvents.push_back({CollisionEventType::Exit, FindBody(first)->entity, FindBody(second)->entity});
+        return true; });
+    mCurrContacts.erase(ended, mCurrContacts.end());
+
+    auto found = std::lower_bound(mBodies.begin(), mBodies.end(), id, [](const Body &b, uint32_t i)
+                                  { return b.id < i; });
+    if (found->proxyId != -1)
+    {
+        mTree.DestroyProxy(found->proxyId);
+    }
+    mBodies.erase(found);
+}
+
+void CollisionWorld::Clear()
+{
+    mBodies.clear();
+    mTree.Clear();
+    mPrevContacts.clear();
+    mCurrContacts.clear();
+    mEvents.clear();
+}
+
+void CollisionWorld::Step()
+{
+    std::swap(mPrevContacts, mCurrContacts);
+    mCurrContacts.clear();
+
+    // Fetch every rect once instead of going through the component map for each pair
+    std::vector<SDL_FRect> rects;
+    rects.reserve(mBodies.size());
+    for (auto &body : mBodies)
+    {
+        auto collider = body.entity->GetCollision2D();
+        SDL_FRect rect = collider != nullptr ? collider->GetRect() : SDL_FRect{0.0f, 0.0f, 0.0f, 0.0f};
+        rects.push_back({rect.x - mContactMargin, rect.y - mContactMargin, rect.w + 2 * mContactMargin, rect.h + 2 * mContactMargin});
+    }
+
+    FindContacts(rects);
+    std::sort(mCurrContacts.begin(), mCurrContacts.end());
+
+    // Both lists are sorted, so a single merge pass tells enter, stay and exit apart
+    auto prev = mPrevContacts.begin();
+    auto curr = mCurrContacts.begin();
+    while (prev != mPrevContacts.end() || curr != mCurrContacts.end())
+    {
+        CollisionEventType type;
+        uint64_t key;
+        if (curr == mCurrContacts.end() || (prev != mPrevContacts.end() && *prev < *curr))
+        {
+            type = CollisionEventType::Exit;
+            key = *prev++;
+        }
+        else if (prev == mPrevContacts.end() || *curr < *prev)
+        {
+            type = CollisionEventType::Enter;
+            key = *curr++;
+        }
+        else
+        {
+            type = CollisionEventType::Stay;
+            key = *curr++;
+            prev++;
+        }
+        mEvents.push_back({type, FindBody(static_cast<uint32_t>(key >> 32))->entity, FindBody(static_cast<uint32_t>(key))->entity});
+    }
+}
+
+std::vector<CollisionEvent> CollisionWorld::DrainEvents()
+{
+    std::vector<CollisionEvent> events;
+    events.swap(mEvents);
+    return events;
+}
+
+bool CollisionWorld::HasContact(std::shared_ptr<GameEntity> a, std::shared_ptr<GameEntity> b) const
+{
+    uint32_t idA = FindId(a);
+    uint32_t idB = FindId(b);
+    if (idA == 0 || idB == 0)
+    {
+        return false;
+    }
+    return std::binary_search(mCurrContacts.begin(), mCurrContacts.end(), MakePairKey(idA, idB));
+}
+
+int CollisionWorld::GetContactCount() const
+{
+    return mCurrContacts.size();
+}
+
+void CollisionWorld::SetContactMargin(float margin)
+{
+    mContactMargin = margin;
+}
+
+float CollisionWorld::GetContactMargin() const
+{
+    return mContactMargin;
+}
+
+int CollisionWorld::GetEntityCount() const
+{
+    return mBodies.size();
+}
+
+void CollisionWorld::SetTileMap(std::shared_ptr<TileMap> tilemap)
+{
+    mStaticTree.Clear();
+    mStaticRects = tilemap != nullptr ? tilemap->GetStaticCollisionRects() : std::vector<SDL_FRect>{};
+    for (size_t i = 0; i < mStaticRects.size(); i++)
+    {
+        mStaticTree.CreateProxy(mStaticRects[i], static_cast<int>(i));
+    }
+}
+
+bool CollisionWorld::IsBlockedAt(std::shared_ptr<GameEntity> e, float x, float y) const
+{
+    auto collider = e->GetCollision2D();
+    if (collider == nullptr)
+    {
+        return false;
+    }
+    SDL_FRect probe{x, y, collider->GetWidth(), collider->GetHeight()};
+
+    bool blocked = false;
+    mStaticTree.Query(probe, [&](int proxyId)
+                      {
+        blocked = SDL_HasRectIntersectionFloat(&probe, &mStaticRects[mStaticTree.GetUserData(proxyId)]);
+        return !blocked; });
+    if (blocked)
+    {
+        return true;
+    }
+
+    if (collider->IsTrigger())
+    {
+        return false;
+    }
+    // The entities may have been moved through their components since the last Step, which the proxies of mTree
+    // only follow at the next one, so every body is tested with its current box
+    for (auto &body : mBodies)
+    {
+        auto other = body.entity->GetCollision2D();
+        if (body.entity == e || other == nullptr || other->IsTrigger())
+        {
+            continue;
+        }
+        auto rect = other->GetRect();
+        if (SDL_HasRectIntersectionFloat(&probe, &rect))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::shared_ptr<GameEntity>> CollisionWorld::QueryRegion(float x, float y, float w, float h) const
+{
+    SDL_FRect region{x, y, w, h};
+    std::vector<std::shared_ptr<GameEntity>> found;
+    auto test = [&](const Body &body)
+    {
+        auto collider = body.entity->GetCollision2D();
+        if (collider == nullptr)
+        {
+            return;
+        }
+        // Inclusive test so that zero sized regions (points) on an edge still count
+        auto r = collider->GetRect();
+        if (r.x <= region.x + region.w && region.x <= r.x + r.w && r.y <= region.y + region.h && region.y <= r.y + r.h)
+        {
+            found.push_back(body.entity);
+        }
+    };
+
+    if (mBroadphase == BroadphaseType::DynamicTree)
+    {
+        for (int id : mTree.QueryRegion(region))
+        {
+            test(*FindBody(id));
+        }
+    }
+    else
+    {
+        for (auto &body : mBodies)
+        {
+            test(body);
+        }
+    }
+    return found;
+}
+
+std::vector<std::shared_ptr<GameEntity>> CollisionWorld::QueryPoint(float x, float y) const
+{
+    return QueryRegion(x, y, 0.0f, 0.0f);
+}
+
+BroadphaseType CollisionWorld::GetBroadphase() const
+{
+    return mBroadphase;
+}
+
+void CollisionWorld::FindContacts(const std::vector<SDL_FRect> &rects)
+{
+    if (mBroadphase == BroadphaseType::LinearScan)
+    {
+        for (size_t i = 0; i < mBodies.size(); i++)
+        {
+            for (size_t j = i + 1; j < mBodies.size(); j++)
+            {
+                if (SDL_HasRectIntersectionFloat(&rects[i], &rects[j]))
+                {
+                    mCurrContacts.push_back(MakePairKey(mBodies[i].id, mBodies[j].id));
+                }
+            }
+        }
+        return;
+    }
+
+    // Entities may have been moved directly through their components, so refit the proxies first
+    for (size_t i = 0; i < mBodies.size(); i++)
+    {
+        mTree.MoveProxy(mBodies[i].proxyId, rects[i]);
+    }
+
+    // The tree only knows the fattened boxes, confirm each candidate with the tight ones
+    for (auto &[proxyA, proxyB] : mTree.QueryPairs())
+    {
+        uint32_t idA = mTree.GetUserData(proxyA);
+        uint32_t idB = mTree.GetUserData(proxyB);
+        auto i = std::lower_bound(mBodies.begin(), mBodies.end(), idA, [](const Body &b, uint32_t id)
+                                  { return b.id < id; }) -
+                 mBodies.begin();
+        auto j = std::lower_bound(mBodies.begin(), mBodies.end(), idB, [](const Body &b, uint32_t id)
+                                  { return b.id < id; }) -
+                 mBodies.begin();
+        if (SDL_HasRectIntersectionFloat(&rects[i], &rects[j]))
+        {
+            mCurrContacts.push_back(MakePairKey(idA, idB));
+        }
+    }
+}
+
+const CollisionWorld::Body *CollisionWorld::FindBody(uint32_t id) const
+{
+    auto found = std::lower_bound(mBodies.begin(), mBodies.end(), id, [](const Body &b, uint32_t i)
+                                  { return b.id < i; });
+    if (found == mBodies.end() || found->id != id)
+    {
+        return nullptr;
+    }
+    return &*found;
+}
+
+uint32_t CollisionWorld::FindId(const std::shared_ptr<GameEntity> &e) const
+{
+    for (auto &body : mBodies)
+    {
+        if (body.entity == e)
+        {
+            return body.id;
+        }
+    }
+    return 0;
+}
+
+uint64_t CollisionWorld::MakePairKey(uint32_t a, uint32_t b)
+{
+    if (a > b)
+    {
+        std::swap(a, b);
+    }
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
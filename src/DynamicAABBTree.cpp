@@ -0,0 +1,390 @@
+#include "DynamicAABBTree.hpp"
+#include <algorithm>
+
+DynamicAABBTree::DynamicAABBTree(float margin) : mMargin(margin)
+{
+}
+
+DynamicAABBTree::~DynamicAABBTree()
+{
+}
+
+int DynamicAABBTree::CreateProxy(SDL_FRect rect, int userData)
+{
+    int proxyId = AllocateNode();
+    AABB box = ToAABB(rect);
+    mNodes[proxyId].box = {box.minX - mMargin, box.minY - mMargin, box.maxX + mMargin, box.maxY + mMargin};
+    mNodes[proxyId].userData = userData;
+    mNodes[proxyId].height = 0;
+    InsertLeaf(proxyId);
+    mProxyCount++;
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxyId)
+{
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    mProxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int proxyId, SDL_FRect rect)
+{
+    AABB box = ToAABB(rect);
+    if (Contains(mNodes[proxyId].box, box))
+    {
+        return false;
+    }
+
+    RemoveLeaf(proxyId);
+    mNodes[proxyId].box = {box.minX - mMargin, box.minY - mMargin, box.maxX + mMargin, box.maxY + mMargin};
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+    mNodes.clear();
+    mRoot = -1;
+    mFreeList = -1;
+    mProxyCount = 0;
+}
+
+int DynamicAABBTree::GetUserData(int proxyId) const
+{
+    return mNodes[proxyId].userData;
+}
+
+SDL_FRect DynamicAABBTree::GetFatRect(int proxyId) const
+{
+    const AABB &b = mNodes[proxyId].box;
+    return {b.minX, b.minY, b.maxX - b.minX, b.maxY - b.minY};
+}
+
+void DynamicAABBTree::Query(SDL_FRect rect, const std::function<bool(int)> &callback) const
+{
+    if (mRoot == -1)
+    {
+        return;
+    }
+
+    AABB box = ToAABB(rect);
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(mRoot);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node &node = mNodes[nodeId];
+        if (!Overlaps(node.box, box))
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            if (!callback(nodeId))
+            {
+                return;
+            }
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+std::vector<int> DynamicAABBTree::QueryRegion(SDL_FRect rect) const
+{
+    std::vector<int> found;
+    Query(rect, [&](int proxyId)
+          {
+        found.push_back(mNodes[proxyId].userData);
+        return true; });
+    return found;
+}
+
+std::vector<int> DynamicAABBTree::QueryPoint(float x, float y) const
+{
+    return QueryRegion({x, y, 0.0f, 0.0f});
+}
+
+std::vector<std::pair<int, int>> DynamicAABBTree::QueryPairs() const
+{
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < static_cast<int>(mNodes.size()); i++)
+    {
+        if (mNodes[i].height != 0)
+        {
+            continue;
+        }
+        Query(GetFatRect(i), [&](int other)
+              {
+            // Every overlap is found from both sides, keep the one seen from the smaller id
+            if (other > i)
+            {
+                pairs.push_back({i, other});
+            }
+            return true; });
+    }
+    return pairs;
+}
+
+int DynamicAABBTree::GetHeight() const
+{
+    return mRoot == -1 ? 0 : mNodes[mRoot].height;
+}
+
+int DynamicAABBTree::GetProxyCount() const
+{
+    return mProxyCount;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+    if (mFreeList == -1)
+    {
+        mNodes.emplace_back();
+        return mNodes.size() - 1;
+    }
+
+    int nodeId = mFreeList;
+    mFreeList = mNodes[nodeId].parent;
+    mNodes[nodeId] = Node();
+    return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int nodeId)
+{
+    mNodes[nodeId].parent = mFreeList;
+    mNodes[nodeId].height = -1;
+    mFreeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+    if (mRoot == -1)
+    {
+        mRoot = leaf;
+        mNodes[mRoot].parent = -1;
+        return;
+    }
+
+    // Walk down to the sibling that costs the least: the new parent perimeter plus the growth of every ancestor
+    AABB leafBox = mNodes[leaf].box;
+    int index = mRoot;
+    while (!mNodes[index].IsLeaf())
+    {
+        int child1 = mNodes[index].child1;
+        int child2 = mNodes[index].child2;
+
+        float perimeter = Perimeter(mNodes[index].box);
+        float combinedPerimeter = Perimeter(Union(mNodes[index].box, leafBox));
+
+        float cost = 2.0f * combinedPerimeter;
+        float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+        auto descendCost = [&](int child)
+        {
+            float grown = Perimeter(Union(leafBox, mNodes[child].box));
+            if (mNodes[child].IsLeaf())
+            {
+                return grown + inheritanceCost;
+            }
+            return grown - Perimeter(mNodes[child].box) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+    int sibling = index;
+
+    int oldParent = mNodes[sibling].parent;
+    int newParent = AllocateNode();
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].box = Union(leafBox, mNodes[sibling].box);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].child1 = sibling;
+    mNodes[newParent].child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent == -1)
+    {
+        mRoot = newParent;
+    }
+    else if (mNodes[oldParent].child1 == sibling)
+    {
+        mNodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        mNodes[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance the ancestors
+    index = mNodes[leaf].parent;
+    while (index != -1)
+    {
+        index = Balance(index);
+
+        int child1 = mNodes[index].child1;
+        int child2 = mNodes[index].child2;
+        mNodes[index].height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+        mNodes[index].box = Union(mNodes[child1].box, mNodes[child2].box);
+
+        index = mNodes[index].parent;
+    }
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = -1;
+        return;
+    }
+
+    int parent = mNodes[leaf].parent;
+    int grandParent = mNodes[parent].parent;
+    int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if (grandParent == -1)
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = -1;
+        FreeNode(parent);
+        return;
+    }
+
+    // The sibling takes the place of the parent
+    if (mNodes[grandParent].child1 == parent)
+    {
+        mNodes[grandParent].child1 = sibling;
+    }
+    else
+    {
+        mNodes[grandParent].child2 = sibling;
+    }
+    mNodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    int index = grandParent;
+    while (index != -1)
+    {
+        index = Balance(index);
+
+        int child1 = mNodes[index].child1;
+        int child2 = mNodes[index].child2;
+        mNodes[index].box = Union(mNodes[child1].box, mNodes[child2].box);
+        mNodes[index].height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+
+        index = mNodes[index].parent;
+    }
+}
+
+int DynamicAABBTree::Balance(int iA)
+{
+    Node &A = mNodes[iA];
+    if (A.IsLeaf() || A.height < 2)
+    {
+        return iA;
+    }
+
+    int iB = A.child1;
+    int iC = A.child2;
+    Node &B = mNodes[iB];
+    Node &C = mNodes[iC];
+    int balance = C.height - B.height;
+
+    // Rotate the taller child up: it becomes the parent of A and A adopts its shorter grandchild
+    auto rotateUp = [&](int iUp, Node &up, int iOther, bool upWasChild2)
+    {
+        int iF = up.child1;
+        int iG = up.child2;
+        Node &F = mNodes[iF];
+        Node &G = mNodes[iG];
+
+        up.child1 = iA;
+        up.parent = A.parent;
+        A.parent = iUp;
+
+        if (up.parent == -1)
+        {
+            mRoot = iUp;
+        }
+        else if (mNodes[up.parent].child1 == iA)
+        {
+            mNodes[up.parent].child1 = iUp;
+        }
+        else
+        {
+            mNodes[up.parent].child2 = iUp;
+        }
+
+        const Node &other = mNodes[iOther];
+        int iKeep = F.height > G.height ? iF : iG;
+        int iGive = iKeep == iF ? iG : iF;
+        Node &give = mNodes[iGive];
+
+        up.child2 = iKeep;
+        if (upWasChild2)
+        {
+            A.child2 = iGive;
+        }
+        else
+        {
+            A.child1 = iGive;
+        }
+        give.parent = iA;
+        A.box = Union(other.box, give.box);
+        A.height = 1 + std::max(other.height, give.height);
+        up.box = Union(A.box, mNodes[iKeep].box);
+        up.height = 1 + std::max(A.height, mNodes[iKeep].height);
+        return iUp;
+    };
+
+    if (balance > 1)
+    {
+        return rotateUp(iC, C, iB, true);
+    }
+    if (balance < -1)
+    {
+        return rotateUp(iB, B, iC, false);
+    }
+    return iA;
+}
+
+DynamicAABBTree::AABB DynamicAABBTree::Union(const AABB &a, const AABB &b)
+{
+    return {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+float DynamicAABBTree::Perimeter(const AABB &a)
+{
+    return 2.0f * ((a.maxX - a.minX) + (a.maxY - a.minY));
+}
+
+bool DynamicAABBTree::Overlaps(const AABB &a, const AABB &b)
+{
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+bool DynamicAABBTree::Contains(const AABB &outer, const AABB &inner)
+{
+    return outer.minX <= inner.minX && outer.minY <= inner.minY && inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+}
+
+DynamicAABBTree::AABB DynamicAABBTree::ToAABB(SDL_FRect rect)
+{
+    return {rect.x, rect.y, rect.x + rect.w, rect.y + rect.h};
+}
@@ -0,0 +1,265 @@
+#include "EditHistory.hpp"
+#include "Collision2DComponent.hpp"
+#include "TransformComponent.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    /**
+     * Check if two records describe the same state, whatever their sequence and checksum.
+     */
+    bool SameState(EditRecord a, EditRecord b)
+    {
+        a.sequence = b.sequence = 0;
+        a.checksum = b.checksum = 0;
+        return std::memcmp(&a, &b, sizeof(EditRecord)) == 0;
+    }
+
+    /**
+     * Check if a record adds or removes an enemy rather than moving an entity.
+     */
+    bool IsPresence(const EditRecord &record)
+    {
+        return record.op == EditOp::AddEnemy || record.op == EditOp::RemoveEnemy;
+    }
+
+    /**
+     * Build the record of a cell holding a tile type id.
+     */
+    EditRecord CellRecord(const TileDelta &delta, Uint16 id)
+    {
+        EditRecord record;
+        record.op = id != 0 ? EditOp::PlaceTile : EditOp::EraseTile;
+        record.layer = delta.layer;
+        record.row = delta.row;
+        record.column = delta.column;
+        record.value = id;
+        return record;
+    }
+}
+
+EditHistory::EditHistory()
+{
+}
+
+EditHistory::~EditHistory()
+{
+}
+
+void EditHistory::RecordTile(int layer, int row, int column, Uint16 before, Uint16 after)
+{
+    mRecording.tiles.push_back(TileDelta{row, column, static_cast<Uint16>(layer), before, after});
+}
+
+void EditHistory::RecordEntity(std::shared_ptr<GameEntity> entity, const EditRecord &before, const EditRecord &after)
+{
+    mRecording.entities.push_back(EntityDelta{std::move(entity), before, after});
+}
+
+void EditHistory::EndStep()
+{
+    if (mRecording.tiles.empty() && mRecording.entities.empty())
+    {
+        return;
+    }
+    // Composed with itself, so that a cell painted over several times in one stroke is kept once
+    std::vector<EditStep> recorded(1);
+    recorded[0] = std::move(mRecording);
+    mRecording = EditStep{};
+    EditStep step = Compose(recorded.cbegin(), recorded.cend());
+    if (step.tiles.empty() && step.entities.empty())
+    {
+        return;
+    }
+
+    for (const EditStep &undone : mRedo)
+    {
+        mByteSize -= StepBytes(undone);
+    }
+    mRedo.clear();
+    mByteSize += StepBytes(step);
+    mUndo.push_back(std::move(step));
+    Coalesce();
+}
+
+std::vector<EditRecord> EditHistory::Undo(std::shared_ptr<TileMap> tilemap)
+{
+    EndStep();
+    if (mUndo.empty())
+    {
+        return {};
+    }
+    mRedo.push_back(std::move(mUndo.back()));
+    mUndo.pop_back();
+    return Apply(tilemap, mRedo.back(), false);
+}
+
+std::vector<EditRecord> EditHistory::Redo(std::shared_ptr<TileMap> tilemap)
+{
+    if (mRedo.empty())
+    {
+        return {};
+    }
+    mUndo.push_back(std::move(mRedo.back()));
+    mRedo.pop_back();
+    return Apply(tilemap, mUndo.back(), true);
+}
+
+void EditHistory::Clear()
+{
+    mRecording = EditStep{};
+    mUndo.clear();
+    mRedo.clear();
+    mByteSize = 0;
+    mCoalescedCount = 0;
+}
+
+int EditHistory::GetUndoCount() const
+{
+    return static_cast<int>(mUndo.size());
+}
+
+int EditHistory::GetRedoCount() const
+{
+    return static_cast<int>(mRedo.size());
+}
+
+int EditHistory::GetCoalescedCount() const
+{
+    return mCoalescedCount;
+}
+
+void EditHistory::SetMemoryBudget(size_t bytes)
+{
+    mMemoryBudget = bytes;
+    Coalesce();
+}
+
+size_t EditHistory::GetByteSize() const
+{
+    return mByteSize;
+}
+
+EditStep EditHistory::Compose(std::vector<EditStep>::const_iterator first, std::vector<EditStep>::const_iterator last)
+{
+    EditStep merged;
+    // Cells by layer, row and column; rows and columns fit in 24 bits
+    std::unordered_map<Uint64, size_t> tileIndices;
+    // Entities by pointer and by kind of change, a move and a removal of the same entity are kept apart
+    std::map<std::pair<const GameEntity *, bool>, size_t> entityIndices;
+    for (auto step = first; step != last; ++step)
+    {
+        for (const TileDelta &delta : step->tiles)
+        {
+            Uint64 key = (static_cast<Uint64>(delta.layer) << 48) | (static_cast<Uint64>(delta.row & 0xFFFFFF) << 24) |
+                         static_cast<Uint64>(delta.column & 0xFFFFFF);
+            auto [found, added] = tileIndices.try_emplace(key, merged.tiles.size());
+            if (added)
+            {
+                merged.tiles.push_back(delta);
+            }
+            else
+            {
+                merged.tiles[found->second].after = delta.after;
+            }
+        }
+        for (const EntityDelta &delta : step->entities)
+        {
+            if (nullptr == delta.entity)
+            {
+                merged.entities.push_back(delta);
+                continue;
+            }
+            auto [found, added] = entityIndices.try_emplace(std::make_pair(delta.entity.get(), IsPresence(delta.after)),
+                                                            merged.entities.size());
+            if (added)
+            {
+                merged.entities.push_back(delta);
+            }
+            else
+            {
+                merged.entities[found->second].after = delta.after;
+            }
+        }
+    }
+
+    std::erase_if(merged.tiles, [](const TileDelta &delta)
+                  { return delta.before == delta.after; });
+    std::erase_if(merged.entities, [](const EntityDelta &delta)
+                  { return SameState(delta.before, delta.after); });
+    merged.tiles.shrink_to_fit();
+    merged.entities.shrink_to_fit();
+    return merged;
+}
+
+size_t EditHistory::StepBytes(const EditStep &step)
+{
+    return sizeof(EditStep) + step.tiles.capacity() * sizeof(TileDelta) + step.entities.capacity() * sizeof(EntityDelta);
+}
+
+std::vector<EditRecord> EditHistory::Apply(std::shared_ptr<TileMap> tilemap, const EditStep &step, bool redo)
+{
+    std::vector<EditRecord> records;
+    records.reserve(step.tiles.size() + step.entities.size());
+
+    // Undone from the last change to the first, so a cell changed twice ends up as it was before the first change
+    std::vector<TileChange> changes;
+    changes.reserve(step.tiles.size());
+    for (size_t i = 0; i < step.tiles.size(); i++)
+    {
+        const TileDelta &delta = step.tiles[redo ? i : step.tiles.size() - 1 - i];
+        Uint16 id = redo ? delta.after : delta.before;
+        changes.push_back(TileChange{delta.row, delta.column, id, delta.layer});
+        records.push_back(CellRecord(delta, id));
+    }
+    if (nullptr != tilemap)
+    {
+        tilemap->SetTileIds(changes);
+    }
+
+    for (size_t i = 0; i < step.entities.size(); i++)
+    {
+        const EntityDelta &delta = step.entities[redo ? i : step.entities.size() - 1 - i];
+        const EditRecord &state = redo ? delta.after : delta.before;
+        records.push_back(state);
+        if (nullptr == delta.entity || (state.op != EditOp::MovePlayer && state.op != EditOp::MoveDestination))
+        {
+            continue;
+        }
+        auto transform = delta.entity->GetTransform();
+        if (nullptr != transform)
+        {
+            transform->SetXY(state.transform[0], state.transform[1]);
+            transform->SetWH(state.transform[2], state.transform[3]);
+        }
+        auto collider = delta.entity->GetCollision2D();
+        if (nullptr != collider)
+        {
+            collider->SetXY(state.collider[0], state.collider[1]);
+            collider->SetWH(state.collider[2], state.collider[3]);
+        }
+    }
+    return records;
+}
+
+void EditHistory::Coalesce()
+{
+    while (mByteSize > mMemoryBudget && mUndo.size() > 1)
+    {
+        // Half of the steps at a time, so that a long history is not merged again step after step
+        size_t count = std::max<size_t>(2, mUndo.size() / 2);
+        EditStep merged = Compose(mUndo.cbegin(), mUndo.cbegin() + count);
+        for (size_t i = 0; i < count; i++)
+        {
+            mByteSize -= StepBytes(mUndo[i]);
+        }
+        mByteSize += StepBytes(merged);
+        mUndo.erase(mUndo.begin() + 1, mUndo.begin() + count);
+        mUndo[0] = std::move(merged);
+        mCoalescedCount += static_cast<int>(count) - 1;
+    }
+}
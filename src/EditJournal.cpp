@@ -0,0 +1,339 @@
+#include "EditJournal.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(LINUX) || defined(__APPLE__)
+#define EDIT_JOURNAL_FSYNC
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(EditRecord) == 72, "EditRecord is stored as is in journal files");
+
+namespace
+{
+    /**
+     * Push the writes of a file to the disk, not only to the operating system.
+     */
+    bool SyncFile(std::FILE *file)
+    {
+        if (std::fflush(file) != 0)
+        {
+            return false;
+        }
+#ifdef EDIT_JOURNAL_FSYNC
+        return fsync(fileno(file)) == 0;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * Write a journal header followed by records to a file.
+     */
+    bool WriteJournal(std::FILE *file, Uint32 baseSequence, const std::vector<EditRecord> &records)
+    {
+        EditJournalHeader header;
+        std::memcpy(header.magic, EditJournal::JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = EditJournal::JOURNAL_VERSION;
+        header.recordSize = sizeof(EditRecord);
+        header.baseSequence = baseSequence;
+        return std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+               std::fwrite(records.data(), sizeof(EditRecord), records.size(), file) == records.size() && SyncFile(file);
+    }
+}
+
+EditJournal::EditJournal()
+{
+}
+
+EditJournal::~EditJournal()
+{
+    Close();
+}
+
+bool EditJournal::Open(const std::string &filepath, Uint32 minSequence)
+{
+    Close();
+
+    std::error_code error;
+    std::vector<EditRecord> records;
+    Uint32 baseSequence = 0;
+    if (std::filesystem::exists(filepath, error))
+    {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        std::vector<char> bytes(file ? static_cast<size_t>(file.tellg()) : 0);
+        file.seekg(0);
+        file.read(bytes.data(), bytes.size());
+        EditJournalHeader header;
+        if (!file || bytes.size() < sizeof(header))
+        {
+            SDL_Log("Error reading journal %s", filepath.c_str());
+            return false;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header.version != JOURNAL_VERSION ||
+            header.recordSize != sizeof(EditRecord))
+        {
+            SDL_Log("Error reading journal %s: not a valid journal", filepath.c_str());
+            return false;
+        }
+
+        // Records are appended with increasing sequence numbers, the first one that is cut short,
+        // fails its checksum or breaks the sequence is where a crash interrupted a write
+        baseSequence = header.baseSequence;
+        size_t offset = sizeof(header);
+        for (; offset + sizeof(EditRecord) <= bytes.size(); offset += sizeof(EditRecord))
+        {
+            EditRecord record;
+            std::memcpy(&record, bytes.data() + offset, sizeof(record));
+            Uint32 expected = (records.empty() ? baseSequence : records.back().sequence) + 1;
+            if (record.sequence != expected || record.checksum != Checksum(record))
+            {
+                break;
+            }
+            records.push_back(record);
+        }
+        if (offset < bytes.size())
+        {
+            SDL_Log("Journal %s: dropping %zu bytes of an interrupted write", filepath.c_str(), bytes.size() - offset);
+            std::filesystem::resize_file(filepath, offset, error);
+            if (error)
+            {
+                SDL_Log("Error repairing journal %s: %s", filepath.c_str(), error.message().c_str());
+                return false;
+            }
+        }
+    }
+    else
+    {
+        std::filesystem::path directory = std::filesystem::path(filepath).parent_path();
+        if (!directory.empty())
+        {
+            std::filesystem::create_directories(directory, error);
+        }
+        std::FILE *file = std::fopen(filepath.c_str(), "wb");
+        bool written = file != nullptr && WriteJournal(file, 0, records);
+        if (file != nullptr)
+        {
+            std::fclose(file);
+        }
+        if (!written)
+        {
+            SDL_Log("Error creating journal %s", filepath.c_str());
+            return false;
+        }
+    }
+
+    mFile = std::fopen(filepath.c_str(), "ab");
+    if (nullptr == mFile)
+    {
+        SDL_Log("Error opening journal %s", filepath.c_str());
+        return false;
+    }
+    mFilepath = filepath;
+    mRecords = records;
+    mWritten = std::move(records);
+    mDroppedSequence = baseSequence;
+    mLastSequence = mWritten.empty() ? baseSequence : mWritten.back().sequence;
+    if (mLastSequence < minSequence)
+    {
+        // Every record is older than the level, restart the journal after it; no job is running yet
+        mLastSequence = minSequence;
+        mDroppedSequence = minSequence;
+        mRecords.clear();
+        Rewrite(minSequence);
+    }
+    return true;
+}
+
+void EditJournal::Close()
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+    Flush();
+    if (mFile != nullptr)
+    {
+        std::fclose(mFile);
+        mFile = nullptr;
+    }
+    mFilepath.clear();
+    mRecords.clear();
+    mWritten.clear();
+    mLastSequence = 0;
+    mDroppedSequence = 0;
+    std::lock_guard<std::mutex> lock(mMutex);
+    mWrittenCount = 0;
+    mSyncCount = 0;
+}
+
+bool EditJournal::IsOpen() const
+{
+    // mFile belongs to the background thread once the journal is open
+    return !mFilepath.empty();
+}
+
+const std::vector<EditRecord> &EditJournal::GetRecords() const
+{
+    return mRecords;
+}
+
+Uint32 EditJournal::Append(EditRecord record)
+{
+    if (!IsOpen())
+    {
+        return 0;
+    }
+    record.sequence = ++mLastSequence;
+    record.checksum = Checksum(record);
+
+    bool queueWrite = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.push_back(record);
+        // A write already queued picks this record up too
+        queueWrite = !mWriteQueued;
+        mWriteQueued = true;
+    }
+    if (queueWrite)
+    {
+        SubmitJob([this]
+                  { WritePending(); });
+    }
+    return record.sequence;
+}
+
+void EditJournal::Flush()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mJobCondition.wait(lock, [this]
+                       { return mRunningJobs == 0; });
+}
+
+void EditJournal::DropThrough(Uint32 sequence)
+{
+    sequence = std::min(sequence, mLastSequence);
+    if (!IsOpen() || sequence <= mDroppedSequence)
+    {
+        return;
+    }
+    mDroppedSequence = sequence;
+    SubmitJob([this, sequence]
+              { Rewrite(sequence); });
+}
+
+Uint32 EditJournal::GetLastSequence() const
+{
+    return mLastSequence;
+}
+
+int EditJournal::GetRecordCount() const
+{
+    return static_cast<int>(mLastSequence - mDroppedSequence);
+}
+
+int EditJournal::GetWrittenCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mWrittenCount;
+}
+
+int EditJournal::GetSyncCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSyncCount;
+}
+
+Uint32 EditJournal::Checksum(const EditRecord &record)
+{
+    // FNV-1a, enough to tell a torn or partly written record from a complete one
+    const Uint8 *bytes = reinterpret_cast<const Uint8 *>(&record);
+    Uint32 hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(EditRecord, checksum); i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void EditJournal::WritePending()
+{
+    std::vector<EditRecord> records;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        records.swap(mPending);
+        mWriteQueued = false;
+    }
+    if (nullptr == mFile || std::fwrite(records.data(), sizeof(EditRecord), records.size(), mFile) != records.size() || !SyncFile(mFile))
+    {
+        SDL_Log("Error writing journal %s", mFilepath.c_str());
+    }
+    mWritten.insert(mWritten.end(), records.begin(), records.end());
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mWrittenCount += records.size();
+    mSyncCount++;
+}
+
+void EditJournal::Rewrite(Uint32 sequence)
+{
+    std::vector<EditRecord> kept;
+    for (const EditRecord &record : mWritten)
+    {
+        if (record.sequence > sequence)
+        {
+            kept.push_back(record);
+        }
+    }
+
+    // Written next to the journal then renamed over it, so a crash leaves either the old or the new journal
+    std::string temporaryPath = mFilepath + ".tmp";
+    std::FILE *file = std::fopen(temporaryPath.c_str(), "wb");
+    bool written = file != nullptr && WriteJournal(file, sequence, kept);
+    if (file != nullptr)
+    {
+        std::fclose(file);
+    }
+    std::error_code error;
+    if (written)
+    {
+        std::filesystem::rename(temporaryPath, mFilepath, error);
+    }
+    if (!written || error)
+    {
+        SDL_Log("Error compacting journal %s", mFilepath.c_str());
+        return;
+    }
+
+    if (mFile != nullptr)
+    {
+        std::fclose(mFile);
+    }
+    mFile = std::fopen(mFilepath.c_str(), "ab");
+    if (nullptr == mFile)
+    {
+        SDL_Log("Error opening journal %s", mFilepath.c_str());
+        return;
+    }
+    mWritten = std::move(kept);
+}
+
+void EditJournal::SubmitJob(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRunningJobs++;
+    }
+    mIOPool.Submit([this, job = std::move(job)]
+                   {
+                       job();
+                       {
+                           std::lock_guard<std::mutex> lock(mMutex);
+                           mRunningJobs--;
+                       }
+                       mJobCondition.notify_all(); });
+}
@@ -0,0 +1,167 @@
+#include "EventQueue.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    /**
+     * Get the text pointer of an event that carries text SDL frees on the next poll, nullptr for any other event.
+     */
+    char **EventText(SDL_Event &event)
+    {
+        switch (event.type)
+        {
+        case SDL_EVENT_TEXT_INPUT:
+            return &event.text.text;
+        case SDL_EVENT_TEXT_EDITING:
+            return &event.edit.text;
+        case SDL_EVENT_DROP_FILE:
+        case SDL_EVENT_DROP_TEXT:
+            return &event.drop.data;
+        default:
+            return nullptr;
+        }
+    }
+
+    /**
+     * Check if an event is a press whose latency is measured.
+     */
+    bool IsPress(const SDL_Event &event)
+    {
+        return (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) || event.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+    }
+}
+
+EventQueue::EventQueue(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    mEvents.resize(size);
+}
+
+EventQueue::~EventQueue()
+{
+}
+
+int EventQueue::Pump()
+{
+    mFrameStart = mNext;
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        // The events of this frame are all kept, whatever the capacity
+        if (mNext - mFrameStart == mEvents.size())
+        {
+            Grow();
+        }
+        QueuedEvent &queued = mEvents[mNext & (mEvents.size() - 1)];
+        queued.event = event;
+        queued.sequence = mNext++;
+        mOldest = std::max(mOldest, mNext > mEvents.size() ? mNext - mEvents.size() : 0);
+        queued.text[0] = '\0';
+        char **text = EventText(queued.event);
+        if (nullptr != text)
+        {
+            if (nullptr != *text)
+            {
+                std::strncpy(queued.text, *text, sizeof(queued.text) - 1);
+                queued.text[sizeof(queued.text) - 1] = '\0';
+            }
+            *text = nullptr;
+        }
+        if (event.type == SDL_EVENT_DROP_FILE || event.type == SDL_EVENT_DROP_TEXT)
+        {
+            // Freed by SDL like the data, and not copied
+            queued.event.drop.source = nullptr;
+        }
+        if (event.type == SDL_EVENT_QUIT)
+        {
+            mQuitRequested = true;
+        }
+    }
+    return static_cast<int>(mNext - mFrameStart);
+}
+
+int EventQueue::GetFrameEventCount() const
+{
+    return static_cast<int>(mNext - mFrameStart);
+}
+
+const QueuedEvent &EventQueue::GetFrameEvent(int index) const
+{
+    return mEvents[(mFrameStart + index) & (mEvents.size() - 1)];
+}
+
+std::vector<QueuedEvent> EventQueue::GetFrameEvents() const
+{
+    return GetEventsSince(mFrameStart);
+}
+
+std::vector<QueuedEvent> EventQueue::GetEventsSince(Uint64 sequence) const
+{
+    std::vector<QueuedEvent> events;
+    for (Uint64 i = std::max(sequence, mOldest); i < mNext; i++)
+    {
+        events.push_back(mEvents[i & (mEvents.size() - 1)]);
+    }
+    return events;
+}
+
+Uint64 EventQueue::GetSequence() const
+{
+    return mNext;
+}
+
+size_t EventQueue::GetCapacity() const
+{
+    return mEvents.size();
+}
+
+bool EventQueue::IsQuitRequested() const
+{
+    return mQuitRequested;
+}
+
+void EventQueue::MarkPresented(Uint64 presentNS)
+{
+    for (Uint64 i = std::max(mPresented, mOldest); i < mNext; i++)
+    {
+        const SDL_Event &event = mEvents[i & (mEvents.size() - 1)].event;
+        if (!IsPress(event) || event.common.timestamp > presentNS)
+        {
+            continue;
+        }
+        double ms = (presentNS - event.common.timestamp) / 1000000.0;
+        mLatency.count++;
+        mLatencyTotalMs += ms;
+        mLatency.meanMs = mLatencyTotalMs / mLatency.count;
+        mLatency.maxMs = std::max(mLatency.maxMs, ms);
+        mLatency.lastMs = ms;
+    }
+    mPresented = mNext;
+}
+
+InputLatency EventQueue::GetLatency() const
+{
+    return mLatency;
+}
+
+void EventQueue::ResetLatency()
+{
+    mLatency = InputLatency{};
+    mLatencyTotalMs = 0.0;
+    mPresented = mNext;
+}
+
+void EventQueue::Grow()
+{
+    std::vector<QueuedEvent> events(mEvents.size() * 2);
+    for (Uint64 i = mOldest; i < mNext; i++)
+    {
+        events[i & (events.size() - 1)] = mEvents[i & (mEvents.size() - 1)];
+    }
+    mEvents = std::move(events);
+}
@@ -0,0 +1,67 @@
+#include "FrameClock.hpp"
+#include "Input.hpp"
+#include "InputRecording.hpp"
+
+namespace
+{
+    /**
+     * The time of the last tick in milliseconds.
+     */
+    Uint64 ticks{0};
+
+    /**
+     * The time between the last two ticks in seconds.
+     * Initialized to 60fps.
+     */
+    float deltaTime{1.0f / 60.0f};
+
+    /**
+     * Whether the clock was ticked yet.
+     */
+    bool started{false};
+
+    /**
+     * Whether the last tick took its time from a replay, which has nothing to do with SDL_GetTicks.
+     */
+    bool replayed{false};
+}
+
+FrameClock::FrameClock()
+{
+}
+
+FrameClock::~FrameClock()
+{
+}
+
+float FrameClock::Tick()
+{
+    auto replay = Input::GetReplay();
+    if (nullptr != replay && replay->PeekClock(deltaTime, ticks))
+    {
+        started = true;
+        replayed = true;
+        return deltaTime;
+    }
+
+    Uint64 now = SDL_GetTicks();
+    // The frame after a replay keeps the delta time of the last replayed frame
+    if (started && !replayed)
+    {
+        deltaTime = (now - ticks) / 1000.0f;
+    }
+    ticks = now;
+    started = true;
+    replayed = false;
+    return deltaTime;
+}
+
+float FrameClock::GetDeltaTime()
+{
+    return deltaTime;
+}
+
+Uint64 FrameClock::GetTicks()
+{
+    return started ? ticks : SDL_GetTicks();
+}
@@ -1,117 +1,240 @@
-#include "Input.hpp"
-#include <cstdint>
-
-Input::Input()
-{
-}
-
-Input::~Input()
-{
-}
-
-bool Input::isUpKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_UP];
-}
-
-bool Input::isDownKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_DOWN];
-}
-
-bool Input::isLeftKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_LEFT];
-}
-
-bool Input::isRightKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_RIGHT];
-}
-
-bool Input::isESCKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_ESCAPE];
-}
-
-bool Input::isXKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_X];
-}
-
-bool Input::isEKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_E];
-}
-
-bool Input::isSKeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_S];
-}
-
-bool Input::is1KeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_1];
-}
-
-bool Input::is2KeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_2];
-}
-
-bool Input::is3KeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_3];
-}
-
-bool Input::is4KeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_4];
-}
-
-bool Input::is5KeyDown()
-{
-    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_5];
-}
-
-std::vector<float> Input::GetMouseClickPosition()
-{
-    float x = 0;
-    float y = 0;
-    std::vector<float> mouseState;
-
-    uint32_t result = SDL_GetMouseState(&x, &y);
-    if (result & SDL_BUTTON(SDL_BUTTON_LEFT))
-    {
-        mouseState.push_back(x);
-        mouseState.push_back(y);
-    }
-
-    return mouseState;
-}
-
-std::vector<float> Input::GetMousePosition()
-{
-    float x = 0;
-    float y = 0;
-    std::vector<float> mouseState;
-
-    SDL_GetMouseState(&x, &y);
-    mouseState.push_back(x);
-    mouseState.push_back(y);
-
-    return mouseState;
-}
-
-bool Input::isQuitClicked()
-{
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
-    {
-        if (event.type == SDL_EVENT_QUIT)
-        {
-            return true;
-        }
-    }
-    return false;
+#include "Input.hpp"
+#include "EventQueue.hpp"
+#include "FrameClock.hpp"
+#include "InputRecording.hpp"
+#include <cstdint>
+
+namespace
+{
+    /**
+     * The snapshot of the current frame.
+     */
+    InputSnapshot snapshot;
+
+    /**
+     * The recording the frames are added to, if any.
+     */
+    std::shared_ptr<InputRecording> recording;
+
+    /**
+     * The recording the frames are played from, if any.
+     */
+    std::shared_ptr<InputRecording> replay;
+}
+
+Input::Input()
+{
+}
+
+Input::~Input()
+{
+}
+
+const InputSnapshot &Input::Update()
+{
+    // Keyboard and mouse state are only updated by the event queue, which is pumped here once per frame
+    EventQueue &events = EventQueue::Instance();
+    events.Pump();
+    if (nullptr != replay)
+    {
+        // The events are still pumped for quit, but the keyboard and mouse are the replayed ones
+        if (replay->Play(snapshot))
+        {
+            snapshot.frame++;
+            return snapshot;
+        }
+        replay = nullptr;
+    }
+    snapshot.previousKeys = snapshot.keys;
+    snapshot.previousMouseButtons = snapshot.mouseButtons;
+
+    int keyCount = 0;
+    const Uint8 *keys = SDL_GetKeyboardState(&keyCount);
+    snapshot.keys.reset();
+    for (int i = 0; i < keyCount && i < SDL_NUM_SCANCODES; i++)
+    {
+        if (keys[i])
+        {
+            snapshot.keys.set(i);
+        }
+    }
+    snapshot.mouseButtons = SDL_GetMouseState(&snapshot.mouseX, &snapshot.mouseY);
+    // A key or button pressed and released between two frames is down for this frame, so the press is not lost
+    for (int i = 0; i < events.GetFrameEventCount(); i++)
+    {
+        const SDL_Event &event = events.GetFrameEvent(i).event;
+        if (event.type == SDL_EVENT_KEY_DOWN && event.key.keysym.scancode >= 0 && event.key.keysym.scancode < SDL_NUM_SCANCODES)
+        {
+            snapshot.keys.set(event.key.keysym.scancode);
+        }
+        else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN && event.button.button >= 1 && event.button.button <= 32)
+        {
+            snapshot.mouseButtons |= SDL_BUTTON(event.button.button);
+        }
+    }
+    snapshot.frame++;
+    if (nullptr != recording)
+    {
+        recording->Record(snapshot, FrameClock::GetDeltaTime(), FrameClock::GetTicks());
+    }
+    return snapshot;
+}
+
+const InputSnapshot &Input::GetSnapshot()
+{
+    return snapshot;
+}
+
+void Input::StartRecording(std::shared_ptr<InputRecording> newRecording)
+{
+    recording = std::move(newRecording);
+    if (nullptr != recording)
+    {
+        recording->Clear();
+    }
+}
+
+void Input::StopRecording()
+{
+    recording = nullptr;
+}
+
+void Input::StartReplay(std::shared_ptr<InputRecording> newReplay)
+{
+    replay = std::move(newReplay);
+    if (nullptr != replay)
+    {
+        replay->Rewind();
+    }
+}
+
+void Input::StopReplay()
+{
+    replay = nullptr;
+}
+
+std::shared_ptr<InputRecording> Input::GetReplay()
+{
+    return replay;
+}
+
+bool Input::IsReplaying()
+{
+    return nullptr != replay && !replay->IsFinished();
+}
+
+bool Input::IsKeyDown(SDL_Scancode scancode)
+{
+    return snapshot.IsKeyDown(scancode);
+}
+
+bool Input::IsKeyPressed(SDL_Scancode scancode)
+{
+    return snapshot.IsKeyPressed(scancode);
+}
+
+bool Input::IsKeyReleased(SDL_Scancode scancode)
+{
+    return snapshot.IsKeyReleased(scancode);
+}
+
+bool Input::isUpKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_UP);
+}
+
+bool Input::isDownKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_DOWN);
+}
+
+bool Input::isLeftKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_LEFT);
+}
+
+bool Input::isRightKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_RIGHT);
+}
+
+bool Input::isESCKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_ESCAPE);
+}
+
+bool Input::isXKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_X);
+}
+
+bool Input::isEKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_E);
+}
+
+bool Input::isSKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_S);
+}
+
+bool Input::isZKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_Z);
+}
+
+bool Input::isYKeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_Y);
+}
+
+bool Input::is1KeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_1);
+}
+
+bool Input::is2KeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_2);
+}
+
+bool Input::is3KeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_3);
+}
+
+bool Input::is4KeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_4);
+}
+
+bool Input::is5KeyDown()
+{
+    return snapshot.IsKeyDown(SDL_SCANCODE_5);
+}
+
+std::vector<float> Input::GetMouseClickPosition()
+{
+    std::vector<float> mouseState;
+    if (snapshot.IsMouseButtonDown(SDL_BUTTON_LEFT))
+    {
+        mouseState.push_back(snapshot.mouseX);
+        mouseState.push_back(snapshot.mouseY);
+    }
+
+    return mouseState;
+}
+
+std::vector<float> Input::GetMousePosition()
+{
+    std::vector<float> mouseState;
+    mouseState.push_back(snapshot.mouseX);
+    mouseState.push_back(snapshot.mouseY);
+
+    return mouseState;
+}
+
+bool Input::isQuitClicked()
+{
+    return EventQueue::Instance().IsQuitRequested();
 }
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "InputRecording.hpp"
+#include <cstring>
+#include <fstream>
+
+static_assert(sizeof(InputRecordingHeader) == 24, "InputRecordingHeader is stored as is in recording files");
+static_assert(sizeof(InputRecordingFrame) == 32, "InputRecordingFrame is stored as is in recording files");
+
+InputRecording::InputRecording()
+{
+}
+
+InputRecording::~InputRecording()
+{
+}
+
+void InputRecording::Record(const InputSnapshot &snapshot, float deltaTime, Uint64 ticks)
+{
+    InputRecordingFrame frame{};
+    frame.deltaTime = deltaTime;
+    if (mFrames.empty())
+    {
+        mStartTicks = ticks;
+        mRecordedKeys.reset();
+    }
+    else
+    {
+        frame.elapsedMs = static_cast<Uint32>(ticks - mRecordedTicks);
+    }
+    frame.mouseX = snapshot.mouseX;
+    frame.mouseY = snapshot.mouseY;
+    frame.mouseButtons = snapshot.mouseButtons;
+
+    std::bitset<SDL_NUM_SCANCODES> changed = snapshot.keys ^ mRecordedKeys;
+    size_t count = changed.count();
+    for (size_t i = 0; i < changed.size() && frame.keyChangeCount < count; i++)
+    {
+        if (changed.test(i))
+        {
+            mKeyChanges.push_back(static_cast<Uint16>(i));
+            frame.keyChangeCount++;
+        }
+    }
+    mFrames.push_back(frame);
+    mRecordedKeys = snapshot.keys;
+    mRecordedTicks = ticks;
+}
+
+void InputRecording::SetStateHash(Uint64 hash)
+{
+    if (!mFrames.empty())
+    {
+        mFrames.back().stateHash = hash;
+    }
+}
+
+Uint64 InputRecording::GetStateHash(int frame) const
+{
+    return frame >= 0 && frame < GetFrameCount() ? mFrames[frame].stateHash : 0;
+}
+
+float InputRecording::GetDeltaTime(int frame) const
+{
+    return frame >= 0 && frame < GetFrameCount() ? mFrames[frame].deltaTime : 0.0f;
+}
+
+int InputRecording::GetFrameCount() const
+{
+    return static_cast<int>(mFrames.size());
+}
+
+size_t InputRecording::GetByteSize() const
+{
+    return sizeof(InputRecordingHeader) + mFrames.size() * sizeof(InputRecordingFrame) + mKeyChanges.size() * sizeof(Uint16);
+}
+
+void InputRecording::Clear()
+{
+    mFrames.clear();
+    mKeyChanges.clear();
+    mStartTicks = 0;
+    mRecordedKeys.reset();
+    mRecordedTicks = 0;
+    Rewind();
+}
+
+bool InputRecording::Save(const std::string &filepath) const
+{
+    InputRecordingHeader header;
+    std::memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.frameCount = static_cast<Uint32>(mFrames.size());
+    header.keyChangeCount = static_cast<Uint32>(mKeyChanges.size());
+    header.startTicks = mStartTicks;
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    // Each frame is followed by its key changes
+    size_t keyChange = 0;
+    for (const InputRecordingFrame &frame : mFrames)
+    {
+        file.write(reinterpret_cast<const char *>(&frame), sizeof(frame));
+        file.write(reinterpret_cast<const char *>(mKeyChanges.data() + keyChange), frame.keyChangeCount * sizeof(Uint16));
+        keyChange += frame.keyChangeCount;
+    }
+    file.flush();
+    if (!file)
+    {
+        SDL_Log("Error writing input recording %s", filepath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::Load(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        SDL_Log("Error opening input recording %s", filepath.c_str());
+        return false;
+    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(bytes.data(), bytes.size());
+    InputRecordingHeader header;
+    if (!file || bytes.size() < sizeof(header))
+    {
+        SDL_Log("Error reading input recording %s", filepath.c_str());
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) != 0 || header.version != RECORDING_VERSION ||
+        bytes.size() != sizeof(header) + static_cast<size_t>(header.frameCount) * sizeof(InputRecordingFrame) +
+                            static_cast<size_t>(header.keyChangeCount) * sizeof(Uint16))
+    {
+        SDL_Log("Error reading input recording %s: not a valid recording", filepath.c_str());
+        return false;
+    }
+
+    std::vector<InputRecordingFrame> frames(header.frameCount);
+    std::vector<Uint16> keyChanges;
+    keyChanges.reserve(header.keyChangeCount);
+    size_t offset = sizeof(header);
+    for (InputRecordingFrame &frame : frames)
+    {
+        std::memcpy(&frame, bytes.data() + offset, sizeof(frame));
+        offset += sizeof(frame);
+        if (frame.keyChangeCount > header.keyChangeCount - keyChanges.size())
+        {
+            SDL_Log("Error reading input recording %s: not a valid recording", filepath.c_str());
+            return false;
+        }
+        for (Uint32 i = 0; i < frame.keyChangeCount; i++)
+        {
+            Uint16 scancode;
+            std::memcpy(&scancode, bytes.data() + offset, sizeof(scancode));
+            offset += sizeof(scancode);
+            if (scancode >= SDL_NUM_SCANCODES)
+            {
+                SDL_Log("Error reading input recording %s: not a valid recording", filepath.c_str());
+                return false;
+            }
+            keyChanges.push_back(scancode);
+        }
+    }
+
+    mFrames = std::move(frames);
+    mKeyChanges = std::move(keyChanges);
+    mStartTicks = header.startTicks;
+    // Recording more goes on from the last frame
+    mRecordedKeys.reset();
+    for (Uint16 scancode : mKeyChanges)
+    {
+        mRecordedKeys.flip(scancode);
+    }
+    mRecordedTicks = mStartTicks;
+    for (const InputRecordingFrame &frame : mFrames)
+    {
+        mRecordedTicks += frame.elapsedMs;
+    }
+    Rewind();
+    return true;
+}
+
+void InputRecording::Rewind()
+{
+    mPosition = 0;
+    mKeyChangePosition = 0;
+    mPlayedTicks = mStartTicks;
+}
+
+int InputRecording::GetPosition() const
+{
+    return mPosition;
+}
+
+bool InputRecording::IsFinished() const
+{
+    return mPosition >= GetFrameCount();
+}
+
+bool InputRecording::PeekClock(float &deltaTime, Uint64 &ticks) const
+{
+    if (IsFinished())
+    {
+        return false;
+    }
+    deltaTime = mFrames[mPosition].deltaTime;
+    ticks = mPlayedTicks + mFrames[mPosition].elapsedMs;
+    return true;
+}
+
+bool InputRecording::Play(InputSnapshot &snapshot)
+{
+    if (IsFinished())
+    {
+        return false;
+    }
+    const InputRecordingFrame &frame = mFrames[mPosition];
+    snapshot.previousKeys = snapshot.keys;
+    snapshot.previousMouseButtons = snapshot.mouseButtons;
+    if (mPosition == 0)
+    {
+        // The input from before the replay is not part of it
+        snapshot.keys.reset();
+        snapshot.previousKeys.reset();
+        snapshot.previousMouseButtons = 0;
+    }
+    for (Uint32 i = 0; i < frame.keyChangeCount; i++)
+    {
+        snapshot.keys.flip(mKeyChanges[mKeyChangePosition + i]);
+    }
+    snapshot.mouseButtons = frame.mouseButtons;
+    snapshot.mouseX = frame.mouseX;
+    snapshot.mouseY = frame.mouseY;
+
+    mKeyChangePosition += frame.keyChangeCount;
+    mPlayedTicks += frame.elapsedMs;
+    mPosition++;
+    return true;
+}
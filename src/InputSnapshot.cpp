@@ -0,0 +1,69 @@
+#include "InputSnapshot.hpp"
+
+namespace
+{
+    /**
+     * Get the SDL_BUTTON flag of a mouse button, 0 for a button out of range.
+     */
+    Uint32 ButtonFlag(int button)
+    {
+        return button >= 1 && button <= 32 ? SDL_BUTTON(button) : 0;
+    }
+
+    /**
+     * Get the scancodes of the bits set in a key bitset.
+     */
+    std::vector<int> Scancodes(const std::bitset<SDL_NUM_SCANCODES> &bits)
+    {
+        std::vector<int> scancodes;
+        size_t count = bits.count();
+        for (size_t i = 0; i < bits.size() && scancodes.size() < count; i++)
+        {
+            if (bits.test(i))
+            {
+                scancodes.push_back(static_cast<int>(i));
+            }
+        }
+        return scancodes;
+    }
+}
+
+bool InputSnapshot::IsKeyDown(SDL_Scancode scancode) const
+{
+    return scancode >= 0 && scancode < SDL_NUM_SCANCODES && keys.test(scancode);
+}
+
+bool InputSnapshot::IsKeyPressed(SDL_Scancode scancode) const
+{
+    return scancode >= 0 && scancode < SDL_NUM_SCANCODES && keys.test(scancode) && !previousKeys.test(scancode);
+}
+
+bool InputSnapshot::IsKeyReleased(SDL_Scancode scancode) const
+{
+    return scancode >= 0 && scancode < SDL_NUM_SCANCODES && !keys.test(scancode) && previousKeys.test(scancode);
+}
+
+bool InputSnapshot::IsMouseButtonDown(int button) const
+{
+    return (mouseButtons & ButtonFlag(button)) != 0;
+}
+
+bool InputSnapshot::IsMouseButtonPressed(int button) const
+{
+    return (mouseButtons & ~previousMouseButtons & ButtonFlag(button)) != 0;
+}
+
+bool InputSnapshot::IsMouseButtonReleased(int button) const
+{
+    return (~mouseButtons & previousMouseButtons & ButtonFlag(button)) != 0;
+}
+
+std::vector<int> InputSnapshot::GetKeysDown() const
+{
+    return Scancodes(keys);
+}
+
+std::vector<int> InputSnapshot::GetKeysPressed() const
+{
+    return Scancodes(keys & ~previousKeys);
+}
@@ -0,0 +1,195 @@
+#include "LevelFile.hpp"
+#include <cstring>
+#include <fstream>
+
+#if defined(LINUX) || defined(__APPLE__)
+#define LEVEL_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LevelFile::LevelFile()
+{
+}
+
+LevelFile::~LevelFile()
+{
+    Close();
+}
+
+bool LevelFile::Open(const std::string &filepath)
+{
+    Close();
+
+#ifdef LEVEL_FILE_MMAP
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        SDL_Log("Error opening level file %s", filepath.c_str());
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0)
+    {
+        SDL_Log("Error reading level file %s", filepath.c_str());
+        close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive, the descriptor is not needed anymore
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        SDL_Log("Error mapping level file %s", filepath.c_str());
+        return false;
+    }
+    size_t size = info.st_size;
+    mMapping = std::shared_ptr<const Uint8>(static_cast<const Uint8 *>(mapped), [size](const Uint8 *data)
+                                            { munmap(const_cast<Uint8 *>(data), size); });
+    mSize = size;
+#else
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        SDL_Log("Error opening level file %s", filepath.c_str());
+        return false;
+    }
+    auto buffer = std::make_shared<std::vector<Uint8>>(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(buffer->data()), buffer->size());
+    mMapping = std::shared_ptr<const Uint8>(buffer, buffer->data());
+    mSize = buffer->size();
+#endif
+    mData = mMapping.get();
+
+    mHeader = reinterpret_cast<const LevelFileHeader *>(mData);
+    if (!Validate())
+    {
+        SDL_Log("Error reading level file %s: not a valid level file", filepath.c_str());
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LevelFile::Close()
+{
+    // Unmapped once the views shared by GetMapping are gone too
+    mMapping.reset();
+    mData = nullptr;
+    mSize = 0;
+    mHeader = nullptr;
+}
+
+bool LevelFile::IsOpen() const
+{
+    return mData != nullptr;
+}
+
+std::shared_ptr<const Uint8> LevelFile::GetMapping() const
+{
+    return mMapping;
+}
+
+std::string_view LevelFile::GetName() const
+{
+    return GetString(mHeader->nameOffset);
+}
+
+int LevelFile::GetRowCount() const
+{
+    return static_cast<int>(mHeader->rows);
+}
+
+int LevelFile::GetColumnCount() const
+{
+    return static_cast<int>(mHeader->columns);
+}
+
+int LevelFile::GetLayerCount() const
+{
+    return static_cast<int>(mHeader->layerCount);
+}
+
+const LevelFileLayer &LevelFile::GetLayer(int index) const
+{
+    return *reinterpret_cast<const LevelFileLayer *>(mData + mHeader->layersOffset + static_cast<Uint64>(index) * mHeader->layerSize);
+}
+
+const Uint16 *LevelFile::GetLayerCells(int index) const
+{
+    return reinterpret_cast<const Uint16 *>(mData + GetLayer(index).cellsOffset);
+}
+
+int LevelFile::GetSpawnCount() const
+{
+    return static_cast<int>(mHeader->spawnCount);
+}
+
+const LevelFileSpawn &LevelFile::GetSpawn(int index) const
+{
+    return *reinterpret_cast<const LevelFileSpawn *>(mData + mHeader->spawnsOffset + static_cast<Uint64>(index) * mHeader->spawnSize);
+}
+
+std::string_view LevelFile::GetString(Uint32 offset) const
+{
+    // Validate made sure every referenced offset is inside the table and the table ends with a 0 byte
+    return reinterpret_cast<const char *>(mData + mHeader->stringsOffset + offset);
+}
+
+Uint32 LevelFile::GetJournalSequence() const
+{
+    return mHeader->journalSequence;
+}
+
+size_t LevelFile::GetByteSize() const
+{
+    return mSize;
+}
+
+bool LevelFile::Validate() const
+{
+    if (mSize < sizeof(LevelFileHeader) || std::memcmp(mHeader->magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) != 0 || mHeader->version != LEVEL_VERSION)
+    {
+        return false;
+    }
+    if (mHeader->stringsOffset > mSize || mHeader->stringsSize == 0 || mHeader->stringsSize > mSize - mHeader->stringsOffset ||
+        mData[mHeader->stringsOffset + mHeader->stringsSize - 1] != 0 || mHeader->nameOffset >= mHeader->stringsSize)
+    {
+        return false;
+    }
+    if (mHeader->layerCount == 0 || mHeader->layerSize < sizeof(LevelFileLayer) || mHeader->layerSize % alignof(LevelFileLayer) != 0 ||
+        mHeader->layersOffset % alignof(LevelFileLayer) != 0 || mHeader->layersOffset > mSize ||
+        (mSize - mHeader->layersOffset) / mHeader->layerSize < mHeader->layerCount)
+    {
+        return false;
+    }
+    if (mHeader->spawnSize < sizeof(LevelFileSpawn) || mHeader->spawnSize % alignof(LevelFileSpawn) != 0 ||
+        mHeader->spawnsOffset % alignof(LevelFileSpawn) != 0 || mHeader->spawnsOffset > mSize ||
+        (mSize - mHeader->spawnsOffset) / mHeader->spawnSize < mHeader->spawnCount)
+    {
+        return false;
+    }
+
+    Uint64 cellBytes = static_cast<Uint64>(mHeader->rows) * mHeader->columns * sizeof(Uint16);
+    for (int i = 0; i < GetLayerCount(); i++)
+    {
+        const LevelFileLayer &layer = GetLayer(i);
+        if (layer.cellsOffset % alignof(Uint16) != 0 || layer.cellsOffset > mSize || cellBytes > mSize - layer.cellsOffset ||
+            layer.nameOffset >= mHeader->stringsSize)
+        {
+            return false;
+        }
+    }
+    for (int i = 0; i < GetSpawnCount(); i++)
+    {
+        const LevelFileSpawn &spawn = GetSpawn(i);
+        if (spawn.kindOffset >= mHeader->stringsSize || spawn.typeOffset >= mHeader->stringsSize)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,329 @@
+#include "LevelSnapshot.hpp"
+#include "AnimationComponent.hpp"
+#include "Collision2DComponent.hpp"
+#include "SingleAnimation.hpp"
+#include "TransformComponent.hpp"
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(LevelSnapshotHeader) == 40, "LevelSnapshotHeader is stored as is in snapshot buffers");
+static_assert(sizeof(LevelSnapshotEntity) == 56, "LevelSnapshotEntity is stored as is in snapshot buffers");
+
+namespace
+{
+    /**
+     * Get the size of the tile type ids of a snapshot, padded so that the entity records after them stay aligned.
+     */
+    Uint64 CellBytes(Uint64 rows, Uint64 columns, Uint64 layerCount)
+    {
+        return (rows * columns * layerCount * sizeof(Uint16) + 3) & ~Uint64{3};
+    }
+}
+
+LevelSnapshot::LevelSnapshot()
+{
+}
+
+LevelSnapshot::~LevelSnapshot()
+{
+}
+
+void LevelSnapshot::Capture(std::shared_ptr<TileMap> tilemap, const std::vector<std::shared_ptr<GameEntity>> &entities,
+                            const std::vector<std::vector<float>> &values)
+{
+    LevelSnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    if (nullptr != tilemap)
+    {
+        header.rows = tilemap->GetRowCount();
+        header.columns = tilemap->GetColumnCount();
+        header.layerCount = tilemap->GetLayerCount();
+        header.tileClock = tilemap->GetTileClock();
+    }
+    header.entityCount = static_cast<Uint32>(entities.size());
+    for (size_t i = 0; i < entities.size() && i < values.size(); i++)
+    {
+        header.valueCount += static_cast<Uint32>(std::min<size_t>(values[i].size(), UINT16_MAX));
+    }
+
+    // clear then resize keeps the storage of the previous capture
+    size_t cellCount = static_cast<size_t>(header.rows) * header.columns;
+    size_t entitiesOffset = sizeof(header) + CellBytes(header.rows, header.columns, header.layerCount);
+    size_t valuesOffset = entitiesOffset + entities.size() * sizeof(LevelSnapshotEntity);
+    mStringsOffset = valuesOffset + header.valueCount * sizeof(float);
+    mBuffer.clear();
+    mBuffer.resize(mStringsOffset);
+    mStrings.clear();
+
+    for (Uint32 layer = 0; layer < header.layerCount; layer++)
+    {
+        std::memcpy(mBuffer.data() + sizeof(header) + layer * cellCount * sizeof(Uint16), tilemap->GetLayerCells(layer),
+                    cellCount * sizeof(Uint16));
+    }
+
+    Uint32 valueOffset = 0;
+    for (size_t i = 0; i < entities.size(); i++)
+    {
+        LevelSnapshotEntity record{};
+        record.frame = -1;
+        record.frameTime = -1.0f;
+        record.valueOffset = valueOffset;
+        if (i < values.size())
+        {
+            record.valueCount = static_cast<Uint16>(std::min<size_t>(values[i].size(), UINT16_MAX));
+            std::memcpy(mBuffer.data() + valuesOffset + valueOffset * sizeof(float), values[i].data(),
+                        record.valueCount * sizeof(float));
+            valueOffset += record.valueCount;
+        }
+
+        const std::shared_ptr<GameEntity> &ge = entities[i];
+        if (nullptr == ge)
+        {
+            record.stateOffset = AddString("");
+            record.animationOffset = record.stateOffset;
+            std::memcpy(mBuffer.data() + entitiesOffset + i * sizeof(record), &record, sizeof(record));
+            continue;
+        }
+        auto transform = ge->GetTransform();
+        if (nullptr != transform)
+        {
+            SDL_FRect rect = transform->GetRect();
+            record.transform[0] = rect.x;
+            record.transform[1] = rect.y;
+            record.transform[2] = rect.w;
+            record.transform[3] = rect.h;
+            record.flags |= ENTITY_TRANSFORM;
+        }
+        auto collider = ge->GetCollision2D();
+        if (nullptr != collider)
+        {
+            SDL_FRect rect = collider->GetRect();
+            record.collider[0] = rect.x;
+            record.collider[1] = rect.y;
+            record.collider[2] = rect.w;
+            record.collider[3] = rect.h;
+            record.flags |= ENTITY_COLLIDER | (collider->IsTrigger() ? ENTITY_TRIGGER : 0);
+        }
+        if (ge->GetFlip())
+        {
+            record.flags |= ENTITY_FLIP;
+        }
+        record.stateOffset = AddString(ge->GetState());
+        record.animationOffset = record.stateOffset;
+
+        auto animations = ge->GetAnimations();
+        if (nullptr != animations)
+        {
+            std::string state = animations->GetCurrentState();
+            auto animation = animations->GetAnimation(state);
+            if (nullptr != animation)
+            {
+                record.frame = animation->GetFrame();
+                record.frameTime = animation->GetFrameTime();
+            }
+            record.animationOffset = AddString(state);
+            record.flags |= ENTITY_ANIMATION;
+        }
+        std::memcpy(mBuffer.data() + entitiesOffset + i * sizeof(record), &record, sizeof(record));
+    }
+
+    header.stringsSize = static_cast<Uint32>(mBuffer.size() - mStringsOffset);
+    std::memcpy(mBuffer.data(), &header, sizeof(header));
+}
+
+bool LevelSnapshot::Restore(std::shared_ptr<TileMap> tilemap, const std::vector<std::shared_ptr<GameEntity>> &entities) const
+{
+    if (mBuffer.empty())
+    {
+        SDL_Log("Error restoring snapshot: nothing was captured");
+        return false;
+    }
+    const LevelSnapshotHeader &header = GetHeader();
+    if (entities.size() != header.entityCount)
+    {
+        SDL_Log("Error restoring snapshot: %zu entities instead of %u", entities.size(), header.entityCount);
+        return false;
+    }
+    bool restoreTiles = nullptr != tilemap && header.layerCount > 0;
+    if (restoreTiles && (tilemap->GetRowCount() != static_cast<int>(header.rows) ||
+                         tilemap->GetColumnCount() != static_cast<int>(header.columns) ||
+                         tilemap->GetLayerCount() != static_cast<int>(header.layerCount)))
+    {
+        SDL_Log("Error restoring snapshot: the tile map does not match the one captured");
+        return false;
+    }
+
+    if (restoreTiles)
+    {
+        // Only the layers whose cells differ are redrawn and merged again
+        const Uint16 *cells = reinterpret_cast<const Uint16 *>(mBuffer.data() + sizeof(header));
+        size_t cellCount = static_cast<size_t>(header.rows) * header.columns;
+        for (Uint32 layer = 0; layer < header.layerCount; layer++)
+        {
+            tilemap->SetLayerCells(cells + layer * cellCount, layer);
+        }
+        tilemap->SetTileClock(header.tileClock);
+    }
+
+    const LevelSnapshotEntity *records = GetEntities();
+    for (size_t i = 0; i < entities.size(); i++)
+    {
+        const LevelSnapshotEntity &record = records[i];
+        const std::shared_ptr<GameEntity> &ge = entities[i];
+        if (nullptr == ge)
+        {
+            continue;
+        }
+        auto transform = ge->GetTransform();
+        if (nullptr != transform && (record.flags & ENTITY_TRANSFORM) != 0)
+        {
+            transform->SetXY(record.transform[0], record.transform[1]);
+            transform->SetWH(record.transform[2], record.transform[3]);
+        }
+        // Before the collider, which was captured already mirrored for the flip
+        ge->SetFlip((record.flags & ENTITY_FLIP) != 0);
+        auto collider = ge->GetCollision2D();
+        if (nullptr != collider && (record.flags & ENTITY_COLLIDER) != 0)
+        {
+            collider->SetXY(record.collider[0], record.collider[1]);
+            collider->SetWH(record.collider[2], record.collider[3]);
+            collider->SetTrigger((record.flags & ENTITY_TRIGGER) != 0);
+        }
+        ge->SetState(GetString(record.stateOffset));
+
+        auto animations = ge->GetAnimations();
+        if (nullptr != animations && (record.flags & ENTITY_ANIMATION) != 0)
+        {
+            std::string state = GetString(record.animationOffset);
+            auto animation = animations->SetCurrentState(state) ? animations->GetAnimation(state) : nullptr;
+            if (nullptr != animation)
+            {
+                animation->SetFrame(record.frame, record.frameTime);
+            }
+        }
+    }
+    return true;
+}
+
+bool LevelSnapshot::IsEmpty() const
+{
+    return mBuffer.empty();
+}
+
+int LevelSnapshot::GetEntityCount() const
+{
+    return mBuffer.empty() ? 0 : static_cast<int>(GetHeader().entityCount);
+}
+
+std::vector<float> LevelSnapshot::GetValues(int entity) const
+{
+    if (entity < 0 || entity >= GetEntityCount())
+    {
+        return {};
+    }
+    const LevelSnapshotEntity &record = GetEntities()[entity];
+    const float *values = reinterpret_cast<const float *>(GetEntities() + GetHeader().entityCount) + record.valueOffset;
+    return std::vector<float>(values, values + record.valueCount);
+}
+
+const std::vector<Uint8> &LevelSnapshot::GetBuffer() const
+{
+    return mBuffer;
+}
+
+bool LevelSnapshot::SetBuffer(std::vector<Uint8> buffer)
+{
+    if (!Validate(buffer))
+    {
+        SDL_Log("Error reading snapshot: not a valid snapshot");
+        return false;
+    }
+    mBuffer = std::move(buffer);
+    mStringsOffset = mBuffer.size() - GetHeader().stringsSize;
+    return true;
+}
+
+size_t LevelSnapshot::GetByteSize() const
+{
+    return mBuffer.size();
+}
+
+Uint64 LevelSnapshot::GetHash() const
+{
+    // 64 bit FNV-1a, the buffer holds no padding or pointer that could differ between two equal states
+    Uint64 hash = 14695981039346656037ull;
+    for (Uint8 byte : mBuffer)
+    {
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool LevelSnapshot::Validate(const std::vector<Uint8> &buffer)
+{
+    LevelSnapshotHeader header;
+    if (buffer.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version != SNAPSHOT_VERSION)
+    {
+        return false;
+    }
+    // 64 bit sizes, so that huge counts cannot wrap around to a size that looks right
+    Uint64 entitiesOffset = sizeof(header) + CellBytes(header.rows, header.columns, header.layerCount);
+    Uint64 valuesOffset = entitiesOffset + static_cast<Uint64>(header.entityCount) * sizeof(LevelSnapshotEntity);
+    Uint64 stringsOffset = valuesOffset + static_cast<Uint64>(header.valueCount) * sizeof(float);
+    if (stringsOffset + header.stringsSize != buffer.size() || (header.stringsSize > 0 && buffer.back() != 0))
+    {
+        return false;
+    }
+    for (Uint32 i = 0; i < header.entityCount; i++)
+    {
+        LevelSnapshotEntity record;
+        std::memcpy(&record, buffer.data() + entitiesOffset + i * sizeof(record), sizeof(record));
+        if (record.stateOffset >= header.stringsSize || record.animationOffset >= header.stringsSize ||
+            static_cast<Uint64>(record.valueOffset) + record.valueCount > header.valueCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Uint32 LevelSnapshot::AddString(const std::string &text)
+{
+    // A level only has a handful of states, a linear search is all it takes
+    for (const auto &[known, offset] : mStrings)
+    {
+        if (known == text)
+        {
+            return offset;
+        }
+    }
+    Uint32 offset = static_cast<Uint32>(mBuffer.size() - mStringsOffset);
+    mBuffer.insert(mBuffer.end(), text.begin(), text.end());
+    mBuffer.push_back(0);
+    mStrings.emplace_back(text, offset);
+    return offset;
+}
+
+const LevelSnapshotHeader &LevelSnapshot::GetHeader() const
+{
+    return *reinterpret_cast<const LevelSnapshotHeader *>(mBuffer.data());
+}
+
+const LevelSnapshotEntity *LevelSnapshot::GetEntities() const
+{
+    const LevelSnapshotHeader &header = GetHeader();
+    return reinterpret_cast<const LevelSnapshotEntity *>(mBuffer.data() + sizeof(header) +
+                                                         CellBytes(header.rows, header.columns, header.layerCount));
+}
+
+const char *LevelSnapshot::GetString(Uint32 offset) const
+{
+    // Validate or Capture made sure every referenced offset is inside the table and the table ends with a 0 byte
+    return reinterpret_cast<const char *>(mBuffer.data() + mStringsOffset + offset);
+}
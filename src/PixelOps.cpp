@@ -0,0 +1,230 @@
+#include "PixelOps.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define PIXELOPS_X86
+#include <immintrin.h>
+// The engine is not built with -mavx2, so the wide kernels enable the instructions they need themselves
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXELOPS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PIXELOPS_TARGET(isa)
+#endif
+#endif
+
+namespace
+{
+    Uint32 *Row(Uint32 *pixels, int y, int pitch)
+    {
+        return reinterpret_cast<Uint32 *>(reinterpret_cast<Uint8 *>(pixels) + static_cast<size_t>(y) * pitch);
+    }
+
+    Uint32 ColorKeyPixel(Uint32 color, Uint32 colorKey)
+    {
+        return (color & 0x00FFFFFF) == colorKey ? 0 : color;
+    }
+
+    Uint32 PremultiplyPixel(Uint32 color)
+    {
+        Uint32 a = color >> 24;
+        // (c * a + 128) / 255 rounded, without a division
+        auto scale = [a](Uint32 c)
+        {
+            Uint32 t = c * a + 128;
+            return (t + (t >> 8)) >> 8;
+        };
+        return a << 24 | scale((color >> 16) & 0xFF) << 16 | scale((color >> 8) & 0xFF) << 8 | scale(color & 0xFF);
+    }
+}
+
+void ColorKeyToAlpha(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    using Kernel = void (*)(Uint32 *, int, int, int, Uint32);
+    static const Kernel kernel = SDL_HasAVX2() ? ColorKeyToAlphaAVX2 : SDL_HasSSE2() ? ColorKeyToAlphaSSE2
+                                                                                      : ColorKeyToAlphaScalar;
+    kernel(pixels, width, height, pitch, colorKey);
+}
+
+void PremultiplyAlpha(Uint32 *pixels, int width, int height, int pitch)
+{
+    using Kernel = void (*)(Uint32 *, int, int, int);
+    static const Kernel kernel = SDL_HasAVX2() ? PremultiplyAlphaAVX2 : SDL_HasSSE2() ? PremultiplyAlphaSSE2
+                                                                                       : PremultiplyAlphaScalar;
+    kernel(pixels, width, height, pitch);
+}
+
+SDL_BlendMode GetPremultipliedBlendMode()
+{
+    return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+}
+
+void ColorKeyToAlphaScalar(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    colorKey &= 0x00FFFFFF;
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        for (int x = 0; x < width; x++)
+        {
+            row[x] = ColorKeyPixel(row[x], colorKey);
+        }
+    }
+}
+
+void PremultiplyAlphaScalar(Uint32 *pixels, int width, int height, int pitch)
+{
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        for (int x = 0; x < width; x++)
+        {
+            row[x] = PremultiplyPixel(row[x]);
+        }
+    }
+}
+
+#ifdef PIXELOPS_X86
+
+namespace
+{
+    /**
+     * Multiply pixels widened to 16 bits per channel by their alpha, the alpha itself by 255 so it stays as is.
+     * Functions rather than lambdas, which would not get the target of the kernel.
+     */
+    PIXELOPS_TARGET("sse2")
+    inline __m128i PremultiplyWideSSE2(__m128i wide)
+    {
+        // In memory an ARGB8888 pixel is B, G, R, A: the alpha is the 4th channel of each group of 4
+        const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(wide, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(wide, alpha), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    PIXELOPS_TARGET("avx2")
+    inline __m256i PremultiplyWideAVX2(__m256i wide)
+    {
+        const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(wide, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm256_blendv_epi8(alpha, _mm256_set1_epi16(255), alphaLanes);
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(wide, alpha), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+}
+
+PIXELOPS_TARGET("sse2")
+void ColorKeyToAlphaSSE2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    colorKey &= 0x00FFFFFF;
+    const __m128i key = _mm_set1_epi32(colorKey);
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            __m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(px, rgbMask), key);
+            // Keyed lanes are all ones in the compare mask, andnot clears them and keeps the others as they are
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), _mm_andnot_si128(keyed, px));
+        }
+        for (; x < width; x++)
+        {
+            row[x] = ColorKeyPixel(row[x], colorKey);
+        }
+    }
+}
+
+PIXELOPS_TARGET("avx2")
+void ColorKeyToAlphaAVX2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    colorKey &= 0x00FFFFFF;
+    const __m256i key = _mm256_set1_epi32(colorKey);
+    const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + x));
+            __m256i keyed = _mm256_cmpeq_epi32(_mm256_and_si256(px, rgbMask), key);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + x), _mm256_andnot_si256(keyed, px));
+        }
+        for (; x < width; x++)
+        {
+            row[x] = ColorKeyPixel(row[x], colorKey);
+        }
+    }
+}
+
+PIXELOPS_TARGET("sse2")
+void PremultiplyAlphaSSE2(Uint32 *pixels, int width, int height, int pitch)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        int x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            __m128i lo = PremultiplyWideSSE2(_mm_unpacklo_epi8(px, zero));
+            __m128i hi = PremultiplyWideSSE2(_mm_unpackhi_epi8(px, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), _mm_packus_epi16(lo, hi));
+        }
+        for (; x < width; x++)
+        {
+            row[x] = PremultiplyPixel(row[x]);
+        }
+    }
+}
+
+PIXELOPS_TARGET("avx2")
+void PremultiplyAlphaAVX2(Uint32 *pixels, int width, int height, int pitch)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    // Unpack and pack both work within 128-bit lanes, so the pixel order is kept
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = Row(pixels, y, pitch);
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + x));
+            __m256i lo = PremultiplyWideAVX2(_mm256_unpacklo_epi8(px, zero));
+            __m256i hi = PremultiplyWideAVX2(_mm256_unpackhi_epi8(px, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + x), _mm256_packus_epi16(lo, hi));
+        }
+        for (; x < width; x++)
+        {
+            row[x] = PremultiplyPixel(row[x]);
+        }
+    }
+}
+
+#else
+
+void ColorKeyToAlphaSSE2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    ColorKeyToAlphaScalar(pixels, width, height, pitch, colorKey);
+}
+
+void ColorKeyToAlphaAVX2(Uint32 *pixels, int width, int height, int pitch, Uint32 colorKey)
+{
+    ColorKeyToAlphaScalar(pixels, width, height, pitch, colorKey);
+}
+
+void PremultiplyAlphaSSE2(Uint32 *pixels, int width, int height, int pitch)
+{
+    PremultiplyAlphaScalar(pixels, width, height, pitch);
+}
+
+void PremultiplyAlphaAVX2(Uint32 *pixels, int width, int height, int pitch)
+{
+    PremultiplyAlphaScalar(pixels, width, height, pitch);
+}
+
+#endif
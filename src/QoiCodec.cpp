@@ -0,0 +1,284 @@
+#include "QoiCodec.hpp"
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    constexpr Uint8 QOI_OP_INDEX = 0x00;
+    constexpr Uint8 QOI_OP_DIFF = 0x40;
+    constexpr Uint8 QOI_OP_LUMA = 0x80;
+    constexpr Uint8 QOI_OP_RUN = 0xc0;
+    constexpr Uint8 QOI_OP_RGB = 0xfe;
+    constexpr Uint8 QOI_OP_RGBA = 0xff;
+    constexpr Uint8 QOI_MASK_2 = 0xc0;
+
+    constexpr size_t QOI_HEADER_SIZE = 14;
+    constexpr Uint8 QOI_PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    /**
+     * Same limit as the reference implementation, keeps width * height * 4 far from overflowing.
+     */
+    constexpr Uint64 QOI_PIXELS_MAX = 400000000;
+
+    /**
+     * A pixel split in channels, the unit the QOI operations work on.
+     */
+    struct Rgba
+    {
+        Uint8 r, g, b, a;
+
+        bool operator==(const Rgba &other) const
+        {
+            return r == other.r && g == other.g && b == other.b && a == other.a;
+        }
+    };
+
+    Rgba FromArgb(Uint32 color)
+    {
+        return {static_cast<Uint8>(color >> 16), static_cast<Uint8>(color >> 8), static_cast<Uint8>(color), static_cast<Uint8>(color >> 24)};
+    }
+
+    Uint32 ToArgb(Rgba px)
+    {
+        return static_cast<Uint32>(px.a) << 24 | static_cast<Uint32>(px.r) << 16 | static_cast<Uint32>(px.g) << 8 | px.b;
+    }
+
+    int Hash(Rgba px)
+    {
+        return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+    }
+
+    void WriteBigEndian(std::vector<Uint8> &out, Uint32 value)
+    {
+        out.push_back(value >> 24);
+        out.push_back(value >> 16);
+        out.push_back(value >> 8);
+        out.push_back(value);
+    }
+
+    Uint32 ReadBigEndian(const Uint8 *data)
+    {
+        return static_cast<Uint32>(data[0]) << 24 | static_cast<Uint32>(data[1]) << 16 | static_cast<Uint32>(data[2]) << 8 | data[3];
+    }
+}
+
+bool QoiEncode(const Uint32 *pixels, int width, int height, int pitch, std::vector<Uint8> &out)
+{
+    if (width <= 0 || height <= 0 || static_cast<Uint64>(width) * height > QOI_PIXELS_MAX)
+    {
+        return false;
+    }
+
+    out.clear();
+    // Worst case: every pixel needs a full QOI_OP_RGBA
+    out.reserve(QOI_HEADER_SIZE + static_cast<size_t>(width) * height * 5 + sizeof(QOI_PADDING));
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    WriteBigEndian(out, width);
+    WriteBigEndian(out, height);
+    out.push_back(4); // RGBA
+    out.push_back(0); // sRGB with linear alpha
+
+    Rgba index[64] = {};
+    Rgba prev{0, 0, 0, 255};
+    int run = 0;
+    for (int y = 0; y < height; y++)
+    {
+        const Uint32 *row = reinterpret_cast<const Uint32 *>(reinterpret_cast<const Uint8 *>(pixels) + static_cast<size_t>(y) * pitch);
+        for (int x = 0; x < width; x++)
+        {
+            Rgba px = FromArgb(row[x]);
+            bool last = y == height - 1 && x == width - 1;
+            if (px == prev)
+            {
+                run++;
+                if (run == 62 || last)
+                {
+                    out.push_back(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                out.push_back(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            int hash = Hash(px);
+            if (index[hash] == px)
+            {
+                out.push_back(QOI_OP_INDEX | hash);
+            }
+            else
+            {
+                index[hash] = px;
+                if (px.a == prev.a)
+                {
+                    signed char vr = px.r - prev.r;
+                    signed char vg = px.g - prev.g;
+                    signed char vb = px.b - prev.b;
+                    signed char vgr = vr - vg;
+                    signed char vgb = vb - vg;
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+                    {
+                        out.push_back(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                    }
+                    else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+                    {
+                        out.push_back(QOI_OP_LUMA | (vg + 32));
+                        out.push_back((vgr + 8) << 4 | (vgb + 8));
+                    }
+                    else
+                    {
+                        out.insert(out.end(), {QOI_OP_RGB, px.r, px.g, px.b});
+                    }
+                }
+                else
+                {
+                    out.insert(out.end(), {QOI_OP_RGBA, px.r, px.g, px.b, px.a});
+                }
+            }
+            prev = px;
+        }
+    }
+
+    out.insert(out.end(), QOI_PADDING, QOI_PADDING + sizeof(QOI_PADDING));
+    return true;
+}
+
+bool QoiReadHeader(const Uint8 *data, size_t size, int *width, int *height)
+{
+    if (size < QOI_HEADER_SIZE + sizeof(QOI_PADDING) || std::memcmp(data, "qoif", 4) != 0)
+    {
+        return false;
+    }
+    Uint32 w = ReadBigEndian(data + 4);
+    Uint32 h = ReadBigEndian(data + 8);
+    if (w == 0 || h == 0 || static_cast<Uint64>(w) * h > QOI_PIXELS_MAX || data[12] < 3 || data[12] > 4 || data[13] > 1)
+    {
+        return false;
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
+
+bool QoiDecode(const Uint8 *data, size_t size, Uint32 *pixels, int pitch)
+{
+    int width, height;
+    if (!QoiReadHeader(data, size, &width, &height))
+    {
+        return false;
+    }
+
+    Rgba index[64] = {};
+    Rgba px{0, 0, 0, 255};
+    int run = 0;
+    size_t p = QOI_HEADER_SIZE;
+    // Every operation but the runs is followed by at least the padding, so reads never pass the end
+    size_t end = size - sizeof(QOI_PADDING);
+    for (int y = 0; y < height; y++)
+    {
+        Uint32 *row = reinterpret_cast<Uint32 *>(reinterpret_cast<Uint8 *>(pixels) + static_cast<size_t>(y) * pitch);
+        for (int x = 0; x < width; x++)
+        {
+            if (run > 0)
+            {
+                run--;
+            }
+            else if (p < end)
+            {
+                Uint8 b1 = data[p++];
+                if (b1 == QOI_OP_RGB)
+                {
+                    px.r = data[p];
+                    px.g = data[p + 1];
+                    px.b = data[p + 2];
+                    p += 3;
+                }
+                else if (b1 == QOI_OP_RGBA)
+                {
+                    px.r = data[p];
+                    px.g = data[p + 1];
+                    px.b = data[p + 2];
+                    px.a = data[p + 3];
+                    p += 4;
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+                {
+                    px = index[b1];
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+                {
+                    px.r += ((b1 >> 4) & 0x03) - 2;
+                    px.g += ((b1 >> 2) & 0x03) - 2;
+                    px.b += (b1 & 0x03) - 2;
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+                {
+                    Uint8 b2 = data[p++];
+                    int vg = (b1 & 0x3f) - 32;
+                    px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px.g += vg;
+                    px.b += vg - 8 + (b2 & 0x0f);
+                }
+                else
+                {
+                    run = b1 & 0x3f;
+                }
+                index[Hash(px)] = px;
+            }
+            else
+            {
+                // Truncated file
+                return false;
+            }
+            row[x] = ToArgb(px);
+        }
+    }
+    return p <= end;
+}
+
+SDL_Surface *QoiLoadSurface(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        SDL_SetError("Couldn't open %s", filepath.c_str());
+        return nullptr;
+    }
+    std::vector<Uint8> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), data.size());
+
+    int width, height;
+    if (!file || !QoiReadHeader(data.data(), data.size(), &width, &height))
+    {
+        SDL_SetError("%s is not a valid QOI file", filepath.c_str());
+        return nullptr;
+    }
+    SDL_Surface *surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_ARGB8888);
+    if (nullptr == surface)
+    {
+        return nullptr;
+    }
+    if (!QoiDecode(data.data(), data.size(), static_cast<Uint32 *>(surface->pixels), surface->pitch))
+    {
+        SDL_SetError("%s is truncated", filepath.c_str());
+        SDL_DestroySurface(surface);
+        return nullptr;
+    }
+    return surface;
+}
+
+bool QoiSaveSurface(SDL_Surface *surface, const std::string &filepath)
+{
+    std::vector<Uint8> data;
+    if (!QoiEncode(static_cast<const Uint32 *>(surface->pixels), surface->w, surface->h, surface->pitch, data))
+    {
+        return false;
+    }
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
@@ -1,15 +1,555 @@
-#include "ResourceManager.hpp"
-
-std::shared_ptr<SDL_Texture> make_shared_texture(SDL_Renderer *renderer, SDL_Surface *pixels)
-{
-    SDL_Texture *pTexture = SDL_CreateTextureFromSurface(renderer, pixels);
-    if (nullptr == pTexture)
-    {
-        SDL_Log("Error creating texture: %s", SDL_GetError());
-    }
-    // A custom deleter is needed because type SDL_Texture is created with a call to SDL_CreateTextureFromSurface,
-    // - other than the default new operator
-    // Also note that here we're using the shared_ptr constructor that takes a pointer and a custom deleter,
-    // - not the make_shared function which doesn't allow for custom deleters
-    return std::shared_ptr<SDL_Texture>(pTexture, TextureFunctorDeleter()); // Custom deleter
+#include "ResourceManager.hpp"
+#include "QoiCodec.hpp"
+#include "PixelOps.hpp"
+
+std::shared_ptr<SDL_Texture> make_shared_texture(SDL_Renderer *renderer, SDL_Surface *pixels)
+{
+    SDL_Texture *pTexture = SDL_CreateTextureFromSurface(renderer, pixels);
+    if (nullptr == pTexture)
+    {
+        SDL_Log("Error creating texture: %s", SDL_GetError());
+    }
+    // A custom deleter is needed because type SDL_Texture is created with a call to SDL_CreateTextureFromSurface,
+    // - other than the default new operator
+    // Also note that here we're using the shared_ptr constructor that takes a pointer and a custom deleter,
+    // - not the make_shared function which doesn't allow for custom deleters
+    return std::shared_ptr<SDL_Texture>(pTexture, TextureFunctorDeleter()); // Custom deleter
+}
+
+ResourceManager::~ResourceManager()
+{
+    // The watcher submits reloads, stop it before the workers
+    mWatcher.Stop();
+    // Running decodes are waited for, so nothing touches the upload queue afterwards
+    mDecodePool.Stop();
+    for (auto &upload : mUploads)
+    {
+        if (nullptr != upload.surface)
+        {
+            SDL_DestroySurface(upload.surface);
+        }
+    }
+    mUploads.clear();
+
+    // Handles may outlive the manager (held by components), but their textures must go before SDL_Quit
+    for (auto &handle : mHandles)
+    {
+        if (handle->IsReady())
+        {
+            handle->SetTexture(nullptr, 0);
+        }
+    }
+}
+
+std::shared_ptr<TextureHandle> ResourceManager::LoadTextureAsync(std::string filepath, JobPriority priority)
+{
+    size_t shardIndex = GetShardIndex(filepath);
+    CacheShard &shard = mShards[shardIndex];
+
+    // Hit path: a version check and a lookup in this thread's snapshot, no lock
+    {
+        // The snapshots last seen by the calling thread, one per shard
+        thread_local std::array<LocalSnapshot, NUM_SHARDS> localSnapshots;
+        thread_local uint64_t localGeneration{0};
+        if (localGeneration != mGeneration)
+        {
+            // Left by a destroyed manager, whose handles are gone
+            localSnapshots = {};
+            localGeneration = mGeneration;
+        }
+        LocalSnapshot &local = localSnapshots[shardIndex];
+        uint64_t version = shard.version.load(std::memory_order_acquire);
+        if (local.version != version)
+        {
+            local.map = shard.snapshot.load(std::memory_order_acquire);
+            local.version = version;
+        }
+        auto found = local.map->find(filepath);
+        if (found != local.map->end())
+        {
+            auto handle = found->second->shared_from_this();
+            handle->Touch();
+            Restore(handle);
+            PinToLevelScope(handle);
+            return handle;
+        }
+    }
+
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::shared_ptr<TextureHandle> handle;
+    {
+        std::lock_guard<std::mutex> lock(shard.writeMutex);
+        // Another loader may have inserted the same filepath while we were waiting, coalesce with it
+        auto snapshot = shard.snapshot.load(std::memory_order_acquire);
+        auto found = snapshot->find(filepath);
+        if (found != snapshot->end())
+        {
+            handle = found->second->shared_from_this();
+            PinToLevelScope(handle);
+            return handle;
+        }
+
+        handle = std::make_shared<TextureHandle>(filepath);
+        handle->SetDecodeFuture(promise->get_future().share());
+        handle->Touch();
+        {
+            std::lock_guard<std::mutex> residencyLock(mResidencyMutex);
+            mHandles.push_back(handle);
+        }
+        auto updated = std::make_shared<HandleMap>(*snapshot);
+        updated->insert({filepath, handle.get()});
+        shard.snapshot.store(std::move(updated), std::memory_order_release);
+        shard.version.fetch_add(1, std::memory_order_release);
+    }
+
+    if (mHotReload.load(std::memory_order_relaxed))
+    {
+        mWatcher.Watch(filepath);
+    }
+    PinToLevelScope(handle);
+    SubmitDecode(handle, promise, priority);
+    return handle;
+}
+
+void ResourceManager::Restore(const std::shared_ptr<TextureHandle> &handle)
+{
+    if (handle->ChangeState(TextureState::Evicted, TextureState::Loading))
+    {
+        SubmitDecode(handle, nullptr, JobPriority::High);
+    }
+}
+
+bool ResourceManager::MountArchive(std::string filepath)
+{
+    auto archive = std::make_unique<AssetArchive>();
+    if (!archive->Open(filepath))
+    {
+        return false;
+    }
+    SDL_Log("Mounted archive %s with %d assets", filepath.c_str(), archive->GetEntryCount());
+    std::unique_lock<std::shared_mutex> lock(mArchivesMutex);
+    mArchives.push_back(std::move(archive));
+    return true;
+}
+
+void ResourceManager::SubmitDecode(std::shared_ptr<TextureHandle> handle, std::shared_ptr<std::promise<bool>> promise, JobPriority priority)
+{
+    // Packed assets are ready to upload as they are, no need to go through the workers
+    AssetArchive *archive = nullptr;
+    const AssetArchiveEntry *entry = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(mArchivesMutex);
+        for (auto mounted = mArchives.rbegin(); mounted != mArchives.rend() && nullptr == entry; mounted++)
+        {
+            archive = mounted->get();
+            entry = archive->Find(handle->GetFilepath());
+        }
+    }
+    if (nullptr == entry)
+    {
+        SubmitFileDecode(handle, promise, priority);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mUploadMutex);
+        mUploads.push_back({handle, nullptr, archive, entry, nullptr, false});
+    }
+    if (nullptr != promise)
+    {
+        promise->set_value(true);
+    }
+}
+
+void ResourceManager::SubmitFileDecode(std::shared_ptr<TextureHandle> handle, std::shared_ptr<std::promise<bool>> promise, JobPriority priority, bool reload)
+{
+    mDecodeCount++;
+    mDecodesRunning++;
+    mDecodePool.Submit([this, handle, promise, reload]()
+                       {
+        SDL_Surface *pixels = DecodeSurface(handle->GetFilepath());
+        if (nullptr != pixels)
+        {
+            // Find the opaque pixels while they are at hand, for the trimmed sprites
+            auto alphaMask = std::make_shared<AlphaMask>();
+            alphaMask->Build(static_cast<const Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch);
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            mUploads.push_back({handle, pixels, nullptr, nullptr, alphaMask, reload});
+        }
+        else if (!reload)
+        {
+            // A failed reload keeps the texture it had
+            handle->ChangeState(TextureState::Loading, TextureState::Failed);
+        }
+        // Only once the surface is queued, so that FinishLoads cannot miss it
+        mDecodesRunning--;
+        if (nullptr != promise)
+        {
+            promise->set_value(nullptr != pixels);
+        } }, priority, handle.get(), [this, handle, promise, reload]()
+                       {
+        // The pool stopped before the decode started: fail the load rather than leave its promise broken
+        if (!reload)
+        {
+            handle->ChangeState(TextureState::Loading, TextureState::Failed);
+        }
+        mDecodesRunning--;
+        if (nullptr != promise)
+        {
+            promise->set_value(false);
+        } });
+}
+
+int ResourceManager::ProcessUploads(SDL_Renderer *renderer, Uint64 budgetNS)
+{
+    Uint64 start = SDL_GetTicksNS();
+    int uploaded = 0;
+    while (uploaded == 0 || SDL_GetTicksNS() - start < budgetNS)
+    {
+        PendingUpload upload;
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            if (mUploads.empty())
+            {
+                break;
+            }
+            upload = mUploads.front();
+            mUploads.pop_front();
+        }
+
+        std::shared_ptr<SDL_Texture> texture;
+        if (nullptr != upload.archive)
+        {
+            texture = std::shared_ptr<SDL_Texture>(upload.archive->CreateTexture(renderer, *upload.entry, mPremultipliedAlpha), TextureFunctorDeleter());
+            // The pixels are mapped already, the mask only has to be built the first time
+            if (nullptr == upload.handle->GetAlphaMask())
+            {
+                auto alphaMask = std::make_shared<AlphaMask>();
+                alphaMask->Build(static_cast<const Uint32 *>(upload.archive->GetPixels(*upload.entry)), upload.entry->width, upload.entry->height, upload.entry->pitch);
+                upload.alphaMask = alphaMask;
+            }
+        }
+        else
+        {
+            texture = make_shared_texture(renderer, upload.surface);
+            SDL_DestroySurface(upload.surface);
+        }
+        uploaded++;
+        if (nullptr == texture)
+        {
+            if (!upload.reload)
+            {
+                upload.handle->ChangeState(TextureState::Loading, TextureState::Failed);
+            }
+            continue;
+        }
+        if (mPremultipliedAlpha)
+        {
+            SDL_SetTextureBlendMode(texture.get(), GetPremultipliedBlendMode());
+        }
+
+        // Account what the texture really takes, which depends on the format the renderer picked
+        Uint32 format = 0;
+        int w = 0;
+        int h = 0;
+        SDL_QueryTexture(texture.get(), &format, nullptr, &w, &h);
+        size_t byteSize = static_cast<size_t>(w) * h * SDL_BYTESPERPIXEL(format);
+
+        if (nullptr != upload.alphaMask)
+        {
+            upload.handle->SetAlphaMask(upload.alphaMask);
+        }
+        // A reload replaces a texture that may still be resident
+        mMemoryUsage -= upload.handle->GetByteSize();
+        if (!upload.handle->IsReady())
+        {
+            mResidentCount++;
+        }
+        upload.handle->SetTexture(texture, byteSize);
+        mMemoryUsage += byteSize;
+        if (upload.reload)
+        {
+            mReloadCount++;
+        }
+        SDL_Log("Created new resource %s", upload.handle->GetFilepath().c_str());
+    }
+
+    if (mMemoryBudget != 0 && mMemoryUsage > mMemoryBudget)
+    {
+        EvictUntil(mMemoryBudget);
+    }
+    return uploaded;
+}
+
+int ResourceManager::GetPendingUploadCount()
+{
+    std::lock_guard<std::mutex> lock(mUploadMutex);
+    return mUploads.size();
+}
+
+int ResourceManager::GetDecodeCount() const
+{
+    return mDecodeCount;
+}
+
+int ResourceManager::FinishLoads(SDL_Renderer *renderer)
+{
+    int uploaded = 0;
+    while (true)
+    {
+        // Read before the uploads: a decode queues its surface before it stops running
+        bool decoding = mDecodesRunning > 0;
+        uploaded += ProcessUploads(renderer, UINT64_MAX);
+        if (!decoding && GetPendingUploadCount() == 0)
+        {
+            return uploaded;
+        }
+        SDL_Delay(1);
+    }
+}
+
+bool ResourceManager::EnableHotReload(Uint32 debounceMS)
+{
+    if (mHotReload)
+    {
+        return true;
+    }
+    if (!mWatcher.Start([this](const std::string &filepath)
+                        { OnAssetChanged(filepath); },
+                        static_cast<Uint64>(debounceMS) * 1000000))
+    {
+        return false;
+    }
+
+    // Textures requested from now on are watched by LoadTextureAsync, the ones before are added here
+    mHotReload = true;
+    std::lock_guard<std::mutex> lock(mResidencyMutex);
+    for (auto &handle : mHandles)
+    {
+        mWatcher.Watch(handle->GetFilepath());
+    }
+    SDL_Log("Hot reload enabled for %zu assets", mHandles.size());
+    return true;
+}
+
+void ResourceManager::DisableHotReload()
+{
+    mHotReload = false;
+    mWatcher.Stop();
+}
+
+bool ResourceManager::IsHotReloadEnabled() const
+{
+    return mHotReload;
+}
+
+int ResourceManager::GetReloadCount() const
+{
+    return mReloadCount;
+}
+
+void ResourceManager::OnAssetChanged(const std::string &filepath)
+{
+    auto snapshot = mShards[GetShardIndex(filepath)].snapshot.load(std::memory_order_acquire);
+    auto found = snapshot->find(filepath);
+    if (found == snapshot->end() || found->second->GetState() == TextureState::Evicted)
+    {
+        return;
+    }
+    SDL_Log("Reloading changed resource %s", filepath.c_str());
+    SubmitFileDecode(found->second->shared_from_this(), nullptr, JobPriority::High, true);
+}
+
+void ResourceManager::SetPremultipliedAlpha(bool premultiplied)
+{
+    mPremultipliedAlpha = premultiplied;
+}
+
+bool ResourceManager::IsPremultipliedAlpha() const
+{
+    return mPremultipliedAlpha;
+}
+
+void ResourceManager::SetMemoryBudget(size_t bytes)
+{
+    mMemoryBudget = bytes;
+}
+
+size_t ResourceManager::GetMemoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+size_t ResourceManager::GetMemoryUsage() const
+{
+    return mMemoryUsage;
+}
+
+int ResourceManager::GetResidentCount() const
+{
+    return mResidentCount;
+}
+
+int ResourceManager::GetEvictionCount() const
+{
+    return mEvictionCount;
+}
+
+int ResourceManager::EvictUnused()
+{
+    return EvictUntil(0);
+}
+
+void ResourceManager::BeginLevelScope(int levelId)
+{
+    mActiveLevel = levelId;
+}
+
+void ResourceManager::EndLevelScope()
+{
+    mActiveLevel = -1;
+}
+
+void ResourceManager::PrefetchLevel(int levelId, const std::vector<std::string> &filepaths)
+{
+    for (auto &filepath : filepaths)
+    {
+        auto handle = LoadTextureAsync(filepath, JobPriority::Low);
+        std::lock_guard<std::mutex> lock(mResidencyMutex);
+        mLevelPins[levelId].insert(handle);
+    }
+}
+
+bool ResourceManager::IsLevelResident(int levelId)
+{
+    std::lock_guard<std::mutex> lock(mResidencyMutex);
+    auto found = mLevelPins.find(levelId);
+    if (found == mLevelPins.end() || found->second.empty())
+    {
+        return false;
+    }
+    return std::all_of(found->second.begin(), found->second.end(), [](const std::shared_ptr<TextureHandle> &handle)
+                       { return handle->GetState() == TextureState::Ready || handle->IsFailed(); });
+}
+
+int ResourceManager::PromoteLevel(int levelId)
+{
+    std::unordered_set<const void *> loading;
+    {
+        std::lock_guard<std::mutex> lock(mResidencyMutex);
+        auto found = mLevelPins.find(levelId);
+        if (found == mLevelPins.end())
+        {
+            return 0;
+        }
+        for (auto &handle : found->second)
+        {
+            if (handle->GetState() == TextureState::Loading)
+            {
+                loading.insert(handle.get());
+            }
+        }
+    }
+    return loading.empty() ? 0 : mDecodePool.Promote(loading);
+}
+
+void ResourceManager::ReleaseLevel(int levelId)
+{
+    std::lock_guard<std::mutex> lock(mResidencyMutex);
+    mLevelPins.erase(levelId);
+}
+
+void ResourceManager::PinToLevelScope(const std::shared_ptr<TextureHandle> &handle)
+{
+    int levelId = mActiveLevel.load(std::memory_order_relaxed);
+    if (levelId == -1)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mResidencyMutex);
+    mLevelPins[levelId].insert(handle);
+}
+
+int ResourceManager::EvictUntil(size_t targetBytes)
+{
+    std::vector<TextureHandle *> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mResidencyMutex);
+        for (auto &handle : mHandles)
+        {
+            // mHandles holds the only reference: no component uses it and no level pins it
+            if (handle.use_count() == 1 && handle->GetState() == TextureState::Ready)
+            {
+                candidates.push_back(handle.get());
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](TextureHandle *a, TextureHandle *b)
+              { return a->GetLastUsed() < b->GetLastUsed(); });
+
+    // A lookup racing with this may still pick up an evicted handle, Restore brings it back on its next render
+    int evicted = 0;
+    for (TextureHandle *handle : candidates)
+    {
+        if (mMemoryUsage <= targetBytes)
+        {
+            break;
+        }
+        mMemoryUsage -= handle->GetByteSize();
+        mResidentCount--;
+        handle->SetTexture(nullptr, 0);
+        SDL_Log("Evicted resource %s", handle->GetFilepath().c_str());
+        evicted++;
+    }
+    mEvictionCount += evicted;
+    return evicted;
+}
+
+size_t ResourceManager::GetShardIndex(const std::string &filepath)
+{
+    return std::hash<std::string>{}(filepath) % NUM_SHARDS;
+}
+
+SDL_Surface *ResourceManager::DecodeSurface(const std::string &filepath)
+{
+    // QOI files are made by the QoiConverter tool, which already turned the color key into alpha
+    if (filepath.size() > 4 && filepath.compare(filepath.size() - 4, 4, ".qoi") == 0)
+    {
+        SDL_Surface *pixels = QoiLoadSurface(filepath);
+        if (nullptr == pixels)
+        {
+            SDL_Log("Error loading %s: %s", filepath.c_str(), SDL_GetError());
+            return nullptr;
+        }
+        if (mPremultipliedAlpha)
+        {
+            PremultiplyAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch);
+        }
+        return pixels;
+    }
+
+    SDL_Surface *loaded = SDL_LoadBMP(filepath.c_str());
+    if (nullptr == loaded)
+    {
+        SDL_Log("Error loading %s: %s", filepath.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    SDL_Surface *pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+    SDL_DestroySurface(loaded);
+    if (nullptr == pixels)
+    {
+        SDL_Log("Error converting %s: %s", filepath.c_str(), SDL_GetError());
+        return nullptr;
+    }
+
+    /**
+     *  Get rid of the background, once here as real alpha rather than a color key tested on every blit.
+     *  The other pixels keep the alpha of the file, which may be partial.
+     */
+    ColorKeyToAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch, COLOR_KEY_R << 16 | COLOR_KEY_G << 8 | COLOR_KEY_B);
+    if (mPremultipliedAlpha)
+    {
+        PremultiplyAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch);
+    }
+    return pixels;
 }
\ No newline at end of file
@@ -1,105 +1,200 @@
-#include "SingleAnimation.hpp"
-#include "ResourceManager.hpp"
-#include "GameEntity.hpp"
-
-// Empty constructor so that we can create an empty sprite without any properties
-SingleAnimation::SingleAnimation()
-{
-}
-
-void SingleAnimation::CreateAnimation(std::shared_ptr<SDLGraphicsProgram> game, std::string filepath)
-{
-    auto renderer = game->getSDLRenderer();
-    // explicit call with std::launch::async to load the texture in a separate thread
-    // start load texture when the object is created, then the texture will be gotten when it's needed for rendering after
-    futureTexture = std::async(std::launch::async, [renderer, filepath]() -> std::shared_ptr<SDL_Texture>
-                               { return ResourceManager::Instance().LoadTexture(renderer, filepath); });
-}
-
-SingleAnimation::~SingleAnimation()
-{
-}
-
-void SingleAnimation::SetFrameConfig(int x, int y, int w, int w_offset, int h, int maxFrame, int millisecond_duration, bool repeat)
-{
-    initialX = x;
-    offsetW = w_offset;
-    mRect_src.x = x;
-    mRect_src.y = y;
-    mRect_src.w = w;
-    mRect_src.h = h;
-    mMaxFrame = maxFrame;
-    mFrameDuration = millisecond_duration;
-    mRepeat = repeat;
-}
-
-int SingleAnimation::GetW() const
-{
-    return mRect_src.w;
-}
-
-int SingleAnimation::GetH() const
-{
-    return mRect_src.h;
-}
-
-int SingleAnimation::GetDuration()
-{
-    return mFrameDuration;
-}
-
-void SingleAnimation::ResetFrame()
-{
-    currFrame = -1;
-    mRect_src.x = initialX;
-}
-
-void SingleAnimation::UpdateFrame()
-{
-    if (frameStartTime != 0.0f)
-    {
-        if (SDL_GetTicks() - frameStartTime < mFrameDuration)
-        {
-            return;
-        }
-        else
-        {
-            currFrame++;
-            if (currFrame >= mMaxFrame)
-            {
-                if (mRepeat)
-                    currFrame = 0;
-                else
-                    currFrame = mMaxFrame - 1;
-            }
-            // Switch Frame
-            mRect_src.x = initialX + (mRect_src.w + offsetW) * currFrame;
-        }
-    }
-    frameStartTime = SDL_GetTicks();
-}
-
-void SingleAnimation::RenderFrame(std::shared_ptr<SDLGraphicsProgram> game, std::shared_ptr<GameEntity> ge)
-{
-    auto renderer = game->getSDLRenderer();
-    auto rect_dest = ge->GetTransform()->GetRect();
-    SDL_FlipMode isFlipped = SDL_FLIP_NONE;
-    if (ge->GetFlip())
-    {
-        isFlipped = SDL_FLIP_HORIZONTAL;
-    }
-
-    if (nullptr == mTexture)
-    {
-        if (futureTexture.valid())
-        {
-            mTexture = futureTexture.get();
-        }
-        else
-        {
-            SDL_RenderRect(renderer, &rect_dest);
-            return;
-        }
-    }
-    SDL_RenderTextureRotated(renderer, mTexture.get(), &mRect_src, &rect_dest, 0, nullptr, isFlipped);
-}
+#include "SingleAnimation.hpp"
+#include "ResourceManager.hpp"
+#include "GameEntity.hpp"
+#include "FrameClock.hpp"
+#include <algorithm>
+
+// Empty constructor so that we can create an empty sprite without any properties
+SingleAnimation::SingleAnimation()
+{
+}
+
+void SingleAnimation::CreateAnimation(std::shared_ptr<SDLGraphicsProgram> game, std::string filepath)
+{
+    mTexture = ResourceManager::Instance().LoadTextureAsync(filepath);
+}
+
+SingleAnimation::~SingleAnimation()
+{
+}
+
+void SingleAnimation::SetFrameConfig(int x, int y, int w, int w_offset, int h, int maxFrame, int millisecond_duration, bool repeat)
+{
+    initialX = x;
+    offsetW = w_offset;
+    mRect_src.x = x;
+    mRect_src.y = y;
+    mRect_src.w = w;
+    mRect_src.h = h;
+    mMaxFrame = maxFrame;
+    mFrameDuration = millisecond_duration;
+    mRepeat = repeat;
+    mFrameTrims.clear();
+}
+
+int SingleAnimation::GetW() const
+{
+    return mRect_src.w;
+}
+
+int SingleAnimation::GetH() const
+{
+    return mRect_src.h;
+}
+
+bool SingleAnimation::TrimFrames()
+{
+    if (nullptr == mTexture || mMaxFrame <= 0)
+    {
+        return false;
+    }
+    auto &alphaMask = mTexture->GetAlphaMask();
+    if (nullptr == alphaMask)
+    {
+        return false;
+    }
+    // Only trimmed again when the texture was reloaded with new pixels
+    if (alphaMask == mTrimmedMask && !mFrameTrims.empty())
+    {
+        return true;
+    }
+
+    mTrimmedMask = alphaMask;
+    mFrameTrims.clear();
+    mFrameTrims.reserve(mMaxFrame);
+    for (int frame = 0; frame < mMaxFrame; frame++)
+    {
+        SDL_Rect cell{static_cast<int>(initialX + (mRect_src.w + offsetW) * frame), static_cast<int>(mRect_src.y),
+                      static_cast<int>(mRect_src.w), static_cast<int>(mRect_src.h)};
+        SDL_Rect bounds = alphaMask->GetOpaqueBounds(cell);
+        mFrameTrims.push_back(SDL_FRect{static_cast<float>(bounds.x - cell.x), static_cast<float>(bounds.y - cell.y),
+                                        static_cast<float>(bounds.w), static_cast<float>(bounds.h)});
+    }
+    return true;
+}
+
+bool SingleAnimation::GetOpaqueBounds(SDL_FRect *bounds)
+{
+    if (!TrimFrames())
+    {
+        return false;
+    }
+
+    float left = mRect_src.w, top = mRect_src.h, right = 0.0f, bottom = 0.0f;
+    for (auto &trim : mFrameTrims)
+    {
+        if (trim.w <= 0.0f)
+        {
+            continue;
+        }
+        left = std::min(left, trim.x);
+        top = std::min(top, trim.y);
+        right = std::max(right, trim.x + trim.w);
+        bottom = std::max(bottom, trim.y + trim.h);
+    }
+    if (right <= left || bottom <= top)
+    {
+        return false;
+    }
+    *bounds = SDL_FRect{left, top, right - left, bottom - top};
+    return true;
+}
+
+int SingleAnimation::GetDuration()
+{
+    return mFrameDuration;
+}
+
+void SingleAnimation::ResetFrame()
+{
+    currFrame = -1;
+    mRect_src.x = initialX;
+}
+
+void SingleAnimation::UpdateFrame()
+{
+    if (frameStartTime != 0.0f)
+    {
+        if (FrameClock::GetTicks() - frameStartTime < mFrameDuration)
+        {
+            return;
+        }
+        else
+        {
+            currFrame++;
+            if (currFrame >= mMaxFrame)
+            {
+                if (mRepeat)
+                    currFrame = 0;
+                else
+                    currFrame = mMaxFrame - 1;
+            }
+            // Switch Frame
+            mRect_src.x = initialX + (mRect_src.w + offsetW) * currFrame;
+        }
+    }
+    frameStartTime = FrameClock::GetTicks();
+}
+
+int SingleAnimation::GetFrame() const
+{
+    return currFrame;
+}
+
+float SingleAnimation::GetFrameTime() const
+{
+    if (frameStartTime == 0.0f)
+    {
+        return -1.0f;
+    }
+    return FrameClock::GetTicks() - frameStartTime;
+}
+
+void SingleAnimation::SetFrame(int frame, float frameTime)
+{
+    currFrame = std::clamp(frame, -1, mMaxFrame - 1);
+    mRect_src.x = initialX + (mRect_src.w + offsetW) * std::max(currFrame, 0);
+    // The start time is kept relative to now, the ticks may have moved on since the frame was read
+    frameStartTime = frameTime < 0.0f ? 0.0f : FrameClock::GetTicks() - frameTime;
+}
+
+void SingleAnimation::RenderFrame(std::shared_ptr<SDLGraphicsProgram> game, std::shared_ptr<GameEntity> ge)
+{
+    auto renderer = game->getSDLRenderer();
+    auto rect_dest = ge->GetTransform()->GetRect();
+    SDL_FlipMode isFlipped = SDL_FLIP_NONE;
+    if (ge->GetFlip())
+    {
+        isFlipped = SDL_FLIP_HORIZONTAL;
+    }
+
+    if (nullptr == mTexture || !mTexture->IsReady())
+    {
+        if (nullptr != mTexture)
+        {
+            // Only happens if the texture was evicted while this handle was being looked up
+            ResourceManager::Instance().Restore(mTexture);
+        }
+        SDL_RenderRect(renderer, &rect_dest);
+        return;
+    }
+    if (!TrimFrames())
+    {
+        SDL_RenderTextureRotated(renderer, mTexture->GetTexture(), &mRect_src, &rect_dest, 0, nullptr, isFlipped);
+        return;
+    }
+
+    // Draw only the opaque part of the frame, scaled and placed like in the full frame
+    const SDL_FRect &trim = mFrameTrims[std::clamp(currFrame, 0, mMaxFrame - 1)];
+    if (trim.w <= 0.0f || mRect_src.w <= 0.0f || mRect_src.h <= 0.0f)
+    {
+        return;
+    }
+    float scaleX = rect_dest.w / mRect_src.w;
+    float scaleY = rect_dest.h / mRect_src.h;
+    // A horizontal flip mirrors the frame, so the margin on the right ends up on the left
+    float offsetX = ge->GetFlip() ? mRect_src.w - trim.x - trim.w : trim.x;
+    SDL_FRect trimmed_src{mRect_src.x + trim.x, mRect_src.y + trim.y, trim.w, trim.h};
+    SDL_FRect trimmed_dest{rect_dest.x + offsetX * scaleX, rect_dest.y + trim.y * scaleY, trim.w * scaleX, trim.h * scaleY};
+    SDL_RenderTextureRotated(renderer, mTexture->GetTexture(), &trimmed_src, &trimmed_dest, 0, nullptr, isFlipped);
+}
@@ -0,0 +1,136 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int numThreads)
+{
+    numThreads = std::max(1, numThreads);
+    for (int i = 0; i < numThreads; i++)
+    {
+        mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Stop()
+{
+    std::deque<QueuedJob> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        dropped = std::move(mJobs);
+        mJobs.clear();
+        for (auto &job : mLowPriorityJobs)
+        {
+            dropped.push_back(std::move(job));
+        }
+        mLowPriorityJobs.clear();
+    }
+    mCondition.notify_all();
+    for (auto &worker : mWorkers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    // Outside the lock, a cancel function may submit again
+    for (auto &job : dropped)
+    {
+        if (job.cancel)
+        {
+            job.cancel();
+        }
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> job, JobPriority priority, const void *key, std::function<void()> cancel)
+{
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mStop)
+        {
+            auto &jobs = priority == JobPriority::Low ? mLowPriorityJobs : mJobs;
+            jobs.push_back({std::move(job), std::move(cancel), key});
+            queued = true;
+        }
+    }
+    if (queued)
+    {
+        mCondition.notify_one();
+    }
+    else if (cancel)
+    {
+        // Nothing would ever run the job
+        cancel();
+    }
+}
+
+int ThreadPool::Promote(const std::unordered_set<const void *> &keys)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    int promoted = 0;
+    auto kept = mLowPriorityJobs.begin();
+    for (auto job = mLowPriorityJobs.begin(); job != mLowPriorityJobs.end(); job++)
+    {
+        if (nullptr != job->key && keys.count(job->key) > 0)
+        {
+            mJobs.push_back(std::move(*job));
+            promoted++;
+        }
+        else
+        {
+            if (kept != job)
+            {
+                *kept = std::move(*job);
+            }
+            kept++;
+        }
+    }
+    mLowPriorityJobs.erase(kept, mLowPriorityJobs.end());
+    return promoted;
+}
+
+int ThreadPool::GetQueuedCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mJobs.size() + mLowPriorityJobs.size();
+}
+
+int ThreadPool::GetThreadCount() const
+{
+    return mWorkers.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]
+                            { return mStop || !mJobs.empty() || !mLowPriorityJobs.empty(); });
+            if (mStop)
+            {
+                return;
+            }
+            if (!mJobs.empty())
+            {
+                job = std::move(mJobs.front().job);
+                mJobs.pop_front();
+            }
+            else
+            {
+                job = std::move(mLowPriorityJobs.front().job);
+                mLowPriorityJobs.pop_front();
+            }
+        }
+        job();
+    }
+}
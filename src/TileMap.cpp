@@ -1,137 +1,888 @@
-#include "TileMap.hpp"
-#include "GameEntity.hpp"
-#include <iostream>
-
-TileMap::TileMap(int mapWidth, int mapHeight, int numOfTileRow, int numOfTileColumn)
-{
-    mMapWidth = mapWidth;
-    mMapHeight = mapHeight;
-    maxRow = numOfTileRow;
-    maxColumn = numOfTileColumn;
-
-    mTileWidth = mapWidth / numOfTileColumn;
-    mTileHeight = mapHeight / numOfTileRow;
-
-    // Initialize the map layout
-    mMapLayout.resize(maxRow);
-    for (auto &row : mMapLayout)
-    {
-        row.resize(maxColumn);
-    }
-}
-
-TileMap::~TileMap()
-{
-}
-
-void TileMap::AddTileType(std::string tileName, std::string filepath, bool collidable)
-{
-    TileRecord tr;
-    tr.filepath = filepath;
-    tr.collidable = collidable;
-    mTiles.insert({tileName, tr});
-}
-
-void TileMap::PlaceTileAt(std::string tileName, int rowNum, int columnNum)
-{
-    // 0-based index
-    if (columnNum < 0 || columnNum >= maxColumn || rowNum < 0 || rowNum >= maxRow)
-    {
-        std::cout << "Invalid tile position" << std::endl;
-        return;
-    }
-
-    if (mTiles.find(tileName) == mTiles.end())
-    {
-        std::cout << "Tile type not found" << std::endl;
-        return;
-    }
-
-    TileRecord tr = mTiles[tileName];
-    std::shared_ptr<GameEntity> tile = std::make_shared<GameEntity>();
-
-    tile->AddTransform(columnNum * mTileWidth, rowNum * mTileHeight, mTileWidth, mTileHeight);
-    tile->SetName(tr.filepath);
-    if (tr.collidable)
-    {
-        tile->AddCollision2D(columnNum * mTileWidth, rowNum * mTileHeight, mTileWidth, mTileHeight);
-    }
-    mMapLayout[rowNum][columnNum] = tile;
-}
-
-void TileMap::EraseTileAt(int rowNum, int columnNum)
-{
-    if (columnNum < 0 || columnNum >= maxColumn || rowNum < 0 || rowNum >= maxRow)
-    {
-        std::cout << "Invalid tile position" << std::endl;
-        return;
-    }
-
-    mMapLayout[rowNum][columnNum] = nullptr;
-}
-
-void TileMap::LoadToGame(std::shared_ptr<SDLGraphicsProgram> game)
-{
-    for (auto &row : mMapLayout)
-    {
-        for (auto &tile : row)
-        {
-            if (tile != nullptr && tile->GetTexture() == nullptr)
-            {
-                tile->AddTexture(game, tile->GetName());
-            }
-        }
-    }
-}
-
-bool TileMap::HasCollisionWith(std::shared_ptr<GameEntity> target)
-{
-    for (auto &row : mMapLayout)
-    {
-        for (auto &tile : row)
-        {
-            if (tile != nullptr)
-            {
-                if (tile != nullptr && tile->isCollidable() && target->isCollidingWith(tile))
-                {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
-}
-
-int TileMap::GetMapWidth() const
-{
-    return mMapWidth;
-}
-
-int TileMap::GetMapHeight() const
-{
-    return mMapHeight;
-}
-
-float TileMap::GetTileWidth() const
-{
-    return mTileWidth;
-}
-
-float TileMap::GetTileHeight() const
-{
-    return mTileHeight;
-}
-
-void TileMap::Render(std::shared_ptr<SDLGraphicsProgram> game)
-{
-    for (auto &row : mMapLayout)
-    {
-        for (auto &tile : row)
-        {
-            if (tile != nullptr)
-            {
-                tile->Render(game);
-            }
-        }
-    }
+#include "TileMap.hpp"
+#include "GameEntity.hpp"
+#include "PixelOps.hpp"
+#include "ResourceManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+TileMap::TileMap(int mapWidth, int mapHeight, int numOfTileRow, int numOfTileColumn)
+{
+    mMapWidth = mapWidth;
+    mMapHeight = mapHeight;
+    maxRow = numOfTileRow;
+    maxColumn = numOfTileColumn;
+
+    mTileWidth = mapWidth / numOfTileColumn;
+    mTileHeight = mapHeight / numOfTileRow;
+
+    // Initialize the terrain layer
+    AddLayer("terrain", 1.0f, 1.0f, true, false);
+}
+
+TileMap::~TileMap()
+{
+    for (auto &layer : mLayers)
+    {
+        if (nullptr != layer.cache)
+        {
+            SDL_DestroyTexture(layer.cache);
+        }
+    }
+}
+
+int TileMap::AddLayer(std::string name, float parallaxX, float parallaxY, bool collidable, bool foreground)
+{
+    TileLayer layer;
+    layer.name = name;
+    layer.cells.resize(maxRow * maxColumn, 0);
+    layer.parallaxX = parallaxX;
+    layer.parallaxY = parallaxY;
+    layer.collidable = collidable;
+    layer.foreground = foreground;
+    mLayers.push_back(std::move(layer));
+    return mLayers.size() - 1;
+}
+
+int TileMap::GetLayerCount() const
+{
+    return mLayers.size();
+}
+
+int TileMap::GetLayerIndex(std::string name) const
+{
+    for (size_t i = 0; i < mLayers.size(); i++)
+    {
+        if (mLayers[i].name == name)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TileMap::SetLayerVisible(int layer, bool visible)
+{
+    if (IsValidLayer(layer))
+    {
+        mLayers[layer].visible = visible;
+    }
+}
+
+void TileMap::SetLayerParallax(int layer, float parallaxX, float parallaxY)
+{
+    if (IsValidLayer(layer))
+    {
+        mLayers[layer].parallaxX = parallaxX;
+        mLayers[layer].parallaxY = parallaxY;
+    }
+}
+
+void TileMap::SetLayerCollidable(int layer, bool collidable)
+{
+    if (!IsValidLayer(layer) || mLayers[layer].collidable == collidable)
+    {
+        return;
+    }
+    mLayers[layer].collidable = collidable;
+    mStaticRects.clear();
+    MergeStaticRects(SDL_Rect{0, 0, maxColumn, maxRow});
+}
+
+void TileMap::SetCamera(float x, float y)
+{
+    mCameraX = x;
+    mCameraY = y;
+}
+
+void TileMap::AddTileType(std::string tileName, std::string filepath, bool collidable, SDL_FRect srcRect,
+                          std::vector<SDL_FRect> frames, Uint32 frameDuration)
+{
+    TileRecord tr;
+    tr.filepath = filepath;
+    tr.collidable = collidable;
+    tr.srcRect = srcRect;
+    tr.frames = std::move(frames);
+    tr.frameDuration = frameDuration;
+    bool animated = !tr.frames.empty() && tr.frameDuration > 0;
+    mTileTypes.push_back(tr);
+    mSolidTypes.push_back(collidable);
+    mAnimatedTypes.push_back(animated);
+    mTiles.insert({tileName, static_cast<Uint16>(mTileTypes.size())});
+}
+
+void TileMap::Update(float deltaTime)
+{
+    mTileClock += deltaTime;
+}
+
+double TileMap::GetTileClock() const
+{
+    return mTileClock;
+}
+
+void TileMap::SetTileClock(double clock)
+{
+    mTileClock = clock;
+}
+
+void TileMap::PlaceTileAt(std::string tileName, int rowNum, int columnNum, int layer)
+{
+    // 0-based index
+    if (columnNum < 0 || columnNum >= maxColumn || rowNum < 0 || rowNum >= maxRow)
+    {
+        std::cout << "Invalid tile position" << std::endl;
+        return;
+    }
+
+    if (mTiles.find(tileName) == mTiles.end())
+    {
+        std::cout << "Tile type not found" << std::endl;
+        return;
+    }
+
+    if (!IsValidLayer(layer))
+    {
+        return;
+    }
+
+    SetCell(rowNum, columnNum, mTiles[tileName], layer);
+}
+
+Uint16 TileMap::GetTileId(int rowNum, int columnNum, int layer) const
+{
+    if (columnNum < 0 || columnNum >= maxColumn || rowNum < 0 || rowNum >= maxRow || layer < 0 || layer >= static_cast<int>(mLayers.size()))
+    {
+        return 0;
+    }
+    return mLayers[layer].cells[rowNum * maxColumn + columnNum];
+}
+
+std::shared_ptr<GameEntity> TileMap::GetTileEntity(int rowNum, int columnNum)
+{
+    Uint16 id = GetTileId(rowNum, columnNum);
+    if (id == 0)
+    {
+        return nullptr;
+    }
+
+    auto &tile = mTileEntities[rowNum * maxColumn + columnNum];
+    if (tile == nullptr)
+    {
+        const TileRecord &tr = mTileTypes[id - 1];
+        tile = std::make_shared<GameEntity>();
+        tile->AddTransform(columnNum * mTileWidth, rowNum * mTileHeight, mTileWidth, mTileHeight);
+        tile->SetName(tr.filepath);
+        if (tr.collidable)
+        {
+            tile->AddCollision2D(columnNum * mTileWidth, rowNum * mTileHeight, mTileWidth, mTileHeight);
+        }
+    }
+    return tile;
+}
+
+bool TileMap::LoadLayout(std::shared_ptr<SDLGraphicsProgram> game, const Uint16 *ids, int rows, int columns, int layer)
+{
+    if (!IsValidLayer(layer))
+    {
+        return false;
+    }
+    if (rows != maxRow || columns != maxColumn)
+    {
+        std::cout << "Layout size does not match the map" << std::endl;
+        return false;
+    }
+    if (!SetLayerCells(ids, layer))
+    {
+        return false;
+    }
+    LoadToGame(game);
+    return true;
+}
+
+bool TileMap::LoadLevelFile(std::shared_ptr<SDLGraphicsProgram> game, const LevelFile &levelFile)
+{
+    if (!levelFile.IsOpen())
+    {
+        std::cout << "Level file not open" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < levelFile.GetLayerCount(); i++)
+    {
+        const LevelFileLayer &record = levelFile.GetLayer(i);
+        bool collidable = (record.flags & LevelFile::LAYER_COLLIDABLE) != 0;
+        int layer = 0;
+        if (i == 0)
+        {
+            SetLayerParallax(0, record.parallaxX, record.parallaxY);
+            SetLayerCollidable(0, collidable);
+        }
+        else
+        {
+            layer = AddLayer(std::string(levelFile.GetString(record.nameOffset)), record.parallaxX, record.parallaxY,
+                             collidable, (record.flags & LevelFile::LAYER_FOREGROUND) != 0);
+        }
+        if (!LoadLayout(game, levelFile.GetLayerCells(i), levelFile.GetRowCount(), levelFile.GetColumnCount(), layer))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const Uint16 *TileMap::GetLayerCells(int layer) const
+{
+    if (layer < 0 || layer >= static_cast<int>(mLayers.size()))
+    {
+        return nullptr;
+    }
+    return mLayers[layer].cells.data();
+}
+
+bool TileMap::SetLayerCells(const Uint16 *ids, int layer)
+{
+    if (!IsValidLayer(layer))
+    {
+        return false;
+    }
+    // Check the ids first, so that a bad layout leaves the map as it was
+    size_t cellCount = static_cast<size_t>(maxRow) * maxColumn;
+    if (std::any_of(ids, ids + cellCount, [&](Uint16 id)
+                    { return id > mTileTypes.size(); }))
+    {
+        std::cout << "Tile type not found" << std::endl;
+        return false;
+    }
+
+    TileLayer &target = mLayers[layer];
+    if (std::equal(ids, ids + cellCount, target.cells.begin()))
+    {
+        return true;
+    }
+    target.cells.assign(ids, ids + cellCount);
+    target.cacheValid = false;
+    if (layer == 0)
+    {
+        mTileEntities.clear();
+    }
+    if (target.collidable)
+    {
+        // One merge of the whole map, the cells may have changed anywhere
+        mStaticRects.clear();
+        MergeStaticRects(SDL_Rect{0, 0, maxColumn, maxRow});
+    }
+    return true;
+}
+
+int TileMap::GetRowCount() const
+{
+    return maxRow;
+}
+
+int TileMap::GetColumnCount() const
+{
+    return maxColumn;
+}
+
+void TileMap::EraseTileAt(int rowNum, int columnNum, int layer)
+{
+    if (columnNum < 0 || columnNum >= maxColumn || rowNum < 0 || rowNum >= maxRow)
+    {
+        std::cout << "Invalid tile position" << std::endl;
+        return;
+    }
+
+    if (!IsValidLayer(layer))
+    {
+        return;
+    }
+
+    SetCell(rowNum, columnNum, 0, layer);
+}
+
+void TileMap::LoadToGame(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    std::vector<bool> used(mTileTypes.size() + 1, false);
+    for (auto &layer : mLayers)
+    {
+        for (Uint16 id : layer.cells)
+        {
+            used[id] = true;
+        }
+    }
+    for (size_t i = 0; i < mTileTypes.size(); i++)
+    {
+        TileRecord &tr = mTileTypes[i];
+        if (used[i + 1] && tr.texture == nullptr)
+        {
+            tr.texture = ResourceManager::Instance().LoadTextureAsync(tr.filepath);
+        }
+    }
+}
+
+bool TileMap::HasCollisionWith(std::shared_ptr<GameEntity> target)
+{
+    if (!target->isCollidable())
+    {
+        return false;
+    }
+    auto rect = target->GetCollision2D()->GetRect();
+    return HasCollisionAt(rect.x, rect.y, rect.w, rect.h);
+}
+
+bool TileMap::HasCollisionAt(float x, float y, float w, float h) const
+{
+    SDL_FRect target{x, y, w, h};
+    for (auto &r : mStaticRects)
+    {
+        SDL_FRect solid{r.x * mTileWidth, r.y * mTileHeight, r.w * mTileWidth, r.h * mTileHeight};
+        if (SDL_HasRectIntersectionFloat(&solid, &target))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<SDL_FRect> TileMap::GetStaticCollisionRects() const
+{
+    std::vector<SDL_FRect> rects;
+    rects.reserve(mStaticRects.size());
+    for (auto &r : mStaticRects)
+    {
+        rects.push_back({r.x * mTileWidth, r.y * mTileHeight, r.w * mTileWidth, r.h * mTileHeight});
+    }
+    return rects;
+}
+
+int TileMap::GetStaticCollisionRectCount() const
+{
+    return mStaticRects.size();
+}
+
+RaycastHit TileMap::Raycast(float x, float y, float dirX, float dirY, float maxDistance) const
+{
+    RaycastHit result;
+    float length = std::sqrt(dirX * dirX + dirY * dirY);
+    if (length == 0.0f || mTileWidth <= 0.0f || mTileHeight <= 0.0f)
+    {
+        return result;
+    }
+    dirX /= length;
+    dirY /= length;
+
+    int column = static_cast<int>(std::floor(x / mTileWidth));
+    int row = static_cast<int>(std::floor(y / mTileHeight));
+    if (column < 0 || column >= maxColumn || row < 0 || row >= maxRow)
+    {
+        return result;
+    }
+
+    // Distance along the ray to the next vertical/horizontal grid line, and between two of them
+    int stepColumn = dirX > 0.0f ? 1 : -1;
+    int stepRow = dirY > 0.0f ? 1 : -1;
+    float deltaX = dirX != 0.0f ? std::abs(mTileWidth / dirX) : INFINITY;
+    float deltaY = dirY != 0.0f ? std::abs(mTileHeight / dirY) : INFINITY;
+    float nextX = dirX != 0.0f ? ((column + (stepColumn > 0)) * mTileWidth - x) / dirX : INFINITY;
+    float nextY = dirY != 0.0f ? ((row + (stepRow > 0)) * mTileHeight - y) / dirY : INFINITY;
+
+    float distance = 0.0f;
+    while (true)
+    {
+        if (IsCellSolid(row, column))
+        {
+            result.hit = true;
+            result.row = row;
+            result.column = column;
+            break;
+        }
+
+        if (nextX < nextY)
+        {
+            distance = nextX;
+            nextX += deltaX;
+            column += stepColumn;
+        }
+        else
+        {
+            distance = nextY;
+            nextY += deltaY;
+            row += stepRow;
+        }
+
+        if (distance > maxDistance || column < 0 || column >= maxColumn || row < 0 || row >= maxRow)
+        {
+            distance = std::min(distance, maxDistance);
+            break;
+        }
+    }
+
+    result.distance = distance;
+    result.x = x + dirX * distance;
+    result.y = y + dirY * distance;
+    return result;
+}
+
+bool TileMap::HasLineOfSight(float x0, float y0, float x1, float y1) const
+{
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0.0f)
+    {
+        return !Raycast(x0, y0, 1.0f, 0.0f, 0.0f).hit;
+    }
+    return !Raycast(x0, y0, dx, dy, length).hit;
+}
+
+std::vector<RaycastHit> TileMap::RaycastBatch(const std::vector<float> &rays) const
+{
+    std::vector<RaycastHit> hits;
+    hits.reserve(rays.size() / 5);
+    for (size_t i = 0; i + 5 <= rays.size(); i += 5)
+    {
+        hits.push_back(Raycast(rays[i], rays[i + 1], rays[i + 2], rays[i + 3], rays[i + 4]));
+    }
+    return hits;
+}
+
+std::vector<bool> TileMap::LineOfSightBatch(const std::vector<float> &segments) const
+{
+    std::vector<bool> visible;
+    visible.reserve(segments.size() / 4);
+    for (size_t i = 0; i + 4 <= segments.size(); i += 4)
+    {
+        visible.push_back(HasLineOfSight(segments[i], segments[i + 1], segments[i + 2], segments[i + 3]));
+    }
+    return visible;
+}
+
+int TileMap::GetMapWidth() const
+{
+    return mMapWidth;
+}
+
+int TileMap::GetMapHeight() const
+{
+    return mMapHeight;
+}
+
+float TileMap::GetTileWidth() const
+{
+    return mTileWidth;
+}
+
+float TileMap::GetTileHeight() const
+{
+    return mTileHeight;
+}
+
+void TileMap::Render(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    RenderBackground(game);
+    RenderForeground(game);
+}
+
+void TileMap::RenderBackground(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    ResolveTileTypes();
+    for (auto &layer : mLayers)
+    {
+        if (!layer.foreground)
+        {
+            RenderLayer(game->getSDLRenderer(), layer);
+        }
+    }
+}
+
+void TileMap::RenderForeground(std::shared_ptr<SDLGraphicsProgram> game)
+{
+    ResolveTileTypes();
+    for (auto &layer : mLayers)
+    {
+        if (layer.foreground)
+        {
+            RenderLayer(game->getSDLRenderer(), layer);
+        }
+    }
+}
+
+void TileMap::ResolveTileTypes()
+{
+    mTypeTextures.assign(mTileTypes.size() + 1, nullptr);
+    mTypePlaceholders.assign(mTileTypes.size() + 1, 0);
+    mTypeSrcRects.assign(mTileTypes.size() + 1, nullptr);
+    Uint64 clockMS = static_cast<Uint64>(mTileClock * 1000.0);
+    for (size_t i = 0; i < mTileTypes.size(); i++)
+    {
+        TileRecord &tr = mTileTypes[i];
+        if (mAnimatedTypes[i + 1])
+        {
+            mTypeSrcRects[i + 1] = &tr.frames[clockMS / tr.frameDuration % tr.frames.size()];
+        }
+        else if (tr.srcRect.w > 0.0f)
+        {
+            mTypeSrcRects[i + 1] = &tr.srcRect;
+        }
+
+        if (nullptr == tr.texture)
+        {
+            continue;
+        }
+        if (tr.texture->IsReady())
+        {
+            mTypeTextures[i + 1] = tr.texture->GetTexture();
+        }
+        else if (tr.texture->IsFailed())
+        {
+            mTypePlaceholders[i + 1] = 2;
+        }
+        else
+        {
+            // Still loading, or evicted while this handle was being looked up
+            ResourceManager::Instance().Restore(tr.texture);
+            mTypePlaceholders[i + 1] = 1;
+        }
+    }
+}
+
+void TileMap::RenderLayer(SDL_Renderer *renderer, TileLayer &layer)
+{
+    if (!layer.visible)
+    {
+        return;
+    }
+
+    float offsetX = std::round(-mCameraX * layer.parallaxX);
+    float offsetY = std::round(-mCameraY * layer.parallaxY);
+    int outputWidth = mMapWidth;
+    int outputHeight = mMapHeight;
+    SDL_GetCurrentRenderOutputSize(renderer, &outputWidth, &outputHeight);
+
+    if (nullptr == layer.cache && !layer.cacheFailed)
+    {
+        layer.cache = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, mMapWidth, mMapHeight);
+        if (nullptr == layer.cache)
+        {
+            // Usually a map larger than the renderer allows for a texture
+            SDL_Log("Could not create the cache of layer %s: %s", layer.name.c_str(), SDL_GetError());
+            layer.cacheFailed = true;
+        }
+        else
+        {
+            // Tiles blended over a transparent target leave premultiplied colors in it
+            SDL_SetTextureBlendMode(layer.cache, GetPremultipliedBlendMode());
+        }
+    }
+    if (nullptr == layer.cache)
+    {
+        DrawLayerCells(renderer, layer, offsetX, offsetY, outputWidth, outputHeight, true);
+        return;
+    }
+
+    int reloadCount = ResourceManager::Instance().GetReloadCount();
+    if (!layer.cacheValid || layer.cacheReloadCount != reloadCount)
+    {
+        SDL_Texture *target = SDL_GetRenderTarget(renderer);
+        Uint8 r, g, b, a;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_SetRenderTarget(renderer, layer.cache);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        // Drawn again next frame while some textures are still loading
+        layer.cacheValid = DrawLayerCells(renderer, layer, 0.0f, 0.0f, mMapWidth, mMapHeight, false);
+        layer.cacheReloadCount = reloadCount;
+        layer.dirtyCells.clear();
+        SDL_SetRenderTarget(renderer, target);
+
+        layer.animatedCells.clear();
+        for (size_t i = 0; i < layer.cells.size(); i++)
+        {
+            if (mAnimatedTypes[layer.cells[i]])
+            {
+                layer.animatedCells.push_back(i);
+            }
+        }
+    }
+    else if (!layer.dirtyCells.empty())
+    {
+        PatchCache(renderer, layer);
+    }
+    SDL_FRect dest{offsetX, offsetY, static_cast<float>(mMapWidth), static_cast<float>(mMapHeight)};
+    SDL_RenderTexture(renderer, layer.cache, nullptr, &dest);
+
+    for (int index : layer.animatedCells)
+    {
+        SDL_FRect rect{offsetX + index % maxColumn * mTileWidth, offsetY + index / maxColumn * mTileHeight, mTileWidth, mTileHeight};
+        if (rect.x + rect.w > 0.0f && rect.y + rect.h > 0.0f && rect.x < outputWidth && rect.y < outputHeight)
+        {
+            DrawCell(renderer, layer.cells[index], rect);
+        }
+    }
+}
+
+bool TileMap::DrawLayerCells(SDL_Renderer *renderer, const TileLayer &layer, float offsetX, float offsetY, int outputWidth, int outputHeight, bool animated)
+{
+    if (mTileWidth <= 0.0f || mTileHeight <= 0.0f)
+    {
+        return true;
+    }
+
+    // Only the rows and columns within the output
+    int firstRow = std::max(0, static_cast<int>(std::floor(-offsetY / mTileHeight)));
+    int firstColumn = std::max(0, static_cast<int>(std::floor(-offsetX / mTileWidth)));
+    int lastRow = std::min(maxRow, static_cast<int>(std::ceil((outputHeight - offsetY) / mTileHeight)));
+    int lastColumn = std::min(maxColumn, static_cast<int>(std::ceil((outputWidth - offsetX) / mTileWidth)));
+
+    bool complete = true;
+    for (int row = firstRow; row < lastRow; row++)
+    {
+        const Uint16 *cells = layer.cells.data() + row * maxColumn;
+        for (int column = firstColumn; column < lastColumn; column++)
+        {
+            Uint16 id = cells[column];
+            if (id == 0 || (!animated && mAnimatedTypes[id]))
+            {
+                continue;
+            }
+            SDL_FRect rect{offsetX + column * mTileWidth, offsetY + row * mTileHeight, mTileWidth, mTileHeight};
+            complete = DrawCell(renderer, id, rect) && complete;
+        }
+    }
+    return complete;
+}
+
+bool TileMap::DrawCell(SDL_Renderer *renderer, Uint16 id, const SDL_FRect &rect)
+{
+    if (nullptr != mTypeTextures[id])
+    {
+        SDL_RenderTexture(renderer, mTypeTextures[id], mTypeSrcRects[id], &rect);
+        return true;
+    }
+    if (mTypePlaceholders[id])
+    {
+        SDL_RenderRect(renderer, &rect);
+    }
+    return mTypePlaceholders[id] == 2;
+}
+
+bool TileMap::IsCellSolid(int rowNum, int columnNum) const
+{
+    int index = rowNum * maxColumn + columnNum;
+    for (auto &layer : mLayers)
+    {
+        if (layer.collidable && mSolidTypes[layer.cells[index]])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TileMap::IsValidLayer(int layer) const
+{
+    if (layer < 0 || layer >= static_cast<int>(mLayers.size()))
+    {
+        std::cout << "Invalid layer" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TileMap::SetCell(int rowNum, int columnNum, Uint16 id, int layer)
+{
+    if (WriteCell(rowNum, columnNum, id, layer))
+    {
+        RebuildStaticRects(SDL_Rect{columnNum, rowNum, 1, 1});
+    }
+}
+
+bool TileMap::WriteCell(int rowNum, int columnNum, Uint16 id, int layer)
+{
+    int index = rowNum * maxColumn + columnNum;
+    TileLayer &target = mLayers[layer];
+    bool wasSolid = IsCellSolid(rowNum, columnNum);
+    target.cells[index] = id;
+    // A few cells are cheaper to redraw one by one than the whole layer
+    if (target.cacheValid && target.dirtyCells.size() < target.cells.size() / 16)
+    {
+        target.dirtyCells.push_back(index);
+    }
+    else
+    {
+        target.cacheValid = false;
+    }
+    if (layer == 0)
+    {
+        mTileEntities.erase(index);
+    }
+    return IsCellSolid(rowNum, columnNum) != wasSolid;
+}
+
+void TileMap::PatchCache(SDL_Renderer *renderer, TileLayer &layer)
+{
+    SDL_Texture *target = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_SetRenderTarget(renderer, layer.cache);
+    for (int index : layer.dirtyCells)
+    {
+        // Cleared to transparent first, drawing over the old tile would blend with it
+        SDL_FRect rect{index % maxColumn * mTileWidth, index / maxColumn * mTileHeight, mTileWidth, mTileHeight};
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderFillRect(renderer, &rect);
+        SDL_SetRenderDrawBlendMode(renderer, blendMode);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+        Uint16 id = layer.cells[index];
+        bool animated = mAnimatedTypes[id];
+        if (id != 0 && !animated && !DrawCell(renderer, id, rect))
+        {
+            // Still loading, the whole layer is drawn again once it is ready
+            layer.cacheValid = false;
+        }
+        auto found = std::lower_bound(layer.animatedCells.begin(), layer.animatedCells.end(), index);
+        bool listed = found != layer.animatedCells.end() && *found == index;
+        if (animated && !listed)
+        {
+            layer.animatedCells.insert(found, index);
+        }
+        else if (!animated && listed)
+        {
+            layer.animatedCells.erase(found);
+        }
+    }
+    SDL_SetRenderTarget(renderer, target);
+    layer.dirtyCells.clear();
+}
+
+int TileMap::SetTileIds(const std::vector<TileChange> &changes)
+{
+    int applied = 0;
+    int firstRow = maxRow;
+    int lastRow = -1;
+    int firstColumn = maxColumn;
+    int lastColumn = -1;
+    for (const TileChange &change : changes)
+    {
+        if (change.column < 0 || change.column >= maxColumn || change.row < 0 || change.row >= maxRow ||
+            change.layer >= mLayers.size() || change.id > mTileTypes.size())
+        {
+            continue;
+        }
+        if (WriteCell(change.row, change.column, change.id, change.layer))
+        {
+            firstRow = std::min(firstRow, change.row);
+            lastRow = std::max(lastRow, change.row);
+            firstColumn = std::min(firstColumn, change.column);
+            lastColumn = std::max(lastColumn, change.column);
+        }
+        applied++;
+    }
+    if (lastRow >= 0)
+    {
+        RebuildStaticRects(SDL_Rect{firstColumn, firstRow, lastColumn - firstColumn + 1, lastRow - firstRow + 1});
+    }
+    return applied;
+}
+
+void TileMap::RebuildStaticRects(SDL_Rect edited)
+{
+    // Drop the rectangles overlapping the edited cells, then merge again what they covered plus the edited cells.
+    // The rectangles kept are stepped around rather than merged again, so the region stays around the edit
+    auto overlapsEdit = [&](const SDL_Rect &r)
+    {
+        return r.x < edited.x + edited.w && edited.x < r.x + r.w && r.y < edited.y + edited.h && edited.y < r.y + r.h;
+    };
+    int top = edited.y;
+    int bottom = edited.y + edited.h - 1;
+    int left = edited.x;
+    int right = edited.x + edited.w - 1;
+    for (auto &r : mStaticRects)
+    {
+        if (overlapsEdit(r))
+        {
+            top = std::min(top, r.y);
+            bottom = std::max(bottom, r.y + r.h - 1);
+            left = std::min(left, r.x);
+            right = std::max(right, r.x + r.w - 1);
+        }
+    }
+    mStaticRects.erase(std::remove_if(mStaticRects.begin(), mStaticRects.end(), overlapsEdit), mStaticRects.end());
+
+    MergeStaticRects(SDL_Rect{left, top, right - left + 1, bottom - top + 1});
+}
+
+void TileMap::MergeStaticRects(SDL_Rect region)
+{
+    int top = region.y;
+    int bottom = region.y + region.h - 1;
+    int left = region.x;
+    int right = region.x + region.w - 1;
+
+    // The cells of the region already covered by a rectangle are left alone
+    std::vector<uint8_t> covered(static_cast<size_t>(region.h) * region.w, 0);
+    for (auto &r : mStaticRects)
+    {
+        int coveredTop = std::max(top, r.y);
+        int coveredBottom = std::min(bottom, r.y + r.h - 1);
+        int coveredLeft = std::max(left, r.x);
+        int coveredRight = std::min(right, r.x + r.w - 1);
+        for (int row = coveredTop; row <= coveredBottom && coveredLeft <= coveredRight; row++)
+        {
+            std::fill_n(covered.begin() + (row - top) * region.w + coveredLeft - left, coveredRight - coveredLeft + 1, 1);
+        }
+    }
+    auto isFree = [&](int row, int column)
+    {
+        return IsCellSolid(row, column) && !covered[(row - top) * region.w + column - left];
+    };
+
+    // Greedy merge: take the widest run from each uncovered solid cell, then grow it down while the rows below match
+    for (int row = top; row <= bottom; row++)
+    {
+        for (int column = left; column <= right; column++)
+        {
+            if (!isFree(row, column))
+            {
+                continue;
+            }
+
+            int width = 1;
+            while (column + width <= right && isFree(row, column + width))
+            {
+                width++;
+            }
+
+            int height = 1;
+            while (row + height <= bottom)
+            {
+                bool fullRow = true;
+                for (int c = column; c < column + width; c++)
+                {
+                    if (!isFree(row + height, c))
+                    {
+                        fullRow = false;
+                        break;
+                    }
+                }
+                if (!fullRow)
+                {
+                    break;
+                }
+                height++;
+            }
+
+            for (int r = row; r < row + height; r++)
+            {
+                std::fill_n(covered.begin() + (r - top) * region.w + column - left, width, 1);
+            }
+            mStaticRects.push_back({column, row, width, height});
+            column += width - 1;
+        }
+    }
 }
\ No newline at end of file
@@ -1,15 +1,39 @@
 // Include the pybindings
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <array>
+#include <cstring>
 #include <memory>
 
 #include "SDLGraphicsProgram.hpp"
 #include "Input.hpp"
+#include "EventQueue.hpp"
+#include "FrameClock.hpp"
+#include "InputRecording.hpp"
 #include "GameEntity.hpp"
 #include "TileMap.hpp"
+#include "ChunkedTileMap.hpp"
+#include "LevelFile.hpp"
+#include "EditHistory.hpp"
+#include "EditJournal.hpp"
+#include "LevelSnapshot.hpp"
+#include "CollisionWorld.hpp"
+#include "ResourceManager.hpp"
 
 namespace py = pybind11;
 
+/**
+ * The tile type ids of one layer of a LevelFile, exported to Python through the buffer protocol.
+ * Holds the mapping, so that a memoryview of it stays valid after the LevelFile is closed or collected.
+ */
+struct LevelFileCells
+{
+    std::shared_ptr<const Uint8> mapping;
+    const Uint16 *cells;
+    py::ssize_t rows;
+    py::ssize_t columns;
+};
+
 // Creates a macro function that will be called
 // whenever the module is imported into python
 // 'mygameengine' is what we 'import' into python.
@@ -21,12 +45,13 @@ PYBIND11_MODULE(mygameengine, m)
     m.doc() = "our game engine as a library"; // Optional docstring
 
     py::class_<SDLGraphicsProgram, std::shared_ptr<SDLGraphicsProgram>>(m, "SDLGraphicsProgram")
-        .def(py::init<int, int, std::string>(),
-             py::arg("w"), py::arg("h"), py::arg("title")) // constructor
+        .def(py::init<int, int, std::string, bool>(),
+             py::arg("w"), py::arg("h"), py::arg("title"), py::arg("headless") = false) // constructor
         .def("clear", &SDLGraphicsProgram::clear,          // member methods
              py::arg("r"), py::arg("g"), py::arg("b"), py::arg("a"))
         .def("delay", &SDLGraphicsProgram::delay)
         .def("flip", &SDLGraphicsProgram::flip)
+        .def("set_upload_budget", &SDLGraphicsProgram::setUploadBudget, py::arg("milliseconds"))
         .def("loop", &SDLGraphicsProgram::loop)
         .def("get_delta_time", &SDLGraphicsProgram::getDeltaTime)
         .def("get_screen_width", &SDLGraphicsProgram::getScreenWidth)
@@ -34,8 +59,81 @@ PYBIND11_MODULE(mygameengine, m)
         .def("draw_rect", &SDLGraphicsProgram::drawRectangle);
     // .def("getSDLWindow", &SDLGraphicsProgram::getSDLWindow, py::return_value_policy::reference)
 
+    // The keys by where they are on a US keyboard; any other scancode can be passed as Scancode(number)
+    py::enum_<SDL_Scancode>(m, "Scancode", py::arithmetic())
+        .value("A", SDL_SCANCODE_A)
+        .value("B", SDL_SCANCODE_B)
+        .value("C", SDL_SCANCODE_C)
+        .value("D", SDL_SCANCODE_D)
+        .value("E", SDL_SCANCODE_E)
+        .value("F", SDL_SCANCODE_F)
+        .value("G", SDL_SCANCODE_G)
+        .value("H", SDL_SCANCODE_H)
+        .value("I", SDL_SCANCODE_I)
+        .value("J", SDL_SCANCODE_J)
+        .value("K", SDL_SCANCODE_K)
+        .value("L", SDL_SCANCODE_L)
+        .value("M", SDL_SCANCODE_M)
+        .value("N", SDL_SCANCODE_N)
+        .value("O", SDL_SCANCODE_O)
+        .value("P", SDL_SCANCODE_P)
+        .value("Q", SDL_SCANCODE_Q)
+        .value("R", SDL_SCANCODE_R)
+        .value("S", SDL_SCANCODE_S)
+        .value("T", SDL_SCANCODE_T)
+        .value("U", SDL_SCANCODE_U)
+        .value("V", SDL_SCANCODE_V)
+        .value("W", SDL_SCANCODE_W)
+        .value("X", SDL_SCANCODE_X)
+        .value("Y", SDL_SCANCODE_Y)
+        .value("Z", SDL_SCANCODE_Z)
+        .value("KEY_1", SDL_SCANCODE_1)
+        .value("KEY_2", SDL_SCANCODE_2)
+        .value("KEY_3", SDL_SCANCODE_3)
+        .value("KEY_4", SDL_SCANCODE_4)
+        .value("KEY_5", SDL_SCANCODE_5)
+        .value("KEY_6", SDL_SCANCODE_6)
+        .value("KEY_7", SDL_SCANCODE_7)
+        .value("KEY_8", SDL_SCANCODE_8)
+        .value("KEY_9", SDL_SCANCODE_9)
+        .value("KEY_0", SDL_SCANCODE_0)
+        .value("RETURN", SDL_SCANCODE_RETURN)
+        .value("ESCAPE", SDL_SCANCODE_ESCAPE)
+        .value("BACKSPACE", SDL_SCANCODE_BACKSPACE)
+        .value("TAB", SDL_SCANCODE_TAB)
+        .value("SPACE", SDL_SCANCODE_SPACE)
+        .value("RIGHT", SDL_SCANCODE_RIGHT)
+        .value("LEFT", SDL_SCANCODE_LEFT)
+        .value("DOWN", SDL_SCANCODE_DOWN)
+        .value("UP", SDL_SCANCODE_UP)
+        .value("LCTRL", SDL_SCANCODE_LCTRL)
+        .value("LSHIFT", SDL_SCANCODE_LSHIFT);
+
+    py::class_<InputSnapshot>(m, "InputSnapshot")
+        .def("is_key_down", &InputSnapshot::IsKeyDown, py::arg("scancode"))
+        .def("is_key_pressed", &InputSnapshot::IsKeyPressed, py::arg("scancode"))
+        .def("is_key_released", &InputSnapshot::IsKeyReleased, py::arg("scancode"))
+        .def("is_mouse_button_down", &InputSnapshot::IsMouseButtonDown, py::arg("button") = SDL_BUTTON_LEFT)
+        .def("is_mouse_button_pressed", &InputSnapshot::IsMouseButtonPressed, py::arg("button") = SDL_BUTTON_LEFT)
+        .def("is_mouse_button_released", &InputSnapshot::IsMouseButtonReleased, py::arg("button") = SDL_BUTTON_LEFT)
+        .def("get_keys_down", &InputSnapshot::GetKeysDown)
+        .def("get_keys_pressed", &InputSnapshot::GetKeysPressed)
+        .def_readonly("mouse_x", &InputSnapshot::mouseX)
+        .def_readonly("mouse_y", &InputSnapshot::mouseY)
+        .def_readonly("frame", &InputSnapshot::frame);
+
     py::class_<Input, std::shared_ptr<Input>>(m, "Input")
         .def(py::init<>())
+        .def("update", &Input::Update, py::return_value_policy::copy)
+        .def("get_snapshot", &Input::GetSnapshot, py::return_value_policy::copy)
+        .def("start_recording", &Input::StartRecording, py::arg("recording"))
+        .def("stop_recording", &Input::StopRecording)
+        .def("start_replay", &Input::StartReplay, py::arg("recording"))
+        .def("stop_replay", &Input::StopReplay)
+        .def("is_replaying", &Input::IsReplaying)
+        .def("is_key_down", &Input::IsKeyDown, py::arg("scancode"))
+        .def("is_key_pressed", &Input::IsKeyPressed, py::arg("scancode"))
+        .def("is_key_released", &Input::IsKeyReleased, py::arg("scancode"))
         .def("is_up_key_down", &Input::isUpKeyDown)
         .def("is_down_key_down", &Input::isDownKeyDown)
         .def("is_left_key_down", &Input::isLeftKeyDown)
@@ -44,6 +142,8 @@ PYBIND11_MODULE(mygameengine, m)
         .def("is_x_key_down", &Input::isXKeyDown)
         .def("is_e_key_down", &Input::isEKeyDown)
         .def("is_s_key_down", &Input::isSKeyDown)
+        .def("is_z_key_down", &Input::isZKeyDown)
+        .def("is_y_key_down", &Input::isYKeyDown)
         .def("is_1_key_down", &Input::is1KeyDown)
         .def("is_2_key_down", &Input::is2KeyDown)
         .def("is_3_key_down", &Input::is3KeyDown)
@@ -53,6 +153,80 @@ PYBIND11_MODULE(mygameengine, m)
         .def("get_mouse_position", &Input::GetMousePosition)
         .def("is_quit_clicked", &Input::isQuitClicked);
 
+    // The kinds of events Python is likely to look at; any other kind comes as EventType(number)
+    py::enum_<SDL_EventType>(m, "EventType", py::arithmetic())
+        .value("QUIT", SDL_EVENT_QUIT)
+        .value("WINDOW_SHOWN", SDL_EVENT_WINDOW_SHOWN)
+        .value("WINDOW_HIDDEN", SDL_EVENT_WINDOW_HIDDEN)
+        .value("WINDOW_MOVED", SDL_EVENT_WINDOW_MOVED)
+        .value("WINDOW_RESIZED", SDL_EVENT_WINDOW_RESIZED)
+        .value("WINDOW_FOCUS_GAINED", SDL_EVENT_WINDOW_FOCUS_GAINED)
+        .value("WINDOW_FOCUS_LOST", SDL_EVENT_WINDOW_FOCUS_LOST)
+        .value("KEY_DOWN", SDL_EVENT_KEY_DOWN)
+        .value("KEY_UP", SDL_EVENT_KEY_UP)
+        .value("TEXT_EDITING", SDL_EVENT_TEXT_EDITING)
+        .value("TEXT_INPUT", SDL_EVENT_TEXT_INPUT)
+        .value("MOUSE_MOTION", SDL_EVENT_MOUSE_MOTION)
+        .value("MOUSE_BUTTON_DOWN", SDL_EVENT_MOUSE_BUTTON_DOWN)
+        .value("MOUSE_BUTTON_UP", SDL_EVENT_MOUSE_BUTTON_UP)
+        .value("MOUSE_WHEEL", SDL_EVENT_MOUSE_WHEEL)
+        .value("DROP_FILE", SDL_EVENT_DROP_FILE);
+
+    py::class_<QueuedEvent>(m, "Event")
+        .def_property_readonly("type", [](const QueuedEvent &e)
+                               { return static_cast<SDL_EventType>(e.event.type); })
+        .def_readonly("sequence", &QueuedEvent::sequence)
+        .def_property_readonly("timestamp_ns", [](const QueuedEvent &e)
+                               { return e.event.common.timestamp; })
+        // 0 for events other than keys
+        .def_property_readonly("scancode", [](const QueuedEvent &e)
+                               { return e.event.type == SDL_EVENT_KEY_DOWN || e.event.type == SDL_EVENT_KEY_UP ? e.event.key.keysym.scancode : SDL_SCANCODE_UNKNOWN; })
+        .def_property_readonly("repeat", [](const QueuedEvent &e)
+                               { return e.event.type == SDL_EVENT_KEY_DOWN && e.event.key.repeat; })
+        // 0 for events other than mouse buttons
+        .def_property_readonly("button", [](const QueuedEvent &e)
+                               { return e.event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || e.event.type == SDL_EVENT_MOUSE_BUTTON_UP ? static_cast<int>(e.event.button.button) : 0; })
+        // The mouse position of mouse button and motion events, 0 for other events
+        .def_property_readonly("x", [](const QueuedEvent &e)
+                               { return e.event.type == SDL_EVENT_MOUSE_MOTION ? e.event.motion.x : e.event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || e.event.type == SDL_EVENT_MOUSE_BUTTON_UP ? e.event.button.x : 0.0f; })
+        .def_property_readonly("y", [](const QueuedEvent &e)
+                               { return e.event.type == SDL_EVENT_MOUSE_MOTION ? e.event.motion.y : e.event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || e.event.type == SDL_EVENT_MOUSE_BUTTON_UP ? e.event.button.y : 0.0f; })
+        .def_property_readonly("text", [](const QueuedEvent &e)
+                               { return std::string(e.text); });
+
+    py::class_<InputRecording, std::shared_ptr<InputRecording>>(m, "InputRecording")
+        .def(py::init<>())
+        .def("set_state_hash", &InputRecording::SetStateHash, py::arg("hash"))
+        .def("get_state_hash", &InputRecording::GetStateHash, py::arg("frame"))
+        .def("get_delta_time", &InputRecording::GetDeltaTime, py::arg("frame"))
+        .def("get_frame_count", &InputRecording::GetFrameCount)
+        .def("get_byte_size", &InputRecording::GetByteSize)
+        .def("get_position", &InputRecording::GetPosition)
+        .def("is_finished", &InputRecording::IsFinished)
+        .def("clear", &InputRecording::Clear)
+        .def("save", &InputRecording::Save, py::arg("filepath"))
+        .def("load", &InputRecording::Load, py::arg("filepath"));
+
+    py::class_<FrameClock, std::shared_ptr<FrameClock>>(m, "FrameClock")
+        .def_static("get_delta_time", &FrameClock::GetDeltaTime)
+        .def_static("get_ticks", &FrameClock::GetTicks);
+
+    py::class_<InputLatency>(m, "InputLatency")
+        .def_readonly("count", &InputLatency::count)
+        .def_readonly("mean_ms", &InputLatency::meanMs)
+        .def_readonly("max_ms", &InputLatency::maxMs)
+        .def_readonly("last_ms", &InputLatency::lastMs);
+
+    py::class_<EventQueue, std::unique_ptr<EventQueue, py::nodelete>>(m, "EventQueue")
+        .def_static("instance", &EventQueue::Instance, py::return_value_policy::reference)
+        .def("get_frame_events", &EventQueue::GetFrameEvents)
+        .def("get_events_since", &EventQueue::GetEventsSince, py::arg("sequence"))
+        .def("get_sequence", &EventQueue::GetSequence)
+        .def("get_capacity", &EventQueue::GetCapacity)
+        .def("is_quit_requested", &EventQueue::IsQuitRequested)
+        .def("get_latency", &EventQueue::GetLatency)
+        .def("reset_latency", &EventQueue::ResetLatency);
+
     py::class_<TransformComponent, std::shared_ptr<TransformComponent>>(m, "TransformComponent")
         .def(py::init<>())
         .def("get_width", &TransformComponent::GetWidth)
@@ -71,11 +245,15 @@ PYBIND11_MODULE(mygameengine, m)
         .def("get_x", &Collision2DComponent::GetX)
         .def("get_y", &Collision2DComponent::GetY)
         .def("set_x", &Collision2DComponent::SetX)
-        .def("set_y", &Collision2DComponent::SetY);
+        .def("set_y", &Collision2DComponent::SetY)
+        .def("set_trigger", &Collision2DComponent::SetTrigger)
+        .def("is_trigger", &Collision2DComponent::IsTrigger);
 
     py::class_<AnimationComponent, std::shared_ptr<AnimationComponent>>(m, "AnimationComponent")
         .def(py::init<>())
-        .def("get_animation", &AnimationComponent::GetAnimation);
+        .def("get_animation", &AnimationComponent::GetAnimation)
+        .def("get_current_state", &AnimationComponent::GetCurrentState)
+        .def("set_current_state", &AnimationComponent::SetCurrentState, py::arg("state"));
 
     py::class_<SingleAnimation, std::shared_ptr<SingleAnimation>>(m, "Animation")
         .def(py::init<>())
@@ -86,7 +264,10 @@ PYBIND11_MODULE(mygameengine, m)
              py::arg("maxFrame"), py::arg("millisecond_duration"), py::arg("repeat") = true)
         .def("get_width", &SingleAnimation::GetW)
         .def("get_height", &SingleAnimation::GetH)
-        .def("get_duration", &SingleAnimation::GetDuration);
+        .def("get_duration", &SingleAnimation::GetDuration)
+        .def("get_frame", &SingleAnimation::GetFrame)
+        .def("get_frame_time", &SingleAnimation::GetFrameTime)
+        .def("set_frame", &SingleAnimation::SetFrame, py::arg("frame"), py::arg("frame_time"));
 
     py::class_<GameEntity, std::shared_ptr<GameEntity>>(m, "GameEntity")
         .def(py::init<>())
@@ -100,6 +281,8 @@ PYBIND11_MODULE(mygameengine, m)
         .def("get_collision2D", &GameEntity::GetCollision2D)
         .def("get_animations", &GameEntity::GetAnimations)
         .def("is_colliding_with", &GameEntity::isCollidingWith)
+        .def("is_blocked_by", &GameEntity::isBlockedBy)
+        .def("is_blocked_by_at", &GameEntity::isBlockedByAt, py::arg("other"), py::arg("x"), py::arg("y"))
         .def("is_collidable", &GameEntity::isCollidable)
         .def("set_name", &GameEntity::SetName)
         .def("get_name", &GameEntity::GetName)
@@ -108,19 +291,403 @@ PYBIND11_MODULE(mygameengine, m)
         .def("set_flip", &GameEntity::SetFlip)
         .def("get_flip", &GameEntity::GetFlip)
         .def("move_x", &GameEntity::MoveX)
-        .def("move_y", &GameEntity::MoveY);
+        .def("move_y", &GameEntity::MoveY)
+        .def("fit_collision2D_to_animation", &GameEntity::FitCollision2DToAnimation, py::arg("state"));
 
     py::class_<TileMap, std::shared_ptr<TileMap>>(m, "TileMap")
         .def(py::init<int, int, int, int>(),
              py::arg("mapWidth"), py::arg("mapHeight"), py::arg("numOfTileColumn"), py::arg("numOfTileRow"))
-        .def("add_tile_type", &TileMap::AddTileType)
-        .def("place_tile_at", &TileMap::PlaceTileAt)
-        .def("erase_tile_at", &TileMap::EraseTileAt)
+        .def("add_tile_type", [](TileMap &t, std::string tileName, std::string filepath, bool collidable,
+                                 float srcX, float srcY, float srcW, float srcH,
+                                 const std::vector<std::tuple<float, float, float, float>> &frames, Uint32 frameDuration)
+             {
+                 // Frames as plain (x, y, w, h) tuples, SDL_FRect is not exposed to python
+                 std::vector<SDL_FRect> rects;
+                 for (auto &[x, y, w, h] : frames)
+                 {
+                     rects.push_back({x, y, w, h});
+                 }
+                 t.AddTileType(tileName, filepath, collidable, SDL_FRect{srcX, srcY, srcW, srcH}, rects, frameDuration); },
+             py::arg("tile_name"), py::arg("filepath"), py::arg("collidable"),
+             py::arg("src_x") = 0.0f, py::arg("src_y") = 0.0f, py::arg("src_w") = 0.0f, py::arg("src_h") = 0.0f,
+             py::arg("frames") = std::vector<std::tuple<float, float, float, float>>{}, py::arg("frame_duration") = 0)
+        .def("update", &TileMap::Update, py::arg("delta_time"))
+        .def("get_tile_clock", &TileMap::GetTileClock)
+        .def("set_tile_clock", &TileMap::SetTileClock, py::arg("clock"))
+        .def("place_tile_at", &TileMap::PlaceTileAt,
+             py::arg("tile_name"), py::arg("row"), py::arg("column"), py::arg("layer") = 0)
+        .def("erase_tile_at", &TileMap::EraseTileAt, py::arg("row"), py::arg("column"), py::arg("layer") = 0)
         .def("load_to_game", &TileMap::LoadToGame)
+        .def("load_layout", [](TileMap &t, std::shared_ptr<SDLGraphicsProgram> game, py::object layout, int layer)
+             {
+                 // Nested lists are copied once into a flat array of ids
+                 if (py::isinstance<py::list>(layout) || py::isinstance<py::tuple>(layout))
+                 {
+                     std::vector<Uint16> ids;
+                     ids.reserve(static_cast<size_t>(t.GetRowCount()) * t.GetColumnCount());
+                     int rows = 0;
+                     for (auto row : layout)
+                     {
+                         auto cells = row.cast<py::sequence>();
+                         if (static_cast<int>(py::len(cells)) != t.GetColumnCount())
+                         {
+                             SDL_Log("Layout row %d does not have %d columns", rows, t.GetColumnCount());
+                             return false;
+                         }
+                         for (auto cell : cells)
+                         {
+                             ids.push_back(cell.cast<Uint16>());
+                         }
+                         rows++;
+                     }
+                     return t.LoadLayout(game, ids.data(), rows, t.GetColumnCount(), layer);
+                 }
+
+                 // Anything with the buffer protocol (numpy, array.array, memoryview) is read in place,
+                 // as long as it holds C-contiguous uint16 ids
+                 py::buffer_info info = layout.cast<py::buffer>().request();
+                 if (info.format != py::format_descriptor<Uint16>::format() || (info.ndim != 1 && info.ndim != 2))
+                 {
+                     SDL_Log("Layout buffers must hold uint16 tile type ids in 1 or 2 dimensions");
+                     return false;
+                 }
+                 int rows = info.ndim == 2 ? static_cast<int>(info.shape[0]) : t.GetRowCount();
+                 int columns = info.ndim == 2 ? static_cast<int>(info.shape[1]) : t.GetColumnCount();
+                 bool contiguous = info.strides.back() == static_cast<py::ssize_t>(sizeof(Uint16)) &&
+                                   (info.ndim == 1 || info.strides[0] == static_cast<py::ssize_t>(columns * sizeof(Uint16)));
+                 if (!contiguous || static_cast<size_t>(info.size) != static_cast<size_t>(rows) * columns)
+                 {
+                     SDL_Log("Layout buffers must be C-contiguous and match the size of the map");
+                     return false;
+                 }
+                 return t.LoadLayout(game, static_cast<const Uint16 *>(info.ptr), rows, columns, layer); },
+             py::arg("game"), py::arg("layout"), py::arg("layer") = 0)
+        .def("load_level_file", &TileMap::LoadLevelFile, py::arg("game"), py::arg("level_file"))
+        .def("set_tile_ids", [](TileMap &t, const std::vector<std::array<int, 4>> &changes)
+             {
+                 // (row, column, id, layer) tuples
+                 std::vector<TileChange> tileChanges;
+                 tileChanges.reserve(changes.size());
+                 for (const auto &[row, column, id, layer] : changes)
+                 {
+                     if (id < 0 || id > UINT16_MAX || layer < 0 || layer > UINT16_MAX)
+                     {
+                         continue;
+                     }
+                     tileChanges.push_back(TileChange{row, column, static_cast<Uint16>(id), static_cast<Uint16>(layer)});
+                 }
+                 return t.SetTileIds(tileChanges); },
+             py::arg("changes"))
+        .def("get_tile_id", &TileMap::GetTileId, py::arg("row"), py::arg("column"), py::arg("layer") = 0)
+        .def("get_tile_entity", &TileMap::GetTileEntity, py::arg("row"), py::arg("column"))
+        .def("get_row_count", &TileMap::GetRowCount)
+        .def("get_column_count", &TileMap::GetColumnCount)
         .def("has_collision_with", &TileMap::HasCollisionWith)
+        .def("has_collision_at", &TileMap::HasCollisionAt,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"))
+        .def("get_static_collision_rects", [](const TileMap &t)
+             {
+                 // Plain (x, y, w, h) tuples, SDL_FRect is not exposed to python
+                 std::vector<std::tuple<float, float, float, float>> rects;
+                 for (auto &r : t.GetStaticCollisionRects())
+                 {
+                     rects.emplace_back(r.x, r.y, r.w, r.h);
+                 }
+                 return rects; })
+        .def("get_static_collision_rect_count", &TileMap::GetStaticCollisionRectCount)
+        .def("raycast", &TileMap::Raycast,
+             py::arg("x"), py::arg("y"), py::arg("dir_x"), py::arg("dir_y"), py::arg("max_distance"))
+        .def("has_line_of_sight", &TileMap::HasLineOfSight,
+             py::arg("x0"), py::arg("y0"), py::arg("x1"), py::arg("y1"))
+        .def("raycast_batch", &TileMap::RaycastBatch, py::arg("rays"))
+        .def("line_of_sight_batch", &TileMap::LineOfSightBatch, py::arg("segments"))
         .def("get_map_width", &TileMap::GetMapWidth)
         .def("get_map_height", &TileMap::GetMapHeight)
         .def("get_tile_width", &TileMap::GetTileWidth)
         .def("get_tile_height", &TileMap::GetTileHeight)
-        .def("render", &TileMap::Render);
+        .def("add_layer", &TileMap::AddLayer, py::arg("name"), py::arg("parallax_x") = 1.0f, py::arg("parallax_y") = 1.0f,
+             py::arg("collidable") = false, py::arg("foreground") = false)
+        .def("get_layer_count", &TileMap::GetLayerCount)
+        .def("get_layer_index", &TileMap::GetLayerIndex, py::arg("name"))
+        .def("set_layer_visible", &TileMap::SetLayerVisible, py::arg("layer"), py::arg("visible"))
+        .def("set_layer_parallax", &TileMap::SetLayerParallax, py::arg("layer"), py::arg("parallax_x"), py::arg("parallax_y"))
+        .def("set_layer_collidable", &TileMap::SetLayerCollidable, py::arg("layer"), py::arg("collidable"))
+        .def("set_camera", &TileMap::SetCamera, py::arg("x"), py::arg("y"))
+        .def("render", &TileMap::Render)
+        .def("render_background", &TileMap::RenderBackground)
+        .def("render_foreground", &TileMap::RenderForeground);
+
+    py::class_<LevelFileCells>(m, "LevelFileCells", py::buffer_protocol())
+        .def_buffer([](LevelFileCells &c)
+                    {
+                        py::ssize_t rowBytes = c.columns * static_cast<py::ssize_t>(sizeof(Uint16));
+                        return py::buffer_info(const_cast<Uint16 *>(c.cells), sizeof(Uint16), py::format_descriptor<Uint16>::format(), 2,
+                                               {c.rows, c.columns}, {rowBytes, static_cast<py::ssize_t>(sizeof(Uint16))}, true); });
+
+    py::class_<LevelFile, std::shared_ptr<LevelFile>>(m, "LevelFile")
+        .def(py::init<>())
+        .def("open", &LevelFile::Open, py::arg("filepath"))
+        .def("close", &LevelFile::Close)
+        .def("is_open", &LevelFile::IsOpen)
+        .def("get_name", [](const LevelFile &l)
+             { return std::string(l.GetName()); })
+        .def("get_row_count", &LevelFile::GetRowCount)
+        .def("get_column_count", &LevelFile::GetColumnCount)
+        .def("get_layer_count", &LevelFile::GetLayerCount)
+        .def("get_layer", [](const LevelFile &l, int index) -> py::object
+             {
+                 if (index < 0 || index >= l.GetLayerCount())
+                 {
+                     return py::none();
+                 }
+                 // (name, parallax_x, parallax_y, collidable, foreground)
+                 const LevelFileLayer &layer = l.GetLayer(index);
+                 return py::make_tuple(std::string(l.GetString(layer.nameOffset)), layer.parallaxX, layer.parallaxY,
+                                       (layer.flags & LevelFile::LAYER_COLLIDABLE) != 0, (layer.flags & LevelFile::LAYER_FOREGROUND) != 0); },
+             py::arg("index"))
+        .def("get_layer_cells", [](const LevelFile &l, int index) -> py::object
+             {
+                 if (index < 0 || index >= l.GetLayerCount())
+                 {
+                     return py::none();
+                 }
+                 // A read-only rows x columns view of the mapping, no copy; it keeps the mapping alive
+                 return py::memoryview(py::cast(LevelFileCells{l.GetMapping(), l.GetLayerCells(index), l.GetRowCount(), l.GetColumnCount()})); },
+             py::arg("index"))
+        .def("get_spawn_count", &LevelFile::GetSpawnCount)
+        .def("get_spawns", [](const LevelFile &l)
+             {
+                 // (kind, type, number, (x, y, w, h), (collider x, y, w, h)) for each spawn
+                 py::list spawns;
+                 for (int i = 0; i < l.GetSpawnCount(); i++)
+                 {
+                     const LevelFileSpawn &spawn = l.GetSpawn(i);
+                     spawns.append(py::make_tuple(std::string(l.GetString(spawn.kindOffset)), std::string(l.GetString(spawn.typeOffset)), spawn.number,
+                                                  py::make_tuple(spawn.transform[0], spawn.transform[1], spawn.transform[2], spawn.transform[3]),
+                                                  py::make_tuple(spawn.collider[0], spawn.collider[1], spawn.collider[2], spawn.collider[3])));
+                 }
+                 return spawns; })
+        .def("get_journal_sequence", &LevelFile::GetJournalSequence)
+        .def("get_byte_size", &LevelFile::GetByteSize);
+
+    py::enum_<EditOp>(m, "EditOp")
+        .value("PLACE_TILE", EditOp::PlaceTile)
+        .value("ERASE_TILE", EditOp::EraseTile)
+        .value("MOVE_PLAYER", EditOp::MovePlayer)
+        .value("MOVE_DESTINATION", EditOp::MoveDestination)
+        .value("ADD_ENEMY", EditOp::AddEnemy)
+        .value("REMOVE_ENEMY", EditOp::RemoveEnemy)
+        .value("COMMIT", EditOp::Commit)
+        .value("DISCARD", EditOp::Discard);
+
+    py::class_<EditRecord>(m, "EditRecord")
+        .def(py::init([](EditOp op, int row, int column, int value, int layer, std::array<float, 4> transform,
+                         std::array<float, 4> collider, std::string type)
+                      {
+                          EditRecord record;
+                          record.op = op;
+                          record.row = row;
+                          record.column = column;
+                          record.value = value;
+                          record.layer = static_cast<Uint16>(layer);
+                          std::copy(transform.begin(), transform.end(), record.transform);
+                          std::copy(collider.begin(), collider.end(), record.collider);
+                          // Longer names are cut, the last byte stays 0
+                          std::strncpy(record.type, type.c_str(), sizeof(record.type) - 1);
+                          return record; }),
+             py::arg("op"), py::arg("row") = 0, py::arg("column") = 0, py::arg("value") = 0, py::arg("layer") = 0,
+             py::arg("transform") = std::array<float, 4>{}, py::arg("collider") = std::array<float, 4>{}, py::arg("type") = "")
+        .def_readonly("sequence", &EditRecord::sequence)
+        .def_readonly("op", &EditRecord::op)
+        .def_readonly("row", &EditRecord::row)
+        .def_readonly("column", &EditRecord::column)
+        .def_readonly("value", &EditRecord::value)
+        .def_readonly("layer", &EditRecord::layer)
+        .def_property_readonly("transform", [](const EditRecord &r)
+                               { return std::make_tuple(r.transform[0], r.transform[1], r.transform[2], r.transform[3]); })
+        .def_property_readonly("collider", [](const EditRecord &r)
+                               { return std::make_tuple(r.collider[0], r.collider[1], r.collider[2], r.collider[3]); })
+        .def_property_readonly("type", [](const EditRecord &r)
+                               { return std::string(r.type, strnlen(r.type, sizeof(r.type))); });
+
+    py::class_<EditJournal, std::shared_ptr<EditJournal>>(m, "EditJournal")
+        .def(py::init<>())
+        .def("open", &EditJournal::Open, py::arg("filepath"), py::arg("min_sequence") = 0)
+        .def("close", &EditJournal::Close)
+        .def("is_open", &EditJournal::IsOpen)
+        .def("get_records", &EditJournal::GetRecords)
+        .def("append", &EditJournal::Append, py::arg("record"))
+        .def("flush", &EditJournal::Flush)
+        .def("drop_through", &EditJournal::DropThrough, py::arg("sequence"))
+        .def("get_last_sequence", &EditJournal::GetLastSequence)
+        .def("get_record_count", &EditJournal::GetRecordCount)
+        .def("get_written_count", &EditJournal::GetWrittenCount)
+        .def("get_sync_count", &EditJournal::GetSyncCount);
+
+    py::class_<EditHistory, std::shared_ptr<EditHistory>>(m, "EditHistory")
+        .def(py::init<>())
+        .def("record_tile", &EditHistory::RecordTile, py::arg("layer"), py::arg("row"), py::arg("column"),
+             py::arg("before"), py::arg("after"))
+        .def("record_entity", &EditHistory::RecordEntity, py::arg("entity"), py::arg("before"), py::arg("after"))
+        .def("end_step", &EditHistory::EndStep)
+        .def("undo", &EditHistory::Undo, py::arg("tilemap"))
+        .def("redo", &EditHistory::Redo, py::arg("tilemap"))
+        .def("clear", &EditHistory::Clear)
+        .def("get_undo_count", &EditHistory::GetUndoCount)
+        .def("get_redo_count", &EditHistory::GetRedoCount)
+        .def("get_coalesced_count", &EditHistory::GetCoalescedCount)
+        .def("set_memory_budget", &EditHistory::SetMemoryBudget, py::arg("bytes"))
+        .def("get_byte_size", &EditHistory::GetByteSize);
+
+    py::class_<LevelSnapshot, std::shared_ptr<LevelSnapshot>>(m, "LevelSnapshot")
+        .def(py::init<>())
+        .def("capture", &LevelSnapshot::Capture, py::arg("tilemap"), py::arg("entities"),
+             py::arg("values") = std::vector<std::vector<float>>{})
+        .def("restore", &LevelSnapshot::Restore, py::arg("tilemap"), py::arg("entities"))
+        .def("is_empty", &LevelSnapshot::IsEmpty)
+        .def("get_entity_count", &LevelSnapshot::GetEntityCount)
+        .def("get_values", &LevelSnapshot::GetValues, py::arg("entity"))
+        .def("to_bytes", [](const LevelSnapshot &s)
+             {
+                 const std::vector<Uint8> &buffer = s.GetBuffer();
+                 return py::bytes(reinterpret_cast<const char *>(buffer.data()), buffer.size()); })
+        .def("from_bytes", [](LevelSnapshot &s, py::bytes data)
+             {
+                 std::string bytes = data;
+                 return s.SetBuffer(std::vector<Uint8>(bytes.begin(), bytes.end())); },
+             py::arg("data"))
+        .def("get_byte_size", &LevelSnapshot::GetByteSize)
+        .def("get_hash", &LevelSnapshot::GetHash);
+
+    py::class_<ChunkedTileMap, std::shared_ptr<ChunkedTileMap>>(m, "ChunkedTileMap")
+        .def(py::init<std::string, int, int, int, int>(),
+             py::arg("directory"), py::arg("tile_width"), py::arg("tile_height"),
+             py::arg("chunk_size") = 64, py::arg("load_radius") = 2)
+        .def("add_tile_type", [](ChunkedTileMap &t, std::string tileName, std::string filepath, bool collidable,
+                                 float srcX, float srcY, float srcW, float srcH,
+                                 const std::vector<std::tuple<float, float, float, float>> &frames, Uint32 frameDuration)
+             {
+                 // Frames as plain (x, y, w, h) tuples, as for TileMap
+                 std::vector<SDL_FRect> rects;
+                 for (auto &[x, y, w, h] : frames)
+                 {
+                     rects.push_back({x, y, w, h});
+                 }
+                 t.AddTileType(tileName, filepath, collidable, SDL_FRect{srcX, srcY, srcW, srcH}, rects, frameDuration); },
+             py::arg("tile_name"), py::arg("filepath"), py::arg("collidable"),
+             py::arg("src_x") = 0.0f, py::arg("src_y") = 0.0f, py::arg("src_w") = 0.0f, py::arg("src_h") = 0.0f,
+             py::arg("frames") = std::vector<std::tuple<float, float, float, float>>{}, py::arg("frame_duration") = 0)
+        .def("add_layer", &ChunkedTileMap::AddLayer, py::arg("name"), py::arg("collidable") = false, py::arg("foreground") = false)
+        .def("get_layer_count", &ChunkedTileMap::GetLayerCount)
+        .def("update", &ChunkedTileMap::Update, py::arg("focus_x"), py::arg("focus_y"), py::arg("delta_time") = 0.0f)
+        .def("wait_for_chunks", &ChunkedTileMap::WaitForChunks)
+        .def("save_all", &ChunkedTileMap::SaveAll)
+        .def("store_chunk", [](ChunkedTileMap &t, int chunkX, int chunkY, const std::vector<std::vector<Uint16>> &layout)
+             {
+                 // One list of ids per row of the chunk, the rows of every layer one layer after the other
+                 std::vector<Uint16> ids;
+                 for (auto &row : layout)
+                 {
+                     if (static_cast<int>(row.size()) != t.GetChunkSize())
+                     {
+                         SDL_Log("Chunk rows must have %d columns", t.GetChunkSize());
+                         return false;
+                     }
+                     ids.insert(ids.end(), row.begin(), row.end());
+                 }
+                 if (static_cast<int>(layout.size()) != t.GetChunkSize() * t.GetLayerCount())
+                 {
+                     SDL_Log("Chunks must have %d rows per layer", t.GetChunkSize());
+                     return false;
+                 }
+                 return t.StoreChunk(chunkX, chunkY, ids.data()); },
+             py::arg("chunk_x"), py::arg("chunk_y"), py::arg("layout"))
+        .def("place_tile_at", &ChunkedTileMap::PlaceTileAt,
+             py::arg("tile_name"), py::arg("row"), py::arg("column"), py::arg("layer") = 0)
+        .def("erase_tile_at", &ChunkedTileMap::EraseTileAt, py::arg("row"), py::arg("column"), py::arg("layer") = 0)
+        .def("get_tile_id", &ChunkedTileMap::GetTileId, py::arg("row"), py::arg("column"), py::arg("layer") = 0)
+        .def("has_collision_with", &ChunkedTileMap::HasCollisionWith)
+        .def("has_collision_at", &ChunkedTileMap::HasCollisionAt,
+             py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"))
+        .def("raycast", &ChunkedTileMap::Raycast,
+             py::arg("x"), py::arg("y"), py::arg("dir_x"), py::arg("dir_y"), py::arg("max_distance"))
+        .def("has_line_of_sight", &ChunkedTileMap::HasLineOfSight,
+             py::arg("x0"), py::arg("y0"), py::arg("x1"), py::arg("y1"))
+        .def("is_chunk_loaded", &ChunkedTileMap::IsChunkLoaded, py::arg("chunk_x"), py::arg("chunk_y"))
+        .def("get_loaded_chunk_count", &ChunkedTileMap::GetLoadedChunkCount)
+        .def("get_pending_chunk_count", &ChunkedTileMap::GetPendingChunkCount)
+        .def("get_loaded_byte_size", &ChunkedTileMap::GetLoadedByteSize)
+        .def("get_chunk_size", &ChunkedTileMap::GetChunkSize)
+        .def("get_tile_width", &ChunkedTileMap::GetTileWidth)
+        .def("get_tile_height", &ChunkedTileMap::GetTileHeight)
+        .def("set_camera", &ChunkedTileMap::SetCamera, py::arg("x"), py::arg("y"))
+        .def("render", &ChunkedTileMap::Render)
+        .def("render_background", &ChunkedTileMap::RenderBackground)
+        .def("render_foreground", &ChunkedTileMap::RenderForeground);
+
+    py::class_<RaycastHit>(m, "RaycastHit")
+        .def_readonly("hit", &RaycastHit::hit)
+        .def_readonly("row", &RaycastHit::row)
+        .def_readonly("column", &RaycastHit::column)
+        .def_readonly("distance", &RaycastHit::distance)
+        .def_readonly("x", &RaycastHit::x)
+        .def_readonly("y", &RaycastHit::y);
+
+    py::enum_<CollisionEventType>(m, "CollisionEventType")
+        .value("ENTER", CollisionEventType::Enter)
+        .value("STAY", CollisionEventType::Stay)
+        .value("EXIT", CollisionEventType::Exit);
+
+    py::class_<CollisionEvent>(m, "CollisionEvent")
+        .def_readonly("type", &CollisionEvent::type)
+        .def_readonly("a", &CollisionEvent::a)
+        .def_readonly("b", &CollisionEvent::b);
+
+    py::enum_<BroadphaseType>(m, "BroadphaseType")
+        .value("LINEAR_SCAN", BroadphaseType::LinearScan)
+        .value("DYNAMIC_TREE", BroadphaseType::DynamicTree);
+
+    py::class_<CollisionWorld, std::shared_ptr<CollisionWorld>>(m, "CollisionWorld")
+        .def(py::init<BroadphaseType>(), py::arg("broadphase") = BroadphaseType::LinearScan)
+        .def("add_entity", &CollisionWorld::AddEntity)
+        .def("remove_entity", &CollisionWorld::RemoveEntity)
+        .def("clear", &CollisionWorld::Clear)
+        .def("step", &CollisionWorld::Step)
+        .def("drain_events", &CollisionWorld::DrainEvents)
+        .def("has_contact", &CollisionWorld::HasContact)
+        .def("get_contact_count", &CollisionWorld::GetContactCount)
+        .def("set_contact_margin", &CollisionWorld::SetContactMargin, py::arg("margin"))
+        .def("get_contact_margin", &CollisionWorld::GetContactMargin)
+        .def("set_tilemap", &CollisionWorld::SetTileMap)
+        .def("is_blocked_at", &CollisionWorld::IsBlockedAt, py::arg("entity"), py::arg("x"), py::arg("y"))
+        .def("query_region", &CollisionWorld::QueryRegion, py::arg("x"), py::arg("y"), py::arg("w"), py::arg("h"))
+        .def("query_point", &CollisionWorld::QueryPoint, py::arg("x"), py::arg("y"))
+        .def("get_broadphase", &CollisionWorld::GetBroadphase)
+        .def("get_entity_count", &CollisionWorld::GetEntityCount);
+
+    // The singleton is owned by C++, Python only borrows it
+    py::class_<ResourceManager, std::unique_ptr<ResourceManager, py::nodelete>>(m, "ResourceManager")
+        .def_static("instance", &ResourceManager::Instance, py::return_value_policy::reference)
+        .def("mount_archive", &ResourceManager::MountArchive, py::arg("filepath"))
+        .def("enable_hot_reload", &ResourceManager::EnableHotReload, py::arg("debounce_ms") = 100)
+        .def("disable_hot_reload", &ResourceManager::DisableHotReload)
+        .def("is_hot_reload_enabled", &ResourceManager::IsHotReloadEnabled)
+        .def("get_reload_count", &ResourceManager::GetReloadCount)
+        .def("set_premultiplied_alpha", &ResourceManager::SetPremultipliedAlpha, py::arg("premultiplied"))
+        .def("set_memory_budget", &ResourceManager::SetMemoryBudget, py::arg("bytes"))
+        .def("get_memory_budget", &ResourceManager::GetMemoryBudget)
+        .def("get_memory_usage", &ResourceManager::GetMemoryUsage)
+        .def("get_resident_count", &ResourceManager::GetResidentCount)
+        .def("get_eviction_count", &ResourceManager::GetEvictionCount)
+        .def("get_pending_upload_count", &ResourceManager::GetPendingUploadCount)
+        .def("finish_loads", [](ResourceManager &r, std::shared_ptr<SDLGraphicsProgram> game)
+             { return r.FinishLoads(game->getSDLRenderer()); },
+             py::arg("game"))
+        .def("evict_unused", &ResourceManager::EvictUnused)
+        .def("begin_level_scope", &ResourceManager::BeginLevelScope, py::arg("level_id"))
+        .def("end_level_scope", &ResourceManager::EndLevelScope)
+        .def("prefetch_level", &ResourceManager::PrefetchLevel, py::arg("level_id"), py::arg("filepaths"))
+        .def("is_level_resident", &ResourceManager::IsLevelResident, py::arg("level_id"))
+        .def("promote_level", &ResourceManager::PromoteLevel, py::arg("level_id"))
+        .def("release_level", &ResourceManager::ReleaseLevel, py::arg("level_id"));
 }
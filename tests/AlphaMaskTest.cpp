@@ -0,0 +1,102 @@
+// Builds AlphaMasks from sprites whose background is transparent white, as the engine decodes them, and checks
+// the opaque bounds: first on pixels made here, then on the hyena run sheet with the frames of config.json,
+// down to the collider GameEntity::FitCollision2DToAnimation fits to them.
+// Usage: ./bin/AlphaMaskTest [sprite]   (defaults to ./assets/Hyena_run.bmp)
+
+#include <SDL3/SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AlphaMask.hpp"
+#include "GameEntity.hpp"
+#include "PixelOps.hpp"
+#include "ResourceManager.hpp"
+#include "SDLGraphicsProgram.hpp"
+#include "SingleAnimation.hpp"
+#include "TestCheck.hpp"
+
+static bool SameRect(const SDL_Rect &a, const SDL_Rect &b)
+{
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static void CheckMadePixels()
+{
+    // Transparent white everywhere, but an opaque block and a pixel at partial alpha
+    const int width = 40;
+    const int height = 8;
+    std::vector<Uint32> pixels(width * height, 0x00FFFFFF);
+    for (int y = 2; y < 5; y++)
+    {
+        for (int x = 35; x < 38; x++)
+        {
+            pixels[y * width + x] = 0xFF804020;
+        }
+    }
+    pixels[6 * width + 36] = 0x40FFFFFF;
+    ColorKeyToAlpha(pixels.data(), width, height, width * 4, 0x000000);
+
+    AlphaMask mask;
+    mask.Build(pixels.data(), width, height, width * 4);
+    CHECK(SameRect(mask.GetOpaqueBounds(SDL_Rect{0, 0, width, height}), SDL_Rect{35, 2, 3, 5}));
+    CHECK(SameRect(mask.GetOpaqueBounds(SDL_Rect{32, 0, 8, 5}), SDL_Rect{35, 2, 3, 3}));
+    CHECK(mask.GetOpaqueBounds(SDL_Rect{0, 0, 32, height}).w == 0);
+}
+
+static void CheckHyena(const std::string &sprite)
+{
+    SDL_Surface *loaded = SDL_LoadBMP(sprite.c_str());
+    CHECK(nullptr != loaded);
+    if (nullptr == loaded)
+    {
+        return;
+    }
+    SDL_Surface *pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+    SDL_DestroySurface(loaded);
+    ColorKeyToAlpha(static_cast<Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch, 0x000000);
+    AlphaMask mask;
+    mask.Build(static_cast<const Uint32 *>(pixels->pixels), pixels->w, pixels->h, pixels->pitch);
+    SDL_DestroySurface(pixels);
+
+    // The run frames of config.json: 45x29 from (3, 19), 3 pixels apart. None of them fills its frame
+    const SDL_Rect expected[] = {{5, 22, 41, 26}, {51, 22, 44, 26}, {99, 22, 45, 26},
+                                 {148, 22, 44, 26}, {196, 21, 44, 26}, {244, 21, 43, 27}};
+    for (int frame = 0; frame < 6; frame++)
+    {
+        SDL_Rect cell{3 + 48 * frame, 19, 45, 29};
+        CHECK(SameRect(mask.GetOpaqueBounds(cell), expected[frame]));
+    }
+
+    // The same frames through the engine: the union of their bounds is 45x27, 2 pixels below the top of the frame
+    auto game = std::make_shared<SDLGraphicsProgram>(64, 64, "AlphaMaskTest");
+    auto entity = std::make_shared<GameEntity>();
+    entity->AddTransform(100.0f, 200.0f, 90.0f, 58.0f);
+    entity->AddCollision2D(100.0f, 200.0f, 90.0f, 58.0f);
+    auto animation = std::make_shared<SingleAnimation>();
+    animation->CreateAnimation(game, sprite);
+    animation->SetFrameConfig(3, 19, 45, 3, 29, 6, 150, true);
+    entity->AddAnimation("run", animation);
+    bool fitted = false;
+    for (int i = 0; i < 1000 && !fitted; i++)
+    {
+        ResourceManager::Instance().ProcessUploads(game->getSDLRenderer(), 1000000);
+        fitted = entity->FitCollision2DToAnimation("run");
+        SDL_Delay(1);
+    }
+    CHECK(fitted);
+    auto collider = entity->GetCollision2D();
+    // The transform is twice the size of the frame
+    CHECK(collider->GetX() == 100.0f && collider->GetY() == 204.0f);
+    CHECK(collider->GetWidth() == 90.0f && collider->GetHeight() == 54.0f);
+}
+
+int main(int argc, char **argv)
+{
+    std::string sprite = argc > 1 ? argv[1] : "./assets/Hyena_run.bmp";
+
+    CheckMadePixels();
+    CheckHyena(sprite);
+    ResourceManager::Destroy();
+    return TestResult("AlphaMaskTest");
+}
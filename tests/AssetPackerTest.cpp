@@ -0,0 +1,65 @@
+// Packs a 32bpp sprite whose background is transparent white with the AssetPacker, then reads it back from the archive:
+// the pixels transparent in the sprite must stay transparent, and every pixel but the color key must keep its color
+// and its alpha.
+// Usage: ./bin/AssetPackerTest [packer] [sprite]   (defaults to ./bin/AssetPacker, ./assets/Hyena_run.bmp)
+
+#include <SDL3/SDL.h>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include "AssetArchive.hpp"
+#include "TestCheck.hpp"
+
+int main(int argc, char **argv)
+{
+    std::string packer = argc > 1 ? argv[1] : "./bin/AssetPacker";
+    std::string sprite = argc > 2 ? argv[2] : "./assets/Hyena_run.bmp";
+    std::string archivePath = (std::filesystem::temp_directory_path() / "AssetPackerTest.pak").string();
+
+    SDL_Surface *loaded = SDL_LoadBMP(sprite.c_str());
+    CHECK(nullptr != loaded);
+    if (nullptr == loaded)
+    {
+        return TestResult("AssetPackerTest");
+    }
+    SDL_Surface *source = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+    SDL_DestroySurface(loaded);
+
+    std::string command = packer + " " + archivePath + " " + sprite + " > /dev/null";
+    CHECK(std::system(command.c_str()) == 0);
+
+    AssetArchive archive;
+    CHECK(archive.Open(archivePath));
+    const AssetArchiveEntry *entry = archive.IsOpen() ? archive.Find(sprite) : nullptr;
+    CHECK(nullptr != entry);
+    if (nullptr != entry)
+    {
+        CHECK(static_cast<int>(entry->width) == source->w && static_cast<int>(entry->height) == source->h);
+        int transparent = 0;
+        int keptTransparent = 0;
+        int changed = 0;
+        for (int y = 0; y < source->h; y++)
+        {
+            const Uint32 *sourceRow = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(source->pixels) + static_cast<size_t>(y) * source->pitch);
+            const Uint32 *packedRow = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(archive.GetPixels(*entry)) + static_cast<size_t>(y) * entry->pitch);
+            for (int x = 0; x < source->w; x++)
+            {
+                // The color key of the engine is black
+                Uint32 expected = (sourceRow[x] & 0x00FFFFFF) == 0 ? 0 : sourceRow[x];
+                transparent += (sourceRow[x] >> 24) == 0;
+                keptTransparent += (sourceRow[x] >> 24) == 0 && (packedRow[x] >> 24) == 0;
+                changed += packedRow[x] != expected;
+            }
+        }
+        // The sprite must have a transparent background for the test to mean anything
+        CHECK(transparent > 0);
+        CHECK(keptTransparent == transparent);
+        CHECK(changed == 0);
+    }
+
+    archive.Close();
+    SDL_DestroySurface(source);
+    std::filesystem::remove(archivePath);
+    return TestResult("AssetPackerTest");
+}
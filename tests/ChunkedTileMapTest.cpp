@@ -0,0 +1,148 @@
+// Stores a 3x3 chunk world around the origin with ChunkedTileMap, streams it back and checks it against a single TileMap
+// holding the same cells: tile ids, collision rectangles and raycasts must agree across the chunk borders, negative
+// coordinates included. Then edits a chunk, walks away until it is unloaded and back, and checks the edit was kept.
+// Usage: ./bin/ChunkedTileMapTest
+
+#include <SDL3/SDL.h>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ChunkedTileMap.hpp"
+#include "TestCheck.hpp"
+#include "TileMap.hpp"
+
+static const int chunkSize = 8;
+static const int tileSize = 10;
+static const int worldChunks = 3;
+static const int worldCells = worldChunks * chunkSize;
+/**
+ * The world spans chunks -1 to 1, the single TileMap starts at its top left corner.
+ */
+static const float worldOrigin = -chunkSize * tileSize;
+
+static void AddTileTypes(ChunkedTileMap &tilemap)
+{
+    tilemap.AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    tilemap.AddTileType("sea", "./assets/Map_tile_sea.bmp", false);
+    tilemap.AddLayer("decor", false, true);
+}
+
+int main()
+{
+    std::string directory = (std::filesystem::temp_directory_path() / "ChunkedTileMapTest").string();
+    std::filesystem::remove_all(directory);
+
+    // One rock in four on the terrain, one sea tile in three on the decor
+    std::mt19937 rng(7);
+    std::vector<Uint16> terrain(worldCells * worldCells);
+    std::vector<Uint16> decor(worldCells * worldCells);
+    for (size_t i = 0; i < terrain.size(); i++)
+    {
+        terrain[i] = rng() % 4 == 0 ? 1 : 0;
+        decor[i] = rng() % 3 == 0 ? 2 : 0;
+    }
+
+    TileMap single(worldCells * tileSize, worldCells * tileSize, worldCells, worldCells);
+    single.AddTileType("rock", "./assets/Map_tile_rock.bmp", true);
+    single.AddTileType("sea", "./assets/Map_tile_sea.bmp", false);
+    single.AddLayer("decor", 1.0f, 1.0f, false, true);
+    {
+        ChunkedTileMap writer(directory, tileSize, tileSize, chunkSize, 1);
+        AddTileTypes(writer);
+        single.SetLayerCells(terrain.data(), 0);
+        single.SetLayerCells(decor.data(), 1);
+        for (int chunkY = 0; chunkY < worldChunks; chunkY++)
+        {
+            for (int chunkX = 0; chunkX < worldChunks; chunkX++)
+            {
+                std::vector<Uint16> ids;
+                for (const auto *layer : {&terrain, &decor})
+                {
+                    for (int row = 0; row < chunkSize; row++)
+                    {
+                        auto start = layer->begin() + (chunkY * chunkSize + row) * worldCells + chunkX * chunkSize;
+                        ids.insert(ids.end(), start, start + chunkSize);
+                    }
+                }
+                CHECK(writer.StoreChunk(chunkX - 1, chunkY - 1, ids.data()));
+            }
+        }
+    }
+
+    ChunkedTileMap chunked(directory, tileSize, tileSize, chunkSize, 1);
+    AddTileTypes(chunked);
+    chunked.Update(1.0f, 1.0f);
+    chunked.WaitForChunks();
+    CHECK(chunked.GetLoadedChunkCount() == 9);
+    CHECK(chunked.GetPendingChunkCount() == 0);
+    CHECK(chunked.IsChunkLoaded(-1, -1) && chunked.IsChunkLoaded(1, 1) && !chunked.IsChunkLoaded(2, 0));
+
+    for (int row = 0; row < worldCells; row++)
+    {
+        for (int column = 0; column < worldCells; column++)
+        {
+            CHECK(chunked.GetTileId(row - chunkSize, column - chunkSize) == single.GetTileId(row, column));
+            CHECK(chunked.GetTileId(row - chunkSize, column - chunkSize, 1) == single.GetTileId(row, column, 1));
+        }
+    }
+
+    // Rectangles and rays anywhere in the world, many of them across chunk borders
+    std::uniform_real_distribution<float> position(0.0f, worldCells * tileSize - 0.01f);
+    std::uniform_real_distribution<float> size(0.5f, 3.0f * tileSize);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    int collisionsAgreed = 0;
+    int raysAgreed = 0;
+    int raysHit = 0;
+    int sightsAgreed = 0;
+    const int queries = 2000;
+    for (int i = 0; i < queries; i++)
+    {
+        float x = position(rng);
+        float y = position(rng);
+        float w = size(rng);
+        float h = size(rng);
+        collisionsAgreed += chunked.HasCollisionAt(worldOrigin + x, worldOrigin + y, w, h) == single.HasCollisionAt(x, y, w, h);
+
+        float a = angle(rng);
+        float distance = size(rng) * 4.0f;
+        RaycastHit expected = single.Raycast(x, y, std::cos(a), std::sin(a), distance);
+        RaycastHit hit = chunked.Raycast(worldOrigin + x, worldOrigin + y, std::cos(a), std::sin(a), distance);
+        raysHit += expected.hit;
+        raysAgreed += hit.hit == expected.hit && std::abs(hit.distance - expected.distance) < 0.01f &&
+                      (!hit.hit || (hit.row == expected.row - chunkSize && hit.column == expected.column - chunkSize));
+
+        float x1 = position(rng);
+        float y1 = position(rng);
+        sightsAgreed += chunked.HasLineOfSight(worldOrigin + x, worldOrigin + y, worldOrigin + x1, worldOrigin + y1) ==
+                        single.HasLineOfSight(x, y, x1, y1);
+    }
+    CHECK(collisionsAgreed == queries);
+    CHECK(raysAgreed == queries);
+    // Some of the rays must hit and some must not for the test to mean anything
+    CHECK(raysHit > 0 && raysHit < queries);
+    CHECK(sightsAgreed == queries);
+
+    // A ray leaving the loaded chunks stops at the first one that is not loaded
+    RaycastHit outside = chunked.Raycast(worldOrigin + 1.0f, worldOrigin - 1.0f, 0.0f, -1.0f, 100.0f);
+    CHECK(!outside.hit && outside.distance == 0.0f);
+
+    // An edit in a chunk survives the chunk being unloaded and read again
+    Uint16 before = chunked.GetTileId(-3, 5);
+    CHECK(chunked.PlaceTileAt(before == 1 ? "sea" : "rock", -3, 5));
+    Uint16 after = chunked.GetTileId(-3, 5);
+    CHECK(after != before);
+    CHECK(!chunked.PlaceTileAt("rock", 40, 40));
+    chunked.Update(10.0f * chunkSize * tileSize, 10.0f * chunkSize * tileSize);
+    CHECK(!chunked.IsChunkLoaded(0, -1));
+    chunked.Update(1.0f, 1.0f);
+    chunked.WaitForChunks();
+    CHECK(chunked.IsChunkLoaded(0, -1));
+    CHECK(chunked.GetTileId(-3, 5) == after);
+    CHECK(chunked.GetLoadedByteSize() >= 9 * 2 * chunkSize * chunkSize * sizeof(Uint16));
+
+    std::filesystem::remove_all(directory);
+    return TestResult("ChunkedTileMapTest");
+}
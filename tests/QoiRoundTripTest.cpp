@@ -0,0 +1,103 @@
+// Round trips images through the QOI path the engine uses: the color key pass then QoiEncode and QoiDecode on pixels
+// made here, and the QoiConverter tool on a copy of a sprite whose background is transparent white.
+// Pixels at alpha 0 that are not the color key must come back at alpha 0, every pixel but the key unchanged.
+// Usage: ./bin/QoiRoundTripTest [converter] [sprite]   (defaults to ./bin/QoiConverter, ./assets/Level_destination.bmp)
+
+#include <SDL3/SDL.h>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "PixelOps.hpp"
+#include "QoiCodec.hpp"
+#include "TestCheck.hpp"
+
+/**
+ * The pixel the engine expects after the color key pass, the key being black.
+ */
+static Uint32 Keyed(Uint32 color)
+{
+    return (color & 0x00FFFFFF) == 0 ? 0 : color;
+}
+
+static void CheckEncodedPixels()
+{
+    // Transparent white, the key, partial alpha, opaque, and a transparent pixel of another color
+    const int width = 5;
+    const int height = 2;
+    std::vector<Uint32> source = {0x00FFFFFF, 0xFF000000, 0x80FF0000, 0xFF123456, 0x00123456,
+                                  0x00FFFFFF, 0x00FFFFFF, 0x00000000, 0x7F00FF00, 0xFFFFFFFF};
+    std::vector<Uint32> keyed = source;
+    ColorKeyToAlpha(keyed.data(), width, height, width * 4, 0x000000);
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        CHECK(keyed[i] == Keyed(source[i]));
+    }
+
+    std::vector<Uint8> encoded;
+    CHECK(QoiEncode(keyed.data(), width, height, width * 4, encoded));
+    int decodedWidth = 0;
+    int decodedHeight = 0;
+    CHECK(QoiReadHeader(encoded.data(), encoded.size(), &decodedWidth, &decodedHeight));
+    CHECK(decodedWidth == width && decodedHeight == height);
+    std::vector<Uint32> decoded(keyed.size());
+    CHECK(QoiDecode(encoded.data(), encoded.size(), decoded.data(), width * 4));
+    CHECK(decoded == keyed);
+    CHECK(decoded[0] >> 24 == 0);
+    CHECK(decoded[4] >> 24 == 0);
+}
+
+static void CheckConvertedSprite(const std::string &converter, const std::string &sprite)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "QoiRoundTripTest";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path copy = directory / std::filesystem::path(sprite).filename();
+    std::filesystem::copy_file(sprite, copy, std::filesystem::copy_options::overwrite_existing);
+
+    std::string command = converter + " " + copy.string() + " > /dev/null";
+    CHECK(std::system(command.c_str()) == 0);
+
+    SDL_Surface *loaded = SDL_LoadBMP(sprite.c_str());
+    CHECK(nullptr != loaded);
+    SDL_Surface *source = nullptr != loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888) : nullptr;
+    SDL_DestroySurface(loaded);
+    SDL_Surface *decoded = QoiLoadSurface(std::filesystem::path(copy).replace_extension(".qoi").string());
+    CHECK(nullptr != decoded);
+    if (nullptr != source && nullptr != decoded)
+    {
+        CHECK(decoded->w == source->w && decoded->h == source->h);
+        int transparent = 0;
+        int keptTransparent = 0;
+        int changed = 0;
+        for (int y = 0; y < source->h && decoded->w == source->w && decoded->h == source->h; y++)
+        {
+            const Uint32 *sourceRow = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(source->pixels) + static_cast<size_t>(y) * source->pitch);
+            const Uint32 *decodedRow = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(decoded->pixels) + static_cast<size_t>(y) * decoded->pitch);
+            for (int x = 0; x < source->w; x++)
+            {
+                bool clear = (sourceRow[x] >> 24) == 0 && (sourceRow[x] & 0x00FFFFFF) != 0;
+                transparent += clear;
+                keptTransparent += clear && (decodedRow[x] >> 24) == 0;
+                changed += decodedRow[x] != Keyed(sourceRow[x]);
+            }
+        }
+        // The sprite must have transparent pixels that are not the key for the test to mean anything
+        CHECK(transparent > 0);
+        CHECK(keptTransparent == transparent);
+        CHECK(changed == 0);
+    }
+    SDL_DestroySurface(source);
+    SDL_DestroySurface(decoded);
+    std::filesystem::remove_all(directory);
+}
+
+int main(int argc, char **argv)
+{
+    std::string converter = argc > 1 ? argv[1] : "./bin/QoiConverter";
+    std::string sprite = argc > 2 ? argv[2] : "./assets/Level_destination.bmp";
+
+    CheckEncodedPixels();
+    CheckConvertedSprite(converter, sprite);
+    return TestResult("QoiRoundTripTest");
+}
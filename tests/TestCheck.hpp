@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * The number of failed checks of the test, its exit code is 1 as soon as one fails.
+ */
+static int testFailures = 0;
+
+/**
+ * Check a condition, printing it with its line when it does not hold. The test goes on after a failure.
+ */
+#define CHECK(condition)                                                                      \
+    do                                                                                        \
+    {                                                                                         \
+        if (!(condition))                                                                     \
+        {                                                                                     \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);          \
+            testFailures++;                                                                   \
+        }                                                                                     \
+    } while (false)
+
+/**
+ * Print the outcome of the test.
+ * @param name The name of the test.
+ * @return The exit code of the test, 0 if every check passed.
+ */
+static int TestResult(const char *name)
+{
+    std::printf("%s: %s\n", name, testFailures == 0 ? "passed" : "FAILED");
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+# Builds the tools and the tests, then runs every test from the repository root.
+# Each file in this directory is a test of its own, linked against the engine like the benchmarks, see buildexecutables.py.
+# A test prints its failed checks and exits with 1 if any failed.
+# Usage (from the repository root): python3 tests/runtests.py
+
+
+import glob
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+from buildexecutables import OUTPUT_DIR, build_executables
+
+# Some tests run the tools
+build_executables("./tools")
+build_executables("./tests")
+
+failed = []
+for source in sorted(glob.glob("./tests/*.cpp")):
+    name = os.path.splitext(os.path.basename(source))[0]
+    if(subprocess.run([os.path.join(OUTPUT_DIR, name)]).returncode != 0):
+        failed.append(name)
+
+if(len(failed) > 0):
+    sys.exit("Failed: " + ", ".join(failed))
+print("Every test passed")
@@ -0,0 +1,116 @@
+// Packs BMP assets into a single archive read by AssetArchive.
+// Every asset is converted to ARGB8888 (the texture format the SDL renderers use natively)
+// and its color key is turned into alpha, the other pixels keeping their own alpha, so the engine only has to copy
+// the pixels to the GPU.
+// Usage: ./bin/AssetPacker [--color-key r g b] <archive> <bmp>...
+// e.g.   ./bin/AssetPacker ./assets/assets.pak ./assets/*.bmp
+
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.hpp"
+#include "PixelOps.hpp"
+
+static void WritePadding(std::ofstream &out, Uint64 alignment)
+{
+    static const char zeros[AssetArchive::ARCHIVE_ALIGNMENT] = {};
+    Uint64 position = out.tellp();
+    Uint64 padding = (alignment - position % alignment) % alignment;
+    out.write(zeros, padding);
+}
+
+int main(int argc, char **argv)
+{
+    // Same color key as the ResourceManager
+    Uint32 colorKey = 0x000000;
+    int first = 1;
+    if (argc > 4 && std::strcmp(argv[1], "--color-key") == 0)
+    {
+        colorKey = (std::atoi(argv[2]) & 0xFF) << 16 | (std::atoi(argv[3]) & 0xFF) << 8 | (std::atoi(argv[4]) & 0xFF);
+        first = 5;
+    }
+    if (argc - first < 2)
+    {
+        std::printf("Usage: %s [--color-key r g b] <archive> <bmp>...\n", argv[0]);
+        return 1;
+    }
+
+    std::string archivePath = argv[first];
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::printf("Could not create %s\n", archivePath.c_str());
+        return 1;
+    }
+
+    // The header is written again once the offsets are known
+    AssetArchiveHeader header{};
+    std::memcpy(header.magic, AssetArchive::ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = AssetArchive::ARCHIVE_VERSION;
+    header.pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<AssetArchiveEntry> entries;
+    std::string strings;
+    Uint64 pixelBytes = 0;
+    for (int i = first + 1; i < argc; i++)
+    {
+        std::string assetPath = AssetArchive::NormalizePath(argv[i]);
+        SDL_Surface *loaded = SDL_LoadBMP(argv[i]);
+        if (nullptr == loaded)
+        {
+            std::printf("Skipping %s: %s\n", argv[i], SDL_GetError());
+            continue;
+        }
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+        SDL_DestroySurface(loaded);
+        if (nullptr == converted)
+        {
+            std::printf("Skipping %s: %s\n", argv[i], SDL_GetError());
+            continue;
+        }
+        ColorKeyToAlpha(static_cast<Uint32 *>(converted->pixels), converted->w, converted->h, converted->pitch, colorKey);
+
+        WritePadding(out, AssetArchive::ARCHIVE_ALIGNMENT);
+        AssetArchiveEntry entry{};
+        entry.pathOffset = strings.size();
+        entry.pathLength = assetPath.size();
+        entry.width = converted->w;
+        entry.height = converted->h;
+        entry.pitch = converted->w * 4;
+        entry.dataOffset = out.tellp();
+        // Rows are written tightly packed, the surface pitch may include padding
+        for (int y = 0; y < converted->h; y++)
+        {
+            out.write(static_cast<const char *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch, entry.pitch);
+        }
+        pixelBytes += static_cast<Uint64>(entry.pitch) * entry.height;
+        SDL_DestroySurface(converted);
+
+        strings += assetPath;
+        entries.push_back(entry);
+        std::printf("Packed %s (%ux%u)\n", assetPath.c_str(), entry.width, entry.height);
+    }
+
+    WritePadding(out, alignof(AssetArchiveEntry));
+    header.entryCount = entries.size();
+    header.indexOffset = out.tellp();
+    out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(AssetArchiveEntry));
+    header.stringsOffset = out.tellp();
+    out.write(strings.data(), strings.size());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!out)
+    {
+        std::printf("Error writing %s\n", archivePath.c_str());
+        return 1;
+    }
+    std::printf("Wrote %s: %u assets, %.1f MB of pixels\n", archivePath.c_str(), header.entryCount, pixelBytes / (1024.0 * 1024.0));
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Converts BMP assets to QOI files next to them, e.g. ./assets/Hyena.bmp -> ./assets/Hyena.qoi.
+// The color key is turned into alpha on the way, the other pixels keeping their own alpha, so the engine loads
+// the QOI files without a color key pass.
+// Point the config at the .qoi files to use them.
+// Usage: ./bin/QoiConverter [--color-key r g b] <bmp>...
+
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "PixelOps.hpp"
+#include "QoiCodec.hpp"
+
+int main(int argc, char **argv)
+{
+    // Same color key as the ResourceManager
+    Uint32 colorKey = 0x000000;
+    int first = 1;
+    if (argc > 4 && std::strcmp(argv[1], "--color-key") == 0)
+    {
+        colorKey = (std::atoi(argv[2]) & 0xFF) << 16 | (std::atoi(argv[3]) & 0xFF) << 8 | (std::atoi(argv[4]) & 0xFF);
+        first = 5;
+    }
+    if (argc - first < 1)
+    {
+        std::printf("Usage: %s [--color-key r g b] <bmp>...\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = first; i < argc; i++)
+    {
+        SDL_Surface *loaded = SDL_LoadBMP(argv[i]);
+        if (nullptr == loaded)
+        {
+            std::printf("Skipping %s: %s\n", argv[i], SDL_GetError());
+            failures++;
+            continue;
+        }
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888);
+        SDL_DestroySurface(loaded);
+        if (nullptr == converted)
+        {
+            std::printf("Skipping %s: %s\n", argv[i], SDL_GetError());
+            failures++;
+            continue;
+        }
+        ColorKeyToAlpha(static_cast<Uint32 *>(converted->pixels), converted->w, converted->h, converted->pitch, colorKey);
+
+        std::string output = std::filesystem::path(argv[i]).replace_extension(".qoi").string();
+        if (QoiSaveSurface(converted, output))
+        {
+            std::printf("%s: %ju -> %ju bytes\n", output.c_str(), static_cast<uintmax_t>(std::filesystem::file_size(argv[i])),
+                        static_cast<uintmax_t>(std::filesystem::file_size(output)));
+        }
+        else
+        {
+            std::printf("Error writing %s\n", output.c_str());
+            failures++;
+        }
+        SDL_DestroySurface(converted);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+# Builds every tool in this directory as its own executable, see buildexecutables.py.
+# Usage (from the repository root): python3 tools/buildtools.py
+
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+from buildexecutables import build_executables
+
+build_executables("./tools")
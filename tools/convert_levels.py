@@ -0,0 +1,63 @@
+# Converts the JSON levels of config.json into binary level files, which the game maps instead of parsing.
+# Each file is read back and compared against its JSON level, then the sizes of both are printed.
+# Levels that already have a level file are skipped: the level editor saves to the level files, not to config.json.
+# With --force they are converted again, dropping the edits made in the game and their journal.
+# Usage (from the repository root): python3 tools/convert_levels.py [--force] [config file] [output directory]
+#        (defaults to ./config.json and the level_directory of its global_config)
+
+
+import json
+import math
+import os
+import sys
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "helpers"))
+from level_format import level_file_path, write_level_file, read_level_file, TileLayout
+
+
+def same(a, b):
+    if(isinstance(b, TileLayout)):
+        b = b.tolist()
+    # Positions are stored as 32 bit floats, like the engine holds them
+    if(isinstance(a, dict)):
+        return isinstance(b, dict) and a.keys() == b.keys() and all(same(a[k], b[k]) for k in a)
+    if(isinstance(a, list)):
+        return isinstance(b, list) and len(a) == len(b) and all(same(x, y) for x, y in zip(a, b))
+    if(isinstance(a, (int, float)) and not isinstance(a, bool)):
+        return isinstance(b, (int, float)) and math.isclose(a, b, rel_tol=1e-6)
+    return a == b
+
+
+force = "--force" in sys.argv
+arguments = [argument for argument in sys.argv[1:] if argument != "--force"]
+config_path = arguments[0] if len(arguments) > 0 else "./config.json"
+with open(config_path, "r") as file:
+    config = json.load(file)
+global_config = dict(config["global_config"])
+if(len(arguments) > 1):
+    global_config["level_directory"] = arguments[1]
+os.makedirs(global_config["level_directory"], exist_ok=True)
+
+failed = False
+for level in range(1, global_config["num_levels"] + 1):
+    level_name = "level {}".format(level)
+    level_config = config["levels"][level_name]
+    path = level_file_path(global_config, level)
+    if(os.path.exists(path) and not force):
+        print("{}: {} exists, skipped".format(level_name, path))
+        continue
+    size = write_level_file(path, level_name, level_config)
+    # A fresh level file holds no edit, the journal of the old one must not be replayed onto it
+    journal = os.path.join(global_config["level_directory"], "level_{}.journal".format(level))
+    if(os.path.exists(journal)):
+        os.remove(journal)
+
+    read_name, read_config = read_level_file(path)
+    if(read_name != level_name or not same(level_config, read_config)):
+        print("{}: {} does not read back as the JSON level".format(level_name, path))
+        failed = True
+        continue
+    json_size = len(json.dumps(level_config, indent=4))
+    print("{}: {} bytes ({} bytes as JSON) -> {}".format(level_name, size, json_size, path))
+
+sys.exit(1 if failed else 0)